@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Measures how event dispatch scales with the
+ * number of widgets.
+ *
+ * A stream of motion, button, scroll and key
+ * events is queued on the headless platform and
+ * dispatched in one go, so the single expose at
+ * the end is amortized over the whole stream. The
+ * time and the number of widget hit tests per
+ * event are printed as JSON.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#define WIDTH 640
+#define HEIGHT 480
+
+/** Upper bound of hit tests per run, so that the
+ * quadratic cases finish in reasonable time. */
+#define MAX_WORK 40000000.0
+
+#define ARRAY_COUNT(x) \
+  (sizeof (x) / sizeof (x[0]))
+
+typedef enum StackType
+{
+  /** Tiled widgets on one level. */
+  STACK_FLAT,
+
+  /** Tiled cells of 4 overlapping widgets
+   * (background, frame, control, label), like a
+   * typical plugin UI. */
+  STACK_CELLS,
+
+  /** Half of the widgets are full-window layers
+   * at the bottom and half are tiled on top. */
+  STACK_LAYERED,
+} StackType;
+
+static const char * stack_names[] = {
+  "flat",
+  "cells",
+  "layered",
+};
+
+static const int widget_counts[] = {
+  10, 100, 1000, 10000,
+};
+
+static void
+draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   rect,
+  void *      data)
+{
+}
+
+static uint64_t
+fingerprint_cb (
+  ZtkWidget * widget)
+{
+  return 1;
+}
+
+static void
+add_widget (
+  ZtkApp *  app,
+  ZtkRect * rect,
+  int       z)
+{
+  ZtkDrawingArea * da =
+    ztk_drawing_area_new (
+      rect, NULL, draw_cb, NULL, NULL);
+  ((ZtkWidget *) da)->fingerprint_cb =
+    fingerprint_cb;
+  ztk_app_add_widget (app, (ZtkWidget *) da, z);
+}
+
+/**
+ * Adds \p num widgets tiled over the window at
+ * the given z, each cell getting \p per_cell
+ * overlapping widgets.
+ */
+static void
+add_tiled (
+  ZtkApp * app,
+  int      num,
+  int      per_cell,
+  int      z)
+{
+  int num_cells = (num + per_cell - 1) / per_cell;
+  int cols = 1;
+  while (cols * cols < num_cells)
+    cols++;
+  double w = (double) WIDTH / cols;
+  double h = (double) HEIGHT / cols;
+  for (int i = 0; i < num; i++)
+    {
+      int cell = i / per_cell;
+      int level = i % per_cell;
+      ZtkRect rect = {
+        (cell % cols) * w + level,
+        (cell / cols) * h + level,
+        w - level * 2, h - level * 2 };
+      add_widget (app, &rect, z + level);
+    }
+}
+
+static ZtkApp *
+create_app (
+  StackType type,
+  int       num_widgets)
+{
+  ZtkApp * app =
+    ztk_app_new ("dispatch", NULL, WIDTH, HEIGHT);
+  switch (type)
+    {
+    case STACK_FLAT:
+      add_tiled (app, num_widgets, 1, 0);
+      break;
+    case STACK_CELLS:
+      add_tiled (app, num_widgets, 4, 0);
+      break;
+    case STACK_LAYERED:
+      {
+        ZtkRect rect = { 0, 0, WIDTH, HEIGHT };
+        for (int i = 0; i < num_widgets / 2; i++)
+          {
+            add_widget (app, &rect, 0);
+          }
+        add_tiled (
+          app, num_widgets - num_widgets / 2, 1, 1);
+      }
+      break;
+    }
+
+  /* draw the first frame */
+  ztk_app_idle (app);
+
+  return app;
+}
+
+/**
+ * Queues a stream of \p num_events synthetic
+ * events.
+ */
+static void
+queue_events (
+  ZtkApp *   app,
+  int        num_events,
+  uint32_t * seed)
+{
+  static const PuglEventType pattern[] = {
+    PUGL_MOTION_NOTIFY, PUGL_MOTION_NOTIFY,
+    PUGL_MOTION_NOTIFY, PUGL_MOTION_NOTIFY,
+    PUGL_BUTTON_PRESS, PUGL_MOTION_NOTIFY,
+    PUGL_MOTION_NOTIFY, PUGL_BUTTON_RELEASE,
+    PUGL_SCROLL, PUGL_SCROLL,
+    PUGL_KEY_PRESS, PUGL_KEY_RELEASE,
+  };
+
+  for (int i = 0; i < num_events; i++)
+    {
+      PuglEvent ev;
+      memset (&ev, 0, sizeof (ev));
+      ev.type = pattern[i % ARRAY_COUNT (pattern)];
+      double x = bench_rand (seed) % WIDTH;
+      double y = bench_rand (seed) % HEIGHT;
+      switch (ev.type)
+        {
+        case PUGL_BUTTON_PRESS:
+        case PUGL_BUTTON_RELEASE:
+          ev.button.x = x;
+          ev.button.y = y;
+          ev.button.button = 1;
+          break;
+        case PUGL_MOTION_NOTIFY:
+          ev.motion.x = x;
+          ev.motion.y = y;
+          break;
+        case PUGL_SCROLL:
+          ev.scroll.x = x;
+          ev.scroll.y = y;
+          ev.scroll.dy = 1.0;
+          break;
+        case PUGL_KEY_PRESS:
+        case PUGL_KEY_RELEASE:
+          ev.key.key = 'a';
+          break;
+        default:
+          break;
+        }
+      puglHeadlessSendEvent (app->view, &ev);
+    }
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  printf ("[\n");
+  for (size_t s = 0; s < ARRAY_COUNT (stack_names);
+       s++)
+    {
+      for (size_t n = 0;
+           n < ARRAY_COUNT (widget_counts); n++)
+        {
+          int num_widgets = widget_counts[n];
+          ZtkApp * app =
+            create_app ((StackType) s, num_widgets);
+
+          /* estimate the work per event to bound
+           * the run time */
+          uint32_t seed = 1;
+          queue_events (app, 12, &seed);
+          app->num_hit_tests = 0;
+          ztk_app_idle (app);
+          double work =
+            (double) app->num_hit_tests / 12 + 1;
+          int num_events =
+            (int) CLAMP (MAX_WORK / work, 24, 20000);
+
+          queue_events (app, num_events, &seed);
+          app->num_hit_tests = 0;
+          uint64_t start = bench_get_time_ns ();
+          ztk_app_idle (app);
+          uint64_t ns = bench_get_time_ns () - start;
+
+          printf (
+            "  { \"stack\": \"%s\", \"widgets\": %d, "
+            "\"events\": %d, "
+            "\"ns_per_event\": %.1f, "
+            "\"widgets_touched_per_event\": %.1f }%s\n",
+            stack_names[s], app->num_widgets,
+            num_events, (double) ns / num_events,
+            (double) app->num_hit_tests / num_events,
+            s == ARRAY_COUNT (stack_names) - 1 &&
+              n == ARRAY_COUNT (widget_counts) - 1 ?
+              "" : ",");
+
+          ztk_app_free (app);
+        }
+    }
+  printf ("]\n");
+
+  return 0;
+}
@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Measures the per-frame draw time of common
+ * widget layouts on the headless platform.
+ *
+ * Each scenario is drawn with full-window exposes
+ * and with small-damage exposes, where only one
+ * knob changes per frame, and the results are
+ * printed as JSON.
+ *
+ * Usage: draw <scenario> [svg file]
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#define WIDTH 640
+#define HEIGHT 480
+#define NUM_WARMUP_FRAMES 10
+#define NUM_FRAMES 300
+
+/** Position of the knob that changes in
+ * small-damage mode. */
+#define PROBE_X (WIDTH - 36)
+#define PROBE_Y (HEIGHT - 36)
+
+#define ARRAY_COUNT(x) \
+  (sizeof (x) / sizeof (x[0]))
+
+typedef void (*SetupFunc) (
+  ZtkApp *     app,
+  const char * arg);
+
+typedef struct Scenario
+{
+  const char * name;
+  SetupFunc    setup;
+} Scenario;
+
+/** Value of the knob that changes in small-damage
+ * mode. */
+static float probe_val = 0.f;
+
+static float
+get_val (
+  void * object)
+{
+  return object ? *(float *) object : 0.5f;
+}
+
+static void
+set_val (
+  void * object,
+  float  val)
+{
+  if (object)
+    *(float *) object = val;
+}
+
+static void
+bg_draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   rect,
+  void *      data)
+{
+  cairo_set_source_rgb (cr, 0.1, 0.1, 0.1);
+  cairo_paint (cr);
+}
+
+static uint64_t
+bg_fingerprint_cb (
+  ZtkWidget * widget)
+{
+  return 1;
+}
+
+static void
+add_background (
+  ZtkApp * app)
+{
+  ZtkRect rect = { 0, 0, WIDTH, HEIGHT };
+  ZtkDrawingArea * bg =
+    ztk_drawing_area_new (
+      &rect, NULL, bg_draw_cb, NULL, NULL);
+  ((ZtkWidget *) bg)->fingerprint_cb =
+    bg_fingerprint_cb;
+  ztk_app_add_widget (app, (ZtkWidget *) bg, 0);
+}
+
+/**
+ * Adds a grid of 32x32 knobs covering the window,
+ * leaving the bottom right cell for the probe
+ * knob.
+ */
+static void
+add_knobs (
+  ZtkApp * app)
+{
+  for (int y = 4; y + 32 <= HEIGHT; y += 40)
+    {
+      for (int x = 4; x + 32 <= WIDTH; x += 40)
+        {
+          if (x == PROBE_X && y == PROBE_Y)
+            continue;
+
+          ZtkRect rect = { x, y, 32, 32 };
+          ZtkKnob * knob =
+            ztk_knob_new (
+              &rect, get_val, set_val, NULL,
+              0.f, 1.f, 0.f);
+          ztk_app_add_widget (
+            app, (ZtkWidget *) knob, 1);
+        }
+    }
+}
+
+/**
+ * Adds a grid of labels covering the window.
+ */
+static void
+add_labels (
+  ZtkApp * app)
+{
+  ZtkColor color;
+  ztk_color_parse_hex (&color, "#CCCCCC");
+  int i = 0;
+  for (int y = 16; y < HEIGHT; y += 20)
+    {
+      for (int x = 4; x + 80 <= WIDTH; x += 80)
+        {
+          char lbl[40];
+          snprintf (
+            lbl, sizeof (lbl), "Param %d", i++);
+          ZtkLabel * label =
+            ztk_label_new (x, y, 12, &color, lbl);
+          ztk_app_add_widget (
+            app, (ZtkWidget *) label, 2);
+        }
+    }
+}
+
+static void
+setup_knobs (
+  ZtkApp *     app,
+  const char * arg)
+{
+  add_background (app);
+  add_knobs (app);
+}
+
+static void
+setup_labels (
+  ZtkApp *     app,
+  const char * arg)
+{
+  add_background (app);
+  add_labels (app);
+}
+
+static void
+setup_svg_buttons (
+  ZtkApp *     app,
+  const char * arg)
+{
+  add_background (app);
+#ifdef HAVE_RSVG
+  ZtkRsvgHandle * svg = ztk_rsvg_load_svg (arg);
+  if (!svg)
+    {
+      ztk_error ("Failed to load %s", arg);
+      exit (1);
+    }
+  for (int y = 4; y + 32 <= HEIGHT; y += 40)
+    {
+      for (int x = 4; x + 32 <= WIDTH; x += 40)
+        {
+          if (x == PROBE_X && y == PROBE_Y)
+            continue;
+
+          ZtkRect rect = { x, y, 32, 32 };
+          ZtkButton * btn =
+            ztk_button_new (&rect, NULL, NULL);
+          ztk_button_make_svged (
+            btn, 2, 2, svg, svg, svg);
+          ztk_app_add_widget (
+            app, (ZtkWidget *) btn, 1);
+        }
+    }
+#else
+  ztk_error (
+    "%s", "SVG buttons need ztoolkit to be built "
+    "with enable_rsvg");
+  exit (1);
+#endif
+}
+
+static void
+setup_combo_box (
+  ZtkApp *     app,
+  const char * arg)
+{
+  add_background (app);
+  add_knobs (app);
+
+  /* open combo box with the maximum number of
+   * elements */
+  ZtkRect rect = { 4, 4, 80, 16 };
+  ZtkButton * btn =
+    ztk_button_new (&rect, NULL, NULL);
+  ztk_button_make_labeled (btn, "Presets");
+  ztk_app_add_widget (app, (ZtkWidget *) btn, 3);
+  ZtkComboBox * combo =
+    ztk_combo_box_new ((ZtkWidget *) btn, 0, 0);
+  ztk_app_add_widget (app, (ZtkWidget *) combo, 4);
+  int max_elements =
+    (int) ARRAY_COUNT (combo->elements);
+  for (int i = 0; i < max_elements; i++)
+    {
+      if (i % 10 == 9)
+        {
+          ztk_combo_box_add_separator (combo);
+          continue;
+        }
+      char lbl[40];
+      snprintf (lbl, sizeof (lbl), "Preset %d", i);
+      ztk_combo_box_add_text_element (
+        combo, lbl, NULL, NULL);
+    }
+}
+
+static void
+setup_dialog (
+  ZtkApp *     app,
+  const char * arg)
+{
+  add_background (app);
+  add_knobs (app);
+  add_labels (app);
+
+  ZtkRect modal_rect = { 0, 0, WIDTH, HEIGHT };
+  ZtkRect rect = {
+    WIDTH / 4, HEIGHT / 4, WIDTH / 2, HEIGHT / 2 };
+  ZtkDialog * dialog =
+    ztk_dialog_new (app, &modal_rect, &rect, NULL);
+  ztk_dialog_make_about (
+    dialog, "About", "1.0",
+    "Copyright (C) 2020 Alexandros Theodotou",
+    ZTK_DIALOG_ABOUT_LICENSE_AGPL_3_PLUS,
+    "A benchmark plugin");
+  ztk_app_add_widget (
+    app, (ZtkWidget *) dialog, 700);
+}
+
+static const Scenario scenarios[] = {
+  { "knobs", setup_knobs },
+  { "labels", setup_labels },
+  { "svg_buttons", setup_svg_buttons },
+  { "combo_box", setup_combo_box },
+  { "dialog", setup_dialog },
+};
+
+static int
+cmp_u64 (
+  const void * a,
+  const void * b)
+{
+  uint64_t ua = *(const uint64_t *) a;
+  uint64_t ub = *(const uint64_t *) b;
+
+  return (ua > ub) - (ua < ub);
+}
+
+/**
+ * Returns the number of window pixels covered by
+ * the rectangles redrawn in the last frame.
+ */
+static long
+count_damaged_pixels (
+  ZtkApp *        app,
+  unsigned char * mask)
+{
+  memset (mask, 0, WIDTH * HEIGHT);
+  long pixels = 0;
+  for (int i = 0; i < app->num_damage_rects; i++)
+    {
+      ZtkRect * r = &app->damage_rects[i];
+      int x0 = MAX ((int) r->x, 0);
+      int y0 = MAX ((int) r->y, 0);
+      int x1 = MIN ((int) (r->x + r->width), WIDTH);
+      int y1 = MIN ((int) (r->y + r->height), HEIGHT);
+      for (int y = y0; y < y1; y++)
+        {
+          for (int x = x0; x < x1; x++)
+            {
+              pixels += !mask[y * WIDTH + x];
+              mask[y * WIDTH + x] = 1;
+            }
+        }
+    }
+
+  return pixels;
+}
+
+/**
+ * Draws NUM_FRAMES frames and prints the timings
+ * as a JSON object.
+ *
+ * @param probe Widget to change on each frame in
+ *   small-damage mode, or NULL to redraw the whole
+ *   window on each frame.
+ */
+static void
+run_mode (
+  ZtkApp *    app,
+  ZtkWidget * probe)
+{
+  uint64_t samples[NUM_FRAMES];
+  unsigned char * mask = malloc (WIDTH * HEIGHT);
+  long pixels = 0;
+  for (int i = 0; i < NUM_WARMUP_FRAMES + NUM_FRAMES;
+       i++)
+    {
+      if (probe)
+        {
+          probe_val = i % 2 ? 0.75f : 0.25f;
+          ztk_widget_queue_draw (probe);
+        }
+      else
+        {
+          app->redraw_all = 1;
+          puglPostRedisplay (app->view);
+        }
+
+      app->num_damage_rects = 0;
+      uint64_t start = bench_get_time_ns ();
+      ztk_app_idle (app);
+      uint64_t ns = bench_get_time_ns () - start;
+
+      if (i < NUM_WARMUP_FRAMES)
+        continue;
+
+      samples[i - NUM_WARMUP_FRAMES] = ns;
+      pixels += count_damaged_pixels (app, mask);
+    }
+  free (mask);
+
+  qsort (
+    samples, NUM_FRAMES, sizeof (uint64_t),
+    cmp_u64);
+  printf (
+    "    { \"mode\": \"%s\", \"frames\": %d, "
+    "\"median_us\": %.3f, \"p99_us\": %.3f, "
+    "\"pixels\": %ld }",
+    probe ? "damage" : "full", NUM_FRAMES,
+    (double) samples[NUM_FRAMES / 2] / 1e3,
+    (double) samples[NUM_FRAMES * 99 / 100] / 1e3,
+    pixels / NUM_FRAMES);
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  const Scenario * scenario = NULL;
+  for (size_t i = 0; argc > 1 &&
+       i < ARRAY_COUNT (scenarios); i++)
+    {
+      if (!strcmp (argv[1], scenarios[i].name))
+        scenario = &scenarios[i];
+    }
+  if (!scenario)
+    {
+      fprintf (
+        stderr, "Usage: %s <scenario> [svg file]\n",
+        argv[0]);
+      return 1;
+    }
+
+  ZtkApp * app =
+    ztk_app_new ("draw", NULL, WIDTH, HEIGHT);
+  scenario->setup (app, argc > 2 ? argv[2] : NULL);
+
+  /* the knob changed in small-damage mode, under
+   * any popups */
+  ZtkRect rect = { PROBE_X, PROBE_Y, 32, 32 };
+  ZtkKnob * probe =
+    ztk_knob_new (
+      &rect, get_val, set_val, &probe_val,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) probe, 1);
+  ztk_app_idle (app);
+
+  printf (
+    "{\n  \"benchmark\": \"%s\",\n"
+    "  \"widgets\": %d,\n"
+    "  \"width\": %d,\n  \"height\": %d,\n"
+    "  \"results\": [\n",
+    scenario->name, app->num_widgets, WIDTH, HEIGHT);
+  run_mode (app, NULL);
+  printf (",\n");
+  run_mode (app, (ZtkWidget *) probe);
+  printf ("\n  ]\n}\n");
+
+  ztk_app_free (app);
+
+  return 0;
+}
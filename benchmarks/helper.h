@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+
+ * This file is part of ZToolkit
+
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __Z_TOOLKIT_BENCHMARKS_HELPER_H__
+#define __Z_TOOLKIT_BENCHMARKS_HELPER_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ztoolkit/log.h>
+
+/**
+ * Returns the monotonic time in nanoseconds.
+ */
+static inline uint64_t
+bench_get_time_ns (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return
+    (uint64_t) ts.tv_sec * 1000000000ull +
+    (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * Deterministic pseudo-random number generator, so
+ * that runs are comparable.
+ */
+static inline uint32_t
+bench_rand (
+  uint32_t * state)
+{
+  *state = *state * 1664525u + 1013904223u;
+  return *state >> 8;
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Compares testing a rect against every widget
+ * one at a time with ztk_widget_is_hit_by_rect()
+ * to the batch kernels over the widget table.
+ *
+ * The time per widget tested is printed as JSON
+ * for each widget count and each kernel supported
+ * on this machine.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#define WIDTH 1280
+#define HEIGHT 720
+
+#define NUM_QUERIES 256
+
+/** Widgets tested per measurement. */
+#define WORK 50000000.0
+
+#define ARRAY_COUNT(x) \
+  (sizeof (x) / sizeof (x[0]))
+
+static const int widget_counts[] = {
+  16, 100, 1000, 10000,
+};
+
+static const ZtkHitTestImpl impls[] = {
+  ZTK_HIT_TEST_SCALAR,
+  ZTK_HIT_TEST_SSE2,
+  ZTK_HIT_TEST_AVX2,
+  ZTK_HIT_TEST_NEON,
+};
+
+/** Keeps the results alive. */
+static volatile int sink;
+
+static void
+get_rand_rect (
+  ZtkRect *  rect,
+  uint32_t * seed,
+  int        max_size)
+{
+  rect->x = bench_rand (seed) % WIDTH;
+  rect->y = bench_rand (seed) % HEIGHT;
+  rect->width = bench_rand (seed) % max_size;
+  rect->height = bench_rand (seed) % max_size;
+}
+
+static void
+print_result (
+  const char * method,
+  int          num_widgets,
+  int          num_rounds,
+  uint64_t     ns,
+  int          last)
+{
+  printf (
+    "  { \"method\": \"%s\", \"widgets\": %d, "
+    "\"ns_per_query\": %.1f, "
+    "\"ns_per_widget\": %.3f }%s\n",
+    method, num_widgets,
+    (double) ns / (num_rounds * NUM_QUERIES),
+    (double) ns /
+      ((double) num_rounds * NUM_QUERIES *
+       num_widgets),
+    last ? "" : ",");
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkRect queries[NUM_QUERIES];
+  uint32_t seed = 1;
+  for (int i = 0; i < NUM_QUERIES; i++)
+    {
+      get_rand_rect (&queries[i], &seed, 100);
+    }
+
+  printf ("[\n");
+  for (size_t n = 0; n < ARRAY_COUNT (widget_counts);
+       n++)
+    {
+      int num_widgets = widget_counts[n];
+      ZtkWidget * widgets =
+        calloc (
+          (size_t) num_widgets, sizeof (ZtkWidget));
+      ZtkWidget ** widget_ptrs =
+        calloc (
+          (size_t) num_widgets, sizeof (ZtkWidget *));
+      for (int i = 0; i < num_widgets; i++)
+        {
+          get_rand_rect (&widgets[i].rect, &seed, 200);
+          widgets[i].visible = 1;
+          widget_ptrs[i] = &widgets[i];
+        }
+      ZtkWidgetTable table;
+      memset (&table, 0, sizeof (table));
+      ztk_widget_table_rebuild (
+        &table, widget_ptrs, num_widgets);
+      uint8_t * mask =
+        calloc (
+          (size_t)
+            ztk_hit_test_get_mask_size (&table),
+          1);
+      int num_rounds =
+        (int)
+        CLAMP (
+          WORK / ((double) num_widgets * NUM_QUERIES),
+          1, 100000);
+
+      /* one widget at a time */
+      uint64_t start = bench_get_time_ns ();
+      for (int r = 0; r < num_rounds; r++)
+        {
+          for (int q = 0; q < NUM_QUERIES; q++)
+            {
+              int num_hits = 0;
+              for (int i = 0; i < num_widgets; i++)
+                {
+                  ZtkWidget * w = widget_ptrs[i];
+                  num_hits +=
+                    w->visible &&
+                    ztk_widget_is_hit_by_rect (
+                      w, &queries[q]);
+                }
+              sink = num_hits;
+            }
+        }
+      print_result (
+        "ztk_widget_is_hit_by_rect", num_widgets,
+        num_rounds, bench_get_time_ns () - start, 0);
+
+      /* batch kernels */
+      for (size_t k = 0; k < ARRAY_COUNT (impls); k++)
+        {
+          if (!ztk_hit_test_is_impl_supported (
+                 impls[k]))
+            continue;
+
+          ztk_hit_test_set_impl (impls[k]);
+          start = bench_get_time_ns ();
+          for (int r = 0; r < num_rounds; r++)
+            {
+              for (int q = 0; q < NUM_QUERIES; q++)
+                {
+                  sink =
+                    ztk_hit_test_batch (
+                      &table, &queries[q], mask);
+                }
+            }
+          uint64_t ns = bench_get_time_ns () - start;
+
+          /* the last supported kernel closes the
+           * array */
+          int last = 0;
+          if (n == ARRAY_COUNT (widget_counts) - 1)
+            {
+              last = 1;
+              for (size_t j = k + 1;
+                   j < ARRAY_COUNT (impls); j++)
+                {
+                  if (ztk_hit_test_is_impl_supported (
+                        impls[j]))
+                    last = 0;
+                }
+            }
+          print_result (
+            ztk_hit_test_impl_to_string (impls[k]),
+            num_widgets, num_rounds, ns, last);
+        }
+
+      free (mask);
+      ztk_widget_table_free (&table);
+      free (widget_ptrs);
+      free (widgets);
+    }
+  printf ("]\n");
+
+  return 0;
+}
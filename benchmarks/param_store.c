@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Measures the per-frame cost of detecting
+ * changed parameters in a 200-parameter plugin UI,
+ * with no changes and with a few port events per
+ * frame.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#define NUM_PARAMS 200
+#define NUM_FRAMES 100000
+
+static double
+run (
+  ZtkParamStore * store,
+  int             num_events)
+{
+  uint32_t seed = 1;
+  uint64_t total_ns = 0;
+  for (int i = 0; i < NUM_FRAMES; i++)
+    {
+      for (int j = 0; j < num_events; j++)
+        {
+          ztk_param_store_port_event (
+            store,
+            bench_rand (&seed) % NUM_PARAMS,
+            (float) (bench_rand (&seed) % 1000));
+        }
+
+      uint64_t start = bench_get_time_ns ();
+      ztk_param_store_drain (store);
+      total_ns += bench_get_time_ns () - start;
+    }
+
+  return (double) total_ns / NUM_FRAMES;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkParamStore * store =
+    ztk_param_store_new (NUM_PARAMS, 256);
+
+  double idle_ns = run (store, 0);
+  double busy_ns = run (store, 4);
+  printf (
+    "drain: %d params, idle %.1f ns/frame, "
+    "4 changes %.1f ns/frame\n",
+    NUM_PARAMS, idle_ns, busy_ns);
+
+  ztk_param_store_free (store);
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Measures the time to build a search index over
+ * 10k preset names and the per-keystroke query
+ * latency while typing.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/search_index.h>
+
+#define NUM_NAMES 10000
+#define NUM_RUNS 50
+
+static const char * categories[] = {
+  "Bass", "Lead", "Pad", "Pluck", "Keys", "Arp",
+  "FX", "Drum", "Bell", "String", "Brass", "Seq",
+};
+
+static const char * adjectives[] = {
+  "Warm", "Dark", "Bright", "Deep", "Wide", "Soft",
+  "Hard", "Dirty", "Clean", "Analog", "Digital",
+  "Vintage", "Modern", "Lush", "Thin", "Fat",
+};
+
+static const char * nouns[] = {
+  "Sunrise", "Machine", "Ocean", "Circuit", "Dream",
+  "Storm", "Glass", "Motion", "Echo", "Pulse",
+  "Nebula", "Garden", "Engine", "River", "Signal",
+};
+
+/** Queries to type, one character at a time. */
+static const char * queries[] = {
+  "warm pad",
+  "circuit",
+  "vintage bass",
+  "xyz",
+};
+
+#define ARRAY_COUNT(x) \
+  (sizeof (x) / sizeof (x[0]))
+
+static int
+cmp_u64 (
+  const void * a,
+  const void * b)
+{
+  uint64_t ua = *(const uint64_t *) a;
+  uint64_t ub = *(const uint64_t *) b;
+
+  return (ua > ub) - (ua < ub);
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  /* generate names */
+  char ** names = calloc (NUM_NAMES, sizeof (char *));
+  uint32_t seed = 1;
+  for (int i = 0; i < NUM_NAMES; i++)
+    {
+      names[i] = malloc (80);
+      snprintf (
+        names[i], 80, "%s %s %s %04d",
+        adjectives[
+          bench_rand (&seed) %
+            ARRAY_COUNT (adjectives)],
+        categories[
+          bench_rand (&seed) %
+            ARRAY_COUNT (categories)],
+        nouns[
+          bench_rand (&seed) % ARRAY_COUNT (nouns)],
+        i);
+    }
+
+  /* build */
+  uint64_t build_ns = 0;
+  ZtkSearchIndex * index = NULL;
+  for (int run = 0; run < NUM_RUNS; run++)
+    {
+      if (index)
+        ztk_search_index_free (index);
+      uint64_t start = bench_get_time_ns ();
+      index =
+        ztk_search_index_new (
+          (const char **) names, NUM_NAMES);
+      build_ns += bench_get_time_ns () - start;
+    }
+  printf (
+    "build: %d names, %.3f ms\n", NUM_NAMES,
+    (double) build_ns / NUM_RUNS / 1e6);
+
+  /* type each query one key at a time, then erase
+   * it */
+  ZtkSearchResults * results =
+    ztk_search_results_new (index);
+  uint64_t * samples =
+    calloc (
+      NUM_RUNS * ARRAY_COUNT (queries) * 2 * 80,
+      sizeof (uint64_t));
+  uint64_t total_ns = 0;
+  int num_keystrokes = 0;
+  for (int run = 0; run < NUM_RUNS; run++)
+    {
+      for (size_t q = 0; q < ARRAY_COUNT (queries);
+           q++)
+        {
+          char buf[80];
+          size_t len = strlen (queries[q]);
+          for (size_t i = 0; i <= len * 2; i++)
+            {
+              size_t cur_len =
+                i <= len ? i : len * 2 - i;
+              memcpy (buf, queries[q], cur_len);
+              buf[cur_len] = '\0';
+
+              uint64_t start = bench_get_time_ns ();
+              ztk_search_index_query (
+                index, buf, results);
+              uint64_t ns =
+                bench_get_time_ns () - start;
+              total_ns += ns;
+              samples[num_keystrokes++] = ns;
+            }
+        }
+    }
+  qsort (
+    samples, (size_t) num_keystrokes,
+    sizeof (uint64_t), cmp_u64);
+  printf (
+    "query: %d keystrokes, mean %.3f ms, "
+    "p99 %.3f ms, max %.3f ms\n",
+    num_keystrokes,
+    (double) total_ns / num_keystrokes / 1e6,
+    (double) samples[num_keystrokes * 99 / 100] /
+      1e6,
+    (double) samples[num_keystrokes - 1] / 1e6);
+  free (samples);
+
+  ztk_search_results_free (results);
+  ztk_search_index_free (index);
+  for (int i = 0; i < NUM_NAMES; i++)
+    {
+      free (names[i]);
+    }
+  free (names);
+
+  return 0;
+}
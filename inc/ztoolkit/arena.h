@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Bump allocator for objects freed all at once.
+ *
+ * Memory is taken from blocks allocated as needed
+ * and only released when the arena is freed, so
+ * objects allocated together end up next to each
+ * other and freeing them costs one free() per
+ * block.
+ *
+ * While an arena is set as current on a thread,
+ * widgets created on that thread are allocated from
+ * it (see ztk_app_use_arena()).
+ */
+
+#ifndef __ZTOOLKIT_ARENA_H__
+#define __ZTOOLKIT_ARENA_H__
+
+#include <stddef.h>
+
+/** Default size of the blocks, in bytes. */
+#define ZTK_ARENA_DEFAULT_BLOCK_SIZE 65536
+
+typedef struct ZtkArenaBlock ZtkArenaBlock;
+
+/**
+ * Bump allocator.
+ */
+typedef struct ZtkArena
+{
+  /** Block allocated from, with older blocks
+   * linked after it. */
+  ZtkArenaBlock *   block;
+
+  /** Size of new blocks, in bytes. */
+  size_t            block_size;
+
+  /** Total bytes allocated from the arena. */
+  size_t            num_bytes;
+} ZtkArena;
+
+/**
+ * Creates a new arena.
+ *
+ * @param block_size Size of the blocks, or 0 for
+ *   ZTK_ARENA_DEFAULT_BLOCK_SIZE.
+ */
+ZtkArena *
+ztk_arena_new (
+  size_t block_size);
+
+/**
+ * Returns \p size bytes of zeroed memory, aligned
+ * for any type.
+ *
+ * The memory stays valid until the arena is
+ * freed.
+ */
+void *
+ztk_arena_alloc (
+  ZtkArena * self,
+  size_t     size);
+
+/**
+ * Returns whether \p ptr was allocated from the
+ * arena.
+ */
+int
+ztk_arena_contains (
+  ZtkArena *   self,
+  const void * ptr);
+
+/**
+ * Sets the arena that widgets created on the
+ * calling thread are allocated from, or NULL to
+ * allocate them on the heap.
+ */
+void
+ztk_arena_set_current (
+  ZtkArena * self);
+
+/**
+ * Returns the current arena of the calling thread,
+ * if any.
+ */
+ZtkArena *
+ztk_arena_get_current (void);
+
+/**
+ * Frees the arena and everything allocated from
+ * it.
+ */
+void
+ztk_arena_free (
+  ZtkArena * self);
+
+#endif
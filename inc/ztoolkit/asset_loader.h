@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Loads assets on a pool of worker threads shared
+ * by all the apps in the process.
+ *
+ * Parsing and rasterizing SVGs on the UI thread
+ * would block the host while a UI with many of
+ * them is opened. Widgets instead request their
+ * assets from the app's loader and draw without
+ * them (or with a placeholder) until they are
+ * ready.
+ *
+ * Assets are resources from the resource cache,
+ * so a loaded asset is also shared with the other
+ * apps in the process. The completion callbacks run
+ * on the UI thread from ztk_app_idle(), after which
+ * the widget is queued for redrawing.
+ */
+
+#ifndef __ZTOOLKIT_ASSET_LOADER_H__
+#define __ZTOOLKIT_ASSET_LOADER_H__
+
+#include <stddef.h>
+
+typedef struct ZtkWidget ZtkWidget;
+typedef struct ZtkAssetLoader ZtkAssetLoader;
+
+/** Maximum number of worker threads. */
+#define ZTK_ASSET_LOADER_MAX_THREADS 8
+
+/**
+ * Loads an asset on a worker thread.
+ *
+ * @param data The data passed when the load was
+ *   requested.
+ * @return A resource from the resource cache with
+ *   a reference for the caller, or NULL if it could
+ *   not be loaded.
+ */
+typedef void * (*ZtkAssetLoadFunc) (
+  const void * data);
+
+/**
+ * Called on the UI thread when an asset finished
+ * loading.
+ *
+ * @param asset The asset, which the callback must
+ *   release with ztk_resource_cache_release() when
+ *   done with it, or NULL if it failed to load.
+ * @param data The data passed when the load was
+ *   requested.
+ */
+typedef void (*ZtkAssetLoadedCallback) (
+  ZtkWidget *  widget,
+  void *       asset,
+  const void * data);
+
+/**
+ * Creates a loader.
+ *
+ * The loaders of all the apps in the process share
+ * one pool of worker threads, which is started
+ * with the first loader and stopped with the last
+ * one.
+ *
+ * @param num_threads Number of worker threads if
+ *   the pool is not running yet, or 0 to use one
+ *   per CPU, up to ZTK_ASSET_LOADER_MAX_THREADS.
+ * @return The loader, or NULL if the threads could
+ *   not be started.
+ */
+ZtkAssetLoader *
+ztk_asset_loader_new (
+  int num_threads);
+
+/**
+ * Requests an asset for \p widget.
+ *
+ * Returns immediately. \p load_func runs on a
+ * worker thread and \p loaded_cb runs on the UI
+ * thread in a later ztk_asset_loader_dispatch()
+ * call, unless the load is cancelled first.
+ *
+ * @param data Data for the callbacks, copied.
+ */
+void
+ztk_asset_loader_load (
+  ZtkAssetLoader *       self,
+  ZtkWidget *            widget,
+  ZtkAssetLoadFunc       load_func,
+  ZtkAssetLoadedCallback loaded_cb,
+  const void *           data,
+  size_t                 data_size);
+
+/**
+ * Cancels the loads requested for \p widget.
+ *
+ * Loads already running are finished but their
+ * assets are released instead of passed to the
+ * widget. Must be called before the widget is
+ * freed.
+ */
+void
+ztk_asset_loader_cancel (
+  ZtkAssetLoader * self,
+  ZtkWidget *      widget);
+
+/**
+ * Calls the completion callbacks of the finished
+ * loads and queues their widgets for redrawing.
+ *
+ * To be called from the UI thread.
+ *
+ * @return The number of finished loads.
+ */
+int
+ztk_asset_loader_dispatch (
+  ZtkAssetLoader * self);
+
+/**
+ * Blocks until all the requested loads finished,
+ * without dispatching them.
+ */
+void
+ztk_asset_loader_wait (
+  ZtkAssetLoader * self);
+
+/**
+ * Returns the number of loads that were requested
+ * and not dispatched or cancelled yet.
+ */
+int
+ztk_asset_loader_get_num_pending (
+  ZtkAssetLoader * self);
+
+/**
+ * Returns the number of worker threads in the
+ * pool shared by the loaders, or 0 if there are
+ * no loaders.
+ */
+int
+ztk_asset_loader_get_num_threads (void);
+
+/**
+ * Cancels all the loads and frees the loader,
+ * stopping the threads if it was the last one.
+ */
+void
+ztk_asset_loader_free (
+  ZtkAssetLoader * self);
+
+#endif
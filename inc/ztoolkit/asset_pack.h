@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Pack of assets mapped into memory.
+ *
+ * Packs are built with scripts/ztkpack.py, which
+ * decodes PNGs (and optionally rasterizes SVGs) at
+ * 1x, 1.5x and 2x into premultiplied ARGB32 pixels
+ * laid out the way cairo expects them. The sprites
+ * are image surfaces that point straight into the
+ * mapped file, so nothing is decoded or copied at
+ * runtime, and all the plugin instances using a
+ * pack, in this process or another, share the same
+ * pages from the page cache.
+ *
+ * Other files, eg, SVGs to load with librsvg, are
+ * stored as they are.
+ *
+ * Packs are shared by the apps in the process
+ * through ztk_resource_cache_get_asset_pack(), and
+ * an app can load one with
+ * ztk_app_load_asset_pack().
+ */
+
+#ifndef __ZTOOLKIT_ASSET_PACK_H__
+#define __ZTOOLKIT_ASSET_PACK_H__
+
+#include <stddef.h>
+
+#include <cairo.h>
+
+typedef struct ZtkAssetPack ZtkAssetPack;
+
+/**
+ * Maps the pack at \p path.
+ *
+ * The pack is validated but its contents are only
+ * paged in when used.
+ *
+ * @return The pack, or NULL if it could not be
+ *   mapped or is invalid.
+ */
+ZtkAssetPack *
+ztk_asset_pack_new (
+  const char * path);
+
+/**
+ * Returns the sprite \p name for the given scale
+ * factor.
+ *
+ * Picks the smallest scale that is at least
+ * \p scale, so that the sprite is only ever scaled
+ * down, or the largest one if there is none.
+ *
+ * The surface belongs to the pack and must only
+ * be used as a source. It must not be referenced
+ * past ztk_asset_pack_free().
+ *
+ * @param scale Scale factor, eg, 1.5 on a display
+ *   scaled to 150%.
+ * @return An ARGB32 image surface, or NULL if
+ *   there is no such sprite.
+ */
+cairo_surface_t *
+ztk_asset_pack_get_sprite (
+  ZtkAssetPack * self,
+  const char *   name,
+  double         scale);
+
+/**
+ * Returns the contents of the file \p name stored
+ * in the pack.
+ *
+ * @param size Set to the size of the contents.
+ * @return The contents, valid until the pack is
+ *   freed, or NULL if there is no such file.
+ */
+const void *
+ztk_asset_pack_get_data (
+  ZtkAssetPack * self,
+  const char *   name,
+  size_t *       size);
+
+/**
+ * Returns the size of the mapped file.
+ */
+size_t
+ztk_asset_pack_get_size (
+  ZtkAssetPack * self);
+
+/**
+ * Destroys the sprites and unmaps the pack.
+ */
+void
+ztk_asset_pack_free (
+  ZtkAssetPack * self);
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * SVGs compiled into C at build time.
+ *
+ * scripts/svg2cairo.py turns SVGs into functions
+ * that issue the cairo calls directly, so they are
+ * drawn without librsvg and without reading or
+ * parsing anything at runtime. The generator is
+ * available to meson as the svg2cairo program, see
+ * the script for its usage and the supported SVG
+ * features.
+ */
+
+#ifndef __ZTOOLKIT_COMPILED_SVG_H__
+#define __ZTOOLKIT_COMPILED_SVG_H__
+
+#include <cairo.h>
+
+#include "ztoolkit/rect.h"
+
+/**
+ * An SVG compiled by svg2cairo.py.
+ */
+typedef struct ZtkCompiledSvg
+{
+  /** File name of the SVG, without the
+   * extension. */
+  const char * name;
+
+  /** Intrinsic size of the SVG. */
+  double       width;
+  double       height;
+
+  /** Draws the SVG at its intrinsic size, with
+   * the origin at its top left corner. */
+  void (*draw) (
+    cairo_t * cr);
+} ZtkCompiledSvg;
+
+/**
+ * Draws the SVG scaled to fit \p rect, keeping its
+ * aspect ratio and centered.
+ */
+void
+ztk_compiled_svg_draw (
+  const ZtkCompiledSvg * self,
+  cairo_t *              cr,
+  const ZtkRect *        rect);
+
+#endif
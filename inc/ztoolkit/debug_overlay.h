@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Debug overlay showing the frame rate and the
+ * areas repainted.
+ */
+
+#ifndef __ZTOOLKIT_DEBUG_OVERLAY_H__
+#define __ZTOOLKIT_DEBUG_OVERLAY_H__
+
+#include <cairo.h>
+
+#include "ztoolkit/rect.h"
+
+typedef struct ZtkWidget ZtkWidget;
+
+/** Number of frames shown in the graph. */
+#define ZTK_DEBUG_OVERLAY_NUM_FRAMES 60
+
+/** Maximum number of repaint flashes shown at
+ * once. */
+#define ZTK_DEBUG_OVERLAY_MAX_FLASHES 32
+
+/** Time a repaint flash takes to fade out, in
+ * seconds. */
+#define ZTK_DEBUG_OVERLAY_FLASH_DURATION 0.3
+
+/**
+ * An area repainted recently.
+ */
+typedef struct ZtkRepaintFlash
+{
+  ZtkRect           rect;
+
+  /** Widget that caused the repaint, or NULL for
+   * full repaints. */
+  ZtkWidget *       widget;
+
+  /** Time of the repaint, in seconds. */
+  double            time;
+} ZtkRepaintFlash;
+
+/**
+ * Debug overlay of an app.
+ */
+typedef struct ZtkDebugOverlay
+{
+  /** Start times and durations of the last frames,
+   * in seconds, in a ring buffer. */
+  double            frame_starts[
+    ZTK_DEBUG_OVERLAY_NUM_FRAMES];
+  double            frame_times[
+    ZTK_DEBUG_OVERLAY_NUM_FRAMES];
+  int               frames_idx;
+  int               num_frames;
+
+  ZtkRepaintFlash   flashes[
+    ZTK_DEBUG_OVERLAY_MAX_FLASHES];
+  int               num_flashes;
+
+  /** Rectangle of the HUD. */
+  ZtkRect           hud_rect;
+} ZtkDebugOverlay;
+
+ZtkDebugOverlay *
+ztk_debug_overlay_new (void);
+
+/**
+ * Adds a frame to the graph.
+ *
+ * @param start Start time of the frame, in seconds.
+ * @param duration Time taken by the frame.
+ */
+void
+ztk_debug_overlay_add_frame (
+  ZtkDebugOverlay * self,
+  double            start,
+  double            duration);
+
+/**
+ * Flashes a repainted area.
+ *
+ * @param widget Widget that caused the repaint, or
+ *   NULL for full repaints.
+ * @param time Current time, in seconds.
+ */
+void
+ztk_debug_overlay_add_flash (
+  ZtkDebugOverlay * self,
+  ZtkRect *         rect,
+  ZtkWidget *       widget,
+  double            time);
+
+/**
+ * Appends the areas the overlay needs to repaint
+ * to \p rects.
+ *
+ * There must be room for
+ * \ref ZTK_DEBUG_OVERLAY_MAX_FLASHES + 1
+ * rectangles.
+ *
+ * @return The number of rectangles appended.
+ */
+int
+ztk_debug_overlay_get_damage (
+  ZtkDebugOverlay * self,
+  ZtkRect *         rects);
+
+/**
+ * Draws the flashes and the HUD on top of the
+ * widgets, then forgets the flashes that faded
+ * out.
+ *
+ * @param time Current time, in seconds.
+ */
+void
+ztk_debug_overlay_draw (
+  ZtkDebugOverlay * self,
+  cairo_t *         cr,
+  double            time);
+
+void
+ztk_debug_overlay_free (
+  ZtkDebugOverlay * self);
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Drag gestures on value widgets.
+ */
+
+#ifndef __ZTOOLKIT_GESTURE_H__
+#define __ZTOOLKIT_GESTURE_H__
+
+typedef struct ZtkWidget ZtkWidget;
+
+/**
+ * Gesture callback prototype.
+ *
+ * @param widget The widget being dragged.
+ * @param value The real (not normalized) value.
+ * @param data User data passed when setting the
+ *   callbacks.
+ */
+typedef void (*ZtkGestureCallback) (
+  ZtkWidget * widget,
+  float       value,
+  void *      data);
+
+/**
+ * A drag gesture on a value widget, such as a knob.
+ *
+ * While dragging, the widget tracks the value here
+ * and only writes it (through its setter or
+ * parameter store) at most once per frame, or at
+ * the rate set with ztk_gesture_set_rate(). The
+ * exact final value is written on release, so
+ * hosts receive a begin notification, a bounded
+ * number of writes, and an end notification.
+ */
+typedef struct ZtkGesture
+{
+  /** Called when a drag starts (optional). */
+  ZtkGestureCallback begin_cb;
+
+  /** Called for each value written during the
+   * drag (optional). */
+  ZtkGestureCallback change_cb;
+
+  /** Called when the drag ends, after the final
+   * value is written (optional). */
+  ZtkGestureCallback end_cb;
+
+  void *            data;
+
+  /** Minimum seconds between writes, or 0 to
+   * write at most once per frame. */
+  double            min_interval;
+
+  /** Whether a drag is in progress. */
+  int               active;
+
+  /** Current value during the drag.
+   *
+   * Widgets show this instead of the stored value
+   * while the gesture is active, since the stored
+   * value may lag behind. */
+  float             value;
+
+  /** Last value written. */
+  float             written_value;
+
+  /** Time of the last write. */
+  double            last_write_time;
+
+  /** Whether \ref ZtkGesture.value has not been
+   * written yet. */
+  int               pending;
+} ZtkGesture;
+
+/**
+ * Sets the callbacks to notify (eg, the host) of
+ * the start, changes and end of drags.
+ */
+void
+ztk_gesture_set_callbacks (
+  ZtkGesture *       self,
+  ZtkGestureCallback begin_cb,
+  ZtkGestureCallback change_cb,
+  ZtkGestureCallback end_cb,
+  void *             data);
+
+/**
+ * Limits the writes during a drag to \p rate per
+ * second, or to one per frame if \p rate is 0.
+ */
+void
+ztk_gesture_set_rate (
+  ZtkGesture * self,
+  double       rate);
+
+/**
+ * Starts a gesture.
+ *
+ * @param value The current value.
+ */
+void
+ztk_gesture_begin (
+  ZtkGesture * self,
+  ZtkWidget *  widget,
+  float        value);
+
+/**
+ * Updates the value during a drag.
+ *
+ * @param now The current time in seconds.
+ *
+ * @return Whether \ref ZtkGesture.value should be
+ *   written now.
+ */
+int
+ztk_gesture_update (
+  ZtkGesture * self,
+  ZtkWidget *  widget,
+  float        value,
+  double       now);
+
+/**
+ * Returns whether there is an unwritten value that
+ * should be written before ending the gesture.
+ */
+int
+ztk_gesture_flush (
+  ZtkGesture * self,
+  ZtkWidget *  widget);
+
+/**
+ * Ends the gesture, if active.
+ */
+void
+ztk_gesture_end (
+  ZtkGesture * self,
+  ZtkWidget *  widget);
+
+#endif
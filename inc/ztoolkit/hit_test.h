@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Batch hit testing over a ZtkWidgetTable.
+ *
+ * The widgets are tested 4 or 8 at a time with
+ * SSE2, AVX2 or NEON where available, picked at
+ * runtime, with a scalar fallback.
+ */
+
+#ifndef __ZTOOLKIT_HIT_TEST_H__
+#define __ZTOOLKIT_HIT_TEST_H__
+
+#include <stdint.h>
+
+#include "ztoolkit/rect.h"
+#include "ztoolkit/widget_table.h"
+
+/**
+ * Implementation of the hit testing kernel.
+ */
+typedef enum ZtkHitTestImpl
+{
+  ZTK_HIT_TEST_SCALAR,
+  ZTK_HIT_TEST_SSE2,
+  ZTK_HIT_TEST_AVX2,
+  ZTK_HIT_TEST_NEON,
+} ZtkHitTestImpl;
+
+/**
+ * Returns the size of the masks filled by
+ * ztk_hit_test_batch() for the given table, in
+ * bytes.
+ */
+static inline int
+ztk_hit_test_get_mask_size (
+  const ZtkWidgetTable * table)
+{
+  return (table->num_widgets + 7) / 8;
+}
+
+/**
+ * Tests the visible widgets of the table against
+ * the given rectangle, including its edges.
+ *
+ * Points can be tested as rectangles of size 0.
+ *
+ * @param mask Set to a bit mask of the widgets hit,
+ *   the widget at index i being bit i % 8 of byte
+ *   i / 8. Must hold
+ *   ztk_hit_test_get_mask_size() bytes.
+ *
+ * @return The number of widgets hit.
+ */
+int
+ztk_hit_test_batch (
+  const ZtkWidgetTable * table,
+  const ZtkRect *        rect,
+  uint8_t *              mask);
+
+/**
+ * Returns the implementation used by
+ * ztk_hit_test_batch(), which is the fastest one
+ * supported by the CPU unless changed with
+ * ztk_hit_test_set_impl().
+ */
+ZtkHitTestImpl
+ztk_hit_test_get_impl (void);
+
+/**
+ * Returns whether the implementation is compiled in
+ * and supported by the CPU.
+ */
+int
+ztk_hit_test_is_impl_supported (
+  ZtkHitTestImpl impl);
+
+/**
+ * Sets the implementation used by
+ * ztk_hit_test_batch(), eg, to compare them.
+ *
+ * @return 0 if successful, -1 if the implementation
+ *   is not supported.
+ */
+int
+ztk_hit_test_set_impl (
+  ZtkHitTestImpl impl);
+
+/**
+ * Returns the name of the implementation.
+ */
+const char *
+ztk_hit_test_impl_to_string (
+  ZtkHitTestImpl impl);
+
+#endif
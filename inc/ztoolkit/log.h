@@ -35,6 +35,26 @@ typedef enum ZtkLogLevel
   ZTK_LOG_LEVEL_OFF,
 } ZtkLogLevel;
 
+/**
+ * Lowest level compiled in, as the number of the
+ * \ref ZtkLogLevel (eg, 2 for warnings).
+ *
+ * Calls below this level compile to nothing. Define
+ * it before including this header, or with
+ * -DZTK_LOG_MIN_LEVEL=n.
+ */
+#ifndef ZTK_LOG_MIN_LEVEL
+#define ZTK_LOG_MIN_LEVEL 0
+#endif
+
+/** Maximum length of a message, longer ones are
+ * truncated. */
+#define ZTK_LOG_MESSAGE_SIZE 512
+
+/** Default number of messages the asynchronous
+ * backend can hold. */
+#define ZTK_LOG_DEFAULT_NUM_MESSAGES 256
+
 /**
  * Sets the log level.
  */
@@ -42,6 +62,39 @@ void
 ztk_log_set_level (
   ZtkLogLevel level);
 
+/**
+ * Starts writing log messages from a background
+ * thread.
+ *
+ * Once started, ztk_log() only formats the message
+ * into a preallocated lock-free ring, so it can be
+ * called from any thread, including real-time
+ * ones, without blocking. Messages that don't fit
+ * in the ring are dropped and counted.
+ *
+ * Calls are counted, and the backend keeps running
+ * until ztk_log_stop_async() was called as many
+ * times, which must happen before the process
+ * exits or the library is unloaded, or pending
+ * messages are lost. Apps only start it when the
+ * ZTK_ASYNC_LOG environment variable is set.
+ *
+ * @param num_messages Number of messages the ring
+ *   can hold.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_log_start_async (
+  int num_messages);
+
+/**
+ * Writes the pending messages and stops the
+ * background thread if this was the last user.
+ */
+void
+ztk_log_stop_async (void);
+
 /**
  * Logs a message.
  *
@@ -54,22 +107,57 @@ ztk_log (
   const char * func,
   ZtkLogLevel  level,
   const char * format,
-  ...);
+  ...)
+#ifdef __GNUC__
+  __attribute__ ((format (printf, 3, 4)))
+#endif
+  ;
+
+/* calls below ZTK_LOG_MIN_LEVEL are kept in a dead
+ * branch so that their arguments are still
+ * checked */
+#define ZTK_LOG_DISABLED(level,...) \
+  do { \
+    if (0) \
+      ztk_log (__func__, level, __VA_ARGS__); \
+  } while (0)
 
+#if ZTK_LOG_MIN_LEVEL <= 0
 #define ztk_debug(...) \
   ztk_log (__func__, ZTK_LOG_LEVEL_DEBUG, \
     __VA_ARGS__)
+#else
+#define ztk_debug(...) \
+  ZTK_LOG_DISABLED (ZTK_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
 
+#if ZTK_LOG_MIN_LEVEL <= 1
 #define ztk_message(...) \
   ztk_log (__func__, ZTK_LOG_LEVEL_MESSAGE, \
     __VA_ARGS__)
+#else
+#define ztk_message(...) \
+  ZTK_LOG_DISABLED ( \
+    ZTK_LOG_LEVEL_MESSAGE, __VA_ARGS__)
+#endif
 
+#if ZTK_LOG_MIN_LEVEL <= 2
 #define ztk_warning(...) \
   ztk_log (__func__, ZTK_LOG_LEVEL_WARNING, \
     __VA_ARGS__)
+#else
+#define ztk_warning(...) \
+  ZTK_LOG_DISABLED ( \
+    ZTK_LOG_LEVEL_WARNING, __VA_ARGS__)
+#endif
 
+#if ZTK_LOG_MIN_LEVEL <= 3
 #define ztk_error(...) \
   ztk_log (__func__, ZTK_LOG_LEVEL_ERROR, \
     __VA_ARGS__)
+#else
+#define ztk_error(...) \
+  ZTK_LOG_DISABLED (ZTK_LOG_LEVEL_ERROR, __VA_ARGS__)
+#endif
 
 #endif
@@ -26,4 +26,7 @@
 #define math_doubles_equal(a,b) \
   (a > b ? a - b < DBL_EPSILON : b - a < DBL_EPSILON)
 
+#define math_floats_equal(a,b) \
+  (a > b ? a - b < FLT_EPSILON : b - a < FLT_EPSILON)
+
 #endif
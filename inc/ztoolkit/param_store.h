@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Parameter values shared between the UI and a
+ * real-time (DSP) thread.
+ */
+
+#ifndef __ZTOOLKIT_PARAM_STORE_H__
+#define __ZTOOLKIT_PARAM_STORE_H__
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+typedef struct ZtkWidget ZtkWidget;
+
+/**
+ * A parameter change.
+ */
+typedef struct ZtkParamEvent
+{
+  uint32_t          id;
+  float             value;
+} ZtkParamEvent;
+
+/**
+ * Lock-free single-producer/single-consumer queue
+ * of parameter changes.
+ */
+typedef struct ZtkParamRing
+{
+  ZtkParamEvent *   events;
+
+  /** Capacity - 1 (the capacity is a power of
+   * 2). */
+  uint32_t          mask;
+
+  /** Next slot to read (owned by the consumer). */
+  atomic_uint       read_idx;
+
+  /** Next slot to write (owned by the
+   * producer). */
+  atomic_uint       write_idx;
+} ZtkParamRing;
+
+/**
+ * Widgets bound to a parameter.
+ */
+typedef struct ZtkParam
+{
+  ZtkWidget **      widgets;
+  int               num_widgets;
+  int               widgets_size;
+} ZtkParam;
+
+/**
+ * Parameter store.
+ *
+ * Values flow from the DSP thread to the UI through
+ * one ring and from the UI to the DSP thread
+ * through another, so neither side locks or
+ * allocates. Hosts that deliver values on the UI
+ * thread instead (such as LV2 port_event) can
+ * write them directly with
+ * ztk_param_store_port_events().
+ *
+ * The UI thread calls ztk_param_store_drain() once
+ * per frame (see ztk_app_idle()), which compares
+ * the live values against the ones last rendered
+ * in one vectorized pass and queues a redraw of
+ * the widgets bound to changed parameters only.
+ */
+typedef struct ZtkParamStore
+{
+  /** Widget bindings, indexed by parameter ID. */
+  ZtkParam *        params;
+  int               num_params;
+
+  /** Live values, indexed by parameter ID. */
+  float *           values;
+
+  /** Values as of the last redraw. */
+  float *           rendered;
+
+  /** Size of \ref ZtkParamStore.values, rounded up
+   * to a multiple of the vector width. */
+  int               values_size;
+
+  /** DSP -> UI. */
+  ZtkParamRing      to_ui;
+
+  /** UI -> DSP. */
+  ZtkParamRing      to_dsp;
+} ZtkParamStore;
+
+/**
+ * Creates a new parameter store.
+ *
+ * @param num_params Number of parameters. IDs are
+ *   0 to num_params - 1.
+ * @param queue_size Minimum number of changes each
+ *   ring can hold before writes fail.
+ */
+ZtkParamStore *
+ztk_param_store_new (
+  int num_params,
+  int queue_size);
+
+/**
+ * Binds a widget to the given parameter so that it
+ * is redrawn when the parameter changes.
+ *
+ * To be called from the UI thread.
+ */
+void
+ztk_param_store_bind_widget (
+  ZtkParamStore * self,
+  uint32_t        id,
+  ZtkWidget *     widget);
+
+/**
+ * Unbinds a widget from all parameters.
+ */
+void
+ztk_param_store_unbind_widget (
+  ZtkParamStore * self,
+  ZtkWidget *     widget);
+
+/**
+ * Returns the current value of a parameter.
+ *
+ * To be called from the UI thread.
+ */
+float
+ztk_param_store_get (
+  ZtkParamStore * self,
+  uint32_t        id);
+
+/**
+ * Sets a parameter from the UI and sends it to the
+ * DSP thread.
+ *
+ * @return 0 if successful, non-zero if the queue
+ *   to the DSP thread is full (the UI value is still
+ *   updated).
+ */
+int
+ztk_param_store_set (
+  ZtkParamStore * self,
+  uint32_t        id,
+  float           value);
+
+/**
+ * Updates parameters from values delivered on the
+ * UI thread, such as LV2 port events.
+ *
+ * The values are not sent to the DSP thread, and
+ * the widgets are redrawn on the next drain.
+ *
+ * @param ids Parameter IDs, or NULL to write
+ *   \p num_values contiguous values starting at
+ *   ID 0.
+ */
+void
+ztk_param_store_port_events (
+  ZtkParamStore *  self,
+  const uint32_t * ids,
+  const float *    values,
+  int              num_values);
+
+/**
+ * Convenience wrapper over
+ * ztk_param_store_port_events() for a single
+ * value.
+ */
+void
+ztk_param_store_port_event (
+  ZtkParamStore * self,
+  uint32_t        id,
+  float           value);
+
+/**
+ * Applies the changes sent by the DSP thread and
+ * queues a redraw of the affected widgets.
+ *
+ * To be called from the UI thread once per frame.
+ *
+ * @return The number of parameters that changed.
+ */
+int
+ztk_param_store_drain (
+  ZtkParamStore * self);
+
+/**
+ * Sends a value to the UI.
+ *
+ * Real-time safe. To be called from the DSP
+ * thread only.
+ *
+ * @return 0 if successful, non-zero if the queue
+ *   is full.
+ */
+int
+ztk_param_store_write_from_dsp (
+  ZtkParamStore * self,
+  uint32_t        id,
+  float           value);
+
+/**
+ * Reads the next value sent by the UI.
+ *
+ * Real-time safe. To be called from the DSP
+ * thread only.
+ *
+ * @return 1 if a change was read into \p id and
+ *   \p value, 0 if there are none.
+ */
+int
+ztk_param_store_read_from_ui (
+  ZtkParamStore * self,
+  uint32_t *      id,
+  float *         value);
+
+void
+ztk_param_store_free (
+  ZtkParamStore * self);
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * USDT probes on the hot paths, compiled in with
+ * the enable_usdt option.
+ *
+ * Each probe is a single NOP until a tracer
+ * attaches to it, eg:
+ *
+ *     bpftrace -e 'usdt:./plugin.so:ztoolkit:frame_end
+ *       { @rects = hist(arg1); }'
+ *
+ * All probes are in the "ztoolkit" provider:
+ *
+ * - frame_begin(app, x, y, width, height): an
+ *   expose starts, with the exposed area.
+ * - frame_end(app, num_damage_rects)
+ * - event_dispatch(app, type): an event is passed
+ *   to the widgets.
+ * - widget_draw_begin(widget, type),
+ *   widget_draw_end(widget, type)
+ * - expose_merge(x, y, width, height): an expose
+ *   was merged into the pending one, with the
+ *   merged area.
+ * - blit_begin(view), blit_end(view): the backend
+ *   copies a drawn frame to the window.
+ *
+ * This header is internal and not installed.
+ */
+
+#ifndef __ZTOOLKIT_PROBES_H__
+#define __ZTOOLKIT_PROBES_H__
+
+#include "ztoolkit_config.h"
+
+#ifdef ENABLE_USDT
+
+#include <sys/sdt.h>
+
+#define ZTK_PROBE1(name,a) \
+  DTRACE_PROBE1 (ztoolkit, name, a)
+#define ZTK_PROBE2(name,a,b) \
+  DTRACE_PROBE2 (ztoolkit, name, a, b)
+#define ZTK_PROBE4(name,a,b,c,d) \
+  DTRACE_PROBE4 (ztoolkit, name, a, b, c, d)
+#define ZTK_PROBE5(name,a,b,c,d,e) \
+  DTRACE_PROBE5 (ztoolkit, name, a, b, c, d, e)
+
+#else
+
+#define ZTK_PROBE1(name,a) do { } while (0)
+#define ZTK_PROBE2(name,a,b) do { } while (0)
+#define ZTK_PROBE4(name,a,b,c,d) do { } while (0)
+#define ZTK_PROBE5(name,a,b,c,d,e) do { } while (0)
+
+#endif
+
+#endif
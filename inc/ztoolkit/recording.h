@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Recordings of the events received by an app,
+ * for reproducing performance problems.
+ *
+ * A recording is a binary file starting with
+ * \ref ZTK_RECORDING_MAGIC, the format version and
+ * the window size, followed by one record per
+ * event: the time in seconds since the recording
+ * started (double), the event type (1 byte) and
+ * the event struct of that type.
+ *
+ * Events are stored in the native byte order and
+ * struct layout, so recordings can only be
+ * replayed on the same architecture.
+ */
+
+#ifndef __ZTOOLKIT_RECORDING_H__
+#define __ZTOOLKIT_RECORDING_H__
+
+#include <stdio.h>
+
+#include "pugl.h"
+
+#define ZTK_RECORDING_MAGIC "ZTKREC"
+#define ZTK_RECORDING_VERSION 1
+
+/**
+ * Writes events to a recording.
+ */
+typedef struct ZtkRecorder
+{
+  FILE *            file;
+
+  /** Time the recording started, in the clock
+   * passed to ztk_recorder_write(). */
+  double            start_time;
+
+  /** Whether the start time is known yet. */
+  int               started;
+} ZtkRecorder;
+
+/**
+ * Reads events from a recording.
+ */
+typedef struct ZtkRecording
+{
+  FILE *            file;
+
+  /** Window size when recorded. */
+  int               width;
+  int               height;
+} ZtkRecording;
+
+/**
+ * A frame drawn during a replay.
+ */
+typedef struct ZtkReplayFrame
+{
+  /** Recorded time of the expose, in seconds. */
+  double            time;
+
+  /** Time spent dispatching the input events since
+   * the previous frame, in seconds. */
+  double            dispatch_time;
+
+  /** Time spent drawing, in seconds. */
+  double            draw_time;
+
+  /** Number of input events since the previous
+   * frame. */
+  int               num_events;
+
+  /** Number of rectangles redrawn, 0 if nothing
+   * changed. */
+  int               num_damage_rects;
+} ZtkReplayFrame;
+
+/**
+ * Results of a replay.
+ */
+typedef struct ZtkReplayReport
+{
+  ZtkReplayFrame *  frames;
+  int               num_frames;
+  int               frames_size;
+
+  /** Number of input events replayed. */
+  int               num_events;
+
+  /** Number of frames where something was
+   * redrawn. */
+  int               num_redraws;
+
+  /** Total time spent dispatching input events, in
+   * seconds. */
+  double            dispatch_time;
+
+  /** Total time spent drawing, in seconds. */
+  double            draw_time;
+} ZtkReplayReport;
+
+/**
+ * Creates a recording at the given path,
+ * overwriting any existing file.
+ *
+ * @return The recorder, or NULL if the file could
+ *   not be written.
+ */
+ZtkRecorder *
+ztk_recorder_new (
+  const char * path,
+  int          width,
+  int          height);
+
+/**
+ * Appends an event to the recording.
+ *
+ * @param time Current time in seconds, in any
+ *   monotonic clock.
+ */
+void
+ztk_recorder_write (
+  ZtkRecorder *     self,
+  double            time,
+  const PuglEvent * event);
+
+/**
+ * Closes the recording.
+ */
+void
+ztk_recorder_free (
+  ZtkRecorder * self);
+
+/**
+ * Opens a recording for reading.
+ *
+ * @return The recording, or NULL if the file could
+ *   not be read or is not a recording.
+ */
+ZtkRecording *
+ztk_recording_open (
+  const char * path);
+
+/**
+ * Reads the next event.
+ *
+ * @return 1 if an event was read into \p time and
+ *   \p event, 0 at the end of the recording.
+ */
+int
+ztk_recording_read_event (
+  ZtkRecording * self,
+  double *       time,
+  PuglEvent *    event);
+
+void
+ztk_recording_close (
+  ZtkRecording * self);
+
+/**
+ * Prints a summary of the report as JSON.
+ */
+void
+ztk_replay_report_print (
+  ZtkReplayReport * self,
+  FILE *            file);
+
+/**
+ * Frees the frames of the report.
+ */
+void
+ztk_replay_report_clear (
+  ZtkReplayReport * self);
+
+#endif
@@ -41,4 +41,13 @@ ztk_rect_copy (
   ZtkRect * dest,
   ZtkRect * src);
 
+/**
+ * Returns whether \p self fully contains
+ * \p other.
+ */
+int
+ztk_rect_contains (
+  ZtkRect * self,
+  ZtkRect * other);
+
 #endif
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Process-wide cache of read-only resources.
+ *
+ * Hosts often open several instances of the same
+ * plugin UI, and each one would otherwise parse
+ * the same SVGs and render the same sprites. The
+ * resources here are shared by all the apps in the
+ * process: the first instance creates them and the
+ * later ones get them almost for free.
+ *
+ * Resources are reference-counted and must be
+ * treated as immutable. Each one returned by the
+ * cache must be released with
+ * ztk_resource_cache_release(). Released resources
+ * stay cached for the next user until their total
+ * size exceeds
+ * ZTK_RESOURCE_CACHE_MAX_UNUSED_BYTES, or until
+ * ztk_resource_cache_trim() is called.
+ *
+ * All the functions are thread-safe.
+ */
+
+#ifndef __ZTOOLKIT_RESOURCE_CACHE_H__
+#define __ZTOOLKIT_RESOURCE_CACHE_H__
+
+#include "ztoolkit_config.h"
+
+#include <stddef.h>
+
+#include <cairo.h>
+
+#include "ztoolkit/rsvg.h"
+
+typedef struct ZtkAssetPack ZtkAssetPack;
+
+/** Bytes of unused resources kept cached. */
+#define ZTK_RESOURCE_CACHE_MAX_UNUSED_BYTES \
+  (16 * 1024 * 1024)
+
+/**
+ * Renders a cached surface.
+ *
+ * Called without the cache locked, so it may use
+ * the cache itself. Two threads may render the
+ * same surface at once, in which case only one
+ * result is kept.
+ *
+ * @param cr Context on a transparent surface of
+ *   \p width x \p height.
+ */
+typedef void (*ZtkResourceRenderCallback) (
+  cairo_t * cr,
+  int       width,
+  int       height,
+  void *    data);
+
+/**
+ * Returns the surface rendered for \p key at the
+ * given size, rendering it with \p render_cb if it
+ * is not cached.
+ *
+ * @param key Key of what is rendered, eg, a sprite
+ *   name. The size is part of the key.
+ * @return An ARGB32 image surface.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_surface (
+  const char *              key,
+  int                       width,
+  int                       height,
+  ZtkResourceRenderCallback render_cb,
+  void *                    data);
+
+/**
+ * Returns the font face for the given family,
+ * slant and weight.
+ */
+cairo_font_face_t *
+ztk_resource_cache_get_font_face (
+  const char *        family,
+  cairo_font_slant_t  slant,
+  cairo_font_weight_t weight);
+
+/**
+ * Returns the asset pack at \p abs_path, mapping
+ * it if it is not cached.
+ *
+ * Packs are keyed by path, size and modification
+ * time, so a pack that was rebuilt is mapped
+ * again.
+ *
+ * @return The pack, or NULL if it could not be
+ *   mapped.
+ */
+ZtkAssetPack *
+ztk_resource_cache_get_asset_pack (
+  const char * abs_path);
+
+/**
+ * Returns the PNG image in \p data, decoding it if
+ * it is not cached.
+ *
+ * PNGs are keyed by \p key and content.
+ *
+ * @param key Key of the PNG, eg, its path.
+ * @return An image surface, or NULL if \p data is
+ *   not a valid PNG.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_png_from_data (
+  const char * key,
+  const void * data,
+  size_t       size);
+
+/**
+ * Returns the PNG image at \p abs_path, decoding
+ * it if it is not cached.
+ *
+ * PNG files are keyed by path, size and
+ * modification time, so they are only read when
+ * they are not cached or changed.
+ *
+ * @return An image surface, or NULL if the file
+ *   could not be read or is not a valid PNG.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_png (
+  const char * abs_path);
+
+#ifdef HAVE_RSVG
+/**
+ * Returns the SVG at \p abs_path, parsing it if it
+ * is not cached.
+ *
+ * SVGs are keyed by path, size and modification
+ * time, so they are only read when they are not
+ * cached or changed on disk.
+ *
+ * @return The SVG, or NULL if it could not be
+ *   loaded.
+ */
+ZtkRsvgHandle *
+ztk_resource_cache_get_svg (
+  const char * abs_path);
+
+/**
+ * Returns \p svg rendered at the given size.
+ *
+ * @return The surface, or NULL if \p svg is not
+ *   from the cache.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_svg_surface (
+  ZtkRsvgHandle * svg,
+  int             width,
+  int             height);
+#endif
+
+/**
+ * Releases a resource returned by the cache.
+ *
+ * Does nothing if \p resource is NULL.
+ */
+void
+ztk_resource_cache_release (
+  const void * resource);
+
+/**
+ * Frees the resources that are not in use.
+ */
+void
+ztk_resource_cache_trim (void);
+
+/**
+ * Returns the number of cached resources, in use
+ * or not.
+ */
+int
+ztk_resource_cache_get_num_resources (void);
+
+#endif
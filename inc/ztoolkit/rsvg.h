@@ -24,19 +24,48 @@
 
 #ifdef HAVE_RSVG
 
+#include <stddef.h>
+
 #include <cairo.h>
 
+#include "ztoolkit/rect.h"
+
 typedef void ZtkRsvgHandle;
 
 /**
  * Loads an SVG from an absolute path.
  *
+ * The SVG is shared with the other apps in the
+ * process through the resource cache, and can be
+ * released with ztk_resource_cache_release().
+ *
  * @return An rsvg handle, or NULL if failed.
  */
 ZtkRsvgHandle *
 ztk_rsvg_load_svg (
   const char * abs_path);
 
+/**
+ * Parses an SVG from memory, without caching it.
+ *
+ * @param abs_path Path the SVG was read from,
+ *   used to resolve the files it references.
+ * @return An rsvg handle to be freed with
+ *   ztk_rsvg_free(), or NULL if failed.
+ */
+ZtkRsvgHandle *
+ztk_rsvg_load_svg_from_data (
+  const char * data,
+  size_t       size,
+  const char * abs_path);
+
+/**
+ * Frees an SVG from ztk_rsvg_load_svg_from_data().
+ */
+void
+ztk_rsvg_free (
+  ZtkRsvgHandle * handle);
+
 /**
  * Gets the width of the svg.
  */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Trigram index for incremental substring search
+ * over a fixed list of names.
+ */
+
+#ifndef __ZTOOLKIT_SEARCH_INDEX_H__
+#define __ZTOOLKIT_SEARCH_INDEX_H__
+
+#include <stdint.h>
+
+/**
+ * Max length of a query, including the null
+ * terminator.
+ */
+#define ZTK_SEARCH_QUERY_MAX 256
+
+/**
+ * Case-insensitive substring index.
+ *
+ * Each name is split into overlapping 3-byte
+ * sequences (trigrams). Queries of 3 characters or
+ * more only need to verify the names in the
+ * shortest posting list of their trigrams.
+ */
+typedef struct ZtkSearchIndex
+{
+  /** Lowercased copies of the names, for
+   * matching. */
+  char **           names;
+
+  /** Copies of the names as given, for display. */
+  char **           display_names;
+  int               num_names;
+
+  /** Sorted unique trigram keys. */
+  uint32_t *        trigrams;
+  int               num_trigrams;
+
+  /** Start of each trigram's posting list in
+   * \ref ZtkSearchIndex.postings (num_trigrams + 1
+   * entries). */
+  int *             offsets;
+
+  /** Name indices, ascending per trigram. */
+  int *             postings;
+} ZtkSearchIndex;
+
+/**
+ * Results of a query.
+ *
+ * The buffers are sized for every name in the
+ * index when created, so queries never allocate.
+ */
+typedef struct ZtkSearchResults
+{
+  /** Matching name indices, in display order. */
+  int *             indices;
+  int               num_indices;
+
+  /** The same matches in index order, used for
+   * incremental filtering. */
+  int *             matches;
+
+  /** Capacity of the buffers above. */
+  int               size;
+
+  /** Last (lowercased) query. */
+  char              query[ZTK_SEARCH_QUERY_MAX];
+
+  /** Whether \ref ZtkSearchResults.indices
+   * holds the results of \ref
+   * ZtkSearchResults.query. */
+  int               valid;
+} ZtkSearchResults;
+
+/**
+ * Builds an index over the given names.
+ *
+ * The names are copied.
+ */
+ZtkSearchIndex *
+ztk_search_index_new (
+  const char ** names,
+  int           num_names);
+
+/**
+ * Creates a result set sized for the given index.
+ */
+ZtkSearchResults *
+ztk_search_results_new (
+  ZtkSearchIndex * index);
+
+/**
+ * Runs a case-insensitive substring query.
+ *
+ * If the query contains the previous query of
+ * \p results (eg, when the user types another
+ * character), only the previous results are
+ * filtered. Names starting with the query are
+ * ordered first, otherwise results keep the order
+ * of the names in the index.
+ *
+ * An empty query matches everything.
+ */
+void
+ztk_search_index_query (
+  ZtkSearchIndex *   self,
+  const char *       query,
+  ZtkSearchResults * results);
+
+void
+ztk_search_results_free (
+  ZtkSearchResults * self);
+
+void
+ztk_search_index_free (
+  ZtkSearchIndex * self);
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Timing and rendering statistics of an app.
+ */
+
+#ifndef __ZTOOLKIT_STATS_H__
+#define __ZTOOLKIT_STATS_H__
+
+#include <stdio.h>
+
+typedef struct ZtkWidget ZtkWidget;
+
+/** Number of most expensive widgets reported. */
+#define ZTK_STATS_MAX_TOP_WIDGETS 8
+
+/**
+ * Timing of a frame phase, in seconds.
+ */
+typedef struct ZtkPhaseStats
+{
+  /** Time in the last frame. */
+  double            last;
+
+  /** Longest time in a single frame. */
+  double            max;
+
+  /** Time in all frames. */
+  double            total;
+} ZtkPhaseStats;
+
+/**
+ * Draw cost of a widget.
+ */
+typedef struct ZtkWidgetDrawStats
+{
+  ZtkWidget *       widget;
+
+  /** Total time spent in the draw callback, in
+   * seconds. */
+  double            draw_time;
+
+  /** Number of times drawn. */
+  unsigned long     num_draws;
+} ZtkWidgetDrawStats;
+
+/**
+ * App statistics, collected while enabled with
+ * ztk_app_set_stats_enabled().
+ */
+typedef struct ZtkAppStats
+{
+  /** Number of frames drawn. */
+  unsigned long     num_frames;
+
+  /** Handling input events since the previous
+   * frame. */
+  ZtkPhaseStats     dispatch;
+
+  /** Calling the widgets' update callbacks. */
+  ZtkPhaseStats     update;
+
+  /** Drawing the widgets. */
+  ZtkPhaseStats     draw;
+
+  /** Time spent in the backend during
+   * ztk_app_idle() outside of the event handlers,
+   * mostly blitting the frame to the window. */
+  ZtkPhaseStats     backend;
+
+  /** Widgets drawn and skipped in the last
+   * frame. */
+  int               last_widgets_drawn;
+  int               last_widgets_culled;
+
+  /** Widgets drawn and skipped in all frames. */
+  unsigned long     widgets_drawn;
+  unsigned long     widgets_culled;
+
+  /** Pixels in the damaged areas. */
+  double            pixels_damaged;
+
+  /** Pixels painted by widgets in the damaged
+   * areas, counting overlapping widgets once
+   * each. */
+  double            pixels_painted;
+
+  /** Painted / damaged pixels. 1.0 means each
+   * damaged pixel was painted once. Filled in by
+   * ztk_app_get_stats(). */
+  double            overdraw;
+
+  /** Widgets with the highest total draw time,
+   * most expensive first. Filled in by
+   * ztk_app_get_stats(). */
+  ZtkWidgetDrawStats top_widgets[
+    ZTK_STATS_MAX_TOP_WIDGETS];
+  int               num_top_widgets;
+} ZtkAppStats;
+
+/**
+ * Returns the time in seconds in a monotonic clock,
+ * used for statistics and traces.
+ *
+ * Unlike puglGetTime(), this cannot be set
+ * manually on the headless platform.
+ */
+double
+ztk_stats_get_time (void);
+
+/**
+ * Adds a sample to the phase.
+ */
+void
+ztk_phase_stats_add (
+  ZtkPhaseStats * self,
+  double          time);
+
+/**
+ * Prints the statistics as JSON.
+ */
+void
+ztk_app_stats_print (
+  ZtkAppStats * self,
+  FILE *        file);
+
+#endif
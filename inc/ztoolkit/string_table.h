@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Interned strings.
+ *
+ * Equal strings interned in the same table share
+ * one reference-counted copy, so widgets with the
+ * same text (eg, "Off", "On" or note names) store
+ * it once, and interned strings can be compared
+ * and used as cache keys by pointer.
+ *
+ * Interned strings are returned as plain
+ * `const char *` and must only be released with
+ * ztk_string_unref().
+ *
+ * Tables are not thread-safe and are meant to be
+ * used from the UI thread.
+ */
+
+#ifndef __ZTOOLKIT_STRING_TABLE_H__
+#define __ZTOOLKIT_STRING_TABLE_H__
+
+#include <stddef.h>
+
+typedef struct ZtkInternedString ZtkInternedString;
+
+/**
+ * Hash set of interned strings.
+ */
+typedef struct ZtkStringTable
+{
+  /** Buckets of strings chained by hash. */
+  ZtkInternedString ** buckets;
+  int               num_buckets;
+
+  /** Number of distinct strings. */
+  int               num_strings;
+} ZtkStringTable;
+
+/**
+ * Creates a new string table.
+ */
+ZtkStringTable *
+ztk_string_table_new (void);
+
+/**
+ * Returns a reference to the interned copy of
+ * \p str, adding it to the table if needed.
+ *
+ * @param self The table, or NULL to return a copy
+ *   not shared with other strings.
+ * @return The interned string, or NULL if \p str
+ *   is NULL.
+ */
+const char *
+ztk_string_table_intern (
+  ZtkStringTable * self,
+  const char *     str);
+
+/**
+ * Frees the table.
+ *
+ * Strings still referenced stay valid and are
+ * freed with their last reference.
+ */
+void
+ztk_string_table_free (
+  ZtkStringTable * self);
+
+/**
+ * Adds a reference to an interned string and
+ * returns it.
+ */
+const char *
+ztk_string_ref (
+  const char * str);
+
+/**
+ * Removes a reference from an interned string,
+ * freeing it when none are left.
+ *
+ * Does nothing if \p str is NULL.
+ */
+void
+ztk_string_unref (
+  const char * str);
+
+/**
+ * Returns the length of an interned string.
+ */
+size_t
+ztk_string_get_length (
+  const char * str);
+
+#endif
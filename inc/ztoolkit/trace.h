@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Traces in the Chrome trace event format, for
+ * viewing in chrome://tracing or Perfetto.
+ *
+ * Tracing is compiled in with the enable_trace
+ * option and started with ztk_trace_start() or by
+ * setting the ZTK_TRACE environment variable to a
+ * path before creating an app. Without the option,
+ * the ZTK_TRACE_* macros expand to nothing.
+ *
+ * Events are stored in a ring allocated when
+ * tracing starts and written to the file from
+ * ztk_app_idle() after the frame, once the ring is
+ * half full. If events come faster than that, the
+ * oldest ones are dropped.
+ *
+ * The trace is process-wide and must only be used
+ * from the UI thread.
+ */
+
+#ifndef __ZTOOLKIT_TRACE_H__
+#define __ZTOOLKIT_TRACE_H__
+
+#include "ztoolkit_config.h"
+
+#include "ztoolkit/stats.h"
+
+/** Default number of events buffered. */
+#define ZTK_TRACE_DEFAULT_NUM_EVENTS 65536
+
+/**
+ * Whether a trace is being recorded.
+ *
+ * Checked by the ZTK_TRACE_* macros before doing
+ * anything else.
+ */
+extern int ztk_trace_active;
+
+/**
+ * Starts writing a trace to the given file.
+ *
+ * Calls are counted, and the trace is recorded
+ * until ztk_trace_stop() was called as many times.
+ * If a trace is already being recorded, it is
+ * kept and \p path is ignored, so that apps
+ * started from ZTK_TRACE share a single trace.
+ *
+ * @param num_events Number of events to buffer.
+ *
+ * @return 0 if successful, -1 if the file could not
+ *   be written or tracing is not compiled in.
+ */
+int
+ztk_trace_start (
+  const char * path,
+  int          num_events);
+
+/**
+ * Writes the buffered events and closes the trace
+ * if this was the last user.
+ */
+void
+ztk_trace_stop (void);
+
+/**
+ * Writes the buffered events to the file.
+ */
+void
+ztk_trace_flush (void);
+
+/**
+ * Writes the buffered events to the file if the
+ * ring is at least half full.
+ */
+void
+ztk_trace_flush_if_needed (void);
+
+/**
+ * Adds a span that started at \p start and ends
+ * now.
+ *
+ * @param name A static string.
+ * @param arg Integer argument shown with the span,
+ *   eg, the widget type, or -1 for none.
+ */
+void
+ztk_trace_add_span (
+  const char * name,
+  double       start,
+  int          arg);
+
+/**
+ * Adds a value to a counter track.
+ *
+ * @param name A static string.
+ */
+void
+ztk_trace_add_counter (
+  const char * name,
+  double       value);
+
+#ifdef ENABLE_TRACE
+
+/**
+ * Starts a span named \p id, which must be a valid
+ * identifier.
+ *
+ * Must be paired with ZTK_TRACE_END() in the same
+ * scope.
+ */
+#define ZTK_TRACE_BEGIN(id) \
+  double ztk_trace_start_##id = \
+    ztk_trace_active ? ztk_stats_get_time () : 0.0
+
+/**
+ * Ends the span named \p id.
+ *
+ * @param arg Integer argument, or -1 for none.
+ */
+#define ZTK_TRACE_END(id,arg) \
+  do { \
+    if (ztk_trace_active) \
+      ztk_trace_add_span ( \
+        #id, ztk_trace_start_##id, arg); \
+  } while (0)
+
+/**
+ * Adds a value to a counter track. \p value is
+ * only evaluated while tracing.
+ */
+#define ZTK_TRACE_COUNTER(name,value) \
+  do { \
+    if (ztk_trace_active) \
+      ztk_trace_add_counter (name, value); \
+  } while (0)
+
+/**
+ * Writes the buffered events if needed. To be
+ * called outside of frames.
+ */
+#define ZTK_TRACE_FLUSH() \
+  do { \
+    if (ztk_trace_active) \
+      ztk_trace_flush_if_needed (); \
+  } while (0)
+
+#else
+
+#define ZTK_TRACE_BEGIN(id)
+#define ZTK_TRACE_END(id,arg) do { } while (0)
+#define ZTK_TRACE_COUNTER(name,value) do { } while (0)
+#define ZTK_TRACE_FLUSH() do { } while (0)
+
+#endif
+
+#endif
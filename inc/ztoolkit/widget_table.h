@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Hot data of the widgets of an app, mirrored in
+ * parallel arrays.
+ *
+ * Hit testing and culling only need the
+ * rectangles, visibility, state and z of the
+ * widgets, so they scan these contiguous arrays
+ * instead of following a pointer to each
+ * ZtkWidget.
+ */
+
+#ifndef __ZTOOLKIT_WIDGET_TABLE_H__
+#define __ZTOOLKIT_WIDGET_TABLE_H__
+
+#include <stdint.h>
+
+#include "ztoolkit/rect.h"
+
+typedef struct ZtkWidget ZtkWidget;
+
+/** Flag set for visible widgets. The lower bits
+ * are the ZtkWidgetState. */
+#define ZTK_WIDGET_TABLE_VISIBLE (1u << 16)
+
+/** Flag set for combo boxes. */
+#define ZTK_WIDGET_TABLE_COMBO_BOX (1u << 17)
+
+/** Mask of the ZtkWidgetState bits. */
+#define ZTK_WIDGET_TABLE_STATE_MASK 0xffffu
+
+/** Number of scratch masks for
+ * ztk_hit_test_batch(). */
+#define ZTK_WIDGET_TABLE_NUM_MASKS 3
+
+/**
+ * Widget data in parallel arrays, in the same
+ * order as the widgets of the app.
+ *
+ * The arrays are 32-byte aligned and padded to a
+ * multiple of 8 entries, with the padding zeroed
+ * (ie, not visible).
+ */
+typedef struct ZtkWidgetTable
+{
+  /** Left, top, right and bottom edges. */
+  float *           x1;
+  float *           y1;
+  float *           x2;
+  float *           y2;
+
+  /** ZTK_WIDGET_TABLE_* flags and state. */
+  uint32_t *        flags;
+
+  int *             z;
+
+  /** Scratch hit masks, big enough for
+   * ztk_hit_test_batch(), so that testing does not
+   * allocate. */
+  uint8_t *         masks[ZTK_WIDGET_TABLE_NUM_MASKS];
+
+  int               num_widgets;
+  int               size;
+} ZtkWidgetTable;
+
+/**
+ * Makes room for at least \p num_widgets widgets.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_widget_table_reserve (
+  ZtkWidgetTable * self,
+  int              num_widgets);
+
+/**
+ * Copies the hot data of the widget to the given
+ * index.
+ */
+void
+ztk_widget_table_set (
+  ZtkWidgetTable * self,
+  int              idx,
+  ZtkWidget *      widget);
+
+/**
+ * Copies the hot data of all the given widgets
+ * and stores their indices in them.
+ */
+void
+ztk_widget_table_rebuild (
+  ZtkWidgetTable * self,
+  ZtkWidget **     widgets,
+  int              num_widgets);
+
+/**
+ * Returns whether the widget at \p idx is visible
+ * and hit by the given coordinates.
+ */
+static inline int
+ztk_widget_table_is_hit (
+  const ZtkWidgetTable * self,
+  int                    idx,
+  double                 x,
+  double                 y)
+{
+  float fx = (float) x;
+  float fy = (float) y;
+  return
+    (self->flags[idx] & ZTK_WIDGET_TABLE_VISIBLE) &&
+    fx >= self->x1[idx] && fx <= self->x2[idx] &&
+    fy >= self->y1[idx] && fy <= self->y2[idx];
+}
+
+/**
+ * Returns whether the widget at \p idx is visible
+ * and overlaps the given rectangle, including its
+ * edges.
+ */
+static inline int
+ztk_widget_table_is_hit_by_rect (
+  const ZtkWidgetTable * self,
+  int                    idx,
+  const ZtkRect *        rect)
+{
+  return
+    (self->flags[idx] & ZTK_WIDGET_TABLE_VISIBLE) &&
+    self->x1[idx] <= (float) (rect->x + rect->width) &&
+    self->x2[idx] >= (float) rect->x &&
+    self->y1[idx] <= (float) (rect->y + rect->height) &&
+    self->y2[idx] >= (float) rect->y;
+}
+
+/**
+ * Returns the index of the top-most visible widget
+ * hit by the given coordinates, or -1.
+ */
+int
+ztk_widget_table_find_top_hit (
+  const ZtkWidgetTable * self,
+  double                 x,
+  double                 y);
+
+/**
+ * Frees the arrays.
+ */
+void
+ztk_widget_table_free (
+  ZtkWidgetTable * self);
+
+#endif
@@ -24,10 +24,25 @@
 #include "pugl.h"
 
 #include "math.h"
+#include "arena.h"
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "compiled_svg.h"
+#include "debug_overlay.h"
+#include "gesture.h"
+#include "hit_test.h"
 #include "log.h"
+#include "param_store.h"
+#include "recording.h"
 #include "rect.h"
+#include "resource_cache.h"
 #include "rsvg.h"
+#include "search_index.h"
+#include "stats.h"
+#include "string_table.h"
+#include "trace.h"
 #include "types.h"
+#include "widget_table.h"
 #include "ztk_widget.h"
 #include "ztk_app.h"
 #include "ztk_button.h"
@@ -39,6 +54,8 @@
 #include "ztk_knob.h"
 #include "ztk_knob_with_label.h"
 #include "ztk_label.h"
+#include "ztk_preset_browser.h"
+#include "ztk_style.h"
 
 #ifndef MAX
 # define MAX(x,y) (x > y ? x : y)
@@ -20,6 +20,10 @@
 #ifndef __Z_TOOLKIT_ZTK_APP_H__
 #define __Z_TOOLKIT_ZTK_APP_H__
 
+#include "ztoolkit/arena.h"
+#include "ztoolkit/stats.h"
+#include "ztoolkit/string_table.h"
+#include "ztoolkit/widget_table.h"
 #include "ztoolkit/ztk_theme.h"
 
 #include <cairo.h>
@@ -29,6 +33,12 @@ typedef struct PuglViewImpl PuglView;
 
 typedef struct ZtkWidget ZtkWidget;
 typedef struct ZtkRect ZtkRect;
+typedef struct ZtkParamStore ZtkParamStore;
+typedef struct ZtkRecorder ZtkRecorder;
+typedef struct ZtkReplayReport ZtkReplayReport;
+typedef struct ZtkDebugOverlay ZtkDebugOverlay;
+typedef struct ZtkAssetLoader ZtkAssetLoader;
+typedef struct ZtkAssetPack ZtkAssetPack;
 
 typedef struct ZtkApp
 {
@@ -44,6 +54,10 @@ typedef struct ZtkApp
   int              num_widgets;
   int              widgets_size;
 
+  /** Hot data of \ref ZtkApp.widgets, used for
+   * hit testing and culling. */
+  ZtkWidgetTable   widget_table;
+
   /** Whether a mouse button is pressed */
   int              pressing;
 
@@ -62,6 +76,93 @@ typedef struct ZtkApp
   //void *           parent;
 
   ZtkTheme         theme;
+
+  /** Table the widgets intern their text in. */
+  ZtkStringTable * strings;
+
+  /** Parameter store drained on each idle call, if
+   * any. */
+  ZtkParamStore *  param_store;
+
+  /** Set to 1 to redraw all widgets on the next
+   * draw, regardless of their fingerprints (eg,
+   * after a resize). */
+  int              redraw_all;
+
+  /** Whether the backend draws each expose on a
+   * new surface instead of over the last frame,
+   * in which case everything in the exposed area
+   * is redrawn. This is the case on macOS. */
+  int              backend_discards_frame;
+
+  /** Rectangles of the widgets that changed, used
+   * during drawing. */
+  ZtkRect *        damage_rects;
+  int              damage_rects_size;
+
+  /** Number of rectangles redrawn in the last
+   * draw, 0 if nothing was redrawn. */
+  int              num_damage_rects;
+
+  /** Number of widget hit tests done while
+   * dispatching events, for profiling. */
+  unsigned long    num_hit_tests;
+
+  /** Recorder of the received events, if
+   * recording. */
+  ZtkRecorder *    recorder;
+
+  /** Whether a recording is being replayed. */
+  int              replaying;
+
+  /** Recorded time of the event being replayed. */
+  double           replay_time;
+
+  /** Whether statistics are collected. */
+  int              stats_enabled;
+
+  /** Statistics collected so far. */
+  ZtkAppStats      stats;
+
+  /** Time spent dispatching input events since the
+   * last frame, while collecting statistics. */
+  double           pending_dispatch_time;
+
+  /** Time spent in the event handlers during the
+   * current ztk_app_idle() call. */
+  double           idle_handler_time;
+
+  /** Whether a frame was drawn during the current
+   * ztk_app_idle() call. */
+  int              idle_drew_frame;
+
+  /** Debug overlay, if enabled. */
+  ZtkDebugOverlay * debug_overlay;
+
+  /** Whether the app started the trace from the
+   * ZTK_TRACE environment variable, in which case
+   * it stops it when freed. */
+  int              started_trace;
+
+  /** Whether the app started the asynchronous log
+   * from the ZTK_ASYNC_LOG environment variable, in
+   * which case it stops it when freed. */
+  int              started_async_log;
+
+  /** Arena of the widgets created while
+   * ztk_app_use_arena() is set, if any. */
+  ZtkArena *       arena;
+
+  /** Loads of the widgets' assets, run on the
+   * process-wide worker threads and dispatched
+   * from ztk_app_idle(). Created on first use by
+   * ztk_app_get_asset_loader(). */
+  ZtkAssetLoader * asset_loader;
+
+  /** Asset pack loaded with
+   * ztk_app_load_asset_pack(), from the resource
+   * cache. */
+  ZtkAssetPack *   asset_pack;
 } ZtkApp;
 
 /**
@@ -93,6 +194,18 @@ ztk_app_remove_widget (
   ZtkApp *    self,
   ZtkWidget * widget);
 
+/**
+ * Updates the hot data of the widget in
+ * \ref ZtkApp.widget_table after its rectangle or
+ * visibility changed.
+ *
+ * Called by the widget setters.
+ */
+void
+ztk_app_update_widget (
+  ZtkApp *    self,
+  ZtkWidget * widget);
+
 int
 ztk_app_contains_widget (
   ZtkApp * self,
@@ -100,6 +213,11 @@ ztk_app_contains_widget (
 
 /**
  * Draws each hit widget.
+ *
+ * Widgets whose fingerprint did not change since
+ * they were last drawn are skipped, unless they
+ * overlap a widget that changed or the backend
+ * does not keep the last frame.
  */
 void
 ztk_app_draw (
@@ -107,6 +225,195 @@ ztk_app_draw (
   cairo_t * cr,
   ZtkRect * rect);
 
+/**
+ * Returns the current time in seconds.
+ *
+ * While replaying a recording, this is the
+ * recorded time of the event being replayed, so
+ * that time-dependent behavior such as gesture
+ * coalescing is reproduced exactly.
+ */
+double
+ztk_app_get_time (
+  ZtkApp * self);
+
+/**
+ * Starts recording the events received by the app
+ * to the given file, replacing any recording in
+ * progress.
+ *
+ * Recording can also be enabled by setting the
+ * ZTK_RECORD_EVENTS environment variable to a
+ * path before creating the app.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_app_start_recording (
+  ZtkApp *     self,
+  const char * path);
+
+/**
+ * Stops recording events.
+ */
+void
+ztk_app_stop_recording (
+  ZtkApp * self);
+
+/**
+ * Replays a recording into the app.
+ *
+ * Input events are passed to the app directly and
+ * each recorded expose draws a frame, so the app
+ * should be in the state it was in when recording
+ * started. This is meant to be used with the
+ * headless platform.
+ *
+ * @param max_speed If non-zero, events are
+ *   replayed as fast as possible, otherwise at the
+ *   recorded times.
+ * @param report Report to fill in. Must be cleared
+ *   with ztk_replay_report_clear() afterwards.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_app_replay (
+  ZtkApp *          self,
+  const char *      path,
+  int               max_speed,
+  ZtkReplayReport * report);
+
+/**
+ * Enables or disables collecting statistics.
+ *
+ * Collecting statistics is off by default and
+ * costs a few clock reads per frame and per drawn
+ * widget while on.
+ */
+void
+ztk_app_set_stats_enabled (
+  ZtkApp * self,
+  int      enabled);
+
+/**
+ * Copies the statistics collected so far into
+ * \p stats.
+ */
+void
+ztk_app_get_stats (
+  ZtkApp *      self,
+  ZtkAppStats * stats);
+
+/**
+ * Clears the statistics collected so far,
+ * including the draw times of the widgets.
+ */
+void
+ztk_app_reset_stats (
+  ZtkApp * self);
+
+/**
+ * Enables or disables the debug overlay.
+ *
+ * The overlay shows the frame rate and a graph of
+ * the frame times, and flashes each area repainted
+ * in a color per widget that caused it, or in red
+ * for full repaints. While enabled, the app redraws
+ * on every ztk_app_idle() call.
+ *
+ * The overlay can also be enabled by setting the
+ * ZTK_DEBUG_OVERLAY environment variable before
+ * creating the app.
+ */
+void
+ztk_app_set_debug_overlay_enabled (
+  ZtkApp * self,
+  int      enabled);
+
+/**
+ * Sets the parameter store to drain on each
+ * ztk_app_idle() call.
+ *
+ * The store is not owned by the app and must
+ * outlive it.
+ */
+void
+ztk_app_set_param_store (
+  ZtkApp *        self,
+  ZtkParamStore * store);
+
+/**
+ * Sets whether widgets created on the calling
+ * thread are allocated from the app's arena.
+ *
+ * This is the fast path for UIs that get opened
+ * and closed many times, like plugin UIs: the
+ * widgets are packed next to each other instead of
+ * scattered across the heap, and ztk_app_free()
+ * releases them all at once along with the arena.
+ *
+ * Widgets allocated from the arena must either be
+ * added to the app or not outlive it, and must not
+ * be freed separately.
+ */
+void
+ztk_app_use_arena (
+  ZtkApp * self,
+  int      use);
+
+/**
+ * Returns the app's asset loader, creating it if
+ * needed.
+ *
+ * The loader only keeps the app's loads, which run
+ * on the worker threads shared by all the apps.
+ *
+ * @return The loader, or NULL if the threads could
+ *   not be started.
+ */
+ZtkAssetLoader *
+ztk_app_get_asset_loader (
+  ZtkApp * self);
+
+/**
+ * Loads the asset pack at \p abs_path, replacing
+ * the previous one.
+ *
+ * The pack is mapped once per process and shared
+ * with the other apps that load it.
+ *
+ * @return Non-zero if failed.
+ */
+int
+ztk_app_load_asset_pack (
+  ZtkApp *     self,
+  const char * abs_path);
+
+/**
+ * Returns the sprite \p name from the app's asset
+ * pack for the given scale factor.
+ *
+ * See ztk_asset_pack_get_sprite().
+ *
+ * @return The surface, valid until the pack is
+ *   replaced or the app is freed, or NULL if there
+ *   is no pack or no such sprite.
+ */
+cairo_surface_t *
+ztk_app_get_sprite (
+  ZtkApp *     self,
+  const char * name,
+  double       scale);
+
+/**
+ * Processes pending events and redraws.
+ *
+ * To be called once per frame. Parameter changes
+ * from the DSP thread and assets loaded in the
+ * background are applied first, so the widgets
+ * showing them get redrawn in the same frame.
+ */
 void
 ztk_app_idle (
   ZtkApp * self);
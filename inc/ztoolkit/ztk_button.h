@@ -20,6 +20,7 @@
 #ifndef __Z_TOOLKIT_ZTK_BUTTON_H__
 #define __Z_TOOLKIT_ZTK_BUTTON_H__
 
+#include "compiled_svg.h"
 #include "rsvg.h"
 #include "ztk_color.h"
 #include "ztk_widget.h"
@@ -38,6 +39,10 @@ typedef enum ZtkButtonType
    * hover, press). */
   ZTK_BTN_SVG,
 
+  /** Button has 3 SVGs compiled at build time, one
+   * for each state. */
+  ZTK_BTN_COMPILED_SVG,
+
   /** Button will be drawn using user callback. */
   ZTK_BTN_CUSTOM,
 } ZtkButtonType;
@@ -91,21 +96,40 @@ typedef struct ZtkButton
    * This will also be used for when toggled.
    */
   ZtkRsvgHandle *   clicked_svg;
+
+  /** The SVGs rendered at
+   * \ref ZtkButton.svg_surface_width x
+   * \ref ZtkButton.svg_surface_height, in the order
+   * normal, hover, clicked, from the resource
+   * cache. */
+  cairo_surface_t * svg_surfaces[3];
+  int               svg_surface_width;
+  int               svg_surface_height;
+
+  /** Paths of the SVGs if they are loaded in the
+   * background, in the same order as
+   * \ref ZtkButton.svg_surfaces. */
+  char *            svg_paths[3];
+
+  /** Incremented on each request for the SVGs, so
+   * that older loads are ignored. */
+  unsigned int      svg_load_id;
 #endif
 
+  /** SVGs compiled at build time, in the order
+   * normal, hover, clicked. */
+  const ZtkCompiledSvg * compiled_svgs[3];
+
   /** Padding to add when using SVGs to control
    * their size. */
   int               hpadding;
   int               vpadding;
 
-  /** If this is 1, background colors will be drawn,
+  /** If set, the background will be drawn with
+   * its BG, BG_HOVER and BG_CLICK colors,
    * regardless if there is a \ref
    * ZtkButton.bg_draw_cb. */
-  int                     has_bg_colors;
-
-  ZtkColor          normal_color;
-  ZtkColor          hovered_color;
-  ZtkColor          clicked_color;
+  ZtkStyle *        bg_style;
 
   /** Set to 1 while pressed, and the activate
    * callback will be fired when released. */
@@ -157,8 +181,38 @@ ztk_button_make_svged (
   ZtkRsvgHandle * svg_normal,
   ZtkRsvgHandle * svg_hover,
   ZtkRsvgHandle * svg_clicked);
+
+/**
+ * Makes a button with the SVGs at the given
+ * paths, loaded and rendered in the background by
+ * the app's asset loader.
+ *
+ * Nothing is drawn in place of the SVGs until
+ * they are ready.
+ */
+void
+ztk_button_make_svged_from_files (
+  ZtkButton *  self,
+  int          hpadding,
+  int          vpadding,
+  const char * normal_path,
+  const char * hover_path,
+  const char * clicked_path);
 #endif
 
+/**
+ * Makes a button with SVGs compiled at build time
+ * by svg2cairo.py.
+ */
+void
+ztk_button_make_compiled_svged (
+  ZtkButton *            self,
+  int                    hpadding,
+  int                    vpadding,
+  const ZtkCompiledSvg * svg_normal,
+  const ZtkCompiledSvg * svg_hover,
+  const ZtkCompiledSvg * svg_clicked);
+
 /**
  * Makes a customly drawn button.
  */
@@ -167,6 +221,13 @@ ztk_button_make_custom (
   ZtkButton *           self,
   ZtkWidgetDrawCallback draw_cb);
 
+/**
+ * Sets the background colors, creating a style
+ * for this button only.
+ *
+ * Prefer ztk_button_set_background_style() with a
+ * style shared by similar buttons.
+ */
 void
 ztk_button_set_background_colors (
   ZtkButton * self,
@@ -174,6 +235,15 @@ ztk_button_set_background_colors (
   ZtkColor *  hovered,
   ZtkColor *  clicked);
 
+/**
+ * Sets the style to draw the background with, or
+ * NULL to not draw background colors.
+ */
+void
+ztk_button_set_background_style (
+  ZtkButton * self,
+  ZtkStyle *  style);
+
 /**
  * Add callback for drawing the background.
  */
@@ -20,6 +20,8 @@
 #ifndef __Z_TOOLKIT_ZTK_COLOR_H__
 #define __Z_TOOLKIT_ZTK_COLOR_H__
 
+#include <stdint.h>
+
 #include <cairo.h>
 
 /**
@@ -39,7 +41,16 @@ ztk_color_set_for_cairo (
   cairo_t *  cr);
 
 /**
- * Parses a ZtkColor from the given hex string.
+ * Returns the color packed as 8-bit RGBA, the
+ * precision it is drawn at.
+ */
+uint32_t
+ztk_color_to_rgba32 (
+  const ZtkColor * color);
+
+/**
+ * Parses a ZtkColor from the given hex string,
+ * either "#RRGGBB" or "#RRGGBBAA".
  */
 void
 ztk_color_parse_hex (
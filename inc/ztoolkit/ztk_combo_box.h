@@ -22,6 +22,9 @@
 
 #include "ztk.h"
 
+/** Maximum number of elements in a combo box. */
+#define ZTK_COMBO_BOX_MAX_ELEMENTS 120
+
 /**
  * A combo box element.
  */
@@ -30,14 +33,20 @@ typedef struct ZtkComboBoxElement
   /** 1 if this is a separator. */
   int                       is_separator;
 
-  /** Label to display. */
-  char                      label[420];
+  /** Label to display, interned in the app's
+   * string table. */
+  const char *              label;
 
   /** Function to call when activated. */
   ZtkWidgetActivateCallback activate_cb;
 
   /** Data specific to this element. */
   void *                    activate_cb_data;
+
+  /** Extents of the label, measured at
+   * \ref ZtkComboBoxElement.extents_font_size. */
+  cairo_text_extents_t      extents;
+  double                    extents_font_size;
 } ZtkComboBoxElement;
 
 /**
@@ -51,36 +60,20 @@ typedef struct ZtkComboBox
   /** Parent widget to spawn on. */
   ZtkWidget *       parent;
 
-  ZtkComboBoxElement elements[120];
+  ZtkComboBoxElement elements[ZTK_COMBO_BOX_MAX_ELEMENTS];
   int               num_elements;
 
-  char              font_name[180];
+  /** Font family, not owned. */
+  const char *      font_name;
 
   double            font_size;
 
-  /** Text color. */
-  ZtkColor          text_normal_color;
-
-  /** Text when hovered. */
-  ZtkColor          text_hover_color;
-
-  /** Text when hovered. */
-  ZtkColor          text_click_color;
-
-  /** Color of the frame around the combo box. */
-  ZtkColor          frame_color;
-
-  /** Background color of the whole combobox. */
-  ZtkColor          bg_color;
-
-  /** Color of separator elements. */
-  ZtkColor          separator_color;
-
-  /** Background color of the hovered element. */
-  ZtkColor          hover_color;
-
-  /** Background color of the clicked element. */
-  ZtkColor          click_color;
+  /** Style overriding the theme's, if any.
+   *
+   * The frame, separators and text are drawn with
+   * the FRAME, SEPARATOR and FG colors, and the
+   * background and elements with the BG colors. */
+  ZtkStyle *        style;
 
   /** 1 if it the combobox should spawn upwards
    * instead of downards. */
@@ -123,6 +116,15 @@ void
 ztk_combo_box_add_separator (
   ZtkComboBox * self);
 
+/**
+ * Sets a style to use instead of the theme's, or
+ * NULL to use the theme's again.
+ */
+void
+ztk_combo_box_set_style (
+  ZtkComboBox * self,
+  ZtkStyle *    style);
+
 void
 ztk_combo_box_clear (
   ZtkComboBox * self);
@@ -20,6 +20,8 @@
 #ifndef __Z_TOOLKIT_ZTK_CONTROL_H__
 #define __Z_TOOLKIT_ZTK_CONTROL_H__
 
+#include "gesture.h"
+#include "param_store.h"
 #include "ztk_widget.h"
 
 typedef struct ZtkControl ZtkControl;
@@ -40,6 +42,20 @@ typedef enum ZtkControlDragMode
   ZTK_CTRL_DRAG_BOTH,
 } ZtkControlDragMode;
 
+/**
+ * How the frames of a filmstrip are laid out.
+ */
+typedef enum ZtkControlFilmstripOrientation
+{
+  /** Frames on top of each other, the first one
+   * at the top. */
+  ZTK_CTRL_FILMSTRIP_VERTICAL,
+
+  /** Frames next to each other, the first one on
+   * the left. */
+  ZTK_CTRL_FILMSTRIP_HORIZONTAL,
+} ZtkControlFilmstripOrientation;
+
 /**
  * Generic control with custom drawing.
  */
@@ -85,6 +101,36 @@ typedef struct ZtkControl
   /** Sensitivity value (default 0.007f). */
   float             sensitivity;
 
+  /** Parameter store to read and write the value
+   * through instead of the getter/setter, if
+   * bound. */
+  ZtkParamStore *   param_store;
+
+  /** Parameter ID in \ref ZtkControl.param_store. */
+  uint32_t          param_id;
+
+  /** Drag gesture. Use ztk_gesture_set_callbacks()
+   * on it to be notified of drags. */
+  ZtkGesture        gesture;
+
+  /** Image with a frame for each value, if drawn
+   * as a filmstrip. */
+  cairo_surface_t * filmstrip;
+
+  /** Number of frames in
+   * \ref ZtkControl.filmstrip. */
+  int               filmstrip_num_frames;
+
+  ZtkControlFilmstripOrientation filmstrip_orientation;
+
+  /** Subsurfaces of the frames drawn scaled,
+   * created on first use. */
+  cairo_surface_t ** filmstrip_frames;
+
+  /** Whether \ref ZtkControl.filmstrip is from the
+   * resource cache. */
+  int               filmstrip_cached;
+
 } ZtkControl;
 
 /**
@@ -92,7 +138,12 @@ typedef struct ZtkControl
  *
  * @param get_val Getter function.
  * @param set_val Setter function.
- * @param draw_cb Custom draw callback.
+ * @param draw_cb Custom draw callback, which
+ *   should draw ztk_control_get_shown_value(), or
+ *   NULL for filmstrip controls. Custom controls
+ *   are redrawn whenever their area is, unless
+ *   ztk_control_use_value_fingerprint() is
+ *   called.
  * @param object Object to call get/set with.
  */
 ZtkControl *
@@ -107,9 +158,104 @@ ztk_control_new (
   float  max,
   float  zero);
 
+/**
+ * Only redraws the control when its shown value
+ * changes by at least a pixel along the drag axis,
+ * or its state changes.
+ *
+ * Filmstrip controls do this already. Custom draw
+ * callbacks that only depend on
+ * ztk_control_get_shown_value() can opt in with
+ * this.
+ */
+void
+ztk_control_use_value_fingerprint (
+  ZtkControl * self);
+
+/**
+ * Returns the real value to draw.
+ *
+ * During drags, this is the dragged value, which
+ * is ahead of the getter's if writes are
+ * rate-limited, so custom draw callbacks should
+ * use this instead of the getter.
+ */
+float
+ztk_control_get_shown_value (
+  ZtkControl * self);
+
 void
 ztk_control_set_relative_mode (
   ZtkControl * self,
   int          on);
 
+/**
+ * Binds the control to a parameter.
+ *
+ * The control will then read and write its value
+ * through the store instead of its getter and
+ * setter, and will be redrawn when the DSP thread
+ * changes the parameter.
+ */
+void
+ztk_control_bind_param (
+  ZtkControl *    self,
+  ZtkParamStore * store,
+  uint32_t        id);
+
+/**
+ * Draws the control as a filmstrip: an image with
+ * \p num_frames frames of the same size, of which
+ * the one for the current value is drawn.
+ *
+ * Frames the size of the control are copied as
+ * they are, otherwise they are scaled to fit. The
+ * control is only redrawn when the frame changes,
+ * or its state changes.
+ *
+ * @param strip The image, referenced by the
+ *   control, eg, a sprite from an asset pack.
+ */
+void
+ztk_control_make_filmstrip (
+  ZtkControl *                   self,
+  cairo_surface_t *              strip,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation);
+
+/**
+ * Draws the control as a filmstrip loaded from the
+ * PNG at \p abs_path.
+ *
+ * The image is decoded once and shared by all the
+ * controls using it, in all the apps of the
+ * process.
+ *
+ * @return Non-zero if the PNG could not be loaded.
+ */
+int
+ztk_control_make_filmstrip_from_png (
+  ZtkControl *                   self,
+  const char *                   abs_path,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation);
+
+/**
+ * Draws the control as a filmstrip decoded from
+ * PNG data in memory, eg, embedded in the plugin.
+ *
+ * @param key Unique name of the PNG, to share it
+ *   between the controls using it.
+ * @return Non-zero if the PNG could not be
+ *   decoded.
+ */
+int
+ztk_control_make_filmstrip_from_png_data (
+  ZtkControl *                   self,
+  const char *                   key,
+  const void *                   data,
+  size_t                         size,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation);
+
 #endif
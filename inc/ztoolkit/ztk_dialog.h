@@ -57,24 +57,32 @@ typedef struct ZtkDialog
 
   ZtkRect           internal_rect;
 
-  /** Dialog title. */
-  char              title[256];
+  /** Dialog title.
+   *
+   * The texts are interned in the app's string
+   * table. */
+  const char *      title;
 
   /** Used by about dialogs. */
-  char              copyright[600];
+  const char *      copyright;
 
   /** Used by about dialogs. */
-  char              version[600];
+  const char *      version;
 
   /** Used by about dialogs. */
   ZtkDialogAboutLicense license;
 
   /** Dialog text. */
-  char              text[6000];
+  const char *      text;
 
   /** Dialog type. */
   ZtkDialogType     type;
 
+  /** Extents of the texts, measured on the first
+   * draw. */
+  cairo_text_extents_t text_extents[6];
+  int               texts_measured;
+
 } ZtkDialog;
 
 /**
@@ -20,7 +20,9 @@
 #ifndef __Z_TOOLKIT_ZTK_KNOB_H__
 #define __Z_TOOLKIT_ZTK_KNOB_H__
 
-#include "ztk_color.h"
+#include "gesture.h"
+#include "param_store.h"
+#include "ztk_style.h"
 #include "ztk_widget.h"
 
 /**
@@ -47,8 +49,23 @@ typedef struct ZtkKnob
   double            last_x;    ///< used in gesture drag
   double            last_y;    ///< used in gesture drag
 
-  ZtkColor          start_color;
-  ZtkColor          end_color;
+  /** Style overriding the theme's, if any.
+   *
+   * The arc goes from the FG_ALT color at the zero
+   * point to the FG color at either end. */
+  ZtkStyle *        style;
+
+  /** Parameter store to read and write the value
+   * through instead of the getter/setter, if
+   * bound. */
+  ZtkParamStore *   param_store;
+
+  /** Parameter ID in \ref ZtkKnob.param_store. */
+  uint32_t          param_id;
+
+  /** Drag gesture. Use ztk_gesture_set_callbacks()
+   * on it to be notified of drags. */
+  ZtkGesture        gesture;
 
 } ZtkKnob;
 
@@ -71,4 +88,27 @@ ztk_knob_new (
   float  max,
   float  zero);
 
+/**
+ * Binds the knob to a parameter.
+ *
+ * The knob will then read and write its value
+ * through the store instead of its getter and
+ * setter, and will be redrawn when the DSP thread
+ * changes the parameter.
+ */
+void
+ztk_knob_bind_param (
+  ZtkKnob *       self,
+  ZtkParamStore * store,
+  uint32_t        id);
+
+/**
+ * Sets a style to use instead of the theme's, or
+ * NULL to use the theme's again.
+ */
+void
+ztk_knob_set_style (
+  ZtkKnob *  self,
+  ZtkStyle * style);
+
 #endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Searchable list of presets.
+ */
+
+#ifndef __Z_TOOLKIT_ZTK_PRESET_BROWSER_H__
+#define __Z_TOOLKIT_ZTK_PRESET_BROWSER_H__
+
+#include "search_index.h"
+#include "ztk_style.h"
+#include "ztk_widget.h"
+
+typedef struct ZtkPresetBrowser ZtkPresetBrowser;
+
+/**
+ * Called when a preset is clicked or Enter is
+ * pressed.
+ *
+ * @param idx Index of the preset in the names
+ *   passed to ztk_preset_browser_new().
+ */
+typedef void (*ZtkPresetBrowserActivateCallback) (
+  ZtkPresetBrowser * self,
+  int                idx,
+  void *             data);
+
+/**
+ * Preset browser widget.
+ *
+ * The top row shows the search query, which is
+ * typed while the widget is selected (clicked).
+ * The rest of the rows show the matching presets.
+ */
+typedef struct ZtkPresetBrowser
+{
+  /** Base widget. */
+  ZtkWidget         base;
+
+  /** Index over the preset names. */
+  ZtkSearchIndex *  index;
+
+  /** Results of the current query. */
+  ZtkSearchResults * results;
+
+  /** Current query. */
+  char              query[ZTK_SEARCH_QUERY_MAX];
+  int               query_len;
+
+  /** Index in the results of the first visible
+   * row. */
+  int               scroll_offset;
+
+  /** Hovered row in the results, or -1. */
+  int               hovered_row;
+
+  /** Selected preset index, or -1. */
+  int               selected_idx;
+
+  double            font_size;
+
+  /** Height of each row, including the search
+   * row. */
+  double            row_height;
+
+  ZtkPresetBrowserActivateCallback activate_cb;
+
+  /** Style overriding the theme's, if any.
+   *
+   * The search row is drawn with the BG_ALT color,
+   * the hovered and selected rows with BG_HOVER and
+   * BG_CLICK, and text with FG. */
+  ZtkStyle *        style;
+
+} ZtkPresetBrowser;
+
+/**
+ * Creates a new preset browser.
+ *
+ * @param names Preset names. These are copied.
+ * @param data User data to pass to the activate
+ *   callback.
+ */
+ZtkPresetBrowser *
+ztk_preset_browser_new (
+  ZtkRect *     rect,
+  const char ** names,
+  int           num_names,
+  ZtkPresetBrowserActivateCallback activate_cb,
+  void *        data);
+
+/**
+ * Sets the search query and scrolls to the top.
+ */
+void
+ztk_preset_browser_set_query (
+  ZtkPresetBrowser * self,
+  const char *       query);
+
+/**
+ * Returns the number of rows that fit in the
+ * widget, excluding the search row.
+ */
+int
+ztk_preset_browser_get_num_visible_rows (
+  ZtkPresetBrowser * self);
+
+/**
+ * Sets a style to use instead of the theme's, or
+ * NULL to use the theme's again.
+ */
+void
+ztk_preset_browser_set_style (
+  ZtkPresetBrowser * self,
+  ZtkStyle *         style);
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Immutable, reference-counted sets of colors
+ * shared by the widgets drawn with them.
+ */
+
+#ifndef __Z_TOOLKIT_ZTK_STYLE_H__
+#define __Z_TOOLKIT_ZTK_STYLE_H__
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include <cairo.h>
+
+#include "ztoolkit/ztk_color.h"
+
+/**
+ * Color roles in a style.
+ *
+ * Widgets document which roles they use.
+ */
+typedef enum ZtkStyleColor
+{
+  /** Background. */
+  ZTK_STYLE_COLOR_BG,
+
+  /** Alternate background, eg, of entries. */
+  ZTK_STYLE_COLOR_BG_ALT,
+
+  /** Background when hovered. */
+  ZTK_STYLE_COLOR_BG_HOVER,
+
+  /** Background when clicked or selected. */
+  ZTK_STYLE_COLOR_BG_CLICK,
+
+  ZTK_STYLE_COLOR_FRAME,
+  ZTK_STYLE_COLOR_SEPARATOR,
+
+  /** Foreground, eg, text. */
+  ZTK_STYLE_COLOR_FG,
+
+  /** Alternate foreground. */
+  ZTK_STYLE_COLOR_FG_ALT,
+
+  /** Foreground when hovered. */
+  ZTK_STYLE_COLOR_FG_HOVER,
+
+  /** Foreground when clicked or selected. */
+  ZTK_STYLE_COLOR_FG_CLICK,
+
+  ZTK_STYLE_NUM_COLORS,
+} ZtkStyleColor;
+
+/**
+ * A style.
+ *
+ * Styles are created by \ref ZtkTheme and shared
+ * by all the widgets that use them, so they must
+ * not be modified after creation.
+ */
+typedef struct ZtkStyle
+{
+  atomic_int        refcount;
+
+  /** Colors, in single precision. */
+  float             colors[ZTK_STYLE_NUM_COLORS][4];
+
+  /** Colors packed as 8-bit RGBA. */
+  uint32_t          rgba32[ZTK_STYLE_NUM_COLORS];
+
+  /** Solid sources for the colors, so that they
+   * are not re-created on each draw. */
+  cairo_pattern_t * patterns[ZTK_STYLE_NUM_COLORS];
+
+  /** Hash of the packed colors.
+   *
+   * Styles with the same colors have the same
+   * hash, so it can be used in fingerprints and
+   * as the key of render caches. */
+  uint64_t          hash;
+} ZtkStyle;
+
+/**
+ * Creates a new style with a reference count of
+ * 1.
+ *
+ * @param colors ZTK_STYLE_NUM_COLORS colors
+ *   indexed by ZtkStyleColor.
+ */
+ZtkStyle *
+ztk_style_new (
+  const ZtkColor * colors);
+
+/**
+ * Adds a reference to the style and returns it.
+ */
+ZtkStyle *
+ztk_style_ref (
+  ZtkStyle * self);
+
+/**
+ * Removes a reference from the style, freeing it
+ * when none are left.
+ */
+void
+ztk_style_unref (
+  ZtkStyle * self);
+
+/**
+ * Replaces the style at \p dest with \p style,
+ * taking a reference to the new one and dropping
+ * the one to the old one.
+ *
+ * Either may be NULL.
+ */
+static inline void
+ztk_style_replace (
+  ZtkStyle ** dest,
+  ZtkStyle *  style)
+{
+  if (style)
+    ztk_style_ref (style);
+  if (*dest)
+    ztk_style_unref (*dest);
+  *dest = style;
+}
+
+/**
+ * Sets the given color as the source of \p cr.
+ */
+static inline void
+ztk_style_set_source (
+  const ZtkStyle * self,
+  ZtkStyleColor    color,
+  cairo_t *        cr)
+{
+  cairo_set_source (cr, self->patterns[color]);
+}
+
+/**
+ * Returns the given color in double precision.
+ */
+void
+ztk_style_get_color (
+  const ZtkStyle * self,
+  ZtkStyleColor    color,
+  ZtkColor *       out);
+
+#endif
@@ -21,9 +21,11 @@
 #define __Z_TOOLKIT_ZTK_THEME_H__
 
 #include "ztk_color.h"
+#include "ztk_style.h"
 
 /**
- * Theme colors.
+ * Theme colors and the styles of the built-in
+ * widgets.
  */
 typedef struct ZtkTheme
 {
@@ -36,6 +38,15 @@ typedef struct ZtkTheme
   ZtkColor    bright_orange;
   ZtkColor    z_purple;
   ZtkColor    matcha_green;
+
+  /** Styles shared by the widgets drawn with the
+   * theme. See each widget for the colors it
+   * uses. */
+  ZtkStyle *  combo_box_style;
+  ZtkStyle *  knob_style;
+  ZtkStyle *  preset_browser_style;
+  ZtkStyle *  dialog_style;
+  ZtkStyle *  dialog_close_button_style;
 } ZtkTheme;
 
 /**
@@ -45,4 +56,13 @@ void
 ztk_theme_init (
   ZtkTheme * self);
 
+/**
+ * Releases the styles of the theme.
+ *
+ * Widgets still holding a style keep it alive.
+ */
+void
+ztk_theme_free (
+  ZtkTheme * self);
+
 #endif
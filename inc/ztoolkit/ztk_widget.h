@@ -29,9 +29,12 @@
 #include "pugl.h"
 #include "rect.h"
 
+#include <stdint.h>
+
 #include <cairo.h>
 
 typedef struct ZtkApp ZtkApp;
+typedef struct ZtkArena ZtkArena;
 
 /**
  * @addtogroup ztoolkit
@@ -82,10 +85,24 @@ typedef enum ZtkWidgetType
   ZTK_WIDGET_TYPE_DRAWING_AREA,
   ZTK_WIDGET_TYPE_COMBO_BOX,
   ZTK_WIDGET_TYPE_CONTROL,
+  ZTK_WIDGET_TYPE_PRESET_BROWSER,
 } ZtkWidgetType;
 
 typedef struct ZtkWidget ZtkWidget;
 
+/**
+ * Prototype for fingerprint callbacks.
+ *
+ * @return A hash of everything that affects how
+ *   the widget is drawn, apart from its state and
+ *   rectangle, which are added automatically.
+ *   Values should be quantized to the resolution
+ *   they are drawn at, so that changes that don't
+ *   change any pixel give the same fingerprint.
+ */
+typedef uint64_t (*ZtkWidgetFingerprintCallback) (
+  ZtkWidget * widget);
+
 /**
  * Prototype for generic callbacks.
  *
@@ -213,12 +230,36 @@ typedef struct ZtkWidget
    */
   int               z;
 
+  /** Index in \ref ZtkApp.widgets and
+   * \ref ZtkApp.widget_table, refreshed by
+   * ztk_widget_table_rebuild(). */
+  int               table_idx;
+
   /** Set to 1 to redraw. */
   int               redraw;
 
   /** Last rectangle drawn in. */
   ZtkRect           last_draw_rect;
 
+  /**
+   * Fingerprint callback (optional).
+   *
+   * If set, the widget is only redrawn when its
+   * fingerprint changes (or when a widget it
+   * overlaps is redrawn).
+   */
+  ZtkWidgetFingerprintCallback fingerprint_cb;
+
+  /** Latest fingerprint calculated. */
+  uint64_t          fingerprint;
+
+  /** Fingerprint when last drawn. */
+  uint64_t          drawn_fingerprint;
+
+  /** Whether \ref ZtkWidget.drawn_fingerprint is
+   * set. */
+  int               has_drawn_fingerprint;
+
   /**
    * Last time a press was finished.
    */
@@ -249,11 +290,46 @@ typedef struct ZtkWidget
   cairo_t *         cached_cr;
   cairo_surface_t * cached_surface;
 
+  /** Total time spent in the draw callback, in
+   * seconds, while the app collects statistics. */
+  double            draw_time;
+
+  /** Number of draws counted in
+   * \ref ZtkWidget.draw_time. */
+  unsigned long     num_draws;
+
   /** User data. */
   void *            user_data;
 
+  /** Arena the widget was allocated from, if
+   * any. */
+  ZtkArena *        arena;
+
 } ZtkWidget;
 
+/**
+ * Allocates a zeroed widget of \p size bytes, from
+ * the current arena of the calling thread if any,
+ * otherwise on the heap.
+ *
+ * To be called from the constructors of
+ * inheriting structs, which must then free it with
+ * ztk_widget_dealloc().
+ */
+void *
+ztk_widget_alloc (
+  size_t size);
+
+/**
+ * Frees a widget allocated with ztk_widget_alloc().
+ *
+ * Widgets in an arena are left for the arena to
+ * free.
+ */
+void
+ztk_widget_dealloc (
+  ZtkWidget * self);
+
 /**
  * Inits a new ZWidget.
  *
@@ -303,6 +379,66 @@ ztk_widget_set_visible (
   ZtkWidget * self,
   int         visible);
 
+/**
+ * Moves or resizes the widget.
+ *
+ * The rectangle must only be changed through this
+ * once the widget is added to an app, so that the
+ * app can keep hit testing it.
+ */
+void
+ztk_widget_set_rect (
+  ZtkWidget *     self,
+  const ZtkRect * rect);
+
+/**
+ * Queues a redraw of the widget's rectangle.
+ *
+ * This is a no-op if the widget is not added to
+ * an app, or if its fingerprint did not change
+ * since it was last drawn.
+ */
+void
+ztk_widget_queue_draw (
+  ZtkWidget * self);
+
+/**
+ * Returns whether the widget would look the same
+ * as when it was last drawn, according to its
+ * fingerprint.
+ *
+ * Widgets without a fingerprint callback are never
+ * considered unchanged.
+ */
+int
+ztk_widget_is_unchanged (
+  ZtkWidget * self);
+
+/**
+ * Records the fingerprint calculated in the last
+ * ztk_widget_is_unchanged() call as drawn.
+ */
+void
+ztk_widget_mark_drawn (
+  ZtkWidget * self);
+
+/**
+ * Adds a value to a fingerprint.
+ */
+uint64_t
+ztk_fingerprint_add (
+  uint64_t fingerprint,
+  uint64_t val);
+
+/**
+ * Adds a string (which may be NULL) to a
+ * fingerprint.
+ */
+uint64_t
+ztk_fingerprint_add_str (
+  uint64_t     fingerprint,
+  const char * str);
+
 /**
  * @}
  */
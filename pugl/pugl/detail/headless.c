@@ -0,0 +1,485 @@
+/*
+  Copyright 2020 Alexandros Theodotou <alex at zrythm dot org>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+   @file headless.c Headless implementation.
+
+   Views are never shown on screen.  Events are queued with
+   puglHeadlessSendEvent() and dispatched by puglDispatchEvents(), merging
+   configure and expose events like the X11 implementation does.
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "pugl/detail/headless.h"
+#include "pugl/detail/implementation.h"
+#include "pugl/detail/types.h"
+#include "pugl/pugl.h"
+#include "pugl/pugl_headless.h"
+#include "pugl/pugl_stub.h"
+
+#include "ztoolkit/probes.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef MIN
+#    define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#    define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+PuglWorldInternals*
+puglInitWorldInternals(void)
+{
+	return (PuglWorldInternals*)calloc(1, sizeof(PuglWorldInternals));
+}
+
+void*
+puglGetNativeWorld(PuglWorld* PUGL_UNUSED(world))
+{
+	return NULL;
+}
+
+PuglInternals*
+puglInitViewInternals(void)
+{
+	return (PuglInternals*)calloc(1, sizeof(PuglInternals));
+}
+
+static bool
+hasPendingEvents(const PuglView* view)
+{
+	return view->impl->numEvents > 0 ||
+	       view->impl->pendingConfigure.type ||
+	       view->impl->pendingExpose.type;
+}
+
+PuglStatus
+puglPollEvents(PuglWorld* world, const double PUGL_UNUSED(timeout))
+{
+	// Nothing can arrive while waiting, so never block
+	for (size_t i = 0; i < world->numViews; ++i) {
+		if (hasPendingEvents(world->views[i])) {
+			return PUGL_SUCCESS;
+		}
+	}
+
+	return PUGL_FAILURE;
+}
+
+PuglStatus
+puglCreateWindow(PuglView* view, const char* title)
+{
+	if (!view->backend || !view->backend->configure) {
+		return PUGL_BAD_BACKEND;
+	}
+
+	PuglStatus st = view->backend->configure(view);
+	if (st || (st = view->backend->create(view))) {
+		view->backend->destroy(view);
+		return st;
+	}
+
+	view->impl->created = true;
+	if (title) {
+		puglSetWindowTitle(view, title);
+	}
+
+	return PUGL_SUCCESS;
+}
+
+static void
+sendConfigure(PuglView* view)
+{
+	const PuglEventConfigure ev = {
+		PUGL_CONFIGURE, 0,
+		view->frame.x, view->frame.y, view->frame.width, view->frame.height
+	};
+
+	puglHeadlessSendEvent(view, (const PuglEvent*)&ev);
+}
+
+PuglStatus
+puglShowWindow(PuglView* view)
+{
+	view->visible = true;
+	sendConfigure(view);
+	puglPostRedisplay(view);
+	return PUGL_SUCCESS;
+}
+
+PuglStatus
+puglHideWindow(PuglView* view)
+{
+	view->visible = false;
+	return PUGL_SUCCESS;
+}
+
+void
+puglFreeViewInternals(PuglView* view)
+{
+	if (view && view->impl) {
+		if (view->backend && view->impl->created) {
+			view->backend->destroy(view);
+		}
+		free(view->impl->events);
+		free(view->impl);
+	}
+}
+
+void
+puglFreeWorldInternals(PuglWorld* world)
+{
+	free(world->impl);
+}
+
+PuglStatus
+puglGrabFocus(PuglView* view)
+{
+	view->impl->focused = true;
+	return PUGL_SUCCESS;
+}
+
+bool
+puglHasFocus(const PuglView* view)
+{
+	return view->impl->focused;
+}
+
+PuglStatus
+puglRequestAttention(PuglView* PUGL_UNUSED(view))
+{
+	return PUGL_SUCCESS;
+}
+
+PuglStatus
+puglWaitForEvent(PuglView* PUGL_UNUSED(view))
+{
+	return PUGL_SUCCESS;
+}
+
+static void
+mergeExposeEvents(PuglEvent* dst, const PuglEvent* src)
+{
+	if (!dst->type) {
+		dst->expose = src->expose;
+	} else {
+		const double max_x = MAX(dst->expose.x + dst->expose.width,
+		                         src->expose.x + src->expose.width);
+		const double max_y = MAX(dst->expose.y + dst->expose.height,
+		                         src->expose.y + src->expose.height);
+
+		dst->expose.x      = MIN(dst->expose.x, src->expose.x);
+		dst->expose.y      = MIN(dst->expose.y, src->expose.y);
+		dst->expose.width  = max_x - dst->expose.x;
+		dst->expose.height = max_y - dst->expose.y;
+		dst->expose.count  = MIN(dst->expose.count, src->expose.count);
+	}
+	ZTK_PROBE4(expose_merge,
+	           (int)dst->expose.x, (int)dst->expose.y,
+	           (int)dst->expose.width, (int)dst->expose.height);
+}
+
+static void
+flushPendingConfigure(PuglView* view)
+{
+	PuglEvent* const configure = &view->impl->pendingConfigure;
+
+	if (configure->type) {
+		view->frame.x = configure->configure.x;
+		view->frame.y = configure->configure.y;
+
+		if (configure->configure.width != view->frame.width ||
+		    configure->configure.height != view->frame.height) {
+			view->frame.width  = configure->configure.width;
+			view->frame.height = configure->configure.height;
+
+			view->backend->resize(view,
+			                      (int)view->frame.width,
+			                      (int)view->frame.height);
+		}
+
+		view->eventFunc(view, configure);
+		configure->type = 0;
+	}
+}
+
+PUGL_API PuglStatus
+puglDispatchEvents(PuglWorld* world)
+{
+	world->impl->dispatchingEvents = true;
+
+	for (size_t i = 0; i < world->numViews; ++i) {
+		PuglView* const      view = world->views[i];
+		PuglInternals* const impl = view->impl;
+
+		// Only dispatch events queued so far, events sent by handlers wait
+		const size_t numEvents = impl->numEvents;
+		for (size_t j = 0; j < numEvents; ++j) {
+			const PuglEvent event = impl->events[j];
+			if (event.type == PUGL_EXPOSE) {
+				mergeExposeEvents(&impl->pendingExpose, &event);
+			} else if (event.type == PUGL_CONFIGURE) {
+				impl->pendingConfigure = event;
+			} else {
+				puglDispatchEvent(view, &event);
+			}
+		}
+
+		impl->numEvents -= numEvents;
+		memmove(impl->events,
+		        impl->events + numEvents,
+		        impl->numEvents * sizeof(PuglEvent));
+	}
+
+	// Flush pending configure and expose events for all views
+	for (size_t i = 0; i < world->numViews; ++i) {
+		PuglView* const  view      = world->views[i];
+		PuglEvent* const configure = &view->impl->pendingConfigure;
+		PuglEvent* const expose    = &view->impl->pendingExpose;
+
+		if (configure->type || expose->type) {
+			const bool mustExpose = expose->type && expose->expose.count == 0;
+			puglEnterContext(view, mustExpose);
+
+			flushPendingConfigure(view);
+
+			if (mustExpose) {
+				view->eventFunc(view, &view->impl->pendingExpose);
+			}
+
+			puglLeaveContext(view, mustExpose);
+			configure->type = 0;
+			expose->type    = 0;
+		}
+	}
+
+	world->impl->dispatchingEvents = false;
+
+	return PUGL_SUCCESS;
+}
+
+PuglStatus
+puglProcessEvents(PuglView* view)
+{
+	return puglDispatchEvents(view->world);
+}
+
+double
+puglGetTime(const PuglWorld* world)
+{
+	if (world->impl->manualTime) {
+		return world->impl->time;
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec + ts.tv_nsec / 1000000000.0) - world->startTime;
+}
+
+PuglStatus
+puglPostRedisplay(PuglView* view)
+{
+	const PuglRect rect = { 0, 0, view->frame.width, view->frame.height };
+
+	return puglPostRedisplayRect(view, rect);
+}
+
+PuglStatus
+puglPostRedisplayRect(PuglView* view, PuglRect rect)
+{
+	const PuglEventExpose event = {
+		PUGL_EXPOSE, 0, rect.x, rect.y, rect.width, rect.height, 0
+	};
+
+	if (view->world->impl->dispatchingEvents) {
+		// Currently dispatching events, expand expose for the loop end
+		mergeExposeEvents(&view->impl->pendingExpose,
+		                  (const PuglEvent*)&event);
+	} else if (view->visible) {
+		// Not dispatching events, draw on the next dispatch
+		puglHeadlessSendEvent(view, (const PuglEvent*)&event);
+	}
+
+	return PUGL_SUCCESS;
+}
+
+PuglNativeWindow
+puglGetNativeWindow(PuglView* PUGL_UNUSED(view))
+{
+	return 0;
+}
+
+PuglStatus
+puglSetWindowTitle(PuglView* view, const char* title)
+{
+	puglSetString(&view->title, title);
+	return PUGL_SUCCESS;
+}
+
+PuglStatus
+puglSetFrame(PuglView* view, const PuglRect frame)
+{
+	if (!view->impl->created) {
+		view->frame = frame;
+		return PUGL_SUCCESS;
+	}
+
+	// Resize like a window manager would, with a configure event
+	const PuglEventConfigure ev = {
+		PUGL_CONFIGURE, 0, frame.x, frame.y, frame.width, frame.height
+	};
+
+	return puglHeadlessSendEvent(view, (const PuglEvent*)&ev);
+}
+
+PuglStatus
+puglSetMinSize(PuglView* const view, const int width, const int height)
+{
+	view->minWidth  = width;
+	view->minHeight = height;
+	return PUGL_SUCCESS;
+}
+
+PuglStatus
+puglSetAspectRatio(PuglView* const view,
+                   const int       minX,
+                   const int       minY,
+                   const int       maxX,
+                   const int       maxY)
+{
+	view->minAspectX = minX;
+	view->minAspectY = minY;
+	view->maxAspectX = maxX;
+	view->maxAspectY = maxY;
+	return PUGL_SUCCESS;
+}
+
+PuglStatus
+puglSetTransientFor(PuglView* view, PuglNativeWindow parent)
+{
+	view->transientParent = parent;
+	return PUGL_SUCCESS;
+}
+
+const void*
+puglGetClipboard(PuglView* const    view,
+                 const char** const type,
+                 size_t* const      len)
+{
+	return puglGetInternalClipboard(view, type, len);
+}
+
+PuglStatus
+puglSetClipboard(PuglView* const   view,
+                 const char* const type,
+                 const void* const data,
+                 const size_t      len)
+{
+	return puglSetInternalClipboard(view, type, data, len);
+}
+
+static size_t
+puglHeadlessEventSize(const PuglEventType type)
+{
+	switch (type) {
+	case PUGL_NOTHING:
+		return sizeof(PuglEventAny);
+	case PUGL_BUTTON_PRESS:
+	case PUGL_BUTTON_RELEASE:
+		return sizeof(PuglEventButton);
+	case PUGL_CONFIGURE:
+		return sizeof(PuglEventConfigure);
+	case PUGL_EXPOSE:
+		return sizeof(PuglEventExpose);
+	case PUGL_CLOSE:
+		return sizeof(PuglEventClose);
+	case PUGL_KEY_PRESS:
+	case PUGL_KEY_RELEASE:
+		return sizeof(PuglEventKey);
+	case PUGL_TEXT:
+		return sizeof(PuglEventText);
+	case PUGL_ENTER_NOTIFY:
+	case PUGL_LEAVE_NOTIFY:
+		return sizeof(PuglEventCrossing);
+	case PUGL_MOTION_NOTIFY:
+		return sizeof(PuglEventMotion);
+	case PUGL_SCROLL:
+		return sizeof(PuglEventScroll);
+	case PUGL_FOCUS_IN:
+	case PUGL_FOCUS_OUT:
+		return sizeof(PuglEventFocus);
+	}
+
+	return sizeof(PuglEventAny);
+}
+
+PuglStatus
+puglHeadlessSendEvent(PuglView* view, const PuglEvent* event)
+{
+	PuglInternals* const impl = view->impl;
+
+	if (impl->numEvents == impl->eventsSize) {
+		const size_t size   = impl->eventsSize ? impl->eventsSize * 2 : 16;
+		PuglEvent*   events = (PuglEvent*)realloc(
+			impl->events, size * sizeof(PuglEvent));
+		if (!events) {
+			return PUGL_FAILURE;
+		}
+
+		impl->events     = events;
+		impl->eventsSize = size;
+	}
+
+	// Callers usually pass a specific event struct, which may be smaller
+	PuglEvent* const dest = &impl->events[impl->numEvents++];
+	memset(dest, 0, sizeof(PuglEvent));
+	memcpy(dest, event, puglHeadlessEventSize(event->type));
+	return PUGL_SUCCESS;
+}
+
+size_t
+puglHeadlessGetNumQueuedEvents(const PuglView* view)
+{
+	return view->impl->numEvents;
+}
+
+void
+puglHeadlessSetTime(PuglWorld* world, double time)
+{
+	world->impl->manualTime = true;
+	world->impl->time       = time;
+}
+
+const PuglBackend*
+puglStubBackend(void)
+{
+	static const PuglBackend backend = {puglStubConfigure,
+	                                    puglStubCreate,
+	                                    puglStubDestroy,
+	                                    puglStubEnter,
+	                                    puglStubLeave,
+	                                    puglStubResize,
+	                                    puglStubGetContext};
+
+	return &backend;
+}
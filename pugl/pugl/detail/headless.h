@@ -0,0 +1,41 @@
+/*
+  Copyright 2020 Alexandros Theodotou <alex at zrythm dot org>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+   @file headless.h Shared definitions for headless implementation.
+*/
+
+#include "pugl/detail/implementation.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct PuglWorldInternalsImpl {
+	bool   dispatchingEvents;
+	bool   manualTime;
+	double time;
+};
+
+struct PuglInternalsImpl {
+	PuglSurface* surface;
+	PuglEvent*   events;
+	size_t       numEvents;
+	size_t       eventsSize;
+	bool         created;
+	bool         focused;
+	PuglEvent    pendingConfigure;
+	PuglEvent    pendingExpose;
+};
@@ -0,0 +1,172 @@
+/*
+  Copyright 2020 Alexandros Theodotou <alex at zrythm dot org>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+   @file headless_cairo.c Cairo graphics backend for the headless platform.
+
+   Draws to an image surface that persists between exposes, like the front
+   surface of the X11 backend.
+*/
+
+#include "pugl/detail/headless.h"
+#include "pugl/detail/types.h"
+#include "pugl/pugl.h"
+#include "pugl/pugl_cairo.h"
+#include "pugl/pugl_headless.h"
+#include "pugl/pugl_stub.h"
+
+#include <cairo.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct  {
+	cairo_surface_t* surface;
+	cairo_t*         cr;
+} PuglHeadlessCairoSurface;
+
+static PuglStatus
+puglHeadlessCairoCreateSurface(PuglHeadlessCairoSurface* surface,
+                               int                       width,
+                               int                       height)
+{
+	surface->surface = cairo_image_surface_create(
+		CAIRO_FORMAT_RGB24, width, height);
+	surface->cr = cairo_create(surface->surface);
+
+	if (cairo_surface_status(surface->surface) ||
+	    cairo_status(surface->cr)) {
+		cairo_destroy(surface->cr);
+		cairo_surface_destroy(surface->surface);
+		surface->cr      = NULL;
+		surface->surface = NULL;
+		return PUGL_CREATE_CONTEXT_FAILED;
+	}
+
+	return PUGL_SUCCESS;
+}
+
+static PuglStatus
+puglHeadlessCairoCreate(PuglView* view)
+{
+	PuglInternals* const impl = view->impl;
+
+	PuglHeadlessCairoSurface* surface = (PuglHeadlessCairoSurface*)calloc(
+		1, sizeof(PuglHeadlessCairoSurface));
+	if (!surface) {
+		return PUGL_CREATE_CONTEXT_FAILED;
+	}
+
+	impl->surface = surface;
+
+	return puglHeadlessCairoCreateSurface(
+		surface, (int)view->frame.width, (int)view->frame.height);
+}
+
+static PuglStatus
+puglHeadlessCairoDestroy(PuglView* view)
+{
+	PuglInternals* const            impl    = view->impl;
+	PuglHeadlessCairoSurface* const surface =
+		(PuglHeadlessCairoSurface*)impl->surface;
+
+	if (surface) {
+		cairo_destroy(surface->cr);
+		cairo_surface_destroy(surface->surface);
+		free(surface);
+		impl->surface = NULL;
+	}
+
+	return PUGL_SUCCESS;
+}
+
+static PuglStatus
+puglHeadlessCairoEnter(PuglView* view, bool drawing)
+{
+	PuglInternals* const            impl    = view->impl;
+	PuglHeadlessCairoSurface* const surface =
+		(PuglHeadlessCairoSurface*)impl->surface;
+
+	if (drawing) {
+		cairo_save(surface->cr);
+	}
+
+	return PUGL_SUCCESS;
+}
+
+static PuglStatus
+puglHeadlessCairoLeave(PuglView* view, bool drawing)
+{
+	PuglInternals* const            impl    = view->impl;
+	PuglHeadlessCairoSurface* const surface =
+		(PuglHeadlessCairoSurface*)impl->surface;
+
+	if (drawing) {
+		cairo_restore(surface->cr);
+		cairo_surface_flush(surface->surface);
+	}
+
+	return PUGL_SUCCESS;
+}
+
+static PuglStatus
+puglHeadlessCairoResize(PuglView* view, int width, int height)
+{
+	PuglInternals* const            impl    = view->impl;
+	PuglHeadlessCairoSurface* const surface =
+		(PuglHeadlessCairoSurface*)impl->surface;
+
+	cairo_destroy(surface->cr);
+	cairo_surface_destroy(surface->surface);
+
+	return puglHeadlessCairoCreateSurface(surface, width, height);
+}
+
+static void*
+puglHeadlessCairoGetContext(PuglView* view)
+{
+	PuglInternals* const            impl    = view->impl;
+	PuglHeadlessCairoSurface* const surface =
+		(PuglHeadlessCairoSurface*)impl->surface;
+
+	return surface->cr;
+}
+
+void*
+puglHeadlessGetSurface(PuglView* view)
+{
+	PuglInternals* const            impl    = view->impl;
+	PuglHeadlessCairoSurface* const surface =
+		(PuglHeadlessCairoSurface*)impl->surface;
+
+	return surface ? surface->surface : NULL;
+}
+
+const PuglBackend*
+puglCairoBackend(void)
+{
+	static const PuglBackend backend = {
+		puglStubConfigure,
+		puglHeadlessCairoCreate,
+		puglHeadlessCairoDestroy,
+		puglHeadlessCairoEnter,
+		puglHeadlessCairoLeave,
+		puglHeadlessCairoResize,
+		puglHeadlessCairoGetContext
+	};
+
+	return &backend;
+}
@@ -21,6 +21,9 @@
 #include "pugl/detail/implementation.h"
 #include "pugl/pugl.h"
 
+#include "ztoolkit/probes.h"
+#include "ztoolkit/trace.h"
+
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -235,7 +238,15 @@ puglEnterContext(PuglView* view, bool drawing)
 PuglStatus
 puglLeaveContext(PuglView* view, bool drawing)
 {
+	if (drawing) {
+		ZTK_PROBE1(blit_begin, view);
+	}
+	ZTK_TRACE_BEGIN(backend_leave);
 	view->backend->leave(view, drawing);
+	if (drawing) {
+		ZTK_TRACE_END(backend_leave, -1);
+		ZTK_PROBE1(blit_end, view);
+	}
 	return PUGL_SUCCESS;
 }
 
@@ -28,6 +28,8 @@
 #include "pugl/pugl.h"
 #include "pugl/pugl_stub.h"
 
+#include "ztoolkit/probes.h"
+
 #include <X11/X.h>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
@@ -619,6 +621,9 @@ mergeExposeEvents(PuglEvent* dst, const PuglEvent* src)
 		dst->expose.height = max_y - dst->expose.y;
 		dst->expose.count  = MIN(dst->expose.count, src->expose.count);
 	}
+	ZTK_PROBE4(expose_merge,
+	           (int)dst->expose.x, (int)dst->expose.y,
+	           (int)dst->expose.width, (int)dst->expose.height);
 }
 
 static void
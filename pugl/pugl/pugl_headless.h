@@ -0,0 +1,69 @@
+/*
+  Copyright 2020 Alexandros Theodotou <alex at zrythm dot org>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+   @file pugl_headless.h Headless platform for tests and benchmarks.
+
+   The headless platform has no window system connection.  Views are drawn
+   to an offscreen cairo image surface, and events only come from
+   puglHeadlessSendEvent(), so runs are deterministic.
+*/
+
+#ifndef PUGL_PUGL_HEADLESS_H
+#define PUGL_PUGL_HEADLESS_H
+
+#include "pugl/pugl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+   Queue an event to be dispatched to `view` by puglDispatchEvents().
+
+   Expose and configure events are merged like on other platforms.
+*/
+PUGL_API PuglStatus
+puglHeadlessSendEvent(PuglView* view, const PuglEvent* event);
+
+/**
+   Return the number of events queued for `view`.
+*/
+PUGL_API size_t
+puglHeadlessGetNumQueuedEvents(const PuglView* view);
+
+/**
+   Use a manual clock for puglGetTime(), set to `time` seconds.
+
+   By default, the monotonic system clock is used.
+*/
+PUGL_API void
+puglHeadlessSetTime(PuglWorld* world, double time);
+
+/**
+   Return the cairo image surface (`cairo_surface_t*`) `view` is drawn to.
+
+   The surface is recreated when the view is resized.  Call
+   cairo_surface_flush() before reading its data.
+*/
+PUGL_API void*
+puglHeadlessGetSurface(PuglView* view);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif // PUGL_PUGL_HEADLESS_H
@@ -0,0 +1,1322 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+#
+# This file is part of ZToolkit
+#
+# ZToolkit is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ZToolkit is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Compiles SVGs into C functions that draw them with
+cairo, so that they can be drawn without librsvg
+and without any parsing at runtime.
+
+Each SVG becomes a ZtkCompiledSvg (see
+compiled_svg.h) named <prefix>_<file name>.
+
+Supported: paths and basic shapes, groups,
+transforms, solid and gradient fills and strokes,
+dashes and opacity. Anything else that would draw
+(text, images, filters, masks, clipping, ...) is
+an error, so that an SVG is never silently drawn
+differently than by librsvg.
+
+Usage from meson:
+
+    icons = custom_target (
+      'icons',
+      input: [ 'knob.svg', 'power.svg' ],
+      output: [ 'icons.c', 'icons.h' ],
+      command: [
+        svg2cairo, '--prefix', 'icons',
+        '--output', '@OUTPUT0@',
+        '--header', '@OUTPUT1@', '@INPUT@' ])
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+SVG_NS = '{http://www.w3.org/2000/svg}'
+XLINK_HREF = '{http://www.w3.org/1999/xlink}href'
+
+# elements that do not draw anything by
+# themselves. clipping, masks and the like are only
+# drawn when referenced, which is an error
+IGNORED_ELEMENTS = {
+  'title', 'desc', 'metadata', 'style', 'defs',
+  'linearGradient', 'radialGradient', 'clipPath',
+  'mask', 'symbol', 'marker', 'pattern', 'filter',
+  }
+
+SHAPE_ELEMENTS = {
+  'path', 'rect', 'circle', 'ellipse', 'line',
+  'polyline', 'polygon',
+  }
+
+# properties inherited by children
+INHERITED_PROPS = {
+  'fill': 'black',
+  'fill-opacity': '1',
+  'fill-rule': 'nonzero',
+  'stroke': 'none',
+  'stroke-opacity': '1',
+  'stroke-width': '1',
+  'stroke-linecap': 'butt',
+  'stroke-linejoin': 'miter',
+  'stroke-miterlimit': '4',
+  'stroke-dasharray': 'none',
+  'stroke-dashoffset': '0',
+  'color': 'black',
+  'visibility': 'visible',
+  }
+
+NON_INHERITED_PROPS = {
+  'opacity', 'display', 'stop-color',
+  'stop-opacity', 'clip-path', 'mask', 'filter',
+  'marker-start', 'marker-mid', 'marker-end',
+  }
+
+UNSUPPORTED_PROPS = (
+  'clip-path', 'mask', 'filter', 'marker-start',
+  'marker-mid', 'marker-end',
+  )
+
+NAMED_COLORS = {
+  'black': (0, 0, 0),
+  'silver': (192, 192, 192),
+  'gray': (128, 128, 128),
+  'grey': (128, 128, 128),
+  'white': (255, 255, 255),
+  'maroon': (128, 0, 0),
+  'red': (255, 0, 0),
+  'purple': (128, 0, 128),
+  'fuchsia': (255, 0, 255),
+  'magenta': (255, 0, 255),
+  'green': (0, 128, 0),
+  'lime': (0, 255, 0),
+  'olive': (128, 128, 0),
+  'yellow': (255, 255, 0),
+  'navy': (0, 0, 128),
+  'blue': (0, 0, 255),
+  'teal': (0, 128, 128),
+  'aqua': (0, 255, 255),
+  'cyan': (0, 255, 255),
+  'orange': (255, 165, 0),
+  'darkgray': (169, 169, 169),
+  'darkgrey': (169, 169, 169),
+  'lightgray': (211, 211, 211),
+  'lightgrey': (211, 211, 211),
+  }
+
+IDENTITY = (1.0, 0.0, 0.0, 1.0, 0.0, 0.0)
+
+
+class SvgError (Exception):
+  pass
+
+
+def local_name (tag):
+  if tag.startswith (SVG_NS):
+    return tag[len (SVG_NS):]
+  if tag.startswith ('{'):
+    return None
+  return tag
+
+
+def fmt (val):
+  """Formats a number as a C double literal."""
+  if abs (val) < 1e-12:
+    val = 0.0
+  s = '%.9g' % val
+  if not re.search (r'[.eEn]', s):
+    s += '.0'
+  return s
+
+
+# ---- matrices, as (xx, yx, xy, yy, x0, y0) like
+# cairo_matrix_t ----
+
+def mat_mul (a, b):
+  """Returns the matrix applying b, then a."""
+  return (
+    a[0] * b[0] + a[2] * b[1],
+    a[1] * b[0] + a[3] * b[1],
+    a[0] * b[2] + a[2] * b[3],
+    a[1] * b[2] + a[3] * b[3],
+    a[0] * b[4] + a[2] * b[5] + a[4],
+    a[1] * b[4] + a[3] * b[5] + a[5])
+
+
+def mat_invert (m):
+  det = m[0] * m[3] - m[1] * m[2]
+  if abs (det) < 1e-15:
+    raise SvgError ('non-invertible transform')
+  xx = m[3] / det
+  yx = -m[1] / det
+  xy = -m[2] / det
+  yy = m[0] / det
+  return (
+    xx, yx, xy, yy,
+    -(xx * m[4] + xy * m[5]),
+    -(yx * m[4] + yy * m[5]))
+
+
+def mat_is_identity (m):
+  return all (
+    abs (a - b) < 1e-12 for a, b in zip (m, IDENTITY))
+
+
+NUMBER_RE = re.compile (
+  r'[-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?')
+
+
+def parse_numbers (s):
+  return [float (n) for n in NUMBER_RE.findall (s)]
+
+
+def parse_transform (s):
+  m = IDENTITY
+  for name, args in re.findall (
+      r'(\w+)\s*\(([^)]*)\)', s or ''):
+    a = parse_numbers (args)
+    if name == 'matrix' and len (a) == 6:
+      t = tuple (a)
+    elif name == 'translate' and a:
+      t = (1, 0, 0, 1, a[0], a[1] if len (a) > 1 else 0)
+    elif name == 'scale' and a:
+      t = (a[0], 0, 0, a[1] if len (a) > 1 else a[0],
+           0, 0)
+    elif name == 'rotate' and a:
+      r = math.radians (a[0])
+      c, s_ = math.cos (r), math.sin (r)
+      t = (c, s_, -s_, c, 0, 0)
+      if len (a) == 3:
+        t = mat_mul (
+          (1, 0, 0, 1, a[1], a[2]),
+          mat_mul (t, (1, 0, 0, 1, -a[1], -a[2])))
+    elif name == 'skewX' and a:
+      t = (1, 0, math.tan (math.radians (a[0])), 1, 0, 0)
+    elif name == 'skewY' and a:
+      t = (1, math.tan (math.radians (a[0])), 0, 1, 0, 0)
+    else:
+      raise SvgError ('invalid transform: ' + s)
+    m = mat_mul (m, t)
+  return m
+
+
+def parse_length (s, ref = 1.0):
+  """Parses a length in user units, with
+  percentages relative to ref."""
+  if s is None:
+    return None
+  s = s.strip ()
+  match = re.match (
+    r'^([-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?)'
+    r'\s*(px|%|pt|mm|cm|in)?$', s)
+  if not match:
+    raise SvgError ('invalid length: ' + s)
+  val = float (match.group (1))
+  unit = match.group (2)
+  if unit == '%':
+    return val / 100.0 * ref
+  return val * {
+    None: 1.0, 'px': 1.0, 'pt': 4.0 / 3.0,
+    'mm': 96.0 / 25.4, 'cm': 96.0 / 2.54,
+    'in': 96.0 }[unit]
+
+
+def parse_color (s, current_color = None):
+  """Returns (r, g, b) in 0-1."""
+  s = s.strip ().lower ()
+  if s == 'currentcolor':
+    return parse_color (current_color or 'black')
+  if s.startswith ('#'):
+    h = s[1:]
+    if len (h) == 3:
+      h = ''.join (c * 2 for c in h)
+    if len (h) != 6:
+      raise SvgError ('invalid color: ' + s)
+    return tuple (
+      int (h[i:i + 2], 16) / 255.0
+      for i in (0, 2, 4))
+  match = re.match (r'^rgb\((.*)\)$', s)
+  if match:
+    parts = match.group (1).split (',')
+    if len (parts) != 3:
+      raise SvgError ('invalid color: ' + s)
+    rgb = []
+    for p in parts:
+      p = p.strip ()
+      if p.endswith ('%'):
+        rgb.append (float (p[:-1]) / 100.0)
+      else:
+        rgb.append (float (p) / 255.0)
+    return tuple (min (max (c, 0.0), 1.0) for c in rgb)
+  if s in NAMED_COLORS:
+    return tuple (c / 255.0 for c in NAMED_COLORS[s])
+  raise SvgError ('unsupported color: ' + s)
+
+
+def parse_style (elem):
+  """Returns the presentation attributes and the
+  style attribute of the element as a dict."""
+  props = {}
+  for key in INHERITED_PROPS.keys () | \
+      NON_INHERITED_PROPS:
+    if key in elem.attrib:
+      props[key] = elem.attrib[key].strip ()
+  for decl in elem.attrib.get ('style', '').split (';'):
+    if ':' not in decl:
+      continue
+    key, val = decl.split (':', 1)
+    key = key.strip ()
+    if key in INHERITED_PROPS or \
+        key in NON_INHERITED_PROPS:
+      props[key] = val.strip ()
+  return props
+
+
+# ---- paths, converted to absolute move_to,
+# line_to, curve_to and close_path ----
+
+class Path:
+
+  def __init__ (self):
+    self.ops = []
+
+  def move_to (self, x, y):
+    self.ops.append (('move_to', (x, y)))
+
+  def line_to (self, x, y):
+    self.ops.append (('line_to', (x, y)))
+
+  def curve_to (self, x1, y1, x2, y2, x3, y3):
+    self.ops.append (
+      ('curve_to', (x1, y1, x2, y2, x3, y3)))
+
+  def close_path (self):
+    self.ops.append (('close_path', ()))
+
+  def bbox (self):
+    """Returns the exact bounding box as
+    (x, y, width, height)."""
+    xs = []
+    ys = []
+    cur = (0.0, 0.0)
+    for op, a in self.ops:
+      if op in ('move_to', 'line_to'):
+        cur = a
+        xs.append (a[0])
+        ys.append (a[1])
+      elif op == 'curve_to':
+        p = [cur, a[0:2], a[2:4], a[4:6]]
+        for t in cubic_extrema (p):
+          x, y = cubic_point (p, t)
+          xs.append (x)
+          ys.append (y)
+        cur = a[4:6]
+        xs.append (cur[0])
+        ys.append (cur[1])
+    if not xs:
+      return (0.0, 0.0, 0.0, 0.0)
+    return (
+      min (xs), min (ys), max (xs) - min (xs),
+      max (ys) - min (ys))
+
+
+def cubic_point (p, t):
+  u = 1 - t
+  return tuple (
+    u * u * u * p[0][i] + 3 * u * u * t * p[1][i] +
+    3 * u * t * t * p[2][i] + t * t * t * p[3][i]
+    for i in (0, 1))
+
+
+def cubic_extrema (p):
+  """Returns the t values in (0, 1) where a cubic
+  bezier reaches an extreme in x or y."""
+  ts = []
+  for i in (0, 1):
+    a = -p[0][i] + 3 * p[1][i] - 3 * p[2][i] + p[3][i]
+    b = 2 * (p[0][i] - 2 * p[1][i] + p[2][i])
+    c = p[1][i] - p[0][i]
+    # derivative / 3 = a t^2 + b t + c
+    if abs (a) < 1e-12:
+      if abs (b) > 1e-12:
+        ts.append (-c / b)
+      continue
+    disc = b * b - 4 * a * c
+    if disc < 0:
+      continue
+    sq = math.sqrt (disc)
+    ts.append ((-b + sq) / (2 * a))
+    ts.append ((-b - sq) / (2 * a))
+  return [t for t in ts if 0 < t < 1]
+
+
+PATH_TOKEN_RE = re.compile (
+  r'([MmLlHhVvCcSsQqTtAaZz])|'
+  r'([-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?)')
+
+NUM_ARGS = {
+  'm': 2, 'l': 2, 'h': 1, 'v': 1, 'c': 6, 's': 4,
+  'q': 4, 't': 2, 'a': 7, 'z': 0,
+  }
+
+
+def tokenize_path (d):
+  tokens = []
+  pos = 0
+  d = d.strip ()
+  while pos < len (d):
+    if d[pos] in ' \t\r\n,':
+      pos += 1
+      continue
+    # arc flags may be written without separators
+    if tokens and _in_arc_flag (tokens) and \
+        d[pos] in '01':
+      tokens.append (float (d[pos]))
+      pos += 1
+      continue
+    match = PATH_TOKEN_RE.match (d, pos)
+    if not match:
+      raise SvgError ('invalid path data: ' + d)
+    if match.group (1):
+      tokens.append (match.group (1))
+    else:
+      tokens.append (float (match.group (2)))
+    pos = match.end ()
+  return tokens
+
+
+def _in_arc_flag (tokens):
+  """Returns whether the next token of the path is
+  a large-arc or sweep flag."""
+  num = 0
+  for tok in reversed (tokens):
+    if isinstance (tok, str):
+      if tok.lower () != 'a':
+        return False
+      return num % 7 in (3, 4)
+    num += 1
+  return False
+
+
+def arc_to_curves (
+    path, x1, y1, rx, ry, phi, large_arc, sweep,
+    x2, y2):
+  """Adds an SVG arc as cubic beziers, following
+  the SVG implementation notes."""
+  if x1 == x2 and y1 == y2:
+    return
+  rx = abs (rx)
+  ry = abs (ry)
+  if rx == 0 or ry == 0:
+    path.line_to (x2, y2)
+    return
+  phi = math.radians (phi)
+  cos_phi = math.cos (phi)
+  sin_phi = math.sin (phi)
+  dx = (x1 - x2) / 2
+  dy = (y1 - y2) / 2
+  x1p = cos_phi * dx + sin_phi * dy
+  y1p = -sin_phi * dx + cos_phi * dy
+  lam = (x1p * x1p) / (rx * rx) + \
+    (y1p * y1p) / (ry * ry)
+  if lam > 1:
+    rx *= math.sqrt (lam)
+    ry *= math.sqrt (lam)
+  num = rx * rx * ry * ry - rx * rx * y1p * y1p - \
+    ry * ry * x1p * x1p
+  den = rx * rx * y1p * y1p + ry * ry * x1p * x1p
+  coef = math.sqrt (max (num, 0) / den) if den else 0
+  if large_arc == sweep:
+    coef = -coef
+  cxp = coef * rx * y1p / ry
+  cyp = -coef * ry * x1p / rx
+  cx = cos_phi * cxp - sin_phi * cyp + (x1 + x2) / 2
+  cy = sin_phi * cxp + cos_phi * cyp + (y1 + y2) / 2
+
+  def angle (ux, uy, vx, vy):
+    return math.atan2 (ux * vy - uy * vx, ux * vx + uy * vy)
+
+  theta1 = angle (
+    1, 0, (x1p - cxp) / rx, (y1p - cyp) / ry)
+  dtheta = angle (
+    (x1p - cxp) / rx, (y1p - cyp) / ry,
+    (-x1p - cxp) / rx, (-y1p - cyp) / ry)
+  if not sweep and dtheta > 0:
+    dtheta -= 2 * math.pi
+  elif sweep and dtheta < 0:
+    dtheta += 2 * math.pi
+
+  num_segs = max (
+    1, int (math.ceil (abs (dtheta) / (math.pi / 2) - 1e-9)))
+  delta = dtheta / num_segs
+  k = 4.0 / 3.0 * math.tan (delta / 4)
+
+  def point (t):
+    return (
+      cx + rx * math.cos (t) * cos_phi -
+        ry * math.sin (t) * sin_phi,
+      cy + rx * math.cos (t) * sin_phi +
+        ry * math.sin (t) * cos_phi)
+
+  def deriv (t):
+    return (
+      -rx * math.sin (t) * cos_phi -
+        ry * math.cos (t) * sin_phi,
+      -rx * math.sin (t) * sin_phi +
+        ry * math.cos (t) * cos_phi)
+
+  t = theta1
+  for i in range (num_segs):
+    p0 = point (t)
+    d0 = deriv (t)
+    p3 = point (t + delta)
+    d3 = deriv (t + delta)
+    if i == num_segs - 1:
+      p3 = (x2, y2)
+    path.curve_to (
+      p0[0] + k * d0[0], p0[1] + k * d0[1],
+      p3[0] - k * d3[0], p3[1] - k * d3[1],
+      p3[0], p3[1])
+    t += delta
+
+
+def parse_path (d):
+  path = Path ()
+  tokens = tokenize_path (d)
+  i = 0
+  cmd = None
+  cur = (0.0, 0.0)
+  start = (0.0, 0.0)
+  last_ctrl = None
+  last_cmd = None
+  while i < len (tokens):
+    if isinstance (tokens[i], str):
+      cmd = tokens[i]
+      i += 1
+    elif cmd is None:
+      raise SvgError ('path data must start with a command')
+    lower = cmd.lower ()
+    rel = cmd.islower ()
+    n = NUM_ARGS[lower]
+    args = tokens[i:i + n]
+    if len (args) < n or \
+        any (isinstance (a, str) for a in args):
+      raise SvgError ('invalid path data: ' + d)
+    i += n
+    ox, oy = cur if rel else (0.0, 0.0)
+
+    if lower == 'm':
+      cur = (args[0] + ox, args[1] + oy)
+      start = cur
+      path.move_to (*cur)
+      # further pairs are line_tos
+      cmd = 'l' if rel else 'L'
+      last_ctrl = None
+    elif lower == 'l':
+      cur = (args[0] + ox, args[1] + oy)
+      path.line_to (*cur)
+      last_ctrl = None
+    elif lower == 'h':
+      cur = (args[0] + ox, cur[1])
+      path.line_to (*cur)
+      last_ctrl = None
+    elif lower == 'v':
+      cur = (cur[0], args[0] + oy)
+      path.line_to (*cur)
+      last_ctrl = None
+    elif lower in ('c', 's'):
+      if lower == 'c':
+        c1 = (args[0] + ox, args[1] + oy)
+        rest = args[2:]
+      else:
+        if last_ctrl and last_cmd in ('c', 's'):
+          c1 = (2 * cur[0] - last_ctrl[0],
+                2 * cur[1] - last_ctrl[1])
+        else:
+          c1 = cur
+        rest = args
+      c2 = (rest[0] + ox, rest[1] + oy)
+      end = (rest[2] + ox, rest[3] + oy)
+      path.curve_to (*c1, *c2, *end)
+      last_ctrl = c2
+      cur = end
+    elif lower in ('q', 't'):
+      if lower == 'q':
+        q = (args[0] + ox, args[1] + oy)
+        end = (args[2] + ox, args[3] + oy)
+      else:
+        if last_ctrl and last_cmd in ('q', 't'):
+          q = (2 * cur[0] - last_ctrl[0],
+               2 * cur[1] - last_ctrl[1])
+        else:
+          q = cur
+        end = (args[0] + ox, args[1] + oy)
+      path.curve_to (
+        cur[0] + 2.0 / 3.0 * (q[0] - cur[0]),
+        cur[1] + 2.0 / 3.0 * (q[1] - cur[1]),
+        end[0] + 2.0 / 3.0 * (q[0] - end[0]),
+        end[1] + 2.0 / 3.0 * (q[1] - end[1]),
+        *end)
+      last_ctrl = q
+      cur = end
+    elif lower == 'a':
+      end = (args[5] + ox, args[6] + oy)
+      arc_to_curves (
+        path, cur[0], cur[1], args[0], args[1],
+        args[2], bool (args[3]), bool (args[4]),
+        end[0], end[1])
+      cur = end
+      last_ctrl = None
+    elif lower == 'z':
+      path.close_path ()
+      cur = start
+      last_ctrl = None
+    last_cmd = lower
+  return path
+
+
+def ellipse_path (path, cx, cy, rx, ry):
+  k = 0.5522847498307936
+  path.move_to (cx + rx, cy)
+  path.curve_to (
+    cx + rx, cy + k * ry, cx + k * rx, cy + ry,
+    cx, cy + ry)
+  path.curve_to (
+    cx - k * rx, cy + ry, cx - rx, cy + k * ry,
+    cx - rx, cy)
+  path.curve_to (
+    cx - rx, cy - k * ry, cx - k * rx, cy - ry,
+    cx, cy - ry)
+  path.curve_to (
+    cx + k * rx, cy - ry, cx + rx, cy - k * ry,
+    cx + rx, cy)
+  path.close_path ()
+
+
+def shape_path (elem, name, vw, vh):
+  """Returns the path of a shape element, or None
+  if it does not draw anything."""
+  a = elem.attrib
+
+  def length (key, ref, default = 0.0):
+    val = parse_length (a.get (key), ref)
+    return default if val is None else val
+
+  diag = math.sqrt (vw * vw + vh * vh) / math.sqrt (2)
+  path = Path ()
+  if name == 'path':
+    d = a.get ('d', '')
+    if not d.strip ():
+      return None
+    return parse_path (d)
+  elif name == 'rect':
+    x = length ('x', vw)
+    y = length ('y', vh)
+    w = length ('width', vw)
+    h = length ('height', vh)
+    if w <= 0 or h <= 0:
+      return None
+    rx = parse_length (a.get ('rx'), vw)
+    ry = parse_length (a.get ('ry'), vh)
+    if rx is None:
+      rx = ry
+    if ry is None:
+      ry = rx
+    rx = min (max (rx or 0.0, 0.0), w / 2)
+    ry = min (max (ry or 0.0, 0.0), h / 2)
+    if rx == 0 or ry == 0:
+      path.move_to (x, y)
+      path.line_to (x + w, y)
+      path.line_to (x + w, y + h)
+      path.line_to (x, y + h)
+      path.close_path ()
+    else:
+      k = 0.5522847498307936
+      path.move_to (x + rx, y)
+      path.line_to (x + w - rx, y)
+      path.curve_to (
+        x + w - rx + k * rx, y, x + w, y + ry - k * ry,
+        x + w, y + ry)
+      path.line_to (x + w, y + h - ry)
+      path.curve_to (
+        x + w, y + h - ry + k * ry,
+        x + w - rx + k * rx, y + h, x + w - rx, y + h)
+      path.line_to (x + rx, y + h)
+      path.curve_to (
+        x + rx - k * rx, y + h, x, y + h - ry + k * ry,
+        x, y + h - ry)
+      path.line_to (x, y + ry)
+      path.curve_to (
+        x, y + ry - k * ry, x + rx - k * rx, y,
+        x + rx, y)
+      path.close_path ()
+  elif name == 'circle':
+    r = length ('r', diag)
+    if r <= 0:
+      return None
+    ellipse_path (
+      path, length ('cx', vw), length ('cy', vh), r, r)
+  elif name == 'ellipse':
+    rx = length ('rx', vw)
+    ry = length ('ry', vh)
+    if rx <= 0 or ry <= 0:
+      return None
+    ellipse_path (
+      path, length ('cx', vw), length ('cy', vh),
+      rx, ry)
+  elif name == 'line':
+    path.move_to (length ('x1', vw), length ('y1', vh))
+    path.line_to (length ('x2', vw), length ('y2', vh))
+  elif name in ('polyline', 'polygon'):
+    pts = parse_numbers (a.get ('points', ''))
+    if len (pts) < 4:
+      return None
+    path.move_to (pts[0], pts[1])
+    for i in range (2, len (pts) - 1, 2):
+      path.line_to (pts[i], pts[i + 1])
+    if name == 'polygon':
+      path.close_path ()
+  return path
+
+
+# ---- code generation ----
+
+# cairo state that the generated code sets only
+# when it changes
+LINE_CAPS = {
+  'butt': 'CAIRO_LINE_CAP_BUTT',
+  'round': 'CAIRO_LINE_CAP_ROUND',
+  'square': 'CAIRO_LINE_CAP_SQUARE',
+  }
+LINE_JOINS = {
+  'miter': 'CAIRO_LINE_JOIN_MITER',
+  'round': 'CAIRO_LINE_JOIN_ROUND',
+  'bevel': 'CAIRO_LINE_JOIN_BEVEL',
+  }
+FILL_RULES = {
+  'nonzero': 'CAIRO_FILL_RULE_WINDING',
+  'evenodd': 'CAIRO_FILL_RULE_EVEN_ODD',
+  }
+EXTENDS = {
+  'pad': 'CAIRO_EXTEND_PAD',
+  'reflect': 'CAIRO_EXTEND_REFLECT',
+  'repeat': 'CAIRO_EXTEND_REPEAT',
+  }
+
+
+class Compiler:
+
+  def __init__ (self, path):
+    self.path = path
+    self.lines = []
+    self.ids = {}
+    self.num_patterns = 0
+    self.uses_base_matrix = False
+    self.state_stack = []
+
+    # the state of the context is not known when
+    # drawing starts, so everything is set on first
+    # use
+    self.state = {}
+
+  def error (self, msg):
+    raise SvgError ('%s: %s' % (self.path, msg))
+
+  def emit (self, line, indent = 1):
+    self.lines.append ('  ' * indent + line)
+
+  def set_state (self, key, value, code, indent):
+    if self.state.get (key) != value:
+      self.emit (code, indent)
+      self.state[key] = value
+
+  def compile (self):
+    try:
+      root = ET.parse (self.path).getroot ()
+    except ET.ParseError as e:
+      self.error (str (e))
+    if local_name (root.tag) != 'svg':
+      self.error ('not an SVG')
+
+    for elem in root.iter ():
+      if 'id' in elem.attrib:
+        self.ids[elem.attrib['id']] = elem
+
+    try:
+      vb = parse_numbers (root.attrib.get ('viewBox', ''))
+      width = parse_length (root.attrib.get ('width'))
+      height = parse_length (root.attrib.get ('height'))
+    except SvgError as e:
+      self.error (str (e))
+    if len (vb) == 4:
+      self.vw, self.vh = vb[2], vb[3]
+      if width is None:
+        width = vb[2]
+      if height is None:
+        height = vb[3]
+    else:
+      if width is None or height is None:
+        self.error ('no viewBox or size')
+      vb = [0.0, 0.0, width, height]
+      self.vw, self.vh = width, height
+    if width <= 0 or height <= 0 or \
+        self.vw <= 0 or self.vh <= 0:
+      self.error ('empty size')
+    self.width = width
+    self.height = height
+
+    # from the viewBox to the intrinsic size
+    if width != self.vw or height != self.vh:
+      self.emit (
+        'cairo_scale (cr, %s, %s);' % (
+          fmt (width / self.vw), fmt (height / self.vh)))
+    if vb[0] != 0 or vb[1] != 0:
+      self.emit (
+        'cairo_translate (cr, %s, %s);' % (
+          fmt (-vb[0]), fmt (-vb[1])))
+    self.state['matrix'] = IDENTITY
+    prologue_len = len (self.lines)
+
+    props = dict (INHERITED_PROPS)
+    self.compile_children (root, props, IDENTITY, 1)
+
+    # elements with transforms are drawn relative
+    # to the viewBox's matrix
+    if self.uses_base_matrix:
+      self.lines[prologue_len:prologue_len] = [
+        '  cairo_matrix_t base;',
+        '  cairo_get_matrix (cr, &base);',
+        ]
+
+  def compile_children (
+      self, elem, props, matrix, indent):
+    for child in elem:
+      self.compile_elem (
+        child, props, matrix, indent)
+
+  def compile_elem (
+      self, elem, parent_props, matrix, indent):
+    if not isinstance (elem.tag, str):
+      return
+    name = local_name (elem.tag)
+
+    # other namespaces, like sodipodi:namedview
+    if name is None or name in IGNORED_ELEMENTS:
+      return
+
+    own = parse_style (elem)
+    if own.get ('display') == 'none':
+      return
+    for key in UNSUPPORTED_PROPS:
+      if own.get (key, 'none') != 'none':
+        self.error ('unsupported property ' + key)
+    props = dict (parent_props)
+    for key in INHERITED_PROPS:
+      if key in own and own[key] != 'inherit':
+        props[key] = own[key]
+
+    if 'transform' in elem.attrib:
+      try:
+        matrix = mat_mul (
+          matrix,
+          parse_transform (elem.attrib['transform']))
+      except SvgError as e:
+        self.error (str (e))
+
+    opacity = float (own.get ('opacity', '1'))
+    if opacity <= 0:
+      return
+
+    if name in ('g', 'a'):
+      if opacity < 1:
+        self.push_group (indent)
+      self.compile_children (
+        elem, props, matrix, indent)
+      if opacity < 1:
+        self.pop_group (opacity, indent)
+      return
+
+    if name not in SHAPE_ELEMENTS:
+      self.error ('unsupported element <%s>' % name)
+
+    try:
+      path = shape_path (elem, name, self.vw, self.vh)
+    except SvgError as e:
+      self.error (str (e))
+    if path is None or \
+        props['visibility'] != 'visible':
+      return
+    self.compile_shape (
+      elem, name, path, props, matrix, opacity,
+      indent)
+
+  def push_group (self, indent):
+    self.emit ('cairo_push_group (cr);', indent)
+
+    # popping the group restores the state
+    self.state_stack.append (dict (self.state))
+
+  def pop_group (self, opacity, indent):
+    self.emit (
+      'cairo_pop_group_to_source (cr);', indent)
+    self.state = self.state_stack.pop ()
+
+    # the source is painted in device space
+    self.emit (
+      'cairo_paint_with_alpha (cr, %s);' % fmt (opacity),
+      indent)
+
+  def set_matrix (self, matrix, indent):
+    if self.state.get ('matrix') == matrix:
+      return
+    self.uses_base_matrix = True
+    if mat_is_identity (matrix):
+      self.emit ('cairo_set_matrix (cr, &base);', indent)
+    else:
+      self.emit ('{', indent)
+      self.emit_matrix ('m', matrix, indent + 1)
+      self.emit (
+        'cairo_set_matrix (cr, &base);', indent + 1)
+      self.emit ('cairo_transform (cr, &m);', indent + 1)
+      self.emit ('}', indent)
+    self.state['matrix'] = matrix
+
+  def compile_shape (
+      self, elem, name, path, props, matrix, opacity,
+      indent):
+    fill = props['fill']
+    stroke = props['stroke']
+    try:
+      stroke_width = parse_length (
+        props['stroke-width'],
+        math.sqrt (self.vw ** 2 + self.vh ** 2) /
+          math.sqrt (2))
+    except SvgError as e:
+      self.error (str (e))
+
+    # lines have no inside
+    has_fill = fill != 'none' and name != 'line'
+    has_stroke = stroke != 'none' and stroke_width > 0
+    if not has_fill and not has_stroke:
+      return
+
+    fill_opacity = float (props['fill-opacity'])
+    stroke_opacity = float (props['stroke-opacity'])
+
+    # the opacity of elements with only a fill or
+    # a stroke is folded into it, otherwise the
+    # overlap would be blended twice
+    group = opacity < 1 and has_fill and has_stroke
+    if not group:
+      fill_opacity *= opacity
+      stroke_opacity *= opacity
+
+    self.emit ('')
+    self.emit (
+      '/* %s%s */' % (
+        name,
+        (' ' + elem.attrib['id'])
+          if 'id' in elem.attrib else ''),
+      indent)
+    if group:
+      self.push_group (indent)
+    self.set_matrix (matrix, indent)
+    self.emit_path (path, indent)
+
+    if has_fill:
+      rule = FILL_RULES.get (props['fill-rule'])
+      if rule is None:
+        self.error ('invalid fill-rule')
+      self.set_state (
+        'fill_rule', rule,
+        'cairo_set_fill_rule (cr, %s);' % rule,
+        indent)
+      pattern = self.emit_paint (
+        fill, fill_opacity, path, props, indent)
+      self.emit (
+        'cairo_fill_preserve (cr);' if has_stroke
+          else 'cairo_fill (cr);',
+        indent)
+      if pattern:
+        self.emit (
+          'cairo_pattern_destroy (%s);' % pattern,
+          indent)
+
+    if has_stroke:
+      self.emit_stroke_style (props, stroke_width, indent)
+      pattern = self.emit_paint (
+        stroke, stroke_opacity, path, props, indent)
+      self.emit ('cairo_stroke (cr);', indent)
+      if pattern:
+        self.emit (
+          'cairo_pattern_destroy (%s);' % pattern,
+          indent)
+
+    if group:
+      self.pop_group (opacity, indent)
+
+  def emit_stroke_style (
+      self, props, stroke_width, indent):
+    self.set_state (
+      'line_width', stroke_width,
+      'cairo_set_line_width (cr, %s);' %
+        fmt (stroke_width),
+      indent)
+    cap = LINE_CAPS.get (props['stroke-linecap'])
+    join = LINE_JOINS.get (props['stroke-linejoin'])
+    if cap is None or join is None:
+      self.error ('invalid line cap or join')
+    self.set_state (
+      'line_cap', cap,
+      'cairo_set_line_cap (cr, %s);' % cap, indent)
+    self.set_state (
+      'line_join', join,
+      'cairo_set_line_join (cr, %s);' % join, indent)
+    miter = float (props['stroke-miterlimit'])
+    self.set_state (
+      'miter_limit', miter,
+      'cairo_set_miter_limit (cr, %s);' % fmt (miter),
+      indent)
+
+    dashes = ()
+    offset = 0.0
+    if props['stroke-dasharray'] != 'none':
+      try:
+        dashes = tuple (
+          parse_length (d, self.vw) for d in re.split (
+            r'[\s,]+',
+            props['stroke-dasharray'].strip ())
+          if d)
+        offset = parse_length (
+          props['stroke-dashoffset'], self.vw)
+      except SvgError as e:
+        self.error (str (e))
+      if len (dashes) % 2:
+        dashes *= 2
+      if sum (dashes) <= 0:
+        dashes = ()
+    if not dashes:
+      self.set_state (
+        'dash', (), 'cairo_set_dash (cr, NULL, 0, 0.0);',
+        indent)
+    elif self.state.get ('dash') != (dashes, offset):
+      self.emit ('{', indent)
+      self.emit (
+        'static const double dashes[] = { %s };' %
+          ', '.join (fmt (d) for d in dashes),
+        indent + 1)
+      self.emit (
+        'cairo_set_dash (cr, dashes, %d, %s);' % (
+          len (dashes), fmt (offset)),
+        indent + 1)
+      self.emit ('}', indent)
+      self.state['dash'] = (dashes, offset)
+
+  def emit_matrix (self, name, m, indent):
+    self.emit (
+      'cairo_matrix_t %s = {' % name, indent)
+    self.emit (
+      '%s, %s, %s,' % tuple (fmt (v) for v in m[0:3]),
+      indent + 1)
+    self.emit (
+      '%s, %s, %s };' % tuple (fmt (v) for v in m[3:6]),
+      indent + 1)
+
+  def emit_path (self, path, indent):
+    self.emit ('cairo_new_path (cr);', indent)
+    for op, args in path.ops:
+      line = 'cairo_%s (cr' % op
+      for a in args:
+        arg = ', ' + fmt (a)
+        # keep the lines short
+        if len (line) + len (arg) + 2 * indent > 70:
+          self.emit (line + ',', indent)
+          line = '  ' + arg[2:]
+        else:
+          line += arg
+      self.emit (line + ');', indent)
+
+  def emit_paint (
+      self, paint, opacity, path, props, indent):
+    """Sets the source to the paint.
+
+    Returns the name of the pattern to destroy
+    after drawing, if any."""
+    paint = paint.strip ()
+    match = re.match (
+      r'^url\(\s*#([^)\s]+)\s*\)\s*(.*)$', paint)
+    if match:
+      grad = self.ids.get (match.group (1))
+      if grad is None or local_name (grad.tag) not in (
+          'linearGradient', 'radialGradient'):
+        fallback = match.group (2).strip ()
+        if fallback and fallback != 'none':
+          return self.emit_paint (
+            fallback, opacity, path, props, indent)
+        self.error ('unsupported paint ' + paint)
+      return self.emit_gradient (
+        grad, opacity, path, indent)
+
+    try:
+      r, g, b = parse_color (paint, props['color'])
+    except SvgError as e:
+      self.error (str (e))
+    if opacity >= 1:
+      self.emit (
+        'cairo_set_source_rgb (cr, %s, %s, %s);' % (
+          fmt (r), fmt (g), fmt (b)),
+        indent)
+    else:
+      self.emit ('cairo_set_source_rgba (', indent)
+      self.emit (
+        'cr, %s, %s, %s, %s);' % (
+          fmt (r), fmt (g), fmt (b), fmt (opacity)),
+        indent + 1)
+    return None
+
+  def gradient_chain (self, grad):
+    """Returns the gradient followed by the ones it
+    inherits from."""
+    chain = [grad]
+    while True:
+      href = grad.attrib.get (XLINK_HREF) or \
+        grad.attrib.get ('href')
+      if not href or not href.startswith ('#'):
+        return chain
+      grad = self.ids.get (href[1:])
+      if grad is None or grad in chain:
+        return chain
+      chain.append (grad)
+
+  def emit_gradient (
+      self, grad, opacity, path, indent):
+    chain = self.gradient_chain (grad)
+
+    def attr (key, default = None):
+      for g in chain:
+        if key in g.attrib:
+          return g.attrib[key]
+      return default
+
+    stops = []
+    for g in chain:
+      stops = [
+        s for s in g if isinstance (s.tag, str) and
+          local_name (s.tag) == 'stop']
+      if stops:
+        break
+
+    user_space = attr (
+      'gradientUnits', 'objectBoundingBox') == \
+      'userSpaceOnUse'
+    rw, rh = (self.vw, self.vh) if user_space \
+      else (1.0, 1.0)
+
+    def coord (key, default, ref):
+      try:
+        return parse_length (attr (key, default), ref)
+      except SvgError as e:
+        self.error (str (e))
+
+    # from gradient space to user space
+    try:
+      m = parse_transform (
+        attr ('gradientTransform', ''))
+    except SvgError as e:
+      self.error (str (e))
+    if not user_space:
+      bx, by, bw, bh = path.bbox ()
+      if bw <= 0 or bh <= 0:
+        # not drawn, as per the spec
+        self.emit (
+          'cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.0);',
+          indent)
+        return None
+      m = mat_mul ((bw, 0, 0, bh, bx, by), m)
+    try:
+      inv = mat_invert (m)
+    except SvgError as e:
+      self.error (str (e))
+
+    pattern = 'pattern%d' % self.num_patterns
+    self.num_patterns += 1
+    self.emit (
+      'cairo_pattern_t * %s =' % pattern, indent)
+    if local_name (grad.tag) == 'linearGradient':
+      self.emit (
+        'cairo_pattern_create_linear (', indent + 1)
+      self.emit (
+        '%s, %s, %s, %s);' % (
+          fmt (coord ('x1', '0%', rw)),
+          fmt (coord ('y1', '0%', rh)),
+          fmt (coord ('x2', '100%', rw)),
+          fmt (coord ('y2', '0%', rh))),
+        indent + 2)
+    else:
+      diag = math.sqrt (rw * rw + rh * rh) / \
+        math.sqrt (2)
+      self.emit (
+        'cairo_pattern_create_radial (', indent + 1)
+      self.emit (
+        '%s, %s, 0.0,' % (
+          fmt (coord ('fx', attr ('cx', '50%'), rw)),
+          fmt (coord ('fy', attr ('cy', '50%'), rh))),
+        indent + 2)
+      self.emit (
+        '%s, %s, %s);' % (
+          fmt (coord ('cx', '50%', rw)),
+          fmt (coord ('cy', '50%', rh)),
+          fmt (coord ('r', '50%', diag))),
+        indent + 2)
+
+    last_offset = 0.0
+    for stop in stops:
+      style = parse_style (stop)
+      offset = stop.attrib.get ('offset', '0').strip ()
+      if offset.endswith ('%'):
+        offset = float (offset[:-1]) / 100.0
+      else:
+        offset = float (offset)
+      # offsets never decrease
+      offset = max (min (offset, 1.0), last_offset)
+      last_offset = offset
+      try:
+        r, g, b = parse_color (
+          style.get ('stop-color', 'black'))
+      except SvgError as e:
+        self.error (str (e))
+      a = float (style.get ('stop-opacity', '1')) * \
+        opacity
+      self.emit (
+        'cairo_pattern_add_color_stop_rgba (', indent)
+      self.emit (
+        '%s, %s,' % (pattern, fmt (offset)),
+        indent + 1)
+      self.emit (
+        '%s, %s, %s, %s);' % (
+          fmt (r), fmt (g), fmt (b), fmt (a)),
+        indent + 1)
+
+    spread = attr ('spreadMethod', 'pad')
+    if spread not in EXTENDS:
+      self.error ('invalid spreadMethod ' + spread)
+    self.emit (
+      'cairo_pattern_set_extend (', indent)
+    self.emit (
+      '%s, %s);' % (pattern, EXTENDS[spread]),
+      indent + 1)
+    if not mat_is_identity (inv):
+      self.emit ('{', indent)
+      self.emit_matrix ('pm', inv, indent + 1)
+      self.emit (
+        'cairo_pattern_set_matrix (%s, &pm);' % pattern,
+        indent + 1)
+      self.emit ('}', indent)
+    self.emit (
+      'cairo_set_source (cr, %s);' % pattern, indent)
+
+    return pattern
+
+
+def c_name (path):
+  name = os.path.splitext (os.path.basename (path))[0]
+  name = re.sub (r'[^A-Za-z0-9_]', '_', name)
+  if name[0].isdigit ():
+    name = '_' + name
+  return name
+
+
+def main ():
+  parser = argparse.ArgumentParser (
+    description =
+      'Compiles SVGs into C functions that draw '
+      'them with cairo.')
+  parser.add_argument (
+    '--prefix', required = True,
+    help = 'prefix of the generated symbols')
+  parser.add_argument (
+    '--output', required = True,
+    help = 'C file to write')
+  parser.add_argument (
+    '--header', required = True,
+    help = 'header to write')
+  parser.add_argument ('svgs', nargs = '+')
+  args = parser.parse_args ()
+
+  prefix = re.sub (r'[^A-Za-z0-9_]', '_', args.prefix)
+  names = [c_name (p) for p in args.svgs]
+  if len (set (names)) != len (names):
+    sys.stderr.write ('svg2cairo: duplicate SVG names\n')
+    return 1
+
+  compiled = []
+  for path in args.svgs:
+    compiler = Compiler (path)
+    try:
+      compiler.compile ()
+    except SvgError as e:
+      sys.stderr.write ('svg2cairo: %s\n' % e)
+      return 1
+    compiled.append (compiler)
+
+  guard = '__%s__' % re.sub (
+    r'[^A-Za-z0-9]', '_',
+    os.path.basename (args.header)).upper ()
+  sources = ', '.join (
+    os.path.basename (p) for p in args.svgs)
+
+  with open (args.header, 'w') as f:
+    f.write (
+      '/* Generated by svg2cairo.py from %s.\n'
+      ' * Do not edit. */\n\n' % sources)
+    f.write ('#ifndef %s\n#define %s\n\n' % (guard, guard))
+    f.write ('#include "ztoolkit/compiled_svg.h"\n\n')
+    for name in names:
+      f.write (
+        'extern const ZtkCompiledSvg %s_%s;\n' % (
+          prefix, name))
+    f.write ('\n#endif\n')
+
+  with open (args.output, 'w') as f:
+    f.write (
+      '/* Generated by svg2cairo.py from %s.\n'
+      ' * Do not edit. */\n\n' % sources)
+    f.write ('#include <stddef.h>\n\n')
+    f.write (
+      '#include "%s"\n' % os.path.basename (args.header))
+    for name, compiler in zip (names, compiled):
+      f.write ('\nstatic void\n')
+      f.write ('draw_%s (\n  cairo_t * cr)\n{\n' % name)
+      for line in compiler.lines:
+        f.write (line.rstrip () + '\n')
+      f.write ('}\n\n')
+      f.write (
+        'const ZtkCompiledSvg %s_%s = {\n'
+        '  "%s", %s, %s, draw_%s };\n' % (
+          prefix, name, name, fmt (compiler.width),
+          fmt (compiler.height), name))
+
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit (main ())
@@ -0,0 +1,409 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+#
+# This file is part of ZToolkit
+#
+# ZToolkit is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ZToolkit is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Bundles assets into a single pack file that
+ZtkAssetPack (see asset_pack.h) maps into memory.
+
+Inputs:
+
+- PNGs become sprites, decoded into premultiplied
+  ARGB32 pixels that cairo can use as they are.
+  The scale is taken from the file name:
+  knob.png is the 1x sprite "knob" and
+  knob@1.5x.png and knob@2x.png its 1.5x and 2x
+  versions.
+- Any other file, eg, an SVG, is stored as it is,
+  under its file name.
+- With --rasterize, SVGs are also rendered with
+  rsvg-convert into sprites at each of the
+  --scales, named after the SVG without the
+  extension.
+
+Usage from meson:
+
+    pack = custom_target (
+      'pack',
+      input: [ 'knob.png', 'knob@2x.png' ],
+      output: 'assets.ztkpack',
+      command: [
+        ztkpack, '--output', '@OUTPUT@', '@INPUT@' ])
+
+Format, with little-endian integers:
+
+    header (32 bytes):
+      char     magic[8]   "ZTKPACK\\0"
+      uint32   version
+      uint32   byte_order 0x01020304
+      uint32   num_entries
+      uint32   entry_size
+      uint64   file_size
+    entries (entry_size bytes each, sorted by name
+    and scale):
+      char     name[40]   NUL-terminated
+      uint32   type       0: data, 1: sprite
+      uint32   scale      per mille, 0 for data
+      uint32   width
+      uint32   height
+      uint32   stride     bytes per row of pixels
+      uint32   reserved
+      uint64   offset     from the start of the file
+      uint64   size
+    payloads, each aligned to PAYLOAD_ALIGN bytes
+"""
+
+import argparse
+import os
+import re
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+
+MAGIC = b'ZTKPACK\0'
+VERSION = 1
+BYTE_ORDER = 0x01020304
+NAME_SIZE = 40
+HEADER = struct.Struct ('<8sIIIIQ')
+ENTRY = struct.Struct ('<%dsIIIIIIQQ' % NAME_SIZE)
+PAYLOAD_ALIGN = 64
+
+TYPE_DATA = 0
+TYPE_SPRITE = 1
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+
+class PackError (Exception):
+  pass
+
+
+def paeth (a, b, c):
+  p = a + b - c
+  pa = abs (p - a)
+  pb = abs (p - b)
+  pc = abs (p - c)
+  if pa <= pb and pa <= pc:
+    return a
+  if pb <= pc:
+    return b
+  return c
+
+
+def unfilter (raw, width, height, bpp):
+  """
+  Undoes the per-row filters of non-interlaced
+  PNG image data.
+  """
+  row_size = width * bpp
+  rows = []
+  prev = bytearray (row_size)
+  pos = 0
+  for _ in range (height):
+    if pos + 1 + row_size > len (raw):
+      raise PackError ('truncated image data')
+    ftype = raw[pos]
+    row = bytearray (raw[pos + 1:pos + 1 + row_size])
+    pos += 1 + row_size
+    if ftype == 1:
+      for i in range (bpp, row_size):
+        row[i] = (row[i] + row[i - bpp]) & 0xff
+    elif ftype == 2:
+      for i in range (row_size):
+        row[i] = (row[i] + prev[i]) & 0xff
+    elif ftype == 3:
+      for i in range (row_size):
+        left = row[i - bpp] if i >= bpp else 0
+        row[i] = (row[i] + ((left + prev[i]) >> 1)) & 0xff
+    elif ftype == 4:
+      for i in range (row_size):
+        left = row[i - bpp] if i >= bpp else 0
+        up_left = prev[i - bpp] if i >= bpp else 0
+        row[i] = (
+          row[i] + paeth (left, prev[i], up_left)) & 0xff
+    elif ftype != 0:
+      raise PackError ('invalid filter type %d' % ftype)
+    rows.append (row)
+    prev = row
+  return rows
+
+
+def decode_png (data):
+  """
+  Decodes an 8-bit, non-interlaced PNG.
+
+  Returns (width, height, rows of RGBA bytes).
+  """
+  if not data.startswith (PNG_SIGNATURE):
+    raise PackError ('not a PNG')
+  pos = len (PNG_SIGNATURE)
+  ihdr = None
+  palette = None
+  trns = None
+  idat = []
+  while pos + 8 <= len (data):
+    length, ctype = struct.unpack (
+      '>I4s', data[pos:pos + 8])
+    chunk = data[pos + 8:pos + 8 + length]
+    pos += 12 + length
+    if ctype == b'IHDR':
+      ihdr = struct.unpack ('>IIBBBBB', chunk)
+    elif ctype == b'PLTE':
+      palette = chunk
+    elif ctype == b'tRNS':
+      trns = chunk
+    elif ctype == b'IDAT':
+      idat.append (chunk)
+    elif ctype == b'IEND':
+      break
+  if not ihdr:
+    raise PackError ('missing IHDR')
+
+  width, height, depth, color, _, _, interlace = ihdr
+  if depth != 8:
+    raise PackError (
+      'unsupported bit depth %d, only 8 is supported'
+      % depth)
+  if interlace:
+    raise PackError ('interlaced PNGs are not supported')
+  channels = { 0: 1, 2: 3, 3: 1, 4: 2, 6: 4 }.get (color)
+  if channels is None:
+    raise PackError ('invalid color type %d' % color)
+  if color == 3 and not palette:
+    raise PackError ('missing palette')
+
+  rows = unfilter (
+    zlib.decompress (b''.join (idat)), width, height,
+    channels)
+
+  rgba_rows = []
+  for row in rows:
+    out = bytearray (width * 4)
+    for x in range (width):
+      px = row[x * channels:(x + 1) * channels]
+      if color == 0:
+        r = g = b = px[0]
+        a = 255
+        if trns and len (trns) >= 2 and \
+           px[0] == struct.unpack ('>H', trns[:2])[0]:
+          a = 0
+      elif color == 2:
+        r, g, b = px
+        a = 255
+        if trns and len (trns) >= 6 and \
+           tuple (px) == struct.unpack ('>HHH', trns[:6]):
+          a = 0
+      elif color == 3:
+        idx = px[0]
+        if idx * 3 + 3 > len (palette):
+          raise PackError ('palette index out of range')
+        r, g, b = palette[idx * 3:idx * 3 + 3]
+        a = trns[idx] if trns and idx < len (trns) else 255
+      elif color == 4:
+        r = g = b = px[0]
+        a = px[1]
+      else:
+        r, g, b, a = px
+      out[x * 4:x * 4 + 4] = bytes ((r, g, b, a))
+    rgba_rows.append (out)
+
+  return width, height, rgba_rows
+
+
+def premultiply (c, a):
+  return (c * a + 127) // 255
+
+
+def stride_for_width (width):
+  """ Same as cairo_format_stride_for_width() for
+  ARGB32. """
+  return (width * 4 + 3) & ~3
+
+
+def to_argb32 (width, height, rows):
+  """
+  Converts RGBA rows into premultiplied ARGB32
+  pixels, stored as little-endian 32-bit words as
+  cairo expects on little-endian hosts.
+  """
+  stride = stride_for_width (width)
+  pixels = bytearray (stride * height)
+  for y, row in enumerate (rows):
+    base = y * stride
+    for x in range (width):
+      r, g, b, a = row[x * 4:x * 4 + 4]
+      pixels[base + x * 4:base + x * 4 + 4] = bytes ((
+        premultiply (b, a), premultiply (g, a),
+        premultiply (r, a), a))
+  return stride, bytes (pixels)
+
+
+def parse_scale (s):
+  try:
+    scale = float (s)
+  except ValueError:
+    raise PackError ('invalid scale %s' % s)
+  if scale <= 0:
+    raise PackError ('invalid scale %s' % s)
+  return int (round (scale * 1000))
+
+
+def sprite_name_and_scale (path):
+  """ Returns the sprite name and scale in per mille
+  of a PNG file name, eg, knob@1.5x.png. """
+  stem = os.path.splitext (os.path.basename (path))[0]
+  m = re.match (r'^(.*)@([0-9.]+)x$', stem)
+  if m:
+    return m.group (1), parse_scale (m.group (2))
+  return stem, 1000
+
+
+def rasterize_svg (path, scale):
+  """ Renders the SVG at \\p path into a PNG with
+  rsvg-convert and returns its contents. """
+  rsvg_convert = shutil.which ('rsvg-convert')
+  if not rsvg_convert:
+    raise PackError ('rsvg-convert is needed to rasterize SVGs')
+  with tempfile.TemporaryDirectory () as tmp:
+    out = os.path.join (tmp, 'out.png')
+    subprocess.run (
+      [ rsvg_convert, '--zoom', '%g' % (scale / 1000.0),
+        '--format', 'png', '--output', out, path ],
+      check = True)
+    with open (out, 'rb') as f:
+      return f.read ()
+
+
+class Entry:
+
+  def __init__ (
+    self, name, etype, payload, scale = 0,
+    width = 0, height = 0, stride = 0):
+    encoded = name.encode ('utf-8')
+    if len (encoded) >= NAME_SIZE:
+      raise PackError (
+        'name %s is longer than %d bytes' % (
+          name, NAME_SIZE - 1))
+    self.name = encoded
+    self.type = etype
+    self.payload = payload
+    self.scale = scale
+    self.width = width
+    self.height = height
+    self.stride = stride
+
+  def key (self):
+    return (self.name, self.scale)
+
+
+def make_sprite (name, scale, png_data):
+  width, height, rows = decode_png (png_data)
+  stride, pixels = to_argb32 (width, height, rows)
+  return Entry (
+    name, TYPE_SPRITE, pixels, scale, width, height,
+    stride)
+
+
+def align (offset):
+  return (offset + PAYLOAD_ALIGN - 1) & ~(PAYLOAD_ALIGN - 1)
+
+
+def write_pack (path, entries):
+  entries.sort (key = Entry.key)
+  for a, b in zip (entries, entries[1:]):
+    if a.key () == b.key ():
+      raise PackError (
+        'duplicate entry %s' % a.name.decode ('utf-8'))
+
+  offset = HEADER.size + ENTRY.size * len (entries)
+  offsets = []
+  for e in entries:
+    offset = align (offset)
+    offsets.append (offset)
+    offset += len (e.payload)
+  file_size = offset
+
+  out = bytearray (file_size)
+  HEADER.pack_into (
+    out, 0, MAGIC, VERSION, BYTE_ORDER, len (entries),
+    ENTRY.size, file_size)
+  for i, (e, off) in enumerate (zip (entries, offsets)):
+    ENTRY.pack_into (
+      out, HEADER.size + i * ENTRY.size, e.name, e.type,
+      e.scale, e.width, e.height, e.stride, 0, off,
+      len (e.payload))
+    out[off:off + len (e.payload)] = e.payload
+
+  with open (path, 'wb') as f:
+    f.write (out)
+
+
+def main ():
+  parser = argparse.ArgumentParser (
+    description =
+      'Bundles assets into a pack that ZtkAssetPack '
+      'maps into memory.')
+  parser.add_argument (
+    '--output', required = True,
+    help = 'pack file to write')
+  parser.add_argument (
+    '--rasterize', action = 'store_true',
+    help = 'also rasterize SVGs into sprites')
+  parser.add_argument (
+    '--scales', default = '1,1.5,2',
+    help = 'scales to rasterize SVGs at')
+  parser.add_argument ('files', nargs = '+')
+  args = parser.parse_args ()
+
+  entries = []
+  try:
+    scales = [parse_scale (s) for s in args.scales.split (',')]
+    for path in args.files:
+      with open (path, 'rb') as f:
+        data = f.read ()
+      ext = os.path.splitext (path)[1].lower ()
+      if ext == '.png':
+        name, scale = sprite_name_and_scale (path)
+        try:
+          entries.append (make_sprite (name, scale, data))
+        except PackError as e:
+          raise PackError ('%s: %s' % (path, e))
+        continue
+
+      entries.append (
+        Entry (os.path.basename (path), TYPE_DATA, data))
+      if ext == '.svg' and args.rasterize:
+        name = os.path.splitext (os.path.basename (path))[0]
+        for scale in scales:
+          entries.append (
+            make_sprite (
+              name, scale, rasterize_svg (path, scale)))
+    write_pack (args.output, entries)
+  except (PackError, OSError,
+          subprocess.CalledProcessError) as e:
+    sys.stderr.write ('ztkpack: %s\n' % e)
+    return 1
+
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit (main ())
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ztoolkit/ztk.h"
+
+/** Alignment of allocations. */
+#define ALIGNMENT (alignof (max_align_t))
+
+struct ZtkArenaBlock
+{
+  /** Next (older) block. */
+  ZtkArenaBlock *   next;
+
+  /** Usable size, in bytes. */
+  size_t            size;
+
+  /** Bytes used. */
+  size_t            used;
+
+  alignas (max_align_t) unsigned char data[];
+};
+
+static _Thread_local ZtkArena * current_arena = NULL;
+
+/**
+ * Creates a new arena.
+ *
+ * @param block_size Size of the blocks, or 0 for
+ *   ZTK_ARENA_DEFAULT_BLOCK_SIZE.
+ */
+ZtkArena *
+ztk_arena_new (
+  size_t block_size)
+{
+  ZtkArena * self = calloc (1, sizeof (ZtkArena));
+  self->block_size =
+    block_size ?
+      block_size : ZTK_ARENA_DEFAULT_BLOCK_SIZE;
+
+  return self;
+}
+
+static ZtkArenaBlock *
+add_block (
+  ZtkArena * self,
+  size_t     size)
+{
+  ZtkArenaBlock * block =
+    calloc (1, sizeof (ZtkArenaBlock) + size);
+  if (!block)
+    return NULL;
+  block->size = size;
+
+  /* keep allocating from the current block if it
+   * has more room left than this one will */
+  if (self->block &&
+      self->block->size - self->block->used > size)
+    {
+      block->next = self->block->next;
+      self->block->next = block;
+    }
+  else
+    {
+      block->next = self->block;
+      self->block = block;
+    }
+
+  return block;
+}
+
+/**
+ * Returns \p size bytes of zeroed memory, aligned
+ * for any type.
+ *
+ * The memory stays valid until the arena is
+ * freed.
+ */
+void *
+ztk_arena_alloc (
+  ZtkArena * self,
+  size_t     size)
+{
+  size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+  ZtkArenaBlock * block = self->block;
+  if (!block || block->size - block->used < size)
+    {
+      block =
+        add_block (self, MAX (size, self->block_size));
+      if (!block)
+        {
+          ztk_warning (
+            "Failed to allocate %zu bytes", size);
+          return NULL;
+        }
+    }
+
+  void * ptr = block->data + block->used;
+  block->used += size;
+  self->num_bytes += size;
+
+  return ptr;
+}
+
+/**
+ * Returns whether \p ptr was allocated from the
+ * arena.
+ */
+int
+ztk_arena_contains (
+  ZtkArena *   self,
+  const void * ptr)
+{
+  uintptr_t p = (uintptr_t) ptr;
+  for (ZtkArenaBlock * block = self->block;
+       block; block = block->next)
+    {
+      uintptr_t start = (uintptr_t) block->data;
+      if (p >= start && p < start + block->used)
+        return 1;
+    }
+
+  return 0;
+}
+
+/**
+ * Sets the arena that widgets created on the
+ * calling thread are allocated from, or NULL to
+ * allocate them on the heap.
+ */
+void
+ztk_arena_set_current (
+  ZtkArena * self)
+{
+  current_arena = self;
+}
+
+/**
+ * Returns the current arena of the calling thread,
+ * if any.
+ */
+ZtkArena *
+ztk_arena_get_current (void)
+{
+  return current_arena;
+}
+
+/**
+ * Frees the arena and everything allocated from
+ * it.
+ */
+void
+ztk_arena_free (
+  ZtkArena * self)
+{
+  if (current_arena == self)
+    current_arena = NULL;
+
+  ZtkArenaBlock * block = self->block;
+  while (block)
+    {
+      ZtkArenaBlock * next = block->next;
+      free (block);
+      block = next;
+    }
+
+  free (self);
+}
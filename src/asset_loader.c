@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ztoolkit_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <ztoolkit/asset_loader.h>
+#include <ztoolkit/log.h>
+#include <ztoolkit/resource_cache.h>
+#include <ztoolkit/ztk_widget.h>
+
+typedef enum JobState
+{
+  JOB_QUEUED,
+  JOB_RUNNING,
+  JOB_DONE,
+} JobState;
+
+typedef struct Job
+{
+  /** Loader the job was requested from. */
+  ZtkAssetLoader *       loader;
+
+  /** Widget to pass the asset to, or NULL if
+   * cancelled. */
+  ZtkWidget *            widget;
+
+  ZtkAssetLoadFunc       load_func;
+  ZtkAssetLoadedCallback loaded_cb;
+
+  JobState               state;
+
+  /** The loaded asset, once done. */
+  void *                 asset;
+
+  /** Next job of the same loader. */
+  struct Job *           next;
+
+  /** Next job in the pool's queue, while
+   * queued. */
+  struct Job *           next_queued;
+
+  /** Copy of the data passed to the callbacks. */
+  max_align_t            data[];
+} Job;
+
+/**
+ * Worker threads shared by the loaders of all the
+ * apps in the process.
+ */
+typedef struct Pool
+{
+  /** Signalled when a job is queued or the pool
+   * is stopping. */
+  pthread_cond_t    job_queued;
+
+  /** Queued jobs of all the loaders, in the order
+   * they were requested. */
+  Job *             queue;
+
+  /** Number of loaders using the pool. */
+  int               num_users;
+
+  int               stopping;
+
+  pthread_t         threads[
+    ZTK_ASSET_LOADER_MAX_THREADS];
+  int               num_threads;
+} Pool;
+
+struct ZtkAssetLoader
+{
+  /** Signalled when one of the loader's jobs is
+   * done. */
+  pthread_cond_t    job_done;
+
+  /** Jobs in the order they were requested. */
+  Job *             jobs;
+
+  /** Number of queued and running jobs. */
+  int               num_busy;
+};
+
+/** Protects the pool and the loaders. */
+static pthread_mutex_t lock =
+  PTHREAD_MUTEX_INITIALIZER;
+
+/** Held while loaders are created and freed, so
+ * the pool is not restarted while its threads are
+ * being stopped. */
+static pthread_mutex_t users_lock =
+  PTHREAD_MUTEX_INITIALIZER;
+
+static Pool pool = {
+  .job_queued = PTHREAD_COND_INITIALIZER,
+};
+
+static void
+append_job (
+  ZtkAssetLoader * self,
+  Job *            job)
+{
+  Job ** last = &self->jobs;
+  while (*last)
+    last = &(*last)->next;
+  *last = job;
+
+  last = &pool.queue;
+  while (*last)
+    last = &(*last)->next_queued;
+  *last = job;
+}
+
+static void
+unqueue_job (
+  Job * job)
+{
+  Job ** prev = &pool.queue;
+  while (*prev != job)
+    prev = &(*prev)->next_queued;
+  *prev = job->next_queued;
+  job->next_queued = NULL;
+}
+
+static void *
+worker_thread (
+  void * data)
+{
+  pthread_mutex_lock (&lock);
+  for (;;)
+    {
+      Job * job = pool.queue;
+      if (!job)
+        {
+          if (pool.stopping)
+            break;
+          pthread_cond_wait (
+            &pool.job_queued, &lock);
+          continue;
+        }
+
+      unqueue_job (job);
+      job->state = JOB_RUNNING;
+      pthread_mutex_unlock (&lock);
+      void * asset = job->load_func (job->data);
+      pthread_mutex_lock (&lock);
+      job->asset = asset;
+      job->state = JOB_DONE;
+      job->loader->num_busy--;
+      pthread_cond_broadcast (&job->loader->job_done);
+    }
+  pthread_mutex_unlock (&lock);
+
+  return NULL;
+}
+
+/**
+ * Returns the number of online CPUs, or 1 if
+ * unknown.
+ */
+static int
+get_num_cpus (void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo (&info);
+  long num_cpus = (long) info.dwNumberOfProcessors;
+#else
+  long num_cpus = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+
+  return num_cpus > 0 ? (int) num_cpus : 1;
+}
+
+/**
+ * Stops the pool's threads. To be called with the
+ * lock held, which is released while waiting for
+ * them.
+ */
+static void
+stop_pool (void)
+{
+  pool.stopping = 1;
+  pthread_cond_broadcast (&pool.job_queued);
+  pthread_mutex_unlock (&lock);
+
+  for (int i = 0; i < pool.num_threads; i++)
+    {
+      pthread_join (pool.threads[i], NULL);
+    }
+
+  pthread_mutex_lock (&lock);
+  pool.num_threads = 0;
+  pool.stopping = 0;
+}
+
+/**
+ * Starts the pool's threads. To be called with the
+ * lock held.
+ *
+ * @return 0 if at least one thread was started.
+ */
+static int
+start_pool (
+  int num_threads)
+{
+  if (num_threads <= 0)
+    num_threads = get_num_cpus ();
+  if (num_threads > ZTK_ASSET_LOADER_MAX_THREADS)
+    num_threads = ZTK_ASSET_LOADER_MAX_THREADS;
+
+  for (int i = 0; i < num_threads; i++)
+    {
+      if (pthread_create (
+            &pool.threads[i], NULL, worker_thread,
+            NULL))
+        {
+          ztk_warning (
+            "%s", "Failed to start an asset loader "
+            "thread");
+          break;
+        }
+      pool.num_threads++;
+    }
+
+  return pool.num_threads > 0 ? 0 : -1;
+}
+
+/**
+ * Creates a loader.
+ *
+ * The loaders of all the apps in the process share
+ * one pool of worker threads, which is started
+ * with the first loader and stopped with the last
+ * one.
+ *
+ * @param num_threads Number of worker threads if
+ *   the pool is not running yet, or 0 to use one
+ *   per CPU, up to ZTK_ASSET_LOADER_MAX_THREADS.
+ * @return The loader, or NULL if the threads could
+ *   not be started.
+ */
+ZtkAssetLoader *
+ztk_asset_loader_new (
+  int num_threads)
+{
+  pthread_mutex_lock (&users_lock);
+  pthread_mutex_lock (&lock);
+  int ret =
+    pool.num_users == 0 ?
+      start_pool (num_threads) : 0;
+  if (!ret)
+    pool.num_users++;
+  pthread_mutex_unlock (&lock);
+  pthread_mutex_unlock (&users_lock);
+  if (ret)
+    return NULL;
+
+  ZtkAssetLoader * self =
+    calloc (1, sizeof (ZtkAssetLoader));
+  pthread_cond_init (&self->job_done, NULL);
+
+  return self;
+}
+
+/**
+ * Requests an asset for \p widget.
+ *
+ * Returns immediately. \p load_func runs on a
+ * worker thread and \p loaded_cb runs on the UI
+ * thread in a later ztk_asset_loader_dispatch()
+ * call, unless the load is cancelled first.
+ *
+ * @param data Data for the callbacks, copied.
+ */
+void
+ztk_asset_loader_load (
+  ZtkAssetLoader *       self,
+  ZtkWidget *            widget,
+  ZtkAssetLoadFunc       load_func,
+  ZtkAssetLoadedCallback loaded_cb,
+  const void *           data,
+  size_t                 data_size)
+{
+  Job * job = calloc (1, sizeof (Job) + data_size);
+  job->loader = self;
+  job->widget = widget;
+  job->load_func = load_func;
+  job->loaded_cb = loaded_cb;
+  job->state = JOB_QUEUED;
+  if (data_size > 0)
+    memcpy (job->data, data, data_size);
+
+  pthread_mutex_lock (&lock);
+  append_job (self, job);
+  self->num_busy++;
+  pthread_cond_signal (&pool.job_queued);
+  pthread_mutex_unlock (&lock);
+}
+
+/**
+ * Cancels the loads requested for \p widget.
+ *
+ * Loads already running are finished but their
+ * assets are released instead of passed to the
+ * widget. Must be called before the widget is
+ * freed.
+ */
+void
+ztk_asset_loader_cancel (
+  ZtkAssetLoader * self,
+  ZtkWidget *      widget)
+{
+  pthread_mutex_lock (&lock);
+  Job ** prev = &self->jobs;
+  while (*prev)
+    {
+      Job * job = *prev;
+      if (job->widget != widget)
+        {
+          prev = &job->next;
+          continue;
+        }
+
+      if (job->state == JOB_QUEUED)
+        {
+          *prev = job->next;
+          unqueue_job (job);
+          self->num_busy--;
+          free (job);
+          continue;
+        }
+
+      /* released when dispatched */
+      job->widget = NULL;
+      prev = &job->next;
+    }
+  pthread_cond_broadcast (&self->job_done);
+  pthread_mutex_unlock (&lock);
+}
+
+/**
+ * Calls the completion callbacks of the finished
+ * loads and queues their widgets for redrawing.
+ *
+ * To be called from the UI thread.
+ *
+ * @return The number of finished loads.
+ */
+int
+ztk_asset_loader_dispatch (
+  ZtkAssetLoader * self)
+{
+  /* take the finished jobs, keeping their order */
+  Job * done = NULL;
+  Job ** last_done = &done;
+  pthread_mutex_lock (&lock);
+  Job ** prev = &self->jobs;
+  while (*prev)
+    {
+      Job * job = *prev;
+      if (job->state != JOB_DONE)
+        {
+          prev = &job->next;
+          continue;
+        }
+      *prev = job->next;
+      job->next = NULL;
+      *last_done = job;
+      last_done = &job->next;
+    }
+  pthread_mutex_unlock (&lock);
+
+  int num_done = 0;
+  while (done)
+    {
+      Job * job = done;
+      done = job->next;
+      if (job->widget)
+        {
+          job->loaded_cb (
+            job->widget, job->asset, job->data);
+          ztk_widget_queue_draw (job->widget);
+          num_done++;
+        }
+      else
+        {
+          ztk_resource_cache_release (job->asset);
+        }
+      free (job);
+    }
+
+  return num_done;
+}
+
+/**
+ * Blocks until all the requested loads finished,
+ * without dispatching them.
+ */
+void
+ztk_asset_loader_wait (
+  ZtkAssetLoader * self)
+{
+  pthread_mutex_lock (&lock);
+  while (self->num_busy > 0)
+    {
+      pthread_cond_wait (
+        &self->job_done, &lock);
+    }
+  pthread_mutex_unlock (&lock);
+}
+
+/**
+ * Returns the number of loads that were requested
+ * and not dispatched or cancelled yet.
+ */
+int
+ztk_asset_loader_get_num_pending (
+  ZtkAssetLoader * self)
+{
+  int num_pending = 0;
+  pthread_mutex_lock (&lock);
+  for (Job * job = self->jobs; job; job = job->next)
+    {
+      if (job->widget)
+        num_pending++;
+    }
+  pthread_mutex_unlock (&lock);
+
+  return num_pending;
+}
+
+/**
+ * Returns the number of worker threads in the
+ * pool shared by the loaders, or 0 if there are
+ * no loaders.
+ */
+int
+ztk_asset_loader_get_num_threads (void)
+{
+  pthread_mutex_lock (&lock);
+  int num_threads = pool.num_threads;
+  pthread_mutex_unlock (&lock);
+
+  return num_threads;
+}
+
+/**
+ * Cancels all the loads and frees the loader,
+ * stopping the threads if it was the last one.
+ */
+void
+ztk_asset_loader_free (
+  ZtkAssetLoader * self)
+{
+  pthread_mutex_lock (&users_lock);
+  pthread_mutex_lock (&lock);
+  Job ** prev = &self->jobs;
+  while (*prev)
+    {
+      Job * job = *prev;
+      if (job->state == JOB_QUEUED)
+        {
+          *prev = job->next;
+          unqueue_job (job);
+          self->num_busy--;
+          free (job);
+          continue;
+        }
+      job->widget = NULL;
+      prev = &job->next;
+    }
+
+  /* the running loads still refer to the loader */
+  while (self->num_busy > 0)
+    {
+      pthread_cond_wait (
+        &self->job_done, &lock);
+    }
+
+  if (--pool.num_users == 0)
+    stop_pool ();
+  pthread_mutex_unlock (&lock);
+  pthread_mutex_unlock (&users_lock);
+
+  /* releases the assets of the finished loads */
+  ztk_asset_loader_dispatch (self);
+
+  pthread_cond_destroy (&self->job_done);
+  free (self);
+}
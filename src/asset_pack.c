@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ztoolkit_config.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ztoolkit/asset_pack.h>
+#include <ztoolkit/log.h>
+
+/* see scripts/ztkpack.py for the format */
+#define PACK_MAGIC "ZTKPACK"
+#define PACK_VERSION 1
+#define PACK_BYTE_ORDER 0x01020304
+#define PACK_HEADER_SIZE 32
+#define PACK_ENTRY_SIZE 80
+#define PACK_NAME_SIZE 40
+
+/** Largest sprite side cairo can handle. */
+#define MAX_SPRITE_SIZE 32767
+
+typedef enum EntryType
+{
+  ENTRY_DATA,
+  ENTRY_SPRITE,
+} EntryType;
+
+typedef struct Entry
+{
+  /** Name, in the mapped index. */
+  const char *      name;
+
+  EntryType         type;
+
+  /** Scale of sprites, per mille. */
+  uint32_t          scale;
+
+  int               width;
+  int               height;
+  int               stride;
+
+  /** Contents, in the mapped file. */
+  unsigned char *   data;
+  size_t            size;
+
+  /** Surface of sprites, created on first use. */
+  cairo_surface_t * surface;
+} Entry;
+
+struct ZtkAssetPack
+{
+  unsigned char *   map;
+  size_t            size;
+
+#ifdef _WIN32
+  HANDLE            mapping;
+#endif
+
+  /** Entries sorted by name and scale, like in
+   * the file. */
+  Entry *           entries;
+  int               num_entries;
+
+  /** Guards the creation of the surfaces, since a
+   * pack is shared by the apps in the process. */
+  pthread_mutex_t   lock;
+};
+
+static uint32_t
+read_u32 (
+  const unsigned char * p)
+{
+  uint32_t val;
+  memcpy (&val, p, sizeof (val));
+  return val;
+}
+
+static uint64_t
+read_u64 (
+  const unsigned char * p)
+{
+  uint64_t val;
+  memcpy (&val, p, sizeof (val));
+  return val;
+}
+
+/**
+ * Maps the file at \p path read-only.
+ *
+ * @return Non-zero if failed.
+ */
+static int
+map_file (
+  ZtkAssetPack * self,
+  const char *   path)
+{
+#ifdef _WIN32
+  HANDLE file =
+    CreateFileA (
+      path, GENERIC_READ, FILE_SHARE_READ, NULL,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return -1;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx (file, &size) ||
+      size.QuadPart <= 0)
+    {
+      CloseHandle (file);
+      return -1;
+    }
+  self->mapping =
+    CreateFileMappingA (
+      file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle (file);
+  if (!self->mapping)
+    return -1;
+  self->map =
+    MapViewOfFile (
+      self->mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!self->map)
+    {
+      CloseHandle (self->mapping);
+      return -1;
+    }
+  self->size = (size_t) size.QuadPart;
+#else
+  int fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  struct stat st;
+  if (fstat (fd, &st) || st.st_size <= 0)
+    {
+      close (fd);
+      return -1;
+    }
+  void * map =
+    mmap (
+      NULL, (size_t) st.st_size, PROT_READ,
+      MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    return -1;
+  self->map = map;
+  self->size = (size_t) st.st_size;
+#endif
+
+  return 0;
+}
+
+static void
+unmap_file (
+  ZtkAssetPack * self)
+{
+#ifdef _WIN32
+  UnmapViewOfFile (self->map);
+  CloseHandle (self->mapping);
+#else
+  munmap (self->map, self->size);
+#endif
+}
+
+/**
+ * Reads and validates the index, including that
+ * the entries are sorted by name and scale.
+ *
+ * @return Non-zero if the pack is invalid.
+ */
+static int
+read_index (
+  ZtkAssetPack * self)
+{
+  const unsigned char * p = self->map;
+  if (self->size < PACK_HEADER_SIZE ||
+      memcmp (p, PACK_MAGIC, sizeof (PACK_MAGIC)))
+    {
+      ztk_error ("%s", "Not an asset pack");
+      return -1;
+    }
+  if (read_u32 (p + 8) != PACK_VERSION)
+    {
+      ztk_error (
+        "Unsupported asset pack version %u",
+        read_u32 (p + 8));
+      return -1;
+    }
+  /* the pixels are in the byte order of the host
+   * that built the pack */
+  if (read_u32 (p + 12) != PACK_BYTE_ORDER)
+    {
+      ztk_error (
+        "%s", "Asset pack built for another byte "
+        "order");
+      return -1;
+    }
+  uint32_t num_entries = read_u32 (p + 16);
+  if (read_u32 (p + 20) != PACK_ENTRY_SIZE ||
+      read_u64 (p + 24) != self->size ||
+      num_entries >
+        (self->size - PACK_HEADER_SIZE) /
+          PACK_ENTRY_SIZE)
+    {
+      ztk_error ("%s", "Truncated asset pack");
+      return -1;
+    }
+
+  self->entries =
+    calloc (
+      num_entries ? num_entries : 1,
+      sizeof (Entry));
+  self->num_entries = (int) num_entries;
+  for (uint32_t i = 0; i < num_entries; i++)
+    {
+      const unsigned char * e =
+        p + PACK_HEADER_SIZE + i * PACK_ENTRY_SIZE;
+      Entry * entry = &self->entries[i];
+      entry->name = (const char *) e;
+      uint32_t type = read_u32 (e + PACK_NAME_SIZE);
+      entry->scale =
+        read_u32 (e + PACK_NAME_SIZE + 4);
+      uint32_t width =
+        read_u32 (e + PACK_NAME_SIZE + 8);
+      uint32_t height =
+        read_u32 (e + PACK_NAME_SIZE + 12);
+      uint32_t stride =
+        read_u32 (e + PACK_NAME_SIZE + 16);
+      uint64_t offset =
+        read_u64 (e + PACK_NAME_SIZE + 24);
+      uint64_t size =
+        read_u64 (e + PACK_NAME_SIZE + 32);
+
+      if (!memchr (e, '\0', PACK_NAME_SIZE) ||
+          offset > self->size ||
+          size > self->size - offset)
+        {
+          ztk_error (
+            "Invalid asset pack entry %u", i);
+          return -1;
+        }
+      /* the lookups binary search the entries */
+      if (i > 0)
+        {
+          const Entry * prev = entry - 1;
+          int cmp = strcmp (prev->name, entry->name);
+          if (cmp > 0 ||
+              (cmp == 0 && prev->scale > entry->scale))
+            {
+              ztk_error (
+                "Asset pack entry %s is out of order",
+                entry->name);
+              return -1;
+            }
+        }
+      entry->data = self->map + offset;
+      entry->size = (size_t) size;
+
+      if (type == ENTRY_DATA)
+        {
+          entry->type = ENTRY_DATA;
+          continue;
+        }
+      if (type != ENTRY_SPRITE ||
+          width == 0 || height == 0 ||
+          width > MAX_SPRITE_SIZE ||
+          height > MAX_SPRITE_SIZE ||
+          entry->scale == 0 ||
+          stride < width * 4 || stride % 4 ||
+          offset % 4 ||
+          size < (uint64_t) stride * height)
+        {
+          ztk_error (
+            "Invalid sprite %s in asset pack",
+            entry->name);
+          return -1;
+        }
+      entry->type = ENTRY_SPRITE;
+      entry->width = (int) width;
+      entry->height = (int) height;
+      entry->stride = (int) stride;
+    }
+
+  return 0;
+}
+
+/**
+ * Maps the pack at \p path.
+ *
+ * The pack is validated but its contents are only
+ * paged in when used.
+ *
+ * @return The pack, or NULL if it could not be
+ *   mapped or is invalid.
+ */
+ZtkAssetPack *
+ztk_asset_pack_new (
+  const char * path)
+{
+  ZtkAssetPack * self =
+    calloc (1, sizeof (ZtkAssetPack));
+  if (map_file (self, path))
+    {
+      ztk_error (
+        "Could not map the asset pack at %s", path);
+      free (self);
+      return NULL;
+    }
+  if (read_index (self))
+    {
+      ztk_error ("Invalid asset pack at %s", path);
+      unmap_file (self);
+      free (self->entries);
+      free (self);
+      return NULL;
+    }
+  pthread_mutex_init (&self->lock, NULL);
+
+  return self;
+}
+
+/**
+ * Returns the index of the first entry called
+ * \p name, or -1 if there is none.
+ */
+static int
+find_first_entry (
+  ZtkAssetPack * self,
+  const char *   name)
+{
+  int lo = 0;
+  int hi = self->num_entries;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+      if (strcmp (self->entries[mid].name, name) < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  if (lo < self->num_entries &&
+      !strcmp (self->entries[lo].name, name))
+    return lo;
+
+  return -1;
+}
+
+/**
+ * Returns the sprite \p name for the given scale
+ * factor.
+ *
+ * Picks the smallest scale that is at least
+ * \p scale, so that the sprite is only ever scaled
+ * down, or the largest one if there is none.
+ *
+ * The surface belongs to the pack and must only
+ * be used as a source. It must not be referenced
+ * past ztk_asset_pack_free().
+ *
+ * @param scale Scale factor, eg, 1.5 on a display
+ *   scaled to 150%.
+ * @return An ARGB32 image surface, or NULL if
+ *   there is no such sprite.
+ */
+cairo_surface_t *
+ztk_asset_pack_get_sprite (
+  ZtkAssetPack * self,
+  const char *   name,
+  double         scale)
+{
+  int first = find_first_entry (self, name);
+  if (first < 0)
+    return NULL;
+
+  /* the sprites of the same name are sorted by
+   * scale */
+  uint32_t wanted = (uint32_t) (scale * 1000.0 + 0.5);
+  Entry * found = NULL;
+  for (int i = first;
+       i < self->num_entries &&
+         !strcmp (self->entries[i].name, name);
+       i++)
+    {
+      Entry * entry = &self->entries[i];
+      if (entry->type != ENTRY_SPRITE)
+        continue;
+      found = entry;
+      if (entry->scale >= wanted)
+        break;
+    }
+  if (!found)
+    return NULL;
+
+  pthread_mutex_lock (&self->lock);
+  if (!found->surface)
+    {
+      found->surface =
+        cairo_image_surface_create_for_data (
+          found->data, CAIRO_FORMAT_ARGB32,
+          found->width, found->height,
+          found->stride);
+    }
+  pthread_mutex_unlock (&self->lock);
+
+  return found->surface;
+}
+
+/**
+ * Returns the contents of the file \p name stored
+ * in the pack.
+ *
+ * @param size Set to the size of the contents.
+ * @return The contents, valid until the pack is
+ *   freed, or NULL if there is no such file.
+ */
+const void *
+ztk_asset_pack_get_data (
+  ZtkAssetPack * self,
+  const char *   name,
+  size_t *       size)
+{
+  int first = find_first_entry (self, name);
+  if (first < 0)
+    return NULL;
+
+  for (int i = first;
+       i < self->num_entries &&
+         !strcmp (self->entries[i].name, name);
+       i++)
+    {
+      Entry * entry = &self->entries[i];
+      if (entry->type == ENTRY_DATA)
+        {
+          *size = entry->size;
+          return entry->data;
+        }
+    }
+
+  return NULL;
+}
+
+/**
+ * Returns the size of the mapped file.
+ */
+size_t
+ztk_asset_pack_get_size (
+  ZtkAssetPack * self)
+{
+  return self->size;
+}
+
+/**
+ * Destroys the sprites and unmaps the pack.
+ */
+void
+ztk_asset_pack_free (
+  ZtkAssetPack * self)
+{
+  for (int i = 0; i < self->num_entries; i++)
+    {
+      if (self->entries[i].surface)
+        cairo_surface_destroy (
+          self->entries[i].surface);
+    }
+  free (self->entries);
+  unmap_file (self);
+  pthread_mutex_destroy (&self->lock);
+  free (self);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ztoolkit/compiled_svg.h>
+
+/**
+ * Draws the SVG scaled to fit \p rect, keeping its
+ * aspect ratio and centered.
+ */
+void
+ztk_compiled_svg_draw (
+  const ZtkCompiledSvg * self,
+  cairo_t *              cr,
+  const ZtkRect *        rect)
+{
+  double xscale = rect->width / self->width;
+  double yscale = rect->height / self->height;
+  double scale = xscale < yscale ? xscale : yscale;
+  if (scale <= 0.0)
+    return;
+
+  cairo_save (cr);
+  cairo_translate (
+    cr,
+    rect->x + (rect->width - scale * self->width) / 2,
+    rect->y +
+      (rect->height - scale * self->height) / 2);
+  cairo_scale (cr, scale, scale);
+  self->draw (cr);
+  cairo_restore (cr);
+}
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ztoolkit/ztk.h"
+
+/** Frame time at the top of the graph. */
+#define GRAPH_MAX_TIME (1.0 / 30.0)
+
+/** Frame time budget at 60 fps. */
+#define FRAME_BUDGET (1.0 / 60.0)
+
+#define HUD_PADDING 4.0
+#define HUD_TEXT_HEIGHT 14.0
+#define BAR_WIDTH 2.0
+
+/** Colors of the widgets causing repaints. Red is
+ * reserved for full repaints. */
+static const ZtkColor widget_colors[] = {
+  { 0.2, 0.6, 1.0, 1.0 },
+  { 0.2, 0.9, 0.3, 1.0 },
+  { 1.0, 0.8, 0.1, 1.0 },
+  { 0.8, 0.3, 1.0, 1.0 },
+  { 0.1, 0.9, 0.9, 1.0 },
+  { 1.0, 0.5, 0.8, 1.0 },
+};
+
+static const ZtkColor full_repaint_color = {
+  1.0, 0.1, 0.1, 1.0 };
+
+ZtkDebugOverlay *
+ztk_debug_overlay_new (void)
+{
+  ZtkDebugOverlay * self =
+    calloc (1, sizeof (ZtkDebugOverlay));
+  self->hud_rect.x = HUD_PADDING;
+  self->hud_rect.y = HUD_PADDING;
+  self->hud_rect.width =
+    ZTK_DEBUG_OVERLAY_NUM_FRAMES * BAR_WIDTH +
+    2 * HUD_PADDING;
+  self->hud_rect.height = 48.0;
+
+  return self;
+}
+
+/**
+ * Adds a frame to the graph.
+ *
+ * @param start Start time of the frame, in seconds.
+ * @param duration Time taken by the frame.
+ */
+void
+ztk_debug_overlay_add_frame (
+  ZtkDebugOverlay * self,
+  double            start,
+  double            duration)
+{
+  self->frame_starts[self->frames_idx] = start;
+  self->frame_times[self->frames_idx] = duration;
+  self->frames_idx =
+    (self->frames_idx + 1) %
+      ZTK_DEBUG_OVERLAY_NUM_FRAMES;
+  if (self->num_frames < ZTK_DEBUG_OVERLAY_NUM_FRAMES)
+    self->num_frames++;
+}
+
+/**
+ * Flashes a repainted area.
+ *
+ * @param widget Widget that caused the repaint, or
+ *   NULL for full repaints.
+ * @param time Current time, in seconds.
+ */
+void
+ztk_debug_overlay_add_flash (
+  ZtkDebugOverlay * self,
+  ZtkRect *         rect,
+  ZtkWidget *       widget,
+  double            time)
+{
+  /* restart the flash of an area repainted again,
+   * otherwise replace the oldest one if full */
+  int idx = self->num_flashes;
+  for (int i = 0; i < self->num_flashes; i++)
+    {
+      ZtkRepaintFlash * flash = &self->flashes[i];
+      if (flash->widget == widget &&
+          ztk_rect_is_equal (&flash->rect, rect))
+        {
+          idx = i;
+          break;
+        }
+      if (self->num_flashes ==
+            ZTK_DEBUG_OVERLAY_MAX_FLASHES &&
+          (idx == self->num_flashes ||
+           flash->time < self->flashes[idx].time))
+        {
+          idx = i;
+        }
+    }
+  if (idx == self->num_flashes)
+    self->num_flashes++;
+
+  ZtkRepaintFlash * flash = &self->flashes[idx];
+  flash->rect = *rect;
+  flash->widget = widget;
+  flash->time = time;
+}
+
+/**
+ * Appends the areas the overlay needs to repaint
+ * to \p rects.
+ *
+ * There must be room for
+ * \ref ZTK_DEBUG_OVERLAY_MAX_FLASHES + 1
+ * rectangles.
+ *
+ * @return The number of rectangles appended.
+ */
+int
+ztk_debug_overlay_get_damage (
+  ZtkDebugOverlay * self,
+  ZtkRect *         rects)
+{
+  /* flashes are repainted until they have faded
+   * out, and the HUD in every frame */
+  for (int i = 0; i < self->num_flashes; i++)
+    {
+      rects[i] = self->flashes[i].rect;
+    }
+  rects[self->num_flashes] = self->hud_rect;
+
+  return self->num_flashes + 1;
+}
+
+static const ZtkColor *
+get_flash_color (
+  ZtkRepaintFlash * flash)
+{
+  if (!flash->widget)
+    return &full_repaint_color;
+
+  size_t num_colors =
+    sizeof (widget_colors) / sizeof (ZtkColor);
+  return
+    &widget_colors[
+      ((uintptr_t) flash->widget >> 4) % num_colors];
+}
+
+static void
+draw_flashes (
+  ZtkDebugOverlay * self,
+  cairo_t *         cr,
+  double            time)
+{
+  for (int i = 0; i < self->num_flashes; i++)
+    {
+      ZtkRepaintFlash * flash = &self->flashes[i];
+      double alpha =
+        1.0 -
+        (time - flash->time) /
+          ZTK_DEBUG_OVERLAY_FLASH_DURATION;
+      if (alpha <= 0.0)
+        continue;
+
+      const ZtkColor * color =
+        get_flash_color (flash);
+      ZtkRect * r = &flash->rect;
+      cairo_set_source_rgba (
+        cr, color->red, color->green, color->blue,
+        0.35 * alpha);
+      cairo_rectangle (
+        cr, r->x, r->y, r->width, r->height);
+      cairo_fill (cr);
+      cairo_set_source_rgba (
+        cr, color->red, color->green, color->blue,
+        alpha);
+      cairo_set_line_width (cr, 1.0);
+      cairo_rectangle (
+        cr, r->x + 0.5, r->y + 0.5, r->width - 1.0,
+        r->height - 1.0);
+      cairo_stroke (cr);
+    }
+}
+
+/**
+ * Removes the flashes that faded out.
+ */
+static void
+remove_faded_flashes (
+  ZtkDebugOverlay * self,
+  double            time)
+{
+  int num_flashes = 0;
+  for (int i = 0; i < self->num_flashes; i++)
+    {
+      if (time - self->flashes[i].time <
+            ZTK_DEBUG_OVERLAY_FLASH_DURATION)
+        {
+          self->flashes[num_flashes++] =
+            self->flashes[i];
+        }
+    }
+  self->num_flashes = num_flashes;
+}
+
+static void
+draw_hud (
+  ZtkDebugOverlay * self,
+  cairo_t *         cr)
+{
+  ZtkRect * r = &self->hud_rect;
+  cairo_set_source_rgba (cr, 0, 0, 0, 0.75);
+  cairo_rectangle (
+    cr, r->x, r->y, r->width, r->height);
+  cairo_fill (cr);
+
+  /* frame rate and time of the last frame */
+  int last =
+    (self->frames_idx +
+     ZTK_DEBUG_OVERLAY_NUM_FRAMES - 1) %
+      ZTK_DEBUG_OVERLAY_NUM_FRAMES;
+  int first =
+    self->num_frames == ZTK_DEBUG_OVERLAY_NUM_FRAMES ?
+      self->frames_idx : 0;
+  double fps = 0.0;
+  if (self->num_frames > 1 &&
+      self->frame_starts[last] >
+        self->frame_starts[first])
+    {
+      fps =
+        (self->num_frames - 1) /
+        (self->frame_starts[last] -
+           self->frame_starts[first]);
+    }
+  char text[64];
+  snprintf (
+    text, sizeof (text), "%.0f fps  %.2f ms", fps,
+    self->num_frames ?
+      self->frame_times[last] * 1e3 : 0.0);
+  cairo_set_source_rgba (cr, 1, 1, 1, 1);
+  cairo_set_font_size (cr, 10);
+  cairo_move_to (
+    cr, r->x + HUD_PADDING,
+    r->y + HUD_TEXT_HEIGHT - 2.0);
+  cairo_show_text (cr, text);
+
+  /* frame time graph, oldest first */
+  double graph_y = r->y + HUD_TEXT_HEIGHT;
+  double graph_height =
+    r->height - HUD_TEXT_HEIGHT - HUD_PADDING;
+  for (int i = 0; i < self->num_frames; i++)
+    {
+      double time =
+        self->frame_times[(first + i) %
+          ZTK_DEBUG_OVERLAY_NUM_FRAMES];
+      double height =
+        MIN (time / GRAPH_MAX_TIME, 1.0) *
+          graph_height;
+      if (time < FRAME_BUDGET)
+        cairo_set_source_rgba (cr, 0.2, 0.9, 0.3, 1);
+      else if (time < GRAPH_MAX_TIME)
+        cairo_set_source_rgba (cr, 1.0, 0.8, 0.1, 1);
+      else
+        cairo_set_source_rgba (cr, 1.0, 0.1, 0.1, 1);
+      cairo_rectangle (
+        cr, r->x + HUD_PADDING + i * BAR_WIDTH,
+        graph_y + graph_height - height,
+        BAR_WIDTH, height);
+      cairo_fill (cr);
+    }
+
+  /* budget line */
+  double budget_y =
+    graph_y + graph_height *
+      (1.0 - FRAME_BUDGET / GRAPH_MAX_TIME);
+  cairo_set_source_rgba (cr, 1, 1, 1, 0.5);
+  cairo_set_line_width (cr, 1.0);
+  cairo_move_to (cr, r->x + HUD_PADDING, budget_y);
+  cairo_line_to (
+    cr, r->x + r->width - HUD_PADDING, budget_y);
+  cairo_stroke (cr);
+}
+
+/**
+ * Draws the flashes and the HUD on top of the
+ * widgets, then forgets the flashes that faded
+ * out.
+ *
+ * @param time Current time, in seconds.
+ */
+void
+ztk_debug_overlay_draw (
+  ZtkDebugOverlay * self,
+  cairo_t *         cr,
+  double            time)
+{
+  cairo_save (cr);
+  draw_flashes (self, cr, time);
+  draw_hud (self, cr);
+  cairo_restore (cr);
+
+  remove_faded_flashes (self, time);
+}
+
+void
+ztk_debug_overlay_free (
+  ZtkDebugOverlay * self)
+{
+  free (self);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ztoolkit/ztk.h"
+
+/**
+ * Sets the callbacks to notify (eg, the host) of
+ * the start, changes and end of drags.
+ */
+void
+ztk_gesture_set_callbacks (
+  ZtkGesture *       self,
+  ZtkGestureCallback begin_cb,
+  ZtkGestureCallback change_cb,
+  ZtkGestureCallback end_cb,
+  void *             data)
+{
+  self->begin_cb = begin_cb;
+  self->change_cb = change_cb;
+  self->end_cb = end_cb;
+  self->data = data;
+}
+
+/**
+ * Limits the writes during a drag to \p rate per
+ * second, or to one per frame if \p rate is 0.
+ */
+void
+ztk_gesture_set_rate (
+  ZtkGesture * self,
+  double       rate)
+{
+  self->min_interval = rate > 0.0 ? 1.0 / rate : 0.0;
+}
+
+/**
+ * Starts a gesture.
+ *
+ * @param value The current value.
+ */
+void
+ztk_gesture_begin (
+  ZtkGesture * self,
+  ZtkWidget *  widget,
+  float        value)
+{
+  self->active = 1;
+  self->value = value;
+  self->written_value = value;
+  self->pending = 0;
+
+  /* allow the first change to be written right
+   * away */
+  self->last_write_time = -1e9;
+
+  if (self->begin_cb)
+    {
+      self->begin_cb (widget, value, self->data);
+    }
+}
+
+/**
+ * Updates the value during a drag.
+ *
+ * @param now The current time in seconds.
+ *
+ * @return Whether \ref ZtkGesture.value should be
+ *   written now.
+ */
+int
+ztk_gesture_update (
+  ZtkGesture * self,
+  ZtkWidget *  widget,
+  float        value,
+  double       now)
+{
+  self->value = value;
+  self->pending =
+    !math_floats_equal (value, self->written_value);
+  if (!self->pending ||
+      now - self->last_write_time <
+        self->min_interval)
+    {
+      return 0;
+    }
+
+  self->last_write_time = now;
+  return ztk_gesture_flush (self, widget);
+}
+
+/**
+ * Returns whether there is an unwritten value that
+ * should be written before ending the gesture.
+ */
+int
+ztk_gesture_flush (
+  ZtkGesture * self,
+  ZtkWidget *  widget)
+{
+  if (!self->pending)
+    return 0;
+
+  self->pending = 0;
+  self->written_value = self->value;
+  if (self->change_cb)
+    {
+      self->change_cb (
+        widget, self->value, self->data);
+    }
+
+  return 1;
+}
+
+/**
+ * Ends the gesture, if active.
+ */
+void
+ztk_gesture_end (
+  ZtkGesture * self,
+  ZtkWidget *  widget)
+{
+  if (!self->active)
+    return;
+
+  self->active = 0;
+  if (self->end_cb)
+    {
+      self->end_cb (
+        widget, self->value, self->data);
+    }
+}
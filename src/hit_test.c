@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ztoolkit/ztk.h"
+
+#if defined (__GNUC__) && \
+  (defined (__x86_64__) || defined (__i386__))
+#define HAVE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#if defined (__aarch64__) && defined (__ARM_NEON)
+#define HAVE_NEON_KERNEL
+#include <arm_neon.h>
+#endif
+
+/**
+ * Rectangle edges tested against.
+ */
+typedef struct Edges
+{
+  float x1;
+  float y1;
+  float x2;
+  float y2;
+} Edges;
+
+typedef int (*HitTestFunc) (
+  const ZtkWidgetTable * table,
+  const Edges *          edges,
+  uint8_t *              mask);
+
+static int
+hit_test_scalar (
+  const ZtkWidgetTable * table,
+  const Edges *          e,
+  uint8_t *              mask)
+{
+  int num_hits = 0;
+  int num_bytes = ztk_hit_test_get_mask_size (table);
+  for (int i = 0; i < num_bytes; i++)
+    {
+      unsigned int bits = 0;
+      for (int j = 0; j < 8; j++)
+        {
+          int k = i * 8 + j;
+          unsigned int hit =
+            (unsigned int)
+            (((table->flags[k] &
+                 ZTK_WIDGET_TABLE_VISIBLE) != 0) &
+             (table->x1[k] <= e->x2) &
+             (table->x2[k] >= e->x1) &
+             (table->y1[k] <= e->y2) &
+             (table->y2[k] >= e->y1));
+          bits |= hit << j;
+        }
+      mask[i] = (uint8_t) bits;
+      num_hits += __builtin_popcount (bits);
+    }
+
+  return num_hits;
+}
+
+#ifdef HAVE_X86_KERNELS
+/**
+ * Returns a mask of the 4 widgets at \p k hit.
+ */
+__attribute__ ((target ("sse2")))
+static inline int
+hit_test_sse2_4 (
+  const ZtkWidgetTable * table,
+  int                    k,
+  __m128                 x1,
+  __m128                 y1,
+  __m128                 x2,
+  __m128                 y2)
+{
+  __m128 hit =
+    _mm_and_ps (
+      _mm_and_ps (
+        _mm_cmple_ps (
+          _mm_load_ps (&table->x1[k]), x2),
+        _mm_cmpge_ps (
+          _mm_load_ps (&table->x2[k]), x1)),
+      _mm_and_ps (
+        _mm_cmple_ps (
+          _mm_load_ps (&table->y1[k]), y2),
+        _mm_cmpge_ps (
+          _mm_load_ps (&table->y2[k]), y1)));
+  __m128i flags =
+    _mm_load_si128 (
+      (const __m128i *) &table->flags[k]);
+  __m128i hidden =
+    _mm_cmpeq_epi32 (
+      _mm_and_si128 (
+        flags,
+        _mm_set1_epi32 (
+          (int) ZTK_WIDGET_TABLE_VISIBLE)),
+      _mm_setzero_si128 ());
+
+  return
+    _mm_movemask_ps (
+      _mm_andnot_ps (_mm_castsi128_ps (hidden), hit));
+}
+
+__attribute__ ((target ("sse2")))
+static int
+hit_test_sse2 (
+  const ZtkWidgetTable * table,
+  const Edges *          e,
+  uint8_t *              mask)
+{
+  __m128 x1 = _mm_set1_ps (e->x1);
+  __m128 y1 = _mm_set1_ps (e->y1);
+  __m128 x2 = _mm_set1_ps (e->x2);
+  __m128 y2 = _mm_set1_ps (e->y2);
+
+  int num_hits = 0;
+  int num_bytes = ztk_hit_test_get_mask_size (table);
+  for (int i = 0; i < num_bytes; i++)
+    {
+      unsigned int bits =
+        (unsigned int)
+        (hit_test_sse2_4 (
+           table, i * 8, x1, y1, x2, y2) |
+         hit_test_sse2_4 (
+           table, i * 8 + 4, x1, y1, x2, y2) << 4);
+      mask[i] = (uint8_t) bits;
+      num_hits += __builtin_popcount (bits);
+    }
+
+  return num_hits;
+}
+
+__attribute__ ((target ("avx2")))
+static int
+hit_test_avx2 (
+  const ZtkWidgetTable * table,
+  const Edges *          e,
+  uint8_t *              mask)
+{
+  __m256 x1 = _mm256_set1_ps (e->x1);
+  __m256 y1 = _mm256_set1_ps (e->y1);
+  __m256 x2 = _mm256_set1_ps (e->x2);
+  __m256 y2 = _mm256_set1_ps (e->y2);
+  __m256i visible =
+    _mm256_set1_epi32 (
+      (int) ZTK_WIDGET_TABLE_VISIBLE);
+
+  int num_hits = 0;
+  int num_bytes = ztk_hit_test_get_mask_size (table);
+  for (int i = 0; i < num_bytes; i++)
+    {
+      int k = i * 8;
+      __m256 hit =
+        _mm256_and_ps (
+          _mm256_and_ps (
+            _mm256_cmp_ps (
+              _mm256_load_ps (&table->x1[k]), x2,
+              _CMP_LE_OQ),
+            _mm256_cmp_ps (
+              _mm256_load_ps (&table->x2[k]), x1,
+              _CMP_GE_OQ)),
+          _mm256_and_ps (
+            _mm256_cmp_ps (
+              _mm256_load_ps (&table->y1[k]), y2,
+              _CMP_LE_OQ),
+            _mm256_cmp_ps (
+              _mm256_load_ps (&table->y2[k]), y1,
+              _CMP_GE_OQ)));
+      __m256i flags =
+        _mm256_load_si256 (
+          (const __m256i *) &table->flags[k]);
+      __m256i hidden =
+        _mm256_cmpeq_epi32 (
+          _mm256_and_si256 (flags, visible),
+          _mm256_setzero_si256 ());
+      unsigned int bits =
+        (unsigned int)
+        _mm256_movemask_ps (
+          _mm256_andnot_ps (
+            _mm256_castsi256_ps (hidden), hit));
+      mask[i] = (uint8_t) bits;
+      num_hits += __builtin_popcount (bits);
+    }
+
+  return num_hits;
+}
+#endif
+
+#ifdef HAVE_NEON_KERNEL
+/**
+ * Returns a mask of the 4 widgets at \p k hit.
+ */
+static inline unsigned int
+hit_test_neon_4 (
+  const ZtkWidgetTable * table,
+  int                    k,
+  float32x4_t            x1,
+  float32x4_t            y1,
+  float32x4_t            x2,
+  float32x4_t            y2)
+{
+  static const uint32_t bit_values[4] = {
+    1, 2, 4, 8 };
+  uint32x4_t hit =
+    vandq_u32 (
+      vandq_u32 (
+        vcleq_f32 (vld1q_f32 (&table->x1[k]), x2),
+        vcgeq_f32 (vld1q_f32 (&table->x2[k]), x1)),
+      vandq_u32 (
+        vcleq_f32 (vld1q_f32 (&table->y1[k]), y2),
+        vcgeq_f32 (vld1q_f32 (&table->y2[k]), y1)));
+  hit =
+    vandq_u32 (
+      hit,
+      vtstq_u32 (
+        vld1q_u32 (&table->flags[k]),
+        vdupq_n_u32 (ZTK_WIDGET_TABLE_VISIBLE)));
+
+  return
+    vaddvq_u32 (
+      vandq_u32 (hit, vld1q_u32 (bit_values)));
+}
+
+static int
+hit_test_neon (
+  const ZtkWidgetTable * table,
+  const Edges *          e,
+  uint8_t *              mask)
+{
+  float32x4_t x1 = vdupq_n_f32 (e->x1);
+  float32x4_t y1 = vdupq_n_f32 (e->y1);
+  float32x4_t x2 = vdupq_n_f32 (e->x2);
+  float32x4_t y2 = vdupq_n_f32 (e->y2);
+
+  int num_hits = 0;
+  int num_bytes = ztk_hit_test_get_mask_size (table);
+  for (int i = 0; i < num_bytes; i++)
+    {
+      unsigned int bits =
+        hit_test_neon_4 (
+          table, i * 8, x1, y1, x2, y2) |
+        hit_test_neon_4 (
+          table, i * 8 + 4, x1, y1, x2, y2) << 4;
+      mask[i] = (uint8_t) bits;
+      num_hits += __builtin_popcount (bits);
+    }
+
+  return num_hits;
+}
+#endif
+
+static ZtkHitTestImpl current_impl = ZTK_HIT_TEST_SCALAR;
+static HitTestFunc hit_test_func = NULL;
+
+static HitTestFunc
+get_func (
+  ZtkHitTestImpl impl)
+{
+  switch (impl)
+    {
+#ifdef HAVE_X86_KERNELS
+    case ZTK_HIT_TEST_SSE2:
+      return hit_test_sse2;
+    case ZTK_HIT_TEST_AVX2:
+      return hit_test_avx2;
+#endif
+#ifdef HAVE_NEON_KERNEL
+    case ZTK_HIT_TEST_NEON:
+      return hit_test_neon;
+#endif
+    default:
+      return hit_test_scalar;
+    }
+}
+
+/**
+ * Returns whether the implementation is compiled in
+ * and supported by the CPU.
+ */
+int
+ztk_hit_test_is_impl_supported (
+  ZtkHitTestImpl impl)
+{
+  switch (impl)
+    {
+    case ZTK_HIT_TEST_SCALAR:
+      return 1;
+#ifdef HAVE_X86_KERNELS
+    case ZTK_HIT_TEST_SSE2:
+      __builtin_cpu_init ();
+      return __builtin_cpu_supports ("sse2");
+    case ZTK_HIT_TEST_AVX2:
+      __builtin_cpu_init ();
+      return __builtin_cpu_supports ("avx2");
+#endif
+#ifdef HAVE_NEON_KERNEL
+    case ZTK_HIT_TEST_NEON:
+      return 1;
+#endif
+    default:
+      return 0;
+    }
+}
+
+/**
+ * Sets the implementation used by
+ * ztk_hit_test_batch(), eg, to compare them.
+ *
+ * @return 0 if successful, -1 if the implementation
+ *   is not supported.
+ */
+int
+ztk_hit_test_set_impl (
+  ZtkHitTestImpl impl)
+{
+  if (!ztk_hit_test_is_impl_supported (impl))
+    {
+      ztk_warning (
+        "Hit testing with %s is not supported",
+        ztk_hit_test_impl_to_string (impl));
+      return -1;
+    }
+
+  current_impl = impl;
+  hit_test_func = get_func (impl);
+
+  return 0;
+}
+
+/**
+ * Picks the fastest implementation on first use.
+ */
+static void
+init_impl (void)
+{
+  const ZtkHitTestImpl impls[] = {
+    ZTK_HIT_TEST_AVX2, ZTK_HIT_TEST_SSE2,
+    ZTK_HIT_TEST_NEON, };
+  for (size_t i = 0;
+       i < sizeof (impls) / sizeof (impls[0]); i++)
+    {
+      if (ztk_hit_test_is_impl_supported (impls[i]))
+        {
+          current_impl = impls[i];
+          hit_test_func = get_func (impls[i]);
+          return;
+        }
+    }
+
+  current_impl = ZTK_HIT_TEST_SCALAR;
+  hit_test_func = hit_test_scalar;
+}
+
+/**
+ * Returns the implementation used by
+ * ztk_hit_test_batch(), which is the fastest one
+ * supported by the CPU unless changed with
+ * ztk_hit_test_set_impl().
+ */
+ZtkHitTestImpl
+ztk_hit_test_get_impl (void)
+{
+  if (!hit_test_func)
+    init_impl ();
+
+  return current_impl;
+}
+
+/**
+ * Returns the name of the implementation.
+ */
+const char *
+ztk_hit_test_impl_to_string (
+  ZtkHitTestImpl impl)
+{
+  switch (impl)
+    {
+    case ZTK_HIT_TEST_SCALAR:
+      return "scalar";
+    case ZTK_HIT_TEST_SSE2:
+      return "sse2";
+    case ZTK_HIT_TEST_AVX2:
+      return "avx2";
+    case ZTK_HIT_TEST_NEON:
+      return "neon";
+    default:
+      return "unknown";
+    }
+}
+
+/**
+ * Tests the visible widgets of the table against
+ * the given rectangle, including its edges.
+ *
+ * Points can be tested as rectangles of size 0.
+ *
+ * @param mask Set to a bit mask of the widgets hit,
+ *   the widget at index i being bit i % 8 of byte
+ *   i / 8. Must hold
+ *   ztk_hit_test_get_mask_size() bytes.
+ *
+ * @return The number of widgets hit.
+ */
+int
+ztk_hit_test_batch (
+  const ZtkWidgetTable * table,
+  const ZtkRect *        rect,
+  uint8_t *              mask)
+{
+  if (!hit_test_func)
+    init_impl ();
+
+  Edges edges = {
+    (float) rect->x, (float) rect->y,
+    (float) (rect->x + rect->width),
+    (float) (rect->y + rect->height), };
+
+  return hit_test_func (table, &edges, mask);
+}
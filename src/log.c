@@ -17,13 +17,34 @@
  * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <limits.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
+
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
 #include <sys/time.h>
+#endif
+
+#if defined (_WIN32)
+typedef HANDLE WakeSem;
+#elif defined (__APPLE__)
+#include <dispatch/dispatch.h>
+typedef dispatch_semaphore_t WakeSem;
+#else
+#include <semaphore.h>
+typedef sem_t WakeSem;
+#endif
 
 #include <ztoolkit/log.h>
+#include <ztoolkit/stats.h>
 
 /* ANSI color codes */
 #define COLOR_RED     "\x1b[31m"
@@ -36,26 +57,363 @@
 
 #define BOLD "\x1b[1m"
 
+/**
+ * A message in the ring.
+ */
+typedef struct LogSlot
+{
+  /** Sequence number, equal to the position being
+   * written to for a free slot and to the position
+   * + 1 once the message is published. */
+  atomic_uint       seq;
+
+  ZtkLogLevel       level;
+  const char *      func;
+
+  /** Monotonic time of the call, in seconds. */
+  double            time;
+
+  char              msg[ZTK_LOG_MESSAGE_SIZE];
+} LogSlot;
+
+/**
+ * Asynchronous backend: a bounded multi-producer,
+ * single-consumer queue drained by a writer
+ * thread.
+ */
+typedef struct AsyncLog
+{
+  LogSlot *         slots;
+  unsigned int      mask;
+
+  /** Next position to write to, shared by the
+   * producers. */
+  atomic_uint       write_idx;
+
+  /** Next position to read from, only used by the
+   * writer thread. */
+  unsigned int      read_idx;
+
+  /** Messages dropped because the ring was full. */
+  atomic_uint       num_dropped;
+
+  atomic_int        running;
+  pthread_t         thread;
+
+  /** Posted for each published message and on
+   * stop, so the writer thread only wakes up
+   * when there is something to do. */
+  WakeSem           wake;
+
+  /** Number of ztk_log() calls using the ring,
+   * so that it is only freed once they are done. */
+  atomic_int        num_writers;
+
+  /** Number of ztk_log_start_async() calls not
+   * matched by ztk_log_stop_async(), guarded by
+   * \ref users_lock. */
+  int               num_users;
+
+  /** Wall clock time at the monotonic time
+   * \ref AsyncLog.start_time, for printing. */
+  double            start_wall_time;
+  double            start_time;
+} AsyncLog;
+
 static ZtkLogLevel ztk_log_level =
   ZTK_LOG_LEVEL_WARNING;
 
+/** Ring in use, or NULL when logging
+ * synchronously. */
+static _Atomic (AsyncLog *) async_log = NULL;
+
+static AsyncLog async_log_storage;
+
+/** Serializes starting and stopping the backend,
+ * which apps on different threads may do. */
+static pthread_mutex_t users_lock =
+  PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Returns the wall clock time in seconds.
+ */
+static double
+get_wall_time (void)
+{
+  struct timeval cur_time;
+  gettimeofday (&cur_time, NULL);
+
+  return
+    (double) cur_time.tv_sec +
+    (double) cur_time.tv_usec * 1e-6;
+}
+
 /**
- * Fills in the timestamp as a string into \ref buf.
+ * Fills in the given wall clock time as a string
+ * into \ref buf.
  */
 static void
 get_timestamp (
-  char * buf)
+  double wall_time,
+  char * buf,
+  size_t size)
 {
-  struct timeval curTime;
-  gettimeofday(&curTime, NULL);
-  int milli = curTime.tv_usec / 1000;
+  time_t secs = (time_t) wall_time;
+  int milli =
+    (int) ((wall_time - (double) secs) * 1000.0);
 
-  char buffer [80];
-  strftime (
-    buffer, 80, "%H:%M:%S",
-    localtime (&curTime.tv_sec));
+  struct tm tm;
+#ifdef _WIN32
+  localtime_s (&tm, &secs);
+#else
+  localtime_r (&secs, &tm);
+#endif
+  char buffer[80];
+  strftime (buffer, sizeof (buffer), "%H:%M:%S", &tm);
 
-  sprintf(buf, "%s:%03d", buffer, milli);
+  snprintf (buf, size, "%s:%03d", buffer, milli);
+}
+
+static const char *
+get_level_prefix (
+  ZtkLogLevel level)
+{
+  switch (level)
+    {
+    case ZTK_LOG_LEVEL_DEBUG:
+      return BOLD COLOR_CYAN "DEBUG ";
+    case ZTK_LOG_LEVEL_MESSAGE:
+      return BOLD COLOR_GREEN "MESSAGE ";
+    case ZTK_LOG_LEVEL_WARNING:
+      return BOLD COLOR_YELLOW "WARNING ";
+    case ZTK_LOG_LEVEL_ERROR:
+      return BOLD COLOR_RED "ERROR ";
+    default:
+      break;
+    }
+
+  return "";
+}
+
+/**
+ * Writes a formatted message to stderr.
+ */
+static void
+write_message (
+  ZtkLogLevel  level,
+  const char * func,
+  double       wall_time,
+  const char * msg)
+{
+  char cur_time[100];
+  get_timestamp (wall_time, cur_time, sizeof (cur_time));
+  fprintf (
+    stderr, "** %s(%s)" COLOR_RESET ": %s: %s\n",
+    get_level_prefix (level), func, cur_time, msg);
+}
+
+/**
+ * Writes the published messages. Only to be called
+ * by the writer thread, or after it stopped.
+ *
+ * @return The number of messages written.
+ */
+static int
+drain (
+  AsyncLog * self)
+{
+  int num_written = 0;
+  for (;;)
+    {
+      LogSlot * slot =
+        &self->slots[self->read_idx & self->mask];
+      unsigned int seq =
+        atomic_load_explicit (
+          &slot->seq, memory_order_acquire);
+      if (seq != self->read_idx + 1)
+        break;
+
+      write_message (
+        slot->level, slot->func,
+        self->start_wall_time +
+          (slot->time - self->start_time),
+        slot->msg);
+      num_written++;
+
+      /* free the slot for the next lap */
+      atomic_store_explicit (
+        &slot->seq, self->read_idx + self->mask + 1,
+        memory_order_release);
+      self->read_idx++;
+    }
+
+  unsigned int num_dropped =
+    atomic_exchange_explicit (
+      &self->num_dropped, 0, memory_order_relaxed);
+  if (num_dropped)
+    {
+      char msg[100];
+      snprintf (
+        msg, sizeof (msg),
+        "%u log messages were dropped", num_dropped);
+      write_message (
+        ZTK_LOG_LEVEL_WARNING, __func__,
+        get_wall_time (), msg);
+    }
+
+  if (num_written)
+    fflush (stderr);
+
+  return num_written;
+}
+
+static void
+sleep_ms (
+  int ms)
+{
+#ifdef _WIN32
+  Sleep ((DWORD) ms);
+#else
+  struct timespec ts = { 0, ms * 1000000L };
+  nanosleep (&ts, NULL);
+#endif
+}
+
+static int
+wake_sem_init (
+  WakeSem * sem)
+{
+#if defined (_WIN32)
+  *sem = CreateSemaphore (NULL, 0, LONG_MAX, NULL);
+  return *sem ? 0 : -1;
+#elif defined (__APPLE__)
+  *sem = dispatch_semaphore_create (0);
+  return *sem ? 0 : -1;
+#else
+  return sem_init (sem, 0, 0);
+#endif
+}
+
+/**
+ * Wakes up the writer thread. Does not block, so
+ * it can be called from real-time threads.
+ */
+static void
+wake_sem_post (
+  WakeSem * sem)
+{
+#if defined (_WIN32)
+  ReleaseSemaphore (*sem, 1, NULL);
+#elif defined (__APPLE__)
+  dispatch_semaphore_signal (*sem);
+#else
+  sem_post (sem);
+#endif
+}
+
+static void
+wake_sem_wait (
+  WakeSem * sem)
+{
+#if defined (_WIN32)
+  WaitForSingleObject (*sem, INFINITE);
+#elif defined (__APPLE__)
+  dispatch_semaphore_wait (
+    *sem, DISPATCH_TIME_FOREVER);
+#else
+  while (sem_wait (sem) != 0)
+    continue;
+#endif
+}
+
+static void
+wake_sem_destroy (
+  WakeSem * sem)
+{
+#if defined (_WIN32)
+  CloseHandle (*sem);
+#elif defined (__APPLE__)
+  dispatch_release (*sem);
+#else
+  sem_destroy (sem);
+#endif
+}
+
+static void *
+writer_thread (
+  void * data)
+{
+  AsyncLog * self = (AsyncLog *) data;
+  while (atomic_load_explicit (
+           &self->running, memory_order_acquire))
+    {
+      /* several posts may be consumed by one
+       * drain, so some wakeups find nothing */
+      wake_sem_wait (&self->wake);
+      drain (self);
+    }
+
+  return NULL;
+}
+
+/**
+ * Adds a message to the ring without blocking.
+ */
+static void
+push_message (
+  AsyncLog *   self,
+  const char * func,
+  ZtkLogLevel  level,
+  const char * format,
+  va_list      args)
+{
+  unsigned int pos =
+    atomic_load_explicit (
+      &self->write_idx, memory_order_relaxed);
+  LogSlot * slot;
+  for (;;)
+    {
+      slot = &self->slots[pos & self->mask];
+      unsigned int seq =
+        atomic_load_explicit (
+          &slot->seq, memory_order_acquire);
+      int diff = (int) (seq - pos);
+      if (diff == 0)
+        {
+          /* claim the slot */
+          if (atomic_compare_exchange_weak_explicit (
+                &self->write_idx, &pos, pos + 1,
+                memory_order_relaxed,
+                memory_order_relaxed))
+            break;
+        }
+      else if (diff < 0)
+        {
+          /* full */
+          atomic_fetch_add_explicit (
+            &self->num_dropped, 1,
+            memory_order_relaxed);
+          return;
+        }
+      else
+        {
+          pos =
+            atomic_load_explicit (
+              &self->write_idx,
+              memory_order_relaxed);
+        }
+    }
+
+  slot->level = level;
+  slot->func = func;
+  slot->time = ztk_stats_get_time ();
+  vsnprintf (slot->msg, sizeof (slot->msg), format, args);
+
+  /* publish the message */
+  atomic_store_explicit (
+    &slot->seq, pos + 1, memory_order_release);
+
+  wake_sem_post (&self->wake);
 }
 
 /**
@@ -68,6 +426,126 @@ ztk_log_set_level (
   ztk_log_level = level;
 }
 
+/**
+ * Starts writing log messages from a background
+ * thread.
+ *
+ * Once started, ztk_log() only formats the message
+ * into a preallocated lock-free ring, so it can be
+ * called from any thread, including real-time
+ * ones, without blocking. Messages that don't fit
+ * in the ring are dropped and counted.
+ *
+ * Calls are counted, and the backend keeps running
+ * until ztk_log_stop_async() was called as many
+ * times, which must happen before the process
+ * exits or the library is unloaded, or pending
+ * messages are lost. Apps only start it when the
+ * ZTK_ASYNC_LOG environment variable is set.
+ *
+ * @param num_messages Number of messages the ring
+ *   can hold.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_log_start_async (
+  int num_messages)
+{
+  AsyncLog * self = &async_log_storage;
+  pthread_mutex_lock (&users_lock);
+  if (self->num_users > 0)
+    {
+      self->num_users++;
+      pthread_mutex_unlock (&users_lock);
+      return 0;
+    }
+
+  unsigned int capacity = 2;
+  while (capacity < (unsigned int) num_messages)
+    capacity *= 2;
+  self->slots = calloc (capacity, sizeof (LogSlot));
+  self->mask = capacity - 1;
+  for (unsigned int i = 0; i < capacity; i++)
+    {
+      atomic_init (&self->slots[i].seq, i);
+    }
+  atomic_init (&self->write_idx, 0);
+  self->read_idx = 0;
+  atomic_init (&self->num_dropped, 0);
+  atomic_init (&self->running, 1);
+  self->start_time = ztk_stats_get_time ();
+  self->start_wall_time = get_wall_time ();
+
+  if (wake_sem_init (&self->wake))
+    {
+      free (self->slots);
+      self->slots = NULL;
+      pthread_mutex_unlock (&users_lock);
+      ztk_warning (
+        "%s", "Failed to create the log semaphore");
+      return -1;
+    }
+
+  if (pthread_create (
+        &self->thread, NULL, writer_thread, self))
+    {
+      wake_sem_destroy (&self->wake);
+      free (self->slots);
+      self->slots = NULL;
+      pthread_mutex_unlock (&users_lock);
+      ztk_warning (
+        "%s", "Failed to start the log thread");
+      return -1;
+    }
+
+  self->num_users = 1;
+  atomic_store_explicit (
+    &async_log, self, memory_order_release);
+  pthread_mutex_unlock (&users_lock);
+
+  return 0;
+}
+
+/**
+ * Writes the pending messages and stops the
+ * background thread if this was the last user.
+ */
+void
+ztk_log_stop_async (void)
+{
+  AsyncLog * self = &async_log_storage;
+  pthread_mutex_lock (&users_lock);
+  if (self->num_users == 0 ||
+      --self->num_users > 0)
+    {
+      pthread_mutex_unlock (&users_lock);
+      return;
+    }
+
+  /* new messages are written synchronously from
+   * now on, wait for the ones being added */
+  atomic_store_explicit (
+    &async_log, NULL, memory_order_seq_cst);
+  while (atomic_load_explicit (
+           &self->num_writers, memory_order_seq_cst))
+    sleep_ms (1);
+
+  atomic_store_explicit (
+    &self->running, 0, memory_order_release);
+  wake_sem_post (&self->wake);
+  pthread_join (self->thread, NULL);
+  wake_sem_destroy (&self->wake);
+
+  /* messages published after the thread's last
+   * pass */
+  drain (self);
+
+  free (self->slots);
+  self->slots = NULL;
+  pthread_mutex_unlock (&users_lock);
+}
+
 /**
  * Logs a message.
  *
@@ -85,49 +563,28 @@ ztk_log (
   if (level < ztk_log_level)
     return;
 
-  va_list arg;
-
-  char buf[6000] = "** ";
+  va_list args;
+  va_start (args, format);
 
-  switch (level)
+  AsyncLog * storage = &async_log_storage;
+  atomic_fetch_add_explicit (
+    &storage->num_writers, 1, memory_order_seq_cst);
+  AsyncLog * async =
+    atomic_load_explicit (
+      &async_log, memory_order_seq_cst);
+  if (async)
     {
-    case ZTK_LOG_LEVEL_DEBUG:
-      strcat ( buf, BOLD COLOR_CYAN "DEBUG ");
-      break;
-    case ZTK_LOG_LEVEL_MESSAGE:
-      strcat (
-        buf, BOLD COLOR_GREEN "MESSAGE ");
-      break;
-    case ZTK_LOG_LEVEL_WARNING:
-      strcat (
-        buf, BOLD COLOR_YELLOW "WARNING ");
-      break;
-    case ZTK_LOG_LEVEL_ERROR:
-      strcat (
-        buf, BOLD COLOR_RED "ERROR ");
-      break;
-    default:
-      break;
+      push_message (async, func, level, format, args);
     }
+  else
+    {
+      char msg[ZTK_LOG_MESSAGE_SIZE];
+      vsnprintf (msg, sizeof (msg), format, args);
+      write_message (
+        level, func, get_wall_time (), msg);
+    }
+  atomic_fetch_sub_explicit (
+    &storage->num_writers, 1, memory_order_release);
 
-  /* print the function name */
-  char func_part[600];
-  sprintf (func_part, "(%s)" COLOR_RESET ": ", func);
-  strcat (buf, func_part);
-
-  /* get current time as string*/
-  char cur_time[200];
-  get_timestamp (cur_time);
-
-  strcat (buf, cur_time);
-  strcat (buf, ": ");
-
-  /* format message */
-  char log_msg[6000];
-  va_start (arg, format);
-  vsprintf (log_msg, format, arg);
-  va_end (arg);
-
-  strcat (buf, log_msg);
-  fprintf (stderr, "%s\n", buf);
+  va_end (args);
 }
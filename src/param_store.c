@@ -0,0 +1,457 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ztoolkit/ztk.h"
+
+static void
+ring_init (
+  ZtkParamRing * self,
+  int            size)
+{
+  uint32_t capacity = 2;
+  while (capacity < (uint32_t) size)
+    capacity *= 2;
+
+  self->events =
+    calloc (capacity, sizeof (ZtkParamEvent));
+  self->mask = capacity - 1;
+  atomic_init (&self->read_idx, 0);
+  atomic_init (&self->write_idx, 0);
+}
+
+/**
+ * Writes an event. Only to be called by the
+ * producer.
+ */
+static int
+ring_write (
+  ZtkParamRing * self,
+  uint32_t       id,
+  float          value)
+{
+  unsigned int write_idx =
+    atomic_load_explicit (
+      &self->write_idx, memory_order_relaxed);
+  unsigned int read_idx =
+    atomic_load_explicit (
+      &self->read_idx, memory_order_acquire);
+  if (write_idx - read_idx > self->mask)
+    return -1;
+
+  ZtkParamEvent * ev =
+    &self->events[write_idx & self->mask];
+  ev->id = id;
+  ev->value = value;
+
+  /* publish the event */
+  atomic_store_explicit (
+    &self->write_idx, write_idx + 1,
+    memory_order_release);
+
+  return 0;
+}
+
+/**
+ * Reads an event. Only to be called by the
+ * consumer.
+ */
+static int
+ring_read (
+  ZtkParamRing *  self,
+  ZtkParamEvent * ev)
+{
+  unsigned int read_idx =
+    atomic_load_explicit (
+      &self->read_idx, memory_order_relaxed);
+  unsigned int write_idx =
+    atomic_load_explicit (
+      &self->write_idx, memory_order_acquire);
+  if (read_idx == write_idx)
+    return 0;
+
+  *ev = self->events[read_idx & self->mask];
+
+  /* release the slot */
+  atomic_store_explicit (
+    &self->read_idx, read_idx + 1,
+    memory_order_release);
+
+  return 1;
+}
+
+/**
+ * Queues a redraw of the widgets bound to the
+ * given parameter and marks its value as
+ * rendered.
+ */
+static void
+invalidate_param (
+  ZtkParamStore * self,
+  int             id)
+{
+  ZtkParam * param = &self->params[id];
+  for (int i = 0; i < param->num_widgets; i++)
+    {
+      ztk_widget_queue_draw (param->widgets[i]);
+    }
+  self->rendered[id] = self->values[id];
+}
+
+/**
+ * Compares the live values against the rendered
+ * ones 4 at a time and invalidates the parameters
+ * that differ.
+ *
+ * Values are compared bitwise so that NaNs don't
+ * cause a redraw on every frame.
+ *
+ * @return The number of parameters that changed.
+ */
+static int
+invalidate_changed (
+  ZtkParamStore * self)
+{
+  int num_changed = 0;
+  for (int i = 0; i < self->values_size; i += 4)
+    {
+      int mask = 0;
+#ifdef __SSE2__
+      __m128i values =
+        _mm_loadu_si128 (
+          (const __m128i *) &self->values[i]);
+      __m128i rendered =
+        _mm_loadu_si128 (
+          (const __m128i *) &self->rendered[i]);
+      mask =
+        ~_mm_movemask_ps (
+          _mm_castsi128_ps (
+            _mm_cmpeq_epi32 (values, rendered))) &
+        0xf;
+#else
+      for (int j = 0; j < 4; j++)
+        {
+          if (memcmp (
+                &self->values[i + j],
+                &self->rendered[i + j],
+                sizeof (float)))
+            mask |= 1 << j;
+        }
+#endif
+      /* common case: nothing changed */
+      if (!mask)
+        continue;
+
+      for (int j = 0; j < 4; j++)
+        {
+          if (mask & (1 << j))
+            {
+              invalidate_param (self, i + j);
+              num_changed++;
+            }
+        }
+    }
+
+  return num_changed;
+}
+
+/**
+ * Creates a new parameter store.
+ *
+ * @param num_params Number of parameters. IDs are
+ *   0 to num_params - 1.
+ * @param queue_size Minimum number of changes each
+ *   ring can hold before writes fail.
+ */
+ZtkParamStore *
+ztk_param_store_new (
+  int num_params,
+  int queue_size)
+{
+  ZtkParamStore * self =
+    calloc (1, sizeof (ZtkParamStore));
+
+  self->num_params = num_params;
+  self->params =
+    calloc ((size_t) num_params + 1, sizeof (ZtkParam));
+
+  /* pad to whole vectors so that the comparison
+   * needs no scalar tail; the padding stays 0 */
+  self->values_size = (num_params + 3) & ~3;
+  self->values =
+    calloc (
+      (size_t) self->values_size, sizeof (float));
+  self->rendered =
+    calloc (
+      (size_t) self->values_size, sizeof (float));
+
+  ring_init (&self->to_ui, queue_size);
+  ring_init (&self->to_dsp, queue_size);
+
+  return self;
+}
+
+/**
+ * Binds a widget to the given parameter so that it
+ * is redrawn when the parameter changes.
+ *
+ * To be called from the UI thread.
+ */
+void
+ztk_param_store_bind_widget (
+  ZtkParamStore * self,
+  uint32_t        id,
+  ZtkWidget *     widget)
+{
+  if (id >= (uint32_t) self->num_params)
+    {
+      ztk_warning (
+        "Invalid parameter ID %u", id);
+      return;
+    }
+
+  ZtkParam * param = &self->params[id];
+  if (param->num_widgets == param->widgets_size)
+    {
+      param->widgets_size =
+        param->widgets_size ?
+          param->widgets_size * 2 : 2;
+      param->widgets =
+        (ZtkWidget **)
+        realloc (
+          param->widgets,
+          (size_t) param->widgets_size *
+            sizeof (ZtkWidget *));
+    }
+  param->widgets[param->num_widgets++] = widget;
+}
+
+/**
+ * Unbinds a widget from all parameters.
+ */
+void
+ztk_param_store_unbind_widget (
+  ZtkParamStore * self,
+  ZtkWidget *     widget)
+{
+  for (int i = 0; i < self->num_params; i++)
+    {
+      ZtkParam * param = &self->params[i];
+      for (int j = param->num_widgets - 1; j >= 0;
+           j--)
+        {
+          if (param->widgets[j] != widget)
+            continue;
+
+          for (int k = j; k < param->num_widgets - 1;
+               k++)
+            {
+              param->widgets[k] =
+                param->widgets[k + 1];
+            }
+          param->num_widgets--;
+        }
+    }
+}
+
+/**
+ * Returns the current value of a parameter.
+ *
+ * To be called from the UI thread.
+ */
+float
+ztk_param_store_get (
+  ZtkParamStore * self,
+  uint32_t        id)
+{
+  if (id >= (uint32_t) self->num_params)
+    return 0.f;
+
+  return self->values[id];
+}
+
+/**
+ * Sets a parameter from the UI and sends it to the
+ * DSP thread.
+ *
+ * @return 0 if successful, non-zero if the queue
+ *   to the DSP thread is full (the UI value is still
+ *   updated).
+ */
+int
+ztk_param_store_set (
+  ZtkParamStore * self,
+  uint32_t        id,
+  float           value)
+{
+  if (id >= (uint32_t) self->num_params)
+    return -1;
+
+  if (math_floats_equal (self->values[id], value))
+    return 0;
+
+  /* other widgets may show the same parameter */
+  self->values[id] = value;
+  invalidate_param (self, (int) id);
+
+  return ring_write (&self->to_dsp, id, value);
+}
+
+/**
+ * Updates parameters from values delivered on the
+ * UI thread, such as LV2 port events.
+ *
+ * The values are not sent to the DSP thread, and
+ * the widgets are redrawn on the next drain.
+ *
+ * @param ids Parameter IDs, or NULL to write
+ *   \p num_values contiguous values starting at
+ *   ID 0.
+ */
+void
+ztk_param_store_port_events (
+  ZtkParamStore *  self,
+  const uint32_t * ids,
+  const float *    values,
+  int              num_values)
+{
+  if (!ids)
+    {
+      if (num_values > self->num_params)
+        num_values = self->num_params;
+      memcpy (
+        self->values, values,
+        (size_t) num_values * sizeof (float));
+      return;
+    }
+
+  for (int i = 0; i < num_values; i++)
+    {
+      if (ids[i] >= (uint32_t) self->num_params)
+        continue;
+
+      self->values[ids[i]] = values[i];
+    }
+}
+
+/**
+ * Convenience wrapper over
+ * ztk_param_store_port_events() for a single
+ * value.
+ */
+void
+ztk_param_store_port_event (
+  ZtkParamStore * self,
+  uint32_t        id,
+  float           value)
+{
+  ztk_param_store_port_events (
+    self, &id, &value, 1);
+}
+
+/**
+ * Applies the changes sent by the DSP thread and
+ * queues a redraw of the affected widgets.
+ *
+ * To be called from the UI thread once per frame.
+ *
+ * @return The number of parameters that changed.
+ */
+int
+ztk_param_store_drain (
+  ZtkParamStore * self)
+{
+  /* only the latest value of each parameter
+   * matters, so just overwrite */
+  ZtkParamEvent ev;
+  while (ring_read (&self->to_ui, &ev))
+    {
+      if (ev.id >= (uint32_t) self->num_params)
+        continue;
+
+      self->values[ev.id] = ev.value;
+    }
+
+  return invalidate_changed (self);
+}
+
+/**
+ * Sends a value to the UI.
+ *
+ * Real-time safe. To be called from the DSP
+ * thread only.
+ *
+ * @return 0 if successful, non-zero if the queue
+ *   is full.
+ */
+int
+ztk_param_store_write_from_dsp (
+  ZtkParamStore * self,
+  uint32_t        id,
+  float           value)
+{
+  return ring_write (&self->to_ui, id, value);
+}
+
+/**
+ * Reads the next value sent by the UI.
+ *
+ * Real-time safe. To be called from the DSP
+ * thread only.
+ *
+ * @return 1 if a change was read into \p id and
+ *   \p value, 0 if there are none.
+ */
+int
+ztk_param_store_read_from_ui (
+  ZtkParamStore * self,
+  uint32_t *      id,
+  float *         value)
+{
+  ZtkParamEvent ev;
+  if (!ring_read (&self->to_dsp, &ev))
+    return 0;
+
+  *id = ev.id;
+  *value = ev.value;
+
+  return 1;
+}
+
+void
+ztk_param_store_free (
+  ZtkParamStore * self)
+{
+  for (int i = 0; i < self->num_params; i++)
+    {
+      free (self->params[i].widgets);
+    }
+  free (self->params);
+  free (self->values);
+  free (self->rendered);
+  free (self->to_ui.events);
+  free (self->to_dsp.events);
+  free (self);
+}
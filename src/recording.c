@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ztoolkit/ztk.h"
+
+/**
+ * Returns the size of the event struct of the
+ * given type, or 0 if the type is unknown.
+ */
+static size_t
+get_event_size (
+  PuglEventType type)
+{
+  switch (type)
+    {
+    case PUGL_BUTTON_PRESS:
+    case PUGL_BUTTON_RELEASE:
+      return sizeof (PuglEventButton);
+    case PUGL_CONFIGURE:
+      return sizeof (PuglEventConfigure);
+    case PUGL_EXPOSE:
+      return sizeof (PuglEventExpose);
+    case PUGL_CLOSE:
+      return sizeof (PuglEventClose);
+    case PUGL_KEY_PRESS:
+    case PUGL_KEY_RELEASE:
+      return sizeof (PuglEventKey);
+    case PUGL_TEXT:
+      return sizeof (PuglEventText);
+    case PUGL_ENTER_NOTIFY:
+    case PUGL_LEAVE_NOTIFY:
+      return sizeof (PuglEventCrossing);
+    case PUGL_MOTION_NOTIFY:
+      return sizeof (PuglEventMotion);
+    case PUGL_SCROLL:
+      return sizeof (PuglEventScroll);
+    case PUGL_FOCUS_IN:
+    case PUGL_FOCUS_OUT:
+      return sizeof (PuglEventFocus);
+    default:
+      break;
+    }
+
+  return 0;
+}
+
+/**
+ * Creates a recording at the given path,
+ * overwriting any existing file.
+ *
+ * @return The recorder, or NULL if the file could
+ *   not be written.
+ */
+ZtkRecorder *
+ztk_recorder_new (
+  const char * path,
+  int          width,
+  int          height)
+{
+  FILE * file = fopen (path, "wb");
+  if (!file)
+    {
+      ztk_warning (
+        "Failed to open %s for recording", path);
+      return NULL;
+    }
+
+  uint16_t version = ZTK_RECORDING_VERSION;
+  int32_t size[2] = { width, height };
+  fwrite (
+    ZTK_RECORDING_MAGIC, 1,
+    strlen (ZTK_RECORDING_MAGIC), file);
+  fwrite (&version, sizeof (version), 1, file);
+  fwrite (size, sizeof (size), 1, file);
+
+  ZtkRecorder * self =
+    calloc (1, sizeof (ZtkRecorder));
+  self->file = file;
+
+  return self;
+}
+
+/**
+ * Appends an event to the recording.
+ *
+ * @param time Current time in seconds, in any
+ *   monotonic clock.
+ */
+void
+ztk_recorder_write (
+  ZtkRecorder *     self,
+  double            time,
+  const PuglEvent * event)
+{
+  size_t size = get_event_size (event->type);
+  if (!size)
+    return;
+
+  if (!self->started)
+    {
+      self->start_time = time;
+      self->started = 1;
+    }
+
+  double rel_time = time - self->start_time;
+  uint8_t type = (uint8_t) event->type;
+  fwrite (&rel_time, sizeof (rel_time), 1, self->file);
+  fwrite (&type, sizeof (type), 1, self->file);
+  fwrite (event, size, 1, self->file);
+}
+
+/**
+ * Closes the recording.
+ */
+void
+ztk_recorder_free (
+  ZtkRecorder * self)
+{
+  fclose (self->file);
+  free (self);
+}
+
+/**
+ * Opens a recording for reading.
+ *
+ * @return The recording, or NULL if the file could
+ *   not be read or is not a recording.
+ */
+ZtkRecording *
+ztk_recording_open (
+  const char * path)
+{
+  FILE * file = fopen (path, "rb");
+  if (!file)
+    {
+      ztk_warning ("Failed to open %s", path);
+      return NULL;
+    }
+
+  char magic[sizeof (ZTK_RECORDING_MAGIC)] = { 0 };
+  uint16_t version = 0;
+  int32_t size[2];
+  if (fread (
+        magic, 1, strlen (ZTK_RECORDING_MAGIC),
+        file) != strlen (ZTK_RECORDING_MAGIC) ||
+      strcmp (magic, ZTK_RECORDING_MAGIC) ||
+      fread (&version, sizeof (version), 1, file) != 1 ||
+      version != ZTK_RECORDING_VERSION ||
+      fread (size, sizeof (size), 1, file) != 1)
+    {
+      ztk_warning ("%s is not a recording", path);
+      fclose (file);
+      return NULL;
+    }
+
+  ZtkRecording * self =
+    calloc (1, sizeof (ZtkRecording));
+  self->file = file;
+  self->width = size[0];
+  self->height = size[1];
+
+  return self;
+}
+
+/**
+ * Reads the next event.
+ *
+ * @return 1 if an event was read into \p time and
+ *   \p event, 0 at the end of the recording.
+ */
+int
+ztk_recording_read_event (
+  ZtkRecording * self,
+  double *       time,
+  PuglEvent *    event)
+{
+  uint8_t type;
+  if (fread (time, sizeof (double), 1, self->file) != 1 ||
+      fread (&type, sizeof (type), 1, self->file) != 1)
+    return 0;
+
+  size_t size = get_event_size ((PuglEventType) type);
+  memset (event, 0, sizeof (PuglEvent));
+  if (!size ||
+      fread (event, size, 1, self->file) != 1)
+    {
+      ztk_warning (
+        "%s", "Truncated or invalid recording");
+      return 0;
+    }
+
+  return 1;
+}
+
+void
+ztk_recording_close (
+  ZtkRecording * self)
+{
+  fclose (self->file);
+  free (self);
+}
+
+static int
+cmp_double (
+  const void * a,
+  const void * b)
+{
+  double da = *(const double *) a;
+  double db = *(const double *) b;
+
+  return (da > db) - (da < db);
+}
+
+/**
+ * Prints the median, 99th percentile and maximum
+ * of the given times as a JSON object, in
+ * milliseconds.
+ *
+ * @param times Times in seconds. They will be
+ *   sorted.
+ */
+static void
+print_times (
+  FILE *       file,
+  const char * name,
+  double *     times,
+  int          num_times)
+{
+  double median = 0.0, p99 = 0.0, max = 0.0;
+  if (num_times > 0)
+    {
+      qsort (
+        times, (size_t) num_times, sizeof (double),
+        cmp_double);
+      median = times[num_times / 2];
+      p99 = times[num_times * 99 / 100];
+      max = times[num_times - 1];
+    }
+  fprintf (
+    file,
+    "  \"%s\": { \"median_ms\": %.3f, "
+    "\"p99_ms\": %.3f, \"max_ms\": %.3f },\n",
+    name, median * 1e3, p99 * 1e3, max * 1e3);
+}
+
+/**
+ * Prints a summary of the report as JSON.
+ */
+void
+ztk_replay_report_print (
+  ZtkReplayReport * self,
+  FILE *            file)
+{
+  double * times =
+    calloc (
+      (size_t) self->num_frames + 1, sizeof (double));
+
+  fprintf (
+    file,
+    "{\n  \"events\": %d,\n  \"frames\": %d,\n"
+    "  \"redraws\": %d,\n",
+    self->num_events, self->num_frames,
+    self->num_redraws);
+
+  for (int i = 0; i < self->num_frames; i++)
+    {
+      ZtkReplayFrame * frame = &self->frames[i];
+      times[i] =
+        frame->dispatch_time + frame->draw_time;
+    }
+  print_times (
+    file, "frame_time", times, self->num_frames);
+  for (int i = 0; i < self->num_frames; i++)
+    {
+      times[i] = self->frames[i].dispatch_time;
+    }
+  print_times (
+    file, "dispatch_time", times, self->num_frames);
+  for (int i = 0; i < self->num_frames; i++)
+    {
+      times[i] = self->frames[i].draw_time;
+    }
+  print_times (
+    file, "draw_time", times, self->num_frames);
+
+  fprintf (
+    file, "  \"dispatch_us_per_event\": %.3f\n}\n",
+    self->num_events ?
+      self->dispatch_time * 1e6 / self->num_events :
+      0.0);
+
+  free (times);
+}
+
+/**
+ * Frees the frames of the report.
+ */
+void
+ztk_replay_report_clear (
+  ZtkReplayReport * self)
+{
+  free (self->frames);
+  memset (self, 0, sizeof (ZtkReplayReport));
+}
@@ -46,3 +46,21 @@ ztk_rect_copy (
   dest->width = src->width;
   dest->height = src->height;
 }
+
+/**
+ * Returns whether \p self fully contains
+ * \p other.
+ */
+int
+ztk_rect_contains (
+  ZtkRect * self,
+  ZtkRect * other)
+{
+  return
+    other->x >= self->x &&
+    other->y >= self->y &&
+    other->x + other->width <=
+      self->x + self->width &&
+    other->y + other->height <=
+      self->y + self->height;
+}
@@ -0,0 +1,948 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ztoolkit_config.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <ztoolkit/asset_pack.h>
+#include <ztoolkit/log.h>
+#include <ztoolkit/resource_cache.h>
+
+typedef enum ResourceType
+{
+  RESOURCE_SURFACE,
+  RESOURCE_FONT_FACE,
+  RESOURCE_SVG,
+  RESOURCE_ASSET_PACK,
+  RESOURCE_PNG,
+} ResourceType;
+
+typedef struct Resource
+{
+  ResourceType      type;
+
+  /** Key, eg, the path of an SVG. */
+  char *            key;
+
+  /** Hash of the contents for SVGs, or of the SVG
+   * for surfaces rendered from one or decoded
+   * PNGs, or of the modification time and size of
+   * asset packs. */
+  uint64_t          content_hash;
+
+  /** Size of surfaces, or slant and weight of
+   * font faces. */
+  int               width;
+  int               height;
+
+  /** The resource itself. */
+  void *            data;
+
+  int               refcount;
+
+  /** Approximate size in bytes. */
+  size_t            size;
+
+  /** Value of \ref last_release_serial when it was
+   * last released, to evict the oldest first. */
+  uint64_t          release_serial;
+
+  /** Hash of the type, key, content hash and
+   * size. */
+  uint64_t          key_hash;
+
+  /** Next resource in the same bucket of
+   * \ref key_buckets. */
+  struct Resource * next_by_key;
+
+  /** Next resource in the same bucket of
+   * \ref data_buckets. */
+  struct Resource * next_by_data;
+
+  /** Held while an SVG is rendered, since a handle
+   * must not be rendered on two threads at once. */
+  pthread_mutex_t   render_lock;
+} Resource;
+
+static pthread_mutex_t lock =
+  PTHREAD_MUTEX_INITIALIZER;
+
+static Resource ** resources = NULL;
+static int num_resources = 0;
+static int resources_size = 0;
+
+/** Total size of the resources not in use. */
+static size_t unused_bytes = 0;
+
+static uint64_t last_release_serial = 0;
+
+/** Hash tables of the resources by key and by
+ * data, with \ref num_buckets buckets each. */
+static Resource ** key_buckets = NULL;
+static Resource ** data_buckets = NULL;
+static int num_buckets = 0;
+
+/**
+ * FNV-1a over \p size bytes.
+ */
+static uint64_t
+hash_bytes (
+  const char * bytes,
+  size_t       size)
+{
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++)
+    {
+      hash ^= (uint8_t) bytes[i];
+      hash *= 1099511628211ull;
+    }
+
+  return hash;
+}
+
+/**
+ * Hash of the fields find_resource() compares.
+ */
+static uint64_t
+hash_key (
+  ResourceType type,
+  const char * key,
+  uint64_t     content_hash,
+  int          width,
+  int          height)
+{
+  uint64_t vals[] = {
+    (uint64_t) type, content_hash,
+    (uint64_t) (uint32_t) width,
+    (uint64_t) (uint32_t) height };
+  uint64_t hash = hash_bytes (key, strlen (key));
+  for (size_t i = 0; i < 4; i++)
+    {
+      hash ^= vals[i];
+      hash *= 1099511628211ull;
+    }
+
+  return hash;
+}
+
+/**
+ * Bucket of \p data in \ref data_buckets.
+ */
+static int
+get_data_bucket (
+  const void * data)
+{
+  uint64_t hash =
+    ((uint64_t) (uintptr_t) data >> 4) *
+      11400714819323198485ull;
+
+  return (int) (hash >> 32) & (num_buckets - 1);
+}
+
+static void
+index_resource (
+  Resource * r)
+{
+  int bucket =
+    (int) (r->key_hash & (uint64_t) (num_buckets - 1));
+  r->next_by_key = key_buckets[bucket];
+  key_buckets[bucket] = r;
+
+  bucket = get_data_bucket (r->data);
+  r->next_by_data = data_buckets[bucket];
+  data_buckets[bucket] = r;
+}
+
+static void
+unindex_resource (
+  Resource * r)
+{
+  Resource ** prev =
+    &key_buckets[
+      r->key_hash & (uint64_t) (num_buckets - 1)];
+  while (*prev != r)
+    prev = &(*prev)->next_by_key;
+  *prev = r->next_by_key;
+
+  prev = &data_buckets[get_data_bucket (r->data)];
+  while (*prev != r)
+    prev = &(*prev)->next_by_data;
+  *prev = r->next_by_data;
+}
+
+/**
+ * Doubles the number of buckets before there are
+ * as many resources, to keep the chains short.
+ */
+static void
+grow_index (void)
+{
+  if (num_resources + 1 < num_buckets)
+    return;
+
+  free (key_buckets);
+  free (data_buckets);
+  num_buckets = num_buckets ? num_buckets * 2 : 64;
+  key_buckets =
+    calloc (
+      (size_t) num_buckets, sizeof (Resource *));
+  data_buckets =
+    calloc (
+      (size_t) num_buckets, sizeof (Resource *));
+  for (int i = 0; i < num_resources; i++)
+    {
+      index_resource (resources[i]);
+    }
+}
+
+static Resource *
+find_resource (
+  ResourceType type,
+  const char * key,
+  uint64_t     content_hash,
+  int          width,
+  int          height)
+{
+  if (num_buckets == 0)
+    return NULL;
+
+  uint64_t key_hash =
+    hash_key (type, key, content_hash, width, height);
+  for (Resource * r =
+         key_buckets[
+           key_hash & (uint64_t) (num_buckets - 1)];
+       r; r = r->next_by_key)
+    {
+      if (r->key_hash == key_hash &&
+          r->type == type &&
+          r->content_hash == content_hash &&
+          r->width == width &&
+          r->height == height &&
+          !strcmp (r->key, key))
+        return r;
+    }
+
+  return NULL;
+}
+
+static Resource *
+find_resource_by_data (
+  const void * data)
+{
+  if (num_buckets == 0)
+    return NULL;
+
+  for (Resource * r =
+         data_buckets[get_data_bucket (data)];
+       r; r = r->next_by_data)
+    {
+      if (r->data == data)
+        return r;
+    }
+
+  return NULL;
+}
+
+/**
+ * Adds a reference to a cached resource and
+ * returns its data.
+ */
+static void *
+ref_resource (
+  Resource * r)
+{
+  if (r->refcount++ == 0)
+    unused_bytes -= r->size;
+
+  return r->data;
+}
+
+static void
+free_resource (
+  Resource * r)
+{
+  switch (r->type)
+    {
+    case RESOURCE_SURFACE:
+    case RESOURCE_PNG:
+      cairo_surface_destroy (r->data);
+      break;
+    case RESOURCE_FONT_FACE:
+      cairo_font_face_destroy (r->data);
+      break;
+    case RESOURCE_SVG:
+#ifdef HAVE_RSVG
+      ztk_rsvg_free (r->data);
+#endif
+      pthread_mutex_destroy (&r->render_lock);
+      break;
+    case RESOURCE_ASSET_PACK:
+      ztk_asset_pack_free (r->data);
+      break;
+    }
+  free (r->key);
+  free (r);
+}
+
+/**
+ * Frees unused resources, oldest first, until at
+ * most \p max_bytes of them are left.
+ */
+static void
+evict (
+  size_t max_bytes)
+{
+  while (unused_bytes > max_bytes ||
+         (max_bytes == 0 && num_resources > 0))
+    {
+      int oldest = -1;
+      for (int i = 0; i < num_resources; i++)
+        {
+          Resource * r = resources[i];
+          if (r->refcount == 0 &&
+              (oldest < 0 ||
+               r->release_serial <
+                 resources[oldest]->release_serial))
+            oldest = i;
+        }
+      if (oldest < 0)
+        return;
+
+      Resource * r = resources[oldest];
+      unused_bytes -= r->size;
+      unindex_resource (r);
+      resources[oldest] =
+        resources[--num_resources];
+      free_resource (r);
+    }
+}
+
+/**
+ * Adds a new resource with a reference and
+ * returns its data.
+ */
+static void *
+add_resource (
+  ResourceType type,
+  const char * key,
+  uint64_t     content_hash,
+  int          width,
+  int          height,
+  void *       data,
+  size_t       size)
+{
+  if (num_resources == resources_size)
+    {
+      resources_size =
+        resources_size ? resources_size * 2 : 16;
+      resources =
+        realloc (
+          resources,
+          (size_t) resources_size *
+            sizeof (Resource *));
+    }
+
+  Resource * r = calloc (1, sizeof (Resource));
+  r->type = type;
+  r->key = strdup (key);
+  r->content_hash = content_hash;
+  r->width = width;
+  r->height = height;
+  r->data = data;
+  r->size = size;
+  r->refcount = 1;
+  r->key_hash =
+    hash_key (type, key, content_hash, width, height);
+  if (type == RESOURCE_SVG)
+    pthread_mutex_init (&r->render_lock, NULL);
+  grow_index ();
+  index_resource (r);
+  resources[num_resources++] = r;
+
+  return data;
+}
+
+/**
+ * Adds \p surface, created without the lock, or
+ * returns the same one if another thread added it
+ * meanwhile, in which case \p surface is
+ * destroyed.
+ */
+static cairo_surface_t *
+add_or_ref_surface (
+  ResourceType      type,
+  const char *      key,
+  uint64_t          content_hash,
+  int               width,
+  int               height,
+  cairo_surface_t * surface)
+{
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      type, key, content_hash, width, height);
+  if (r)
+    {
+      cairo_surface_destroy (surface);
+      surface = ref_resource (r);
+    }
+  else
+    {
+      add_resource (
+        type, key, content_hash, width, height,
+        surface,
+        (size_t)
+          cairo_image_surface_get_stride (surface) *
+          (size_t)
+            cairo_image_surface_get_height (surface));
+    }
+  pthread_mutex_unlock (&lock);
+
+  return surface;
+}
+
+/**
+ * Returns the surface rendered for \p key at the
+ * given size, rendering it with \p render_cb if it
+ * is not cached.
+ *
+ * @param key Key of what is rendered, eg, a sprite
+ *   name. The size is part of the key.
+ * @return An ARGB32 image surface.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_surface (
+  const char *              key,
+  int                       width,
+  int                       height,
+  ZtkResourceRenderCallback render_cb,
+  void *                    data)
+{
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      RESOURCE_SURFACE, key, 0, width, height);
+  if (r)
+    {
+      cairo_surface_t * surface = ref_resource (r);
+      pthread_mutex_unlock (&lock);
+      return surface;
+    }
+
+  pthread_mutex_unlock (&lock);
+
+  /* render without the lock, so that several
+   * surfaces can be rendered at once and the
+   * callback can use the cache */
+  cairo_surface_t * surface =
+    cairo_image_surface_create (
+      CAIRO_FORMAT_ARGB32, width, height);
+  cairo_t * cr = cairo_create (surface);
+  render_cb (cr, width, height, data);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  return
+    add_or_ref_surface (
+      RESOURCE_SURFACE, key, 0, width, height,
+      surface);
+}
+
+/**
+ * Returns the font face for the given family,
+ * slant and weight.
+ */
+cairo_font_face_t *
+ztk_resource_cache_get_font_face (
+  const char *        family,
+  cairo_font_slant_t  slant,
+  cairo_font_weight_t weight)
+{
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      RESOURCE_FONT_FACE, family, 0, (int) slant,
+      (int) weight);
+  cairo_font_face_t * face;
+  if (r)
+    {
+      face = ref_resource (r);
+    }
+  else
+    {
+      face =
+        cairo_toy_font_face_create (
+          family, slant, weight);
+      add_resource (
+        RESOURCE_FONT_FACE, family, 0, (int) slant,
+        (int) weight, face, 0);
+    }
+  pthread_mutex_unlock (&lock);
+
+  return face;
+}
+
+/**
+ * Sets \p version to a hash of the modification
+ * time and size of the file at \p path, to tell
+ * whether it changed without reading it.
+ *
+ * @return 0 if the file exists.
+ */
+static int
+get_file_version (
+  const char * path,
+  uint64_t *   version)
+{
+  struct stat st;
+  if (stat (path, &st))
+    return -1;
+
+  *version =
+    ((uint64_t) st.st_mtime * 1099511628211ull) ^
+    (uint64_t) st.st_size;
+
+  return 0;
+}
+
+/**
+ * Returns the asset pack at \p abs_path, mapping
+ * it if it is not cached.
+ *
+ * Packs are keyed by path, size and modification
+ * time, so a pack that was rebuilt is mapped
+ * again.
+ *
+ * @return The pack, or NULL if it could not be
+ *   mapped.
+ */
+ZtkAssetPack *
+ztk_resource_cache_get_asset_pack (
+  const char * abs_path)
+{
+  uint64_t version;
+  if (get_file_version (abs_path, &version))
+    {
+      ztk_error (
+        "Could not find the asset pack at %s",
+        abs_path);
+      return NULL;
+    }
+
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      RESOURCE_ASSET_PACK, abs_path, version,
+      0, 0);
+  ZtkAssetPack * pack;
+  if (r)
+    {
+      pack = ref_resource (r);
+    }
+  else
+    {
+      /* mapping only reads the index, so it is
+       * done with the lock held */
+      pack = ztk_asset_pack_new (abs_path);
+      if (pack)
+        {
+          add_resource (
+            RESOURCE_ASSET_PACK, abs_path, version,
+            0, 0, pack,
+            ztk_asset_pack_get_size (pack));
+        }
+    }
+  pthread_mutex_unlock (&lock);
+
+  return pack;
+}
+
+/**
+ * Reads the whole file at \p path.
+ *
+ * @return The contents, to be freed with free(),
+ *   or NULL if the file could not be read.
+ */
+static char *
+read_file (
+  const char * path,
+  size_t *     size)
+{
+  FILE * file = fopen (path, "rb");
+  if (!file)
+    return NULL;
+
+  char * contents = NULL;
+  size_t num_read = 0;
+  size_t contents_size = 0;
+  for (;;)
+    {
+      if (num_read == contents_size)
+        {
+          contents_size =
+            contents_size ? contents_size * 2 : 4096;
+          contents = realloc (contents, contents_size);
+        }
+      size_t n =
+        fread (
+          contents + num_read, 1,
+          contents_size - num_read, file);
+      if (n == 0)
+        break;
+      num_read += n;
+    }
+  fclose (file);
+  *size = num_read;
+
+  return contents;
+}
+
+/** Read position in PNG data being decoded. */
+typedef struct PngReader
+{
+  const unsigned char * data;
+  size_t                size;
+  size_t                pos;
+} PngReader;
+
+static cairo_status_t
+read_png_data (
+  void *          closure,
+  unsigned char * data,
+  unsigned int    length)
+{
+  PngReader * reader = (PngReader *) closure;
+  if (length > reader->size - reader->pos)
+    return CAIRO_STATUS_READ_ERROR;
+
+  memcpy (data, reader->data + reader->pos, length);
+  reader->pos += length;
+
+  return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Returns the PNG image in \p data, decoding it if
+ * it is not cached under \p key and
+ * \p content_hash.
+ */
+static cairo_surface_t *
+get_png (
+  const char * key,
+  uint64_t     content_hash,
+  const void * data,
+  size_t       size)
+{
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      RESOURCE_PNG, key, content_hash, 0, 0);
+  if (r)
+    {
+      cairo_surface_t * surface = ref_resource (r);
+      pthread_mutex_unlock (&lock);
+      return surface;
+    }
+  pthread_mutex_unlock (&lock);
+
+  /* decode without the lock, like SVGs */
+  PngReader reader = { data, size, 0 };
+  cairo_surface_t * surface =
+    cairo_image_surface_create_from_png_stream (
+      read_png_data, &reader);
+  if (!surface ||
+      cairo_surface_status (surface) !=
+        CAIRO_STATUS_SUCCESS)
+    {
+      ztk_error ("Could not decode the PNG %s", key);
+      cairo_surface_destroy (surface);
+      return NULL;
+    }
+
+  return
+    add_or_ref_surface (
+      RESOURCE_PNG, key, content_hash, 0, 0,
+      surface);
+}
+
+/**
+ * Returns the PNG image in \p data, decoding it if
+ * it is not cached.
+ *
+ * PNGs are keyed by \p key and content.
+ *
+ * @param key Key of the PNG, eg, its path.
+ * @return An image surface, or NULL if \p data is
+ *   not a valid PNG.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_png_from_data (
+  const char * key,
+  const void * data,
+  size_t       size)
+{
+  return
+    get_png (key, hash_bytes (data, size), data, size);
+}
+
+/**
+ * Returns the PNG image at \p abs_path, decoding
+ * it if it is not cached.
+ *
+ * PNG files are keyed by path, size and
+ * modification time, so they are only read when
+ * they are not cached or changed.
+ *
+ * @return An image surface, or NULL if the file
+ *   could not be read or is not a valid PNG.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_png (
+  const char * abs_path)
+{
+  uint64_t version;
+  if (get_file_version (abs_path, &version))
+    {
+      ztk_error (
+        "Could not read the PNG file at %s",
+        abs_path);
+      return NULL;
+    }
+
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      RESOURCE_PNG, abs_path, version, 0, 0);
+  if (r)
+    {
+      cairo_surface_t * surface = ref_resource (r);
+      pthread_mutex_unlock (&lock);
+      return surface;
+    }
+  pthread_mutex_unlock (&lock);
+
+  size_t size = 0;
+  char * contents = read_file (abs_path, &size);
+  if (!contents)
+    {
+      ztk_error (
+        "Could not read the PNG file at %s",
+        abs_path);
+      return NULL;
+    }
+  cairo_surface_t * surface =
+    get_png (abs_path, version, contents, size);
+  free (contents);
+
+  return surface;
+}
+
+#ifdef HAVE_RSVG
+/**
+ * Returns the SVG at \p abs_path, parsing it if it
+ * is not cached.
+ *
+ * SVGs are keyed by path, size and modification
+ * time, so they are only read when they are not
+ * cached or changed on disk.
+ *
+ * @return The SVG, or NULL if it could not be
+ *   loaded.
+ */
+ZtkRsvgHandle *
+ztk_resource_cache_get_svg (
+  const char * abs_path)
+{
+  uint64_t version;
+  if (get_file_version (abs_path, &version))
+    {
+      ztk_error (
+        "Could not read the SVG file at %s",
+        abs_path);
+      return NULL;
+    }
+
+  pthread_mutex_lock (&lock);
+  Resource * r =
+    find_resource (
+      RESOURCE_SVG, abs_path, version, 0, 0);
+  if (r)
+    {
+      ZtkRsvgHandle * svg = ref_resource (r);
+      pthread_mutex_unlock (&lock);
+      return svg;
+    }
+  pthread_mutex_unlock (&lock);
+
+  size_t size = 0;
+  char * contents = read_file (abs_path, &size);
+  if (!contents)
+    {
+      ztk_error (
+        "Could not read the SVG file at %s",
+        abs_path);
+      return NULL;
+    }
+
+  /* parse without the lock, so that SVGs can be
+   * loaded on several threads at once */
+  ZtkRsvgHandle * svg =
+    ztk_rsvg_load_svg_from_data (
+      contents, size, abs_path);
+  free (contents);
+  if (!svg)
+    return NULL;
+
+  /* another thread may have loaded it meanwhile */
+  pthread_mutex_lock (&lock);
+  r =
+    find_resource (
+      RESOURCE_SVG, abs_path, version, 0, 0);
+  if (r)
+    {
+      ztk_rsvg_free (svg);
+      svg = ref_resource (r);
+    }
+  else
+    {
+      add_resource (
+        RESOURCE_SVG, abs_path, version, 0, 0, svg,
+        size);
+    }
+  pthread_mutex_unlock (&lock);
+
+  return svg;
+}
+
+/**
+ * Returns \p svg rendered at the given size.
+ *
+ * @return The surface, or NULL if \p svg is not
+ *   from the cache.
+ */
+cairo_surface_t *
+ztk_resource_cache_get_svg_surface (
+  ZtkRsvgHandle * svg,
+  int             width,
+  int             height)
+{
+  pthread_mutex_lock (&lock);
+  Resource * svg_r = find_resource_by_data (svg);
+  if (!svg_r)
+    {
+      pthread_mutex_unlock (&lock);
+      return NULL;
+    }
+  Resource * r =
+    find_resource (
+      RESOURCE_SURFACE, svg_r->key,
+      svg_r->content_hash, width, height);
+  if (r)
+    {
+      cairo_surface_t * surface = ref_resource (r);
+      pthread_mutex_unlock (&lock);
+      return surface;
+    }
+
+  /* the SVG is kept while it is rendered without
+   * the lock */
+  ref_resource (svg_r);
+  pthread_mutex_unlock (&lock);
+
+  cairo_surface_t * surface =
+    cairo_image_surface_create (
+      CAIRO_FORMAT_ARGB32, width, height);
+  cairo_t * cr = cairo_create (surface);
+  ZtkRect rect = { 0, 0, width, height };
+  pthread_mutex_lock (&svg_r->render_lock);
+  ztk_rsvg_draw (svg, cr, &rect);
+  pthread_mutex_unlock (&svg_r->render_lock);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  surface =
+    add_or_ref_surface (
+      RESOURCE_SURFACE, svg_r->key,
+      svg_r->content_hash, width, height, surface);
+  ztk_resource_cache_release (svg);
+
+  return surface;
+}
+#endif
+
+/**
+ * Releases a resource returned by the cache.
+ *
+ * Does nothing if \p resource is NULL.
+ */
+void
+ztk_resource_cache_release (
+  const void * resource)
+{
+  if (!resource)
+    return;
+
+  pthread_mutex_lock (&lock);
+  Resource * r = find_resource_by_data (resource);
+  if (!r)
+    {
+      pthread_mutex_unlock (&lock);
+      ztk_warning ("%s", "Resource is not cached");
+      return;
+    }
+  if (--r->refcount == 0)
+    {
+      r->release_serial = ++last_release_serial;
+      unused_bytes += r->size;
+      evict (ZTK_RESOURCE_CACHE_MAX_UNUSED_BYTES);
+    }
+  pthread_mutex_unlock (&lock);
+}
+
+/**
+ * Frees the resources that are not in use.
+ */
+void
+ztk_resource_cache_trim (void)
+{
+  pthread_mutex_lock (&lock);
+  evict (0);
+  pthread_mutex_unlock (&lock);
+}
+
+/**
+ * Returns the number of cached resources, in use
+ * or not.
+ */
+int
+ztk_resource_cache_get_num_resources (void)
+{
+  pthread_mutex_lock (&lock);
+  int num = num_resources;
+  pthread_mutex_unlock (&lock);
+
+  return num;
+}
@@ -28,27 +28,52 @@
 /**
  * Loads an SVG from an absolute path.
  *
+ * The SVG is shared with the other apps in the
+ * process through the resource cache, and can be
+ * released with ztk_resource_cache_release().
+ *
  * @return An rsvg handle, or NULL if failed.
  */
 ZtkRsvgHandle *
 ztk_rsvg_load_svg (
   const char * abs_path)
 {
-  GFile * file =
-    g_file_new_for_path (abs_path);
+  return ztk_resource_cache_get_svg (abs_path);
+}
+
+/**
+ * Parses an SVG from memory, without caching it.
+ *
+ * @param abs_path Path the SVG was read from,
+ *   used to resolve the files it references.
+ * @return An rsvg handle to be freed with
+ *   ztk_rsvg_free(), or NULL if failed.
+ */
+ZtkRsvgHandle *
+ztk_rsvg_load_svg_from_data (
+  const char * data,
+  size_t       size,
+  const char * abs_path)
+{
+  GInputStream * stream =
+    g_memory_input_stream_new_from_data (
+      data, (gssize) size, NULL);
+  GFile * file = g_file_new_for_path (abs_path);
   GError * err = NULL;
   RsvgHandle * handle =
-    rsvg_handle_new_from_gfile_sync (
-      file, RSVG_HANDLE_FLAGS_NONE, NULL, &err);
+    rsvg_handle_new_from_stream_sync (
+      stream, file, RSVG_HANDLE_FLAGS_NONE, NULL,
+      &err);
+  g_object_unref (file);
+  g_object_unref (stream);
   if (err)
     {
       ztk_error (
         "An error occurred parsing the SVG file at "
         "%s: %s", abs_path, err->message);
-      g_object_unref (file);
+      g_error_free (err);
       return NULL;
     }
-  g_object_unref (file);
 
   /* common values are 75, 90, 300 */
   rsvg_handle_set_dpi (handle, 300);
@@ -56,6 +81,16 @@ ztk_rsvg_load_svg (
   return (ZtkRsvgHandle *) handle;
 }
 
+/**
+ * Frees an SVG from ztk_rsvg_load_svg_from_data().
+ */
+void
+ztk_rsvg_free (
+  ZtkRsvgHandle * handle)
+{
+  g_object_unref (handle);
+}
+
 /**
  * Gets the width of the svg.
  */
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ztoolkit/search_index.h"
+
+#define TRIGRAM(str) \
+  (((uint32_t) (unsigned char) (str)[0] << 16) | \
+   ((uint32_t) (unsigned char) (str)[1] << 8) | \
+   (uint32_t) (unsigned char) (str)[2])
+
+/**
+ * Copies \p src into \p dest in lowercase,
+ * truncating to \p size - 1 bytes.
+ *
+ * @return The length of \p dest.
+ */
+static size_t
+copy_lowercase (
+  char *       dest,
+  const char * src,
+  size_t       size)
+{
+  size_t len = 0;
+  while (src[len] && len < size - 1)
+    {
+      dest[len] =
+        (char) tolower ((unsigned char) src[len]);
+      len++;
+    }
+  dest[len] = '\0';
+
+  return len;
+}
+
+static int
+cmp_entries (
+  const void * a,
+  const void * b)
+{
+  uint64_t ea = *(const uint64_t *) a;
+  uint64_t eb = *(const uint64_t *) b;
+
+  return (ea > eb) - (ea < eb);
+}
+
+/**
+ * Builds an index over the given names.
+ *
+ * The names are copied.
+ */
+ZtkSearchIndex *
+ztk_search_index_new (
+  const char ** names,
+  int           num_names)
+{
+  ZtkSearchIndex * self =
+    calloc (1, sizeof (ZtkSearchIndex));
+
+  self->num_names = num_names;
+  self->names =
+    calloc ((size_t) num_names + 1, sizeof (char *));
+  self->display_names =
+    calloc ((size_t) num_names + 1, sizeof (char *));
+
+  size_t num_entries = 0;
+  for (int i = 0; i < num_names; i++)
+    {
+      size_t len = strlen (names[i]);
+      self->names[i] = malloc (len + 1);
+      copy_lowercase (
+        self->names[i], names[i], len + 1);
+      self->display_names[i] = strdup (names[i]);
+      if (len >= 3)
+        num_entries += len - 2;
+    }
+
+  /* collect (trigram, name) pairs and sort them so
+   * that each trigram's names are contiguous and
+   * ascending */
+  uint64_t * entries =
+    malloc ((num_entries + 1) * sizeof (uint64_t));
+  size_t n = 0;
+  for (int i = 0; i < num_names; i++)
+    {
+      const char * name = self->names[i];
+      for (size_t j = 0; name[j] && name[j + 1] &&
+           name[j + 2]; j++)
+        {
+          entries[n++] =
+            ((uint64_t) TRIGRAM (&name[j]) << 32) |
+            (uint64_t) i;
+        }
+    }
+  qsort (
+    entries, num_entries, sizeof (uint64_t),
+    cmp_entries);
+
+  /* count unique trigrams */
+  int num_trigrams = 0;
+  for (size_t i = 0; i < num_entries; i++)
+    {
+      if (i == 0 ||
+          (entries[i] >> 32) !=
+            (entries[i - 1] >> 32))
+        num_trigrams++;
+    }
+
+  self->trigrams =
+    malloc (
+      ((size_t) num_trigrams + 1) *
+        sizeof (uint32_t));
+  self->offsets =
+    malloc (
+      ((size_t) num_trigrams + 1) * sizeof (int));
+  self->postings =
+    malloc ((num_entries + 1) * sizeof (int));
+
+  /* fill in the posting lists, skipping duplicate
+   * names (a trigram may appear more than once in
+   * a name) */
+  int num_postings = 0;
+  self->num_trigrams = 0;
+  for (size_t i = 0; i < num_entries; i++)
+    {
+      uint32_t key = (uint32_t) (entries[i] >> 32);
+      if (i == 0 ||
+          key != (uint32_t) (entries[i - 1] >> 32))
+        {
+          self->trigrams[self->num_trigrams] = key;
+          self->offsets[self->num_trigrams] =
+            num_postings;
+          self->num_trigrams++;
+        }
+      else if (entries[i] == entries[i - 1])
+        {
+          continue;
+        }
+      self->postings[num_postings++] =
+        (int) (entries[i] & 0xFFFFFFFF);
+    }
+  self->offsets[self->num_trigrams] = num_postings;
+
+  free (entries);
+
+  return self;
+}
+
+/**
+ * Creates a result set sized for the given index.
+ */
+ZtkSearchResults *
+ztk_search_results_new (
+  ZtkSearchIndex * index)
+{
+  ZtkSearchResults * self =
+    calloc (1, sizeof (ZtkSearchResults));
+
+  self->size = index->num_names;
+  self->indices =
+    calloc ((size_t) self->size + 1, sizeof (int));
+  self->matches =
+    calloc ((size_t) self->size + 1, sizeof (int));
+
+  return self;
+}
+
+/**
+ * Returns the posting list of the given trigram
+ * in \p list, or 0 if it is not in the index.
+ *
+ * @return The length of the posting list.
+ */
+static int
+find_postings (
+  ZtkSearchIndex * self,
+  uint32_t         trigram,
+  const int **     list)
+{
+  int lo = 0;
+  int hi = self->num_trigrams - 1;
+  while (lo <= hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+      uint32_t key = self->trigrams[mid];
+      if (key < trigram)
+        lo = mid + 1;
+      else if (key > trigram)
+        hi = mid - 1;
+      else
+        {
+          *list = &self->postings[self->offsets[mid]];
+          return
+            self->offsets[mid + 1] -
+              self->offsets[mid];
+        }
+    }
+
+  return 0;
+}
+
+/**
+ * Fills in the matches in index order.
+ */
+static void
+find_matches (
+  ZtkSearchIndex *   self,
+  const char *       query,
+  size_t             len,
+  ZtkSearchResults * results)
+{
+  int num_matches = 0;
+
+  /* the query extends the previous one, so only
+   * the previous matches can still match */
+  if (results->valid &&
+      strstr (query, results->query))
+    {
+      for (int i = 0; i < results->num_indices; i++)
+        {
+          int idx = results->matches[i];
+          if (strstr (self->names[idx], query))
+            results->matches[num_matches++] = idx;
+        }
+    }
+  else if (len >= 3)
+    {
+      /* verify the names in the shortest posting
+       * list */
+      const int * shortest = NULL;
+      int shortest_len = -1;
+      for (size_t i = 0; i + 2 < len; i++)
+        {
+          const int * list = NULL;
+          int list_len =
+            find_postings (
+              self, TRIGRAM (&query[i]), &list);
+          if (shortest_len < 0 ||
+              list_len < shortest_len)
+            {
+              shortest = list;
+              shortest_len = list_len;
+            }
+          if (list_len == 0)
+            break;
+        }
+      for (int i = 0; i < shortest_len; i++)
+        {
+          int idx = shortest[i];
+          if (strstr (self->names[idx], query))
+            results->matches[num_matches++] = idx;
+        }
+    }
+  else
+    {
+      for (int i = 0; i < self->num_names; i++)
+        {
+          if (len == 0 ||
+              strstr (self->names[i], query))
+            results->matches[num_matches++] = i;
+        }
+    }
+
+  results->num_indices = num_matches;
+}
+
+/**
+ * Runs a case-insensitive substring query.
+ *
+ * If the query contains the previous query of
+ * \p results (eg, when the user types another
+ * character), only the previous results are
+ * filtered. Names starting with the query are
+ * ordered first, otherwise results keep the order
+ * of the names in the index.
+ *
+ * An empty query matches everything.
+ */
+void
+ztk_search_index_query (
+  ZtkSearchIndex *   self,
+  const char *       query,
+  ZtkSearchResults * results)
+{
+  char q[ZTK_SEARCH_QUERY_MAX];
+  size_t len =
+    copy_lowercase (q, query, sizeof (q));
+
+  find_matches (self, q, len, results);
+
+  /* order prefix matches first */
+  int n = 0;
+  for (int i = 0; i < results->num_indices; i++)
+    {
+      int idx = results->matches[i];
+      if (strncmp (self->names[idx], q, len) == 0)
+        results->indices[n++] = idx;
+    }
+  for (int i = 0; i < results->num_indices; i++)
+    {
+      int idx = results->matches[i];
+      if (strncmp (self->names[idx], q, len) != 0)
+        results->indices[n++] = idx;
+    }
+
+  strcpy (results->query, q);
+  results->valid = 1;
+}
+
+void
+ztk_search_results_free (
+  ZtkSearchResults * self)
+{
+  free (self->indices);
+  free (self->matches);
+  free (self);
+}
+
+void
+ztk_search_index_free (
+  ZtkSearchIndex * self)
+{
+  for (int i = 0; i < self->num_names; i++)
+    {
+      free (self->names[i]);
+      free (self->display_names[i]);
+    }
+  free (self->names);
+  free (self->display_names);
+  free (self->trigrams);
+  free (self->offsets);
+  free (self->postings);
+  free (self);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "ztoolkit/ztk.h"
+
+/**
+ * Returns the time in seconds in a monotonic clock,
+ * used for statistics and traces.
+ *
+ * Unlike puglGetTime(), this cannot be set
+ * manually on the headless platform.
+ */
+double
+ztk_stats_get_time (void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency (&freq);
+  QueryPerformanceCounter (&count);
+  return
+    (double) count.QuadPart /
+      (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return
+    (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * Adds a sample to the phase.
+ */
+void
+ztk_phase_stats_add (
+  ZtkPhaseStats * self,
+  double          time)
+{
+  self->last = time;
+  self->total += time;
+  if (time > self->max)
+    self->max = time;
+}
+
+static void
+print_phase (
+  FILE *          file,
+  const char *    name,
+  ZtkPhaseStats * phase,
+  unsigned long   num_frames)
+{
+  fprintf (
+    file,
+    "  \"%s\": { \"last_ms\": %.3f, "
+    "\"mean_ms\": %.3f, \"max_ms\": %.3f },\n",
+    name, phase->last * 1e3,
+    num_frames ?
+      phase->total * 1e3 / (double) num_frames :
+      0.0,
+    phase->max * 1e3);
+}
+
+/**
+ * Prints the statistics as JSON.
+ */
+void
+ztk_app_stats_print (
+  ZtkAppStats * self,
+  FILE *        file)
+{
+  fprintf (
+    file, "{\n  \"frames\": %lu,\n",
+    self->num_frames);
+  print_phase (
+    file, "dispatch", &self->dispatch,
+    self->num_frames);
+  print_phase (
+    file, "update", &self->update,
+    self->num_frames);
+  print_phase (
+    file, "draw", &self->draw, self->num_frames);
+  print_phase (
+    file, "backend", &self->backend,
+    self->num_frames);
+  fprintf (
+    file,
+    "  \"widgets_drawn\": %lu,\n"
+    "  \"widgets_culled\": %lu,\n"
+    "  \"pixels_damaged\": %.0f,\n"
+    "  \"pixels_painted\": %.0f,\n"
+    "  \"overdraw\": %.3f,\n"
+    "  \"top_widgets\": [\n",
+    self->widgets_drawn, self->widgets_culled,
+    self->pixels_damaged, self->pixels_painted,
+    self->overdraw);
+  for (int i = 0; i < self->num_top_widgets; i++)
+    {
+      ZtkWidgetDrawStats * ws =
+        &self->top_widgets[i];
+      fprintf (
+        file,
+        "    { \"type\": %d, \"x\": %.0f, "
+        "\"y\": %.0f, \"draws\": %lu, "
+        "\"total_ms\": %.3f }%s\n",
+        ws->widget->type, ws->widget->rect.x,
+        ws->widget->rect.y, ws->num_draws,
+        ws->draw_time * 1e3,
+        i == self->num_top_widgets - 1 ? "" : ",");
+    }
+  fprintf (file, "  ]\n}\n");
+}
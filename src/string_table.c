@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ztoolkit/string_table.h>
+
+#define DEFAULT_NUM_BUCKETS 64
+
+struct ZtkInternedString
+{
+  /** Next string in the same bucket. */
+  ZtkInternedString * next;
+
+  /** Table the string is in, or NULL if it is
+   * not shared. */
+  ZtkStringTable *  table;
+
+  uint32_t          hash;
+  int               refcount;
+  size_t            len;
+
+  char              str[];
+};
+
+static ZtkInternedString *
+get_interned (
+  const char * str)
+{
+  return
+    (ZtkInternedString *)
+    (void *)
+    (str - offsetof (ZtkInternedString, str));
+}
+
+/**
+ * FNV-1a.
+ */
+static uint32_t
+hash_str (
+  const char * str,
+  size_t *     len)
+{
+  uint32_t hash = 2166136261u;
+  const char * c = str;
+  for (; *c; c++)
+    {
+      hash ^= (uint8_t) *c;
+      hash *= 16777619u;
+    }
+  *len = (size_t) (c - str);
+
+  return hash;
+}
+
+/**
+ * Doubles the number of buckets.
+ */
+static void
+grow (
+  ZtkStringTable * self)
+{
+  int num_buckets = self->num_buckets * 2;
+  ZtkInternedString ** buckets =
+    calloc (
+      (size_t) num_buckets,
+      sizeof (ZtkInternedString *));
+  for (int i = 0; i < self->num_buckets; i++)
+    {
+      ZtkInternedString * s = self->buckets[i];
+      while (s)
+        {
+          ZtkInternedString * next = s->next;
+          uint32_t idx =
+            s->hash & (uint32_t) (num_buckets - 1);
+          s->next = buckets[idx];
+          buckets[idx] = s;
+          s = next;
+        }
+    }
+  free (self->buckets);
+  self->buckets = buckets;
+  self->num_buckets = num_buckets;
+}
+
+/**
+ * Creates a new string table.
+ */
+ZtkStringTable *
+ztk_string_table_new (void)
+{
+  ZtkStringTable * self =
+    calloc (1, sizeof (ZtkStringTable));
+  self->num_buckets = DEFAULT_NUM_BUCKETS;
+  self->buckets =
+    calloc (
+      (size_t) self->num_buckets,
+      sizeof (ZtkInternedString *));
+
+  return self;
+}
+
+/**
+ * Returns a reference to the interned copy of
+ * \p str, adding it to the table if needed.
+ *
+ * @param self The table, or NULL to return a copy
+ *   not shared with other strings.
+ * @return The interned string, or NULL if \p str
+ *   is NULL.
+ */
+const char *
+ztk_string_table_intern (
+  ZtkStringTable * self,
+  const char *     str)
+{
+  if (!str)
+    return NULL;
+
+  size_t len;
+  uint32_t hash = hash_str (str, &len);
+  if (self)
+    {
+      ZtkInternedString * s =
+        self->buckets[
+          hash & (uint32_t) (self->num_buckets - 1)];
+      for (; s; s = s->next)
+        {
+          if (s->hash == hash && s->len == len &&
+              !memcmp (s->str, str, len))
+            {
+              s->refcount++;
+              return s->str;
+            }
+        }
+    }
+
+  ZtkInternedString * s =
+    malloc (sizeof (ZtkInternedString) + len + 1);
+  memcpy (s->str, str, len + 1);
+  s->hash = hash;
+  s->len = len;
+  s->refcount = 1;
+  s->table = self;
+  s->next = NULL;
+  if (self)
+    {
+      if (self->num_strings >= self->num_buckets)
+        grow (self);
+      uint32_t idx =
+        hash & (uint32_t) (self->num_buckets - 1);
+      s->next = self->buckets[idx];
+      self->buckets[idx] = s;
+      self->num_strings++;
+    }
+
+  return s->str;
+}
+
+/**
+ * Frees the table.
+ *
+ * Strings still referenced stay valid and are
+ * freed with their last reference.
+ */
+void
+ztk_string_table_free (
+  ZtkStringTable * self)
+{
+  for (int i = 0; i < self->num_buckets; i++)
+    {
+      ZtkInternedString * s = self->buckets[i];
+      while (s)
+        {
+          ZtkInternedString * next = s->next;
+          s->table = NULL;
+          s->next = NULL;
+          s = next;
+        }
+    }
+  free (self->buckets);
+  free (self);
+}
+
+/**
+ * Adds a reference to an interned string and
+ * returns it.
+ */
+const char *
+ztk_string_ref (
+  const char * str)
+{
+  get_interned (str)->refcount++;
+
+  return str;
+}
+
+/**
+ * Removes a reference from an interned string,
+ * freeing it when none are left.
+ *
+ * Does nothing if \p str is NULL.
+ */
+void
+ztk_string_unref (
+  const char * str)
+{
+  if (!str)
+    return;
+
+  ZtkInternedString * s = get_interned (str);
+  if (--s->refcount > 0)
+    return;
+
+  ZtkStringTable * table = s->table;
+  if (table)
+    {
+      ZtkInternedString ** prev =
+        &table->buckets[
+          s->hash &
+          (uint32_t) (table->num_buckets - 1)];
+      while (*prev != s)
+        prev = &(*prev)->next;
+      *prev = s->next;
+      table->num_strings--;
+    }
+  free (s);
+}
+
+/**
+ * Returns the length of an interned string.
+ */
+size_t
+ztk_string_get_length (
+  const char * str)
+{
+  return get_interned (str)->len;
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ztoolkit/ztk.h"
+
+typedef enum TraceEventType
+{
+  TRACE_EVENT_SPAN,
+  TRACE_EVENT_COUNTER,
+} TraceEventType;
+
+typedef struct TraceEvent
+{
+  TraceEventType type;
+  const char *   name;
+
+  /** Start time, in seconds. */
+  double         time;
+
+  /** Duration for spans, value for counters. */
+  double         value;
+
+  int            arg;
+} TraceEvent;
+
+typedef struct Trace
+{
+  FILE *         file;
+
+  /** Ring of events. */
+  TraceEvent *   events;
+  int            num_events;
+  int            events_size;
+  int            first_event;
+
+  /** Events overwritten before being written. */
+  unsigned long  num_dropped;
+
+  /** Whether an event was written, to separate the
+   * next one. */
+  int            wrote_event;
+
+  /** Time of the start of the trace. */
+  double         start_time;
+
+  /** Number of ztk_trace_start() calls not
+   * matched by ztk_trace_stop() yet. */
+  int            num_users;
+} Trace;
+
+int ztk_trace_active = 0;
+
+static Trace trace;
+
+/**
+ * Starts writing a trace to the given file.
+ *
+ * Calls are counted, and the trace is recorded
+ * until ztk_trace_stop() was called as many times.
+ * If a trace is already being recorded, it is
+ * kept and \p path is ignored, so that apps
+ * started from ZTK_TRACE share a single trace.
+ *
+ * @param num_events Number of events to buffer.
+ *
+ * @return 0 if successful, -1 if the file could not
+ *   be written or tracing is not compiled in.
+ */
+int
+ztk_trace_start (
+  const char * path,
+  int          num_events)
+{
+#ifdef ENABLE_TRACE
+  if (trace.num_users > 0)
+    {
+      trace.num_users++;
+      return 0;
+    }
+
+  FILE * file = fopen (path, "w");
+  if (!file)
+    {
+      ztk_warning (
+        "Failed to open %s for tracing", path);
+      return -1;
+    }
+
+  trace.file = file;
+  trace.events_size = MAX (num_events, 2);
+  trace.events =
+    calloc (
+      (size_t) trace.events_size,
+      sizeof (TraceEvent));
+  trace.num_events = 0;
+  trace.first_event = 0;
+  trace.num_dropped = 0;
+  trace.wrote_event = 0;
+  trace.start_time = ztk_stats_get_time ();
+  fprintf (file, "[\n");
+  trace.num_users = 1;
+  ztk_trace_active = 1;
+
+  return 0;
+#else
+  ztk_warning (
+    "Can't trace to %s: tracing is not enabled "
+    "in this build", path);
+  return -1;
+#endif
+}
+
+/**
+ * Writes the buffered events and closes the trace
+ * if this was the last user.
+ */
+void
+ztk_trace_stop (void)
+{
+  if (trace.num_users == 0 ||
+      --trace.num_users > 0)
+    return;
+
+  ztk_trace_flush ();
+  if (trace.num_dropped)
+    {
+      ztk_warning (
+        "%lu trace events were dropped",
+        trace.num_dropped);
+    }
+  fprintf (trace.file, "\n]\n");
+  fclose (trace.file);
+  free (trace.events);
+  trace.file = NULL;
+  trace.events = NULL;
+  ztk_trace_active = 0;
+}
+
+static void
+write_event (
+  TraceEvent * ev)
+{
+  double ts = (ev->time - trace.start_time) * 1e6;
+  if (trace.wrote_event)
+    fprintf (trace.file, ",\n");
+  trace.wrote_event = 1;
+
+  if (ev->type == TRACE_EVENT_COUNTER)
+    {
+      fprintf (
+        trace.file,
+        "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,"
+        "\"pid\":1,\"tid\":1,"
+        "\"args\":{\"value\":%.0f}}",
+        ev->name, ts, ev->value);
+    }
+  else if (ev->arg >= 0)
+    {
+      fprintf (
+        trace.file,
+        "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+        "\"dur\":%.3f,\"pid\":1,\"tid\":1,"
+        "\"args\":{\"arg\":%d}}",
+        ev->name, ts, ev->value * 1e6, ev->arg);
+    }
+  else
+    {
+      fprintf (
+        trace.file,
+        "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+        "\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+        ev->name, ts, ev->value * 1e6);
+    }
+}
+
+/**
+ * Writes the buffered events to the file.
+ */
+void
+ztk_trace_flush (void)
+{
+  if (!trace.file)
+    return;
+
+  for (int i = 0; i < trace.num_events; i++)
+    {
+      write_event (
+        &trace.events[
+          (trace.first_event + i) %
+            trace.events_size]);
+    }
+  trace.num_events = 0;
+  trace.first_event = 0;
+  fflush (trace.file);
+}
+
+/**
+ * Writes the buffered events to the file if the
+ * ring is at least half full.
+ */
+void
+ztk_trace_flush_if_needed (void)
+{
+  if (trace.num_events >= trace.events_size / 2)
+    ztk_trace_flush ();
+}
+
+/**
+ * Returns the next event in the ring, overwriting
+ * the oldest one if full.
+ */
+static TraceEvent *
+add_event (void)
+{
+  int idx;
+  if (trace.num_events == trace.events_size)
+    {
+      idx = trace.first_event;
+      trace.first_event =
+        (trace.first_event + 1) % trace.events_size;
+      trace.num_dropped++;
+    }
+  else
+    {
+      idx =
+        (trace.first_event + trace.num_events++) %
+          trace.events_size;
+    }
+
+  return &trace.events[idx];
+}
+
+/**
+ * Adds a span that started at \p start and ends
+ * now.
+ *
+ * @param name A static string.
+ * @param arg Integer argument shown with the span,
+ *   eg, the widget type, or -1 for none.
+ */
+void
+ztk_trace_add_span (
+  const char * name,
+  double       start,
+  int          arg)
+{
+  if (!trace.file)
+    return;
+
+  TraceEvent * ev = add_event ();
+  ev->type = TRACE_EVENT_SPAN;
+  ev->name = name;
+  ev->time = start;
+  ev->value = ztk_stats_get_time () - start;
+  ev->arg = arg;
+}
+
+/**
+ * Adds a value to a counter track.
+ *
+ * @param name A static string.
+ */
+void
+ztk_trace_add_counter (
+  const char * name,
+  double       value)
+{
+  if (!trace.file)
+    return;
+
+  TraceEvent * ev = add_event ();
+  ev->type = TRACE_EVENT_COUNTER;
+  ev->name = name;
+  ev->time = ztk_stats_get_time ();
+  ev->value = value;
+  ev->arg = -1;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "ztoolkit/ztk.h"
+
+/** Alignment of the arrays, in bytes. */
+#define ALIGNMENT 32
+
+/**
+ * Allocates \p size bytes aligned to ALIGNMENT,
+ * to be freed with free_aligned().
+ */
+static void *
+alloc_aligned (
+  size_t size)
+{
+#ifdef _WIN32
+  /* aligned_alloc() is not available */
+  return _aligned_malloc (size, ALIGNMENT);
+#else
+  return aligned_alloc (ALIGNMENT, size);
+#endif
+}
+
+static void
+free_aligned (
+  void * ptr)
+{
+#ifdef _WIN32
+  _aligned_free (ptr);
+#else
+  free (ptr);
+#endif
+}
+
+/**
+ * Replaces the array at \p arr with a zeroed,
+ * aligned one of \p size elements keeping the first
+ * \p num ones.
+ */
+static int
+grow_array (
+  void ** arr,
+  size_t  elem_size,
+  int     num,
+  int     size)
+{
+  void * new_arr =
+    alloc_aligned ((size_t) size * elem_size);
+  if (!new_arr)
+    return -1;
+
+  memset (new_arr, 0, (size_t) size * elem_size);
+  if (*arr)
+    {
+      memcpy (new_arr, *arr, (size_t) num * elem_size);
+      free_aligned (*arr);
+    }
+  *arr = new_arr;
+
+  return 0;
+}
+
+static int
+grow_masks (
+  ZtkWidgetTable * self,
+  int              size)
+{
+  for (int i = 0; i < ZTK_WIDGET_TABLE_NUM_MASKS; i++)
+    {
+      uint8_t * mask =
+        realloc (self->masks[i], (size_t) size / 8);
+      if (!mask)
+        return -1;
+      self->masks[i] = mask;
+    }
+
+  return 0;
+}
+
+/**
+ * Makes room for at least \p num_widgets widgets.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_widget_table_reserve (
+  ZtkWidgetTable * self,
+  int              num_widgets)
+{
+  if (num_widgets <= self->size)
+    return 0;
+
+  /* padded to whole vectors of 8 */
+  int size = MAX (self->size * 2, 8);
+  while (size < num_widgets)
+    size *= 2;
+
+  int num = self->num_widgets;
+  if (grow_array (
+        (void **) &self->x1, sizeof (float), num,
+        size) ||
+      grow_array (
+        (void **) &self->y1, sizeof (float), num,
+        size) ||
+      grow_array (
+        (void **) &self->x2, sizeof (float), num,
+        size) ||
+      grow_array (
+        (void **) &self->y2, sizeof (float), num,
+        size) ||
+      grow_array (
+        (void **) &self->flags, sizeof (uint32_t),
+        num, size) ||
+      grow_array (
+        (void **) &self->z, sizeof (int), num, size) ||
+      grow_masks (self, size))
+    {
+      ztk_warning (
+        "Failed to allocate the hot data of %d "
+        "widgets", num_widgets);
+      return -1;
+    }
+  self->size = size;
+
+  return 0;
+}
+
+/**
+ * Copies the hot data of the widget to the given
+ * index.
+ */
+void
+ztk_widget_table_set (
+  ZtkWidgetTable * self,
+  int              idx,
+  ZtkWidget *      widget)
+{
+  ZtkRect * rect = &widget->rect;
+  self->x1[idx] = (float) rect->x;
+  self->y1[idx] = (float) rect->y;
+  self->x2[idx] = (float) (rect->x + rect->width);
+  self->y2[idx] = (float) (rect->y + rect->height);
+
+  uint32_t flags =
+    (uint32_t) widget->state &
+      ZTK_WIDGET_TABLE_STATE_MASK;
+  if (widget->visible)
+    flags |= ZTK_WIDGET_TABLE_VISIBLE;
+  if (widget->type == ZTK_WIDGET_TYPE_COMBO_BOX)
+    flags |= ZTK_WIDGET_TABLE_COMBO_BOX;
+  self->flags[idx] = flags;
+
+  self->z[idx] = widget->z;
+}
+
+/**
+ * Copies the hot data of all the given widgets
+ * and stores their indices in them.
+ */
+void
+ztk_widget_table_rebuild (
+  ZtkWidgetTable * self,
+  ZtkWidget **     widgets,
+  int              num_widgets)
+{
+  if (ztk_widget_table_reserve (self, num_widgets))
+    return;
+
+  for (int i = 0; i < num_widgets; i++)
+    {
+      ztk_widget_table_set (self, i, widgets[i]);
+      widgets[i]->table_idx = i;
+    }
+
+  /* clear the entries left over */
+  for (int i = num_widgets; i < self->num_widgets;
+       i++)
+    {
+      self->flags[i] = 0;
+    }
+  self->num_widgets = num_widgets;
+}
+
+/**
+ * Returns the index of the top-most visible widget
+ * hit by the given coordinates, or -1.
+ */
+int
+ztk_widget_table_find_top_hit (
+  const ZtkWidgetTable * self,
+  double                 x,
+  double                 y)
+{
+  ZtkRect point = { x, y, 0.0, 0.0 };
+  uint8_t * mask = self->masks[0];
+  if (!ztk_hit_test_batch (self, &point, mask))
+    return -1;
+
+  for (int i = ztk_hit_test_get_mask_size (self) - 1;
+       i >= 0; i--)
+    {
+      if (mask[i])
+        return i * 8 + 31 - __builtin_clz (mask[i]);
+    }
+
+  return -1;
+}
+
+/**
+ * Frees the arrays.
+ */
+void
+ztk_widget_table_free (
+  ZtkWidgetTable * self)
+{
+  free_aligned (self->x1);
+  free_aligned (self->y1);
+  free_aligned (self->x2);
+  free_aligned (self->y2);
+  free_aligned (self->flags);
+  free_aligned (self->z);
+  for (int i = 0; i < ZTK_WIDGET_TABLE_NUM_MASKS; i++)
+    {
+      free (self->masks[i]);
+    }
+  memset (self, 0, sizeof (ZtkWidgetTable));
+}
@@ -21,11 +21,41 @@
 #include <stdio.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "ztoolkit/probes.h"
 #include "ztoolkit/ztk.h"
 
 #include "pugl/pugl.h"
 #include "pugl/pugl_cairo.h"
 
+/**
+ * Adds the phases of a frame to the statistics.
+ */
+static void
+add_frame_stats (
+  ZtkApp * self,
+  double   start,
+  double   update_end,
+  double   draw_end)
+{
+  ZtkAppStats * stats = &self->stats;
+  stats->num_frames++;
+  ztk_phase_stats_add (
+    &stats->dispatch, self->pending_dispatch_time);
+  ztk_phase_stats_add (
+    &stats->update, update_end - start);
+  ztk_phase_stats_add (
+    &stats->draw, draw_end - update_end);
+  self->pending_dispatch_time = 0.0;
+  self->idle_handler_time += draw_end - start;
+  self->idle_drew_frame = 1;
+}
+
 static void
 on_close (PuglView* view)
 {
@@ -38,14 +68,27 @@ on_expose (
   const PuglEventExpose * expose)
 {
   ZtkApp * self = puglGetHandle (view);
+  ZTK_PROBE5 (
+    frame_begin, self, (int) expose->x,
+    (int) expose->y, (int) expose->width,
+    (int) expose->height);
+
+  int stats = self->stats_enabled;
+  int timed = stats || self->debug_overlay;
+  double start =
+    timed ? ztk_stats_get_time () : 0.0;
 
   /** update each widget */
   ZtkWidget * w = NULL;
   for (int i = 0; i < self->num_widgets; i++)
     {
       w = self->widgets[i];
+      ZTK_TRACE_BEGIN (update_cb);
       w->update_cb (w, w->user_data);
+      ZTK_TRACE_END (update_cb, (int) w->type);
     }
+  double update_end =
+    timed ? ztk_stats_get_time () : 0.0;
 
   /* reset offsets */
   self->prev_press_x = self->offset_press_x;
@@ -71,30 +114,86 @@ on_expose (
   ZtkRect rect = {
     expose->x, expose->y, expose->width,
     expose->height };
+
+  /* only touch the damaged area, so that widgets
+   * intersecting it don't paint over widgets
+   * outside it */
+  cairo_rectangle (
+    cr, rect.x, rect.y, rect.width, rect.height);
+  cairo_clip (cr);
+
   ztk_app_draw (
     self, cr, &rect);
+
+  double end =
+    timed ? ztk_stats_get_time () : 0.0;
+  if (stats)
+    {
+      add_frame_stats (
+        self, start, update_end, end);
+    }
+  if (self->debug_overlay)
+    {
+      ztk_debug_overlay_add_frame (
+        self->debug_overlay, start, end - start);
+    }
+
+  ZTK_PROBE2 (
+    frame_end, self, self->num_damage_rects);
 }
 
+/**
+ * Hit-tests the widget at \p idx while dispatching
+ * events, counting it in
+ * \ref ZtkApp.num_hit_tests.
+ */
 static int
-is_first_widget_hit (
+is_hit (
   ZtkApp *    self,
-  ZtkWidget * widget,
+  int         idx,
   double      x,
   double      y)
 {
-  for (int i = self->num_widgets - 1; i >= 0; i--)
-    {
-      ZtkWidget * w = self->widgets[i];
-      if (w->visible && ztk_widget_is_hit (w, x, y))
-        {
-          if (widget == w)
-            return 1;
-          else
-            return 0;
-        }
-    }
+  self->num_hit_tests++;
+  return
+    ztk_widget_table_is_hit (
+      &self->widget_table, idx, x, y);
+}
 
-  return 0;
+/**
+ * Returns the top-most widget hit by the given
+ * coordinates, if any.
+ */
+static ZtkWidget *
+get_first_widget_hit (
+  ZtkApp * self,
+  double   x,
+  double   y)
+{
+  int idx =
+    ztk_widget_table_find_top_hit (
+      &self->widget_table, x, y);
+  self->num_hit_tests +=
+    (unsigned long) self->num_widgets;
+
+  return idx >= 0 ? self->widgets[idx] : NULL;
+}
+
+/**
+ * Mirrors the state of the widget at \p idx in the
+ * widget table.
+ */
+static void
+sync_state (
+  ZtkApp *    self,
+  int         idx,
+  ZtkWidget * widget)
+{
+  uint32_t * flags = &self->widget_table.flags[idx];
+  *flags =
+    (*flags & ~ZTK_WIDGET_TABLE_STATE_MASK) |
+    ((uint32_t) widget->state &
+       ZTK_WIDGET_TABLE_STATE_MASK);
 }
 
 static void
@@ -102,6 +201,7 @@ post_event_to_widgets (
   ZtkApp *          self,
   const PuglEvent * event)
 {
+  ZTK_TRACE_BEGIN (post_event_to_widgets);
   ZtkWidget * w = NULL;
 
   /* if any combo box is active:
@@ -116,13 +216,11 @@ post_event_to_widgets (
       for (int i = self->num_widgets - 1;
            i >= 0; i--)
         {
-          w = self->widgets[i];
-          if (w->type ==
-                 ZTK_WIDGET_TYPE_COMBO_BOX)
+          if (self->widget_table.flags[i] &
+                ZTK_WIDGET_TABLE_COMBO_BOX)
             {
-              if (w->visible &&
-                  ztk_widget_is_hit (
-                    w, ev->x, ev->y))
+              w = self->widgets[i];
+              if (is_hit (self, i, ev->x, ev->y))
                 {
                   combo_box_hit = 1;
                 }
@@ -134,6 +232,21 @@ post_event_to_widgets (
         }
     }
 
+  /* the widget receiving presses and motion */
+  ZtkWidget * first_hit = NULL;
+  if (event->type == PUGL_BUTTON_PRESS)
+    {
+      first_hit =
+        get_first_widget_hit (
+          self, event->button.x, event->button.y);
+    }
+  else if (event->type == PUGL_MOTION_NOTIFY)
+    {
+      first_hit =
+        get_first_widget_hit (
+          self, event->motion.x, event->motion.y);
+    }
+
   for (int i = self->num_widgets - 1; i >= 0; i--)
     {
       w = self->widgets[i];
@@ -155,11 +268,7 @@ post_event_to_widgets (
           {
             const PuglEventButton * ev =
               (const PuglEventButton *) event;
-            if (w->visible &&
-                ztk_widget_is_hit (
-                  w, ev->x, ev->y) &&
-                is_first_widget_hit (
-                  self, w, ev->x, ev->y))
+            if (w == first_hit)
               {
                 w->before_last_btn_press = w->last_btn_press;
                 w->last_btn_press = ev->time;
@@ -173,6 +282,7 @@ post_event_to_widgets (
                   }
                 w->state |=
                   ZTK_WIDGET_STATE_SELECTED;
+                sync_state (self, i, w);
                 if (w->button_event_cb &&
                     (w->type ==
                        ZTK_WIDGET_TYPE_COMBO_BOX ||
@@ -187,6 +297,7 @@ post_event_to_widgets (
                 w->state &=
                   (unsigned int)
                   ~ZTK_WIDGET_STATE_SELECTED;
+                sync_state (self, i, w);
               }
           }
           break;
@@ -200,6 +311,7 @@ post_event_to_widgets (
             w->state &=
               (unsigned int)
               ~ZTK_WIDGET_STATE_RIGHT_PRESSED;
+            sync_state (self, i, w);
             w->mod = ev->state;
             w->before_last_btn_release =
               w->last_btn_release;
@@ -220,14 +332,11 @@ post_event_to_widgets (
             const PuglEventMotion * ev =
               (const PuglEventMotion *) event;
             w->mod = ev->state;
-            if (w->visible &&
-                ztk_widget_is_hit (
-                  w, ev->x, ev->y) &&
-                is_first_widget_hit (
-                  self, w, ev->x, ev->y))
+            if (w == first_hit)
               {
                 w->state |=
                   ZTK_WIDGET_STATE_HOVERED;
+                sync_state (self, i, w);
                 if (w->motion_event_cb)
                   {
                     w->motion_event_cb (
@@ -239,6 +348,7 @@ post_event_to_widgets (
                 w->state &=
                   (unsigned int)
                   ~ZTK_WIDGET_STATE_HOVERED;
+                sync_state (self, i, w);
               }
           }
           break;
@@ -252,6 +362,7 @@ post_event_to_widgets (
                 w->state &=
                   (unsigned int)
                   ~ZTK_WIDGET_STATE_HOVERED;
+                sync_state (self, i, w);
                 if (w->visible &&
                     w->motion_event_cb)
                   {
@@ -266,9 +377,7 @@ post_event_to_widgets (
             const PuglEventScroll * ev =
               (const PuglEventScroll *) event;
             w->mod = ev->state;
-            if (w->visible &&
-                ztk_widget_is_hit (
-                  w, ev->x, ev->y) &&
+            if (is_hit (self, i, ev->x, ev->y) &&
                 w->scroll_event_cb)
               {
                 w->scroll_event_cb (w, ev);
@@ -279,6 +388,9 @@ post_event_to_widgets (
           break;
         }
     }
+
+  ZTK_TRACE_END (
+    post_event_to_widgets, (int) event->type);
 }
 
 #undef POST_EVENT_FUNC
@@ -289,7 +401,24 @@ on_event (
   const PuglEvent * event)
 {
   ZtkApp * self = puglGetHandle (view);
+  ZTK_TRACE_BEGIN (on_event);
+
+  /* exposes are counted as frames */
+  int stats =
+    self->stats_enabled &&
+    event->type != PUGL_EXPOSE;
+  double start =
+    stats ? ztk_stats_get_time () : 0.0;
+
+  if (self->recorder)
+    {
+      ztk_recorder_write (
+        self->recorder, puglGetTime (self->world),
+        event);
+    }
 
+  ZTK_PROBE2 (
+    event_dispatch, self, (int) event->type);
   post_event_to_widgets (self, event);
 
   switch (event->type)
@@ -345,6 +474,11 @@ on_event (
     case PUGL_KEY_RELEASE:
       puglPostRedisplay(view);
       break;
+    case PUGL_CONFIGURE:
+      /* the surface may have been recreated */
+      self->redraw_all = 1;
+      puglPostRedisplay(view);
+      break;
     case PUGL_EXPOSE:
       on_expose (view, &event->expose);
       break;
@@ -356,6 +490,15 @@ on_event (
       break;
     }
 
+  if (stats)
+    {
+      double time = ztk_stats_get_time () - start;
+      self->pending_dispatch_time += time;
+      self->idle_handler_time += time;
+    }
+
+  ZTK_TRACE_END (on_event, (int) event->type);
+
   return PUGL_SUCCESS;
 }
 
@@ -373,7 +516,18 @@ ztk_app_new (
 {
   ZtkApp * self = calloc (1, sizeof (ZtkApp));
 
+  /* opt-in, since the log thread is global and the
+   * app may be a plugin sharing the process */
+  const char * async_log = getenv ("ZTK_ASYNC_LOG");
+  if (async_log && *async_log &&
+      !ztk_log_start_async (
+        ZTK_LOG_DEFAULT_NUM_MESSAGES))
+    {
+      self->started_async_log = 1;
+    }
+
   ztk_theme_init (&self->theme);
+  self->strings = ztk_string_table_new ();
 
   self->world = puglNewWorld ();
   self->title = strdup (title);
@@ -381,6 +535,10 @@ ztk_app_new (
   self->height = height;
   self->widgets = calloc (1, sizeof (ZtkWidget *));
   self->widgets_size = 1;
+  self->redraw_all = 1;
+#ifdef __APPLE__
+  self->backend_discards_frame = 1;
+#endif
 
   puglSetClassName (self->world, title);
   PuglRect frame = { 0, 0, width, height };
@@ -408,9 +566,55 @@ ztk_app_new (
 
   puglShowWindow (self->view);
 
+  const char * record_path =
+    getenv ("ZTK_RECORD_EVENTS");
+  if (record_path && *record_path)
+    {
+      ztk_app_start_recording (self, record_path);
+    }
+
+  const char * trace_path = getenv ("ZTK_TRACE");
+  if (trace_path && *trace_path &&
+      !ztk_trace_start (
+        trace_path, ZTK_TRACE_DEFAULT_NUM_EVENTS))
+    {
+      self->started_trace = 1;
+    }
+
+  const char * debug_overlay =
+    getenv ("ZTK_DEBUG_OVERLAY");
+  if (debug_overlay && *debug_overlay)
+    {
+      ztk_app_set_debug_overlay_enabled (self, 1);
+    }
+
   return self;
 }
 
+/**
+ * Makes room for the damage rectangles of a frame,
+ * so that drawing does not need to allocate.
+ */
+static void
+reserve_damage_rects (
+  ZtkApp * self)
+{
+  /* at least one for full redraws */
+  int max_rects = MAX (self->num_widgets, 1);
+  if (self->debug_overlay)
+    max_rects += ZTK_DEBUG_OVERLAY_MAX_FLASHES + 1;
+  if (self->damage_rects_size < max_rects)
+    {
+      self->damage_rects_size = max_rects;
+      self->damage_rects =
+        (ZtkRect *)
+        realloc (
+          self->damage_rects,
+          (size_t) self->damage_rects_size *
+            sizeof (ZtkRect));
+    }
+}
+
 static int
 cmp_z (
   const void * a,
@@ -468,6 +672,11 @@ ztk_app_add_widget (
   qsort (
     self->widgets, (size_t) self->num_widgets,
     sizeof (ZtkWidget *), cmp_z);
+  ztk_widget_table_rebuild (
+    &self->widget_table, self->widgets,
+    self->num_widgets);
+
+  reserve_damage_rects (self);
 }
 
 /**
@@ -504,6 +713,41 @@ ztk_app_remove_widget (
     }
 
   self->num_widgets--;
+  ztk_widget_table_rebuild (
+    &self->widget_table, self->widgets,
+    self->num_widgets);
+
+  /* it may be freed before its assets are loaded */
+  if (self->asset_loader)
+    {
+      ztk_asset_loader_cancel (
+        self->asset_loader, widget);
+    }
+
+  /* nothing else knows the area it covered */
+  self->redraw_all = 1;
+}
+
+/**
+ * Updates the hot data of the widget in
+ * \ref ZtkApp.widget_table after its rectangle or
+ * visibility changed.
+ *
+ * Called by the widget setters.
+ */
+void
+ztk_app_update_widget (
+  ZtkApp *    self,
+  ZtkWidget * widget)
+{
+  /* the index is stale if the widget was removed */
+  int idx = widget->table_idx;
+  if (idx < 0 || idx >= self->num_widgets ||
+      self->widgets[idx] != widget)
+    return;
+
+  ztk_widget_table_set (
+    &self->widget_table, idx, widget);
 }
 
 int
@@ -520,8 +764,164 @@ ztk_app_contains_widget (
   return 0;
 }
 
+/**
+ * Returns whether the widget at \p idx is set in
+ * the hit mask.
+ */
+static inline int
+is_in_mask (
+  const uint8_t * mask,
+  int             idx)
+{
+  return (mask[idx / 8] >> (idx % 8)) & 1;
+}
+
+/**
+ * Sets \p damaged to the mask of the widgets
+ * overlapping any of the first \p num_rects damage
+ * rectangles and \p exposed.
+ */
+static void
+get_damaged_mask (
+  ZtkApp *        self,
+  int             num_rects,
+  const uint8_t * exposed,
+  uint8_t *       damaged)
+{
+  ZtkWidgetTable * table = &self->widget_table;
+  uint8_t * mask = table->masks[0];
+  int mask_size = ztk_hit_test_get_mask_size (table);
+  if (mask_size == 0)
+    return;
+
+  memset (damaged, 0, (size_t) mask_size);
+  for (int i = 0; i < num_rects; i++)
+    {
+      ztk_hit_test_batch (
+        table, &self->damage_rects[i], mask);
+      for (int j = 0; j < mask_size; j++)
+        {
+          damaged[j] |= mask[j];
+        }
+    }
+  for (int j = 0; j < mask_size; j++)
+    {
+      damaged[j] &= exposed[j];
+    }
+}
+
+/**
+ * Returns the area of the intersection of the
+ * given rectangles.
+ */
+static double
+get_overlap_area (
+  const ZtkRect * a,
+  const ZtkRect * b)
+{
+  double width =
+    MIN (a->x + a->width, b->x + b->width) -
+    MAX (a->x, b->x);
+  double height =
+    MIN (a->y + a->height, b->y + b->height) -
+    MAX (a->y, b->y);
+  if (width <= 0.0 || height <= 0.0)
+    return 0.0;
+
+  return width * height;
+}
+
+/**
+ * Returns the pixels of the widget inside the
+ * given rectangle and the first \p num_rects
+ * damage rectangles.
+ */
+static double
+get_painted_area (
+  ZtkApp *    self,
+  ZtkWidget * widget,
+  ZtkRect *   rect,
+  int         num_rects)
+{
+  double area = 0.0;
+  for (int i = 0; i < num_rects; i++)
+    {
+      ZtkRect * r = &self->damage_rects[i];
+      ZtkRect damage = {
+        MAX (r->x, rect->x), MAX (r->y, rect->y),
+        0.0, 0.0 };
+      damage.width =
+        MIN (r->x + r->width, rect->x + rect->width) -
+        damage.x;
+      damage.height =
+        MIN (
+          r->y + r->height, rect->y + rect->height) -
+        damage.y;
+      area += get_overlap_area (&widget->rect, &damage);
+    }
+
+  return area;
+}
+
+/**
+ * Returns the pixels of the first \p num_rects
+ * damage rectangles inside the given rectangle.
+ */
+static double
+get_damage_area (
+  ZtkApp *  self,
+  ZtkRect * rect,
+  int       num_rects)
+{
+  double area = 0.0;
+  for (int i = 0; i < num_rects; i++)
+    {
+      area +=
+        get_overlap_area (
+          &self->damage_rects[i], rect);
+    }
+
+  return area;
+}
+
+/**
+ * Adds the results of a draw to the statistics.
+ */
+static void
+add_draw_stats (
+  ZtkApp *  self,
+  ZtkRect * rect,
+  int       num_rects,
+  int       num_drawn,
+  double    pixels_painted)
+{
+  int num_visible = 0;
+  for (int i = 0; i < self->num_widgets; i++)
+    {
+      if (self->widget_table.flags[i] &
+            ZTK_WIDGET_TABLE_VISIBLE)
+        num_visible++;
+    }
+
+  ZtkAppStats * stats = &self->stats;
+  stats->last_widgets_drawn = num_drawn;
+  stats->last_widgets_culled =
+    num_visible - num_drawn;
+  stats->widgets_drawn += (unsigned long) num_drawn;
+  stats->widgets_culled +=
+    (unsigned long) (num_visible - num_drawn);
+  stats->pixels_damaged +=
+    get_damage_area (self, rect, num_rects);
+  stats->pixels_painted += pixels_painted;
+}
+
 /**
  * Draws each hit widget.
+ *
+ * Widgets whose fingerprint did not change since
+ * they were last drawn are skipped, unless they
+ * overlap a widget that changed or the backend
+ * does not keep the last frame.
  */
 void
 ztk_app_draw (
@@ -529,24 +929,632 @@ ztk_app_draw (
   cairo_t * cr,
   ZtkRect * rect)
 {
+  ZtkDebugOverlay * overlay = self->debug_overlay;
+
+  /* normally already reserved */
+  reserve_damage_rects (self);
+
+  double time =
+    overlay ? ztk_stats_get_time () : 0.0;
+
+  /* collect the rectangles of changed widgets */
+  int num_rects = 0;
+  int redraw_all =
+    self->redraw_all || self->backend_discards_frame;
+  ZtkWidgetTable * table = &self->widget_table;
+  uint8_t * exposed = table->masks[1];
+  ztk_hit_test_batch (table, rect, exposed);
   for (int i = 0; i < self->num_widgets; i++)
     {
+      if (!is_in_mask (exposed, i))
+        continue;
+
       ZtkWidget * widget = self->widgets[i];
-      if (!widget->visible ||
-          !ztk_widget_is_hit_by_rect (widget, rect))
+      if (ztk_widget_is_unchanged (widget) &&
+          !redraw_all)
+        continue;
+
+      /* widgets may draw outside their rectangle
+       * (eg, labels), in which case the whole area
+       * must be redrawn. The loop goes on so that
+       * the fingerprints of the widgets after it are
+       * up to date when they are marked drawn */
+      if (widget->rect.width <= 0.0 ||
+          widget->rect.height <= 0.0)
+        {
+          redraw_all = 1;
+          continue;
+        }
+
+      self->damage_rects[num_rects++] = widget->rect;
+      if (overlay && !redraw_all)
+        {
+          ztk_debug_overlay_add_flash (
+            overlay, &widget->rect, widget, time);
+        }
+    }
+  self->redraw_all = 0;
+  if (redraw_all)
+    {
+      self->damage_rects[0] = *rect;
+      num_rects = 1;
+    }
+  if (overlay)
+    {
+      /* full repaints flash in red, then the
+       * overlay repaints its own areas */
+      if (redraw_all)
+        {
+          ztk_debug_overlay_add_flash (
+            overlay, rect, NULL, time);
+        }
+      num_rects +=
+        ztk_debug_overlay_get_damage (
+          overlay, &self->damage_rects[num_rects]);
+    }
+  self->num_damage_rects = num_rects;
+  ZTK_TRACE_COUNTER (
+    "damage_area",
+    get_damage_area (self, rect, num_rects));
+  int stats = self->stats_enabled;
+  if (num_rects == 0)
+    {
+      if (stats)
+        add_draw_stats (self, rect, 0, 0, 0.0);
+      return;
+    }
+
+  cairo_save (cr);
+  for (int i = 0; i < num_rects; i++)
+    {
+      ZtkRect * r = &self->damage_rects[i];
+      cairo_rectangle (
+        cr, r->x, r->y, r->width, r->height);
+    }
+  cairo_clip (cr);
+
+  /* redraw everything under and over the changed
+   * widgets, so that stacking is preserved */
+  int num_drawn = 0;
+  double pixels_painted = 0.0;
+  uint8_t * damaged = table->masks[2];
+  get_damaged_mask (self, num_rects, exposed, damaged);
+  for (int i = 0; i < self->num_widgets; i++)
+    {
+      if (!is_in_mask (damaged, i))
         continue;
 
+      ZtkWidget * widget = self->widgets[i];
+
+      double start =
+        stats ? ztk_stats_get_time () : 0.0;
+      ZTK_PROBE2 (
+        widget_draw_begin, widget,
+        (int) widget->type);
+      ZTK_TRACE_BEGIN (draw_cb);
       widget->draw_cb (
         widget, cr, rect, widget->user_data);
+      ZTK_TRACE_END (draw_cb, (int) widget->type);
+      ZTK_PROBE2 (
+        widget_draw_end, widget, (int) widget->type);
+      num_drawn++;
+      if (stats)
+        {
+          widget->draw_time +=
+            ztk_stats_get_time () - start;
+          widget->num_draws++;
+          pixels_painted +=
+            get_painted_area (
+              self, widget, rect, num_rects);
+        }
+
+      /* if only part of the widget was drawn, draw
+       * the rest in the next expose */
+      if (ztk_rect_contains (rect, &widget->rect))
+        ztk_widget_mark_drawn (widget);
+      else
+        ztk_widget_queue_draw (widget);
+    }
+
+  if (overlay)
+    ztk_debug_overlay_draw (overlay, cr, time);
+
+  cairo_restore (cr);
+
+  if (stats)
+    {
+      add_draw_stats (
+        self, rect, num_rects, num_drawn,
+        pixels_painted);
     }
 }
 
+/**
+ * Returns the current time in seconds.
+ *
+ * While replaying a recording, this is the
+ * recorded time of the event being replayed, so
+ * that time-dependent behavior such as gesture
+ * coalescing is reproduced exactly.
+ */
+double
+ztk_app_get_time (
+  ZtkApp * self)
+{
+  if (self->replaying)
+    return self->replay_time;
+
+  return puglGetTime (self->world);
+}
+
+/**
+ * Starts recording the events received by the app
+ * to the given file, replacing any recording in
+ * progress.
+ *
+ * Recording can also be enabled by setting the
+ * ZTK_RECORD_EVENTS environment variable to a
+ * path before creating the app.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_app_start_recording (
+  ZtkApp *     self,
+  const char * path)
+{
+  ztk_app_stop_recording (self);
+
+  self->recorder =
+    ztk_recorder_new (
+      path, self->width, self->height);
+
+  return self->recorder ? 0 : -1;
+}
+
+/**
+ * Stops recording events.
+ */
+void
+ztk_app_stop_recording (
+  ZtkApp * self)
+{
+  if (self->recorder)
+    {
+      ztk_recorder_free (self->recorder);
+      self->recorder = NULL;
+    }
+}
+
+/**
+ * Sleeps until the given time, in the clock of
+ * puglGetTime().
+ */
+static void
+wait_until (
+  ZtkApp * self,
+  double   time)
+{
+  double remaining = time - puglGetTime (self->world);
+  if (remaining <= 0.0)
+    return;
+
+#ifdef _WIN32
+  Sleep ((DWORD) (remaining * 1000.0));
+#else
+  struct timespec ts = {
+    (time_t) remaining,
+    (long)
+      ((remaining - (double) (time_t) remaining) *
+         1e9) };
+  nanosleep (&ts, NULL);
+#endif
+}
+
+/**
+ * Appends a frame to the report.
+ */
+static void
+add_frame (
+  ZtkReplayReport * report,
+  ZtkReplayFrame *  frame)
+{
+  if (report->num_frames == report->frames_size)
+    {
+      report->frames_size =
+        report->frames_size ?
+          report->frames_size * 2 : 64;
+      report->frames =
+        (ZtkReplayFrame *)
+        realloc (
+          report->frames,
+          (size_t) report->frames_size *
+            sizeof (ZtkReplayFrame));
+    }
+  report->frames[report->num_frames++] = *frame;
+
+  report->dispatch_time += frame->dispatch_time;
+  report->draw_time += frame->draw_time;
+  if (frame->num_damage_rects > 0)
+    report->num_redraws++;
+}
+
+/**
+ * Replays a recording into the app.
+ *
+ * Input events are passed to the app directly and
+ * each recorded expose draws a frame, so the app
+ * should be in the state it was in when recording
+ * started. This is meant to be used with the
+ * headless platform.
+ *
+ * @param max_speed If non-zero, events are
+ *   replayed as fast as possible, otherwise at the
+ *   recorded times.
+ * @param report Report to fill in. Must be cleared
+ *   with ztk_replay_report_clear() afterwards.
+ *
+ * @return 0 if successful.
+ */
+int
+ztk_app_replay (
+  ZtkApp *          self,
+  const char *      path,
+  int               max_speed,
+  ZtkReplayReport * report)
+{
+  memset (report, 0, sizeof (ZtkReplayReport));
+
+  ZtkRecording * recording =
+    ztk_recording_open (path);
+  if (!recording)
+    return -1;
+
+  if (recording->width != self->width ||
+      recording->height != self->height)
+    {
+      ztk_warning (
+        "Replaying a %dx%d recording into a %dx%d "
+        "app", recording->width, recording->height,
+        self->width, self->height);
+    }
+
+  /* draw any pending changes first so that they
+   * are not counted */
+  puglDispatchEvents (self->world);
+
+  self->replaying = 1;
+  double start_time = puglGetTime (self->world);
+  ZtkReplayFrame frame;
+  memset (&frame, 0, sizeof (frame));
+  double time;
+  PuglEvent event;
+  while (ztk_recording_read_event (
+           recording, &time, &event))
+    {
+      if (!max_speed)
+        wait_until (self, start_time + time);
+      self->replay_time = time;
+
+      if (event.type != PUGL_EXPOSE)
+        {
+          double before = puglGetTime (self->world);
+          on_event (self->view, &event);
+          frame.dispatch_time +=
+            puglGetTime (self->world) - before;
+          frame.num_events++;
+          report->num_events++;
+          continue;
+        }
+
+      /* draw the recorded frame along with anything
+       * invalidated by the events before it */
+      PuglRect rect = {
+        event.expose.x, event.expose.y,
+        event.expose.width, event.expose.height };
+      self->num_damage_rects = 0;
+      double before = puglGetTime (self->world);
+      puglPostRedisplayRect (self->view, rect);
+      puglDispatchEvents (self->world);
+      frame.draw_time =
+        puglGetTime (self->world) - before;
+      frame.time = time;
+      frame.num_damage_rects =
+        self->num_damage_rects;
+      add_frame (report, &frame);
+      memset (&frame, 0, sizeof (frame));
+    }
+  self->replaying = 0;
+
+  ztk_recording_close (recording);
+
+  return 0;
+}
+
+/**
+ * Enables or disables collecting statistics.
+ *
+ * Collecting statistics is off by default and
+ * costs a few clock reads per frame and per drawn
+ * widget while on.
+ */
+void
+ztk_app_set_stats_enabled (
+  ZtkApp * self,
+  int      enabled)
+{
+  if (enabled && !self->stats_enabled)
+    self->pending_dispatch_time = 0.0;
+  self->stats_enabled = enabled;
+}
+
+/**
+ * Copies the statistics collected so far into
+ * \p stats.
+ */
+void
+ztk_app_get_stats (
+  ZtkApp *      self,
+  ZtkAppStats * stats)
+{
+  *stats = self->stats;
+  stats->overdraw =
+    stats->pixels_damaged > 0.0 ?
+      stats->pixels_painted / stats->pixels_damaged :
+      0.0;
+
+  /* keep the most expensive widgets sorted by
+   * insertion */
+  stats->num_top_widgets = 0;
+  for (int i = 0; i < self->num_widgets; i++)
+    {
+      ZtkWidget * w = self->widgets[i];
+      if (!w->num_draws)
+        continue;
+
+      int j = stats->num_top_widgets;
+      if (j == ZTK_STATS_MAX_TOP_WIDGETS)
+        {
+          if (w->draw_time <=
+                stats->top_widgets[j - 1].draw_time)
+            continue;
+          j--;
+        }
+      else
+        {
+          stats->num_top_widgets++;
+        }
+      while (j > 0 &&
+             stats->top_widgets[j - 1].draw_time <
+               w->draw_time)
+        {
+          stats->top_widgets[j] =
+            stats->top_widgets[j - 1];
+          j--;
+        }
+      stats->top_widgets[j].widget = w;
+      stats->top_widgets[j].draw_time = w->draw_time;
+      stats->top_widgets[j].num_draws = w->num_draws;
+    }
+}
+
+/**
+ * Clears the statistics collected so far,
+ * including the draw times of the widgets.
+ */
+void
+ztk_app_reset_stats (
+  ZtkApp * self)
+{
+  memset (&self->stats, 0, sizeof (ZtkAppStats));
+  self->pending_dispatch_time = 0.0;
+  for (int i = 0; i < self->num_widgets; i++)
+    {
+      self->widgets[i]->draw_time = 0.0;
+      self->widgets[i]->num_draws = 0;
+    }
+}
+
+/**
+ * Enables or disables the debug overlay.
+ *
+ * The overlay shows the frame rate and a graph of
+ * the frame times, and flashes each area repainted
+ * in a color per widget that caused it, or in red
+ * for full repaints. While enabled, the app redraws
+ * on every ztk_app_idle() call.
+ *
+ * The overlay can also be enabled by setting the
+ * ZTK_DEBUG_OVERLAY environment variable before
+ * creating the app.
+ */
+void
+ztk_app_set_debug_overlay_enabled (
+  ZtkApp * self,
+  int      enabled)
+{
+  if (enabled && !self->debug_overlay)
+    {
+      self->debug_overlay = ztk_debug_overlay_new ();
+      reserve_damage_rects (self);
+    }
+  else if (!enabled && self->debug_overlay)
+    {
+      ztk_debug_overlay_free (self->debug_overlay);
+      self->debug_overlay = NULL;
+
+      /* paint over the overlay */
+      self->redraw_all = 1;
+    }
+  puglPostRedisplay (self->view);
+}
+
+/**
+ * Sets the parameter store to drain on each
+ * ztk_app_idle() call.
+ *
+ * The store is not owned by the app and must
+ * outlive it.
+ */
+void
+ztk_app_set_param_store (
+  ZtkApp *        self,
+  ZtkParamStore * store)
+{
+  self->param_store = store;
+}
+
+/**
+ * Sets whether widgets created on the calling
+ * thread are allocated from the app's arena.
+ *
+ * This is the fast path for UIs that get opened
+ * and closed many times, like plugin UIs: the
+ * widgets are packed next to each other instead of
+ * scattered across the heap, and ztk_app_free()
+ * releases them all at once along with the arena.
+ *
+ * Widgets allocated from the arena must either be
+ * added to the app or not outlive it, and must not
+ * be freed separately.
+ */
+void
+ztk_app_use_arena (
+  ZtkApp * self,
+  int      use)
+{
+  if (use)
+    {
+      if (!self->arena)
+        self->arena = ztk_arena_new (0);
+      ztk_arena_set_current (self->arena);
+    }
+  else if (self->arena &&
+           ztk_arena_get_current () == self->arena)
+    {
+      ztk_arena_set_current (NULL);
+    }
+}
+
+/**
+ * Returns the app's asset loader, creating it if
+ * needed.
+ *
+ * The loader only keeps the app's loads, which run
+ * on the worker threads shared by all the apps.
+ *
+ * @return The loader, or NULL if the threads could
+ *   not be started.
+ */
+ZtkAssetLoader *
+ztk_app_get_asset_loader (
+  ZtkApp * self)
+{
+  if (!self->asset_loader)
+    self->asset_loader = ztk_asset_loader_new (0);
+
+  return self->asset_loader;
+}
+
+/**
+ * Loads the asset pack at \p abs_path, replacing
+ * the previous one.
+ *
+ * The pack is mapped once per process and shared
+ * with the other apps that load it.
+ *
+ * @return Non-zero if failed.
+ */
+int
+ztk_app_load_asset_pack (
+  ZtkApp *     self,
+  const char * abs_path)
+{
+  ZtkAssetPack * pack =
+    ztk_resource_cache_get_asset_pack (abs_path);
+  if (!pack)
+    return -1;
+
+  ztk_resource_cache_release (self->asset_pack);
+  self->asset_pack = pack;
+
+  return 0;
+}
+
+/**
+ * Returns the sprite \p name from the app's asset
+ * pack for the given scale factor.
+ *
+ * See ztk_asset_pack_get_sprite().
+ *
+ * @return The surface, valid until the pack is
+ *   replaced or the app is freed, or NULL if there
+ *   is no pack or no such sprite.
+ */
+cairo_surface_t *
+ztk_app_get_sprite (
+  ZtkApp *     self,
+  const char * name,
+  double       scale)
+{
+  if (!self->asset_pack)
+    return NULL;
+
+  return
+    ztk_asset_pack_get_sprite (
+      self->asset_pack, name, scale);
+}
+
+/**
+ * Processes pending events and redraws.
+ *
+ * To be called once per frame. Parameter changes
+ * from the DSP thread and assets loaded in the
+ * background are applied first, so the widgets
+ * showing them get redrawn in the same frame.
+ */
 void
 ztk_app_idle (
   ZtkApp * self)
 {
+  if (self->param_store)
+    {
+      ztk_param_store_drain (self->param_store);
+    }
+  if (self->asset_loader)
+    {
+      ztk_asset_loader_dispatch (self->asset_loader);
+    }
+
   puglPollEvents (self->world, 0);
+
+  /* keep the HUD and the flashes animating */
+  if (self->debug_overlay)
+    puglPostRedisplay (self->view);
+
+  /* whatever is not spent in the event handlers is
+   * spent in the backend */
+  int stats = self->stats_enabled;
+  double start = 0.0;
+  if (stats)
+    {
+      self->idle_handler_time = 0.0;
+      self->idle_drew_frame = 0;
+      start = ztk_stats_get_time ();
+    }
+  ZTK_TRACE_BEGIN (puglDispatchEvents);
   puglDispatchEvents (self->world);
+  ZTK_TRACE_END (puglDispatchEvents, -1);
+  if (stats && self->idle_drew_frame)
+    {
+      ztk_phase_stats_add (
+        &self->stats.backend,
+        ztk_stats_get_time () - start -
+          self->idle_handler_time);
+    }
+
+  /* write the trace after the frame */
+  ZTK_TRACE_FLUSH ();
 }
 
 /**
@@ -576,11 +1584,40 @@ void
 ztk_app_free (
   ZtkApp * self)
 {
+  /* stop loading before the widgets are gone */
+  if (self->asset_loader)
+    ztk_asset_loader_free (self->asset_loader);
+
+  /* free all the widgets in one pass. widgets in
+   * the arena only release what they own here and
+   * their memory goes with the arena */
+  for (int i = 0; i < self->num_widgets; i++)
+    {
+      ZtkWidget * widget = self->widgets[i];
+      if (widget->free_cb)
+        widget->free_cb (widget, widget->user_data);
+    }
+  free (self->widgets);
+  ztk_widget_table_free (&self->widget_table);
+  if (self->arena)
+    ztk_arena_free (self->arena);
+
   puglFreeView (self->view);
   puglFreeWorld (self->world);
 
   if (self->title)
     free (self->title);
+  free (self->damage_rects);
+  ztk_resource_cache_release (self->asset_pack);
+  ztk_theme_free (&self->theme);
+  ztk_string_table_free (self->strings);
+  ztk_app_stop_recording (self);
+  if (self->debug_overlay)
+    ztk_debug_overlay_free (self->debug_overlay);
+  if (self->started_trace)
+    ztk_trace_stop ();
+  if (self->started_async_log)
+    ztk_log_stop_async ();
 
   free (self);
 }
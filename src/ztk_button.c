@@ -17,12 +17,198 @@
  * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <ztoolkit/ztk.h>
 #include "pugl.h"
 
+#ifdef HAVE_RSVG
+/**
+ * Data of a background load of an SVG surface.
+ */
+typedef struct SvgLoad
+{
+  unsigned int id;
+  int          idx;
+  int          width;
+  int          height;
+  char         path[];
+} SvgLoad;
+
+static void
+clear_svg_surfaces (
+  ZtkButton * self)
+{
+  for (int i = 0; i < 3; i++)
+    {
+      ztk_resource_cache_release (
+        self->svg_surfaces[i]);
+      self->svg_surfaces[i] = NULL;
+    }
+}
+
+static void
+clear_svg_paths (
+  ZtkButton * self)
+{
+  for (int i = 0; i < 3; i++)
+    {
+      free (self->svg_paths[i]);
+      self->svg_paths[i] = NULL;
+    }
+}
+
+/**
+ * Loads an SVG and renders it, on a worker
+ * thread.
+ */
+static void *
+load_svg_surface (
+  const void * data)
+{
+  const SvgLoad * load = (const SvgLoad *) data;
+  ZtkRsvgHandle * svg =
+    ztk_resource_cache_get_svg (load->path);
+  if (!svg)
+    return NULL;
+
+  cairo_surface_t * surface =
+    ztk_resource_cache_get_svg_surface (
+      svg, load->width, load->height);
+  ztk_resource_cache_release (svg);
+
+  return surface;
+}
+
+static void
+on_svg_surface_loaded (
+  ZtkWidget *  widget,
+  void *       asset,
+  const void * data)
+{
+  ZtkButton * self = (ZtkButton *) widget;
+  const SvgLoad * load = (const SvgLoad *) data;
+
+  /* the SVGs or the size changed since */
+  if (load->id != self->svg_load_id ||
+      self->svg_surfaces[load->idx])
+    {
+      ztk_resource_cache_release (asset);
+      return;
+    }
+
+  self->svg_surfaces[load->idx] = asset;
+}
+
+/**
+ * Requests the surfaces of all the states at the
+ * given size, so that hovering or clicking does
+ * not wait for another load.
+ */
+static void
+request_svg_surfaces (
+  ZtkButton * self,
+  int         width,
+  int         height)
+{
+  ZtkWidget * widget = (ZtkWidget *) self;
+  ZtkAssetLoader * loader =
+    ztk_app_get_asset_loader (widget->app);
+  self->svg_load_id++;
+  for (int i = 0; i < 3; i++)
+    {
+      size_t path_size =
+        strlen (self->svg_paths[i]) + 1;
+      size_t size = sizeof (SvgLoad) + path_size;
+      SvgLoad * load = malloc (size);
+      load->id = self->svg_load_id;
+      load->idx = i;
+      load->width = width;
+      load->height = height;
+      memcpy (
+        load->path, self->svg_paths[i], path_size);
+
+      /* load synchronously if there are no
+       * threads */
+      if (loader)
+        {
+          ztk_asset_loader_load (
+            loader, widget, load_svg_surface,
+            on_svg_surface_loaded, load, size);
+        }
+      else
+        {
+          on_svg_surface_loaded (
+            widget, load_svg_surface (load), load);
+        }
+      free (load);
+    }
+}
+
+/**
+ * Draws the SVG for the given state from a surface
+ * rendered once per size and shared through the
+ * resource cache, since rendering SVGs allocates.
+ *
+ * @param idx 0 for normal, 1 for hover, 2 for
+ *   clicked.
+ */
+static void
+draw_svg (
+  ZtkButton *     self,
+  cairo_t *       cr,
+  int             idx,
+  ZtkRsvgHandle * svg)
+{
+  ZtkWidget * widget = (ZtkWidget *) self;
+  ZtkRect rect = {
+    widget->rect.x + self->hpadding,
+    widget->rect.y + self->vpadding,
+    widget->rect.width - self->hpadding * 2,
+    widget->rect.height - self->vpadding * 2 };
+  int width = (int) ceil (rect.width);
+  int height = (int) ceil (rect.height);
+  if (width <= 0 || height <= 0)
+    return;
+
+  if (width != self->svg_surface_width ||
+      height != self->svg_surface_height)
+    {
+      clear_svg_surfaces (self);
+      self->svg_surface_width = width;
+      self->svg_surface_height = height;
+      if (self->svg_paths[0])
+        request_svg_surfaces (self, width, height);
+    }
+
+  if (!self->svg_surfaces[idx])
+    {
+      /* still loading */
+      if (self->svg_paths[0])
+        return;
+
+      self->svg_surfaces[idx] =
+        ztk_resource_cache_get_svg_surface (
+          svg, width, height);
+
+      /* not loaded through the cache */
+      if (!self->svg_surfaces[idx])
+        {
+          ztk_rsvg_draw (svg, cr, &rect);
+          return;
+        }
+    }
+
+  cairo_set_source_surface (
+    cr, self->svg_surfaces[idx], rect.x, rect.y);
+  cairo_rectangle (
+    cr, rect.x, rect.y, width, height);
+  cairo_fill (cr);
+}
+#endif
+
 static void
 button_draw_cb (
   ZtkWidget * widget,
@@ -33,25 +219,28 @@ button_draw_cb (
   ZtkButton * self = (ZtkButton *) widget;
 
   ZtkWidgetState state = widget->state;
-  if (self->has_bg_colors)
+  if (self->bg_style)
     {
       if ((state & ZTK_WIDGET_STATE_PRESSED) ||
           (self->is_toggle &&
              self->toggled_getter (
                self, widget->user_data)))
         {
-          ztk_color_set_for_cairo (
-            &self->clicked_color, cr);
+          ztk_style_set_source (
+            self->bg_style,
+            ZTK_STYLE_COLOR_BG_CLICK, cr);
         }
       else if (state & ZTK_WIDGET_STATE_HOVERED)
         {
-          ztk_color_set_for_cairo (
-            &self->hovered_color, cr);
+          ztk_style_set_source (
+            self->bg_style,
+            ZTK_STYLE_COLOR_BG_HOVER, cr);
         }
       else
         {
-          ztk_color_set_for_cairo (
-            &self->normal_color, cr);
+          ztk_style_set_source (
+            self->bg_style,
+            ZTK_STYLE_COLOR_BG, cr);
         }
       cairo_rectangle (
         cr, widget->rect.x, widget->rect.y,
@@ -64,15 +253,6 @@ button_draw_cb (
         widget, cr, draw_rect, data);
     }
 
-#define DRAW_SVG(svg) \
-  ZtkRect rect = { \
-    widget->rect.x + self->hpadding, \
-    widget->rect.y + self->vpadding, \
-    widget->rect.width - self->hpadding * 2, \
-    widget->rect.height - self->vpadding * 2 }; \
-  ztk_rsvg_draw ( \
-    self->svg, cr, &rect)
-
   switch (self->type)
     {
     case ZTK_BTN_LBL:
@@ -85,18 +265,37 @@ button_draw_cb (
              self->toggled_getter (
                self, widget->user_data)))
         {
-          DRAW_SVG (clicked_svg);
+          draw_svg (self, cr, 2, self->clicked_svg);
         }
       else if (state & ZTK_WIDGET_STATE_HOVERED)
         {
-          DRAW_SVG (hover_svg);
+          draw_svg (self, cr, 1, self->hover_svg);
         }
       else
         {
-          DRAW_SVG (normal_svg);
+          draw_svg (self, cr, 0, self->normal_svg);
         }
       break;
 #endif
+    case ZTK_BTN_COMPILED_SVG:
+      {
+        int idx = 0;
+        if ((state & ZTK_WIDGET_STATE_PRESSED) ||
+            (self->is_toggle &&
+               self->toggled_getter (
+                 self, widget->user_data)))
+          idx = 2;
+        else if (state & ZTK_WIDGET_STATE_HOVERED)
+          idx = 1;
+        ZtkRect rect = {
+          widget->rect.x + self->hpadding,
+          widget->rect.y + self->vpadding,
+          widget->rect.width - self->hpadding * 2,
+          widget->rect.height - self->vpadding * 2 };
+        ztk_compiled_svg_draw (
+          self->compiled_svgs[idx], cr, &rect);
+      }
+      break;
     case ZTK_BTN_CUSTOM:
       self->custom_draw_cb (
         widget, cr, draw_rect, data);
@@ -104,8 +303,52 @@ button_draw_cb (
     default:
       break;
     }
+}
 
-#undef DRAW_SVG
+/**
+ * Built-in fingerprint, used unless the button has
+ * custom drawing.
+ */
+static uint64_t
+fingerprint_cb (
+  ZtkWidget * widget)
+{
+  ZtkButton * self = (ZtkButton *) widget;
+
+  uint64_t fp =
+    ztk_fingerprint_add (0, self->type);
+  fp =
+    ztk_fingerprint_add (
+      fp,
+      self->is_toggle &&
+        self->toggled_getter (
+          self, widget->user_data));
+  fp = ztk_fingerprint_add_str (fp, self->lbl);
+  for (int i = 0; i < 3; i++)
+    {
+      fp =
+        ztk_fingerprint_add (
+          fp,
+          (uint64_t) (uintptr_t)
+            self->compiled_svgs[i]);
+    }
+  if (self->bg_style)
+    {
+      fp =
+        ztk_fingerprint_add (
+          fp, self->bg_style->hash);
+    }
+#ifdef HAVE_RSVG
+  /* redraw when SVGs finish loading */
+  for (int i = 0; i < 3; i++)
+    {
+      fp =
+        ztk_fingerprint_add (
+          fp, self->svg_surfaces[i] != NULL);
+    }
+#endif
+
+  return fp;
 }
 
 static void
@@ -150,7 +393,14 @@ free_cb (
 {
   ZtkButton * self = (ZtkButton *) widget;
 
-  free (self);
+  if (self->lbl)
+    free (self->lbl);
+#ifdef HAVE_RSVG
+  clear_svg_surfaces (self);
+  clear_svg_paths (self);
+#endif
+  ztk_style_replace (&self->bg_style, NULL);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 /**
@@ -165,11 +415,13 @@ ztk_button_new (
   ZtkWidgetActivateCallback activate_cb,
   void *                    user_data)
 {
-  ZtkButton * self = calloc (1, sizeof (ZtkButton));
+  ZtkButton * self =
+    ztk_widget_alloc (sizeof (ZtkButton));
   ZtkWidget * widget = (ZtkWidget *) self;
   ztk_widget_init (
     (ZtkWidget *) self, ZTK_WIDGET_TYPE_BUTTON, rect,
     update_cb, button_draw_cb, free_cb);
+  widget->fingerprint_cb = fingerprint_cb;
 
   self->activate_cb = activate_cb;
 
@@ -198,7 +450,9 @@ ztk_button_make_labeled (
 {
   self->type = ZTK_BTN_LBL;
 
-  strcpy (self->lbl, label);
+  if (self->lbl)
+    free (self->lbl);
+  self->lbl = strdup (label);
 }
 
 #ifdef HAVE_RSVG
@@ -221,9 +475,70 @@ ztk_button_make_svged (
   self->normal_svg = svg_normal;
   self->hover_svg = svg_hover;
   self->clicked_svg = svg_clicked;
+  clear_svg_surfaces (self);
+  clear_svg_paths (self);
+  self->svg_load_id++;
+}
+
+/**
+ * Makes a button with the SVGs at the given
+ * paths, loaded and rendered in the background by
+ * the app's asset loader.
+ *
+ * Nothing is drawn in place of the SVGs until
+ * they are ready.
+ */
+void
+ztk_button_make_svged_from_files (
+  ZtkButton *  self,
+  int          hpadding,
+  int          vpadding,
+  const char * normal_path,
+  const char * hover_path,
+  const char * clicked_path)
+{
+  self->type = ZTK_BTN_SVG;
+
+  self->hpadding = hpadding;
+  self->vpadding = vpadding;
+  self->normal_svg = NULL;
+  self->hover_svg = NULL;
+  self->clicked_svg = NULL;
+  clear_svg_surfaces (self);
+  clear_svg_paths (self);
+  self->svg_paths[0] = strdup (normal_path);
+  self->svg_paths[1] = strdup (hover_path);
+  self->svg_paths[2] = strdup (clicked_path);
+
+  /* requested again at the next draw */
+  self->svg_load_id++;
+  self->svg_surface_width = 0;
+  self->svg_surface_height = 0;
 }
 #endif
 
+/**
+ * Makes a button with SVGs compiled at build time
+ * by svg2cairo.py.
+ */
+void
+ztk_button_make_compiled_svged (
+  ZtkButton *            self,
+  int                    hpadding,
+  int                    vpadding,
+  const ZtkCompiledSvg * svg_normal,
+  const ZtkCompiledSvg * svg_hover,
+  const ZtkCompiledSvg * svg_clicked)
+{
+  self->type = ZTK_BTN_COMPILED_SVG;
+
+  self->hpadding = hpadding;
+  self->vpadding = vpadding;
+  self->compiled_svgs[0] = svg_normal;
+  self->compiled_svgs[1] = svg_hover;
+  self->compiled_svgs[2] = svg_clicked;
+}
+
 /**
  * Makes a customly drawn button.
  */
@@ -235,8 +550,18 @@ ztk_button_make_custom (
   self->type = ZTK_BTN_CUSTOM;
 
   self->custom_draw_cb = draw_cb;
+
+  /* can't tell what the callback depends on */
+  ((ZtkWidget *) self)->fingerprint_cb = NULL;
 }
 
+/**
+ * Sets the background colors, creating a style
+ * for this button only.
+ *
+ * Prefer ztk_button_set_background_style() with a
+ * style shared by similar buttons.
+ */
 void
 ztk_button_set_background_colors (
   ZtkButton * self,
@@ -244,11 +569,25 @@ ztk_button_set_background_colors (
   ZtkColor *  hovered,
   ZtkColor *  clicked)
 {
-  self->has_bg_colors = 1;
+  ZtkColor colors[ZTK_STYLE_NUM_COLORS] = {
+    [ZTK_STYLE_COLOR_BG] = * normal,
+    [ZTK_STYLE_COLOR_BG_HOVER] = * hovered,
+    [ZTK_STYLE_COLOR_BG_CLICK] = * clicked, };
+  ZtkStyle * style = ztk_style_new (colors);
+  ztk_button_set_background_style (self, style);
+  ztk_style_unref (style);
+}
 
-  self->normal_color = * normal;
-  self->hovered_color = * hovered;
-  self->clicked_color = * clicked;
+/**
+ * Sets the style to draw the background with, or
+ * NULL to not draw background colors.
+ */
+void
+ztk_button_set_background_style (
+  ZtkButton * self,
+  ZtkStyle *  style)
+{
+  ztk_style_replace (&self->bg_style, style);
 }
 
 /**
@@ -260,4 +599,7 @@ ztk_button_add_background_callback (
   ZtkWidgetDrawCallback draw_cb)
 {
   self->bg_draw_cb = draw_cb;
+
+  /* can't tell what the callback depends on */
+  ((ZtkWidget *) self)->fingerprint_cb = NULL;
 }
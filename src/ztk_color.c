@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <ztoolkit/log.h>
 #include <ztoolkit/ztk_color.h>
@@ -34,7 +35,29 @@ ztk_color_set_for_cairo (
 }
 
 /**
- * Parses a ZtkColor from the given hex string.
+ * Returns the color packed as 8-bit RGBA, the
+ * precision it is drawn at.
+ */
+uint32_t
+ztk_color_to_rgba32 (
+  const ZtkColor * color)
+{
+#define TO_8BIT(x) \
+  ((uint32_t) ((x) <= 0.0 ? 0 : \
+     (x) >= 1.0 ? 255 : (x) * 255.0 + 0.5))
+
+  return
+    TO_8BIT (color->red) << 24 |
+    TO_8BIT (color->green) << 16 |
+    TO_8BIT (color->blue) << 8 |
+    TO_8BIT (color->alpha);
+
+#undef TO_8BIT
+}
+
+/**
+ * Parses a ZtkColor from the given hex string,
+ * either "#RRGGBB" or "#RRGGBBAA".
  */
 void
 ztk_color_parse_hex (
@@ -59,4 +82,11 @@ ztk_color_parse_hex (
   num = strtol (str, NULL, 16);
   color->blue = (double) num / 255;
   color->alpha = 1;
+  if (strlen (hex_str) < 9)
+    return;
+  str[0] = hex_str[7];
+  str[1] = hex_str[8];
+  str[2] = '\0';
+  num = strtol (str, NULL, 16);
+  color->alpha = (double) num / 255;
 }
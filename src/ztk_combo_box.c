@@ -29,6 +29,28 @@
  * text. */
 #define PADDING 2
 
+/**
+ * Returns the extents of the element's label,
+ * measuring them only when the font size changes,
+ * since measuring allocates inside cairo.
+ */
+static const cairo_text_extents_t *
+get_label_extents (
+  ZtkComboBox *        self,
+  ZtkComboBoxElement * el,
+  cairo_t *            cr)
+{
+  if (el->extents_font_size != self->font_size)
+    {
+      cairo_set_font_size (cr, self->font_size);
+      cairo_text_extents (
+        cr, el->label, &el->extents);
+      el->extents_font_size = self->font_size;
+    }
+
+  return &el->extents;
+}
+
 static double
 get_height (
   ZtkComboBox * self)
@@ -52,11 +74,10 @@ get_height (
           cairo_t* cr =
             (cairo_t*) puglGetContext (
               widget->app->view);
-          cairo_text_extents_t extents;
-          cairo_set_font_size (cr, self->font_size);
-          cairo_text_extents (cr, el->label, &extents);
+          const cairo_text_extents_t * extents =
+            get_label_extents (self, el, cr);
 
-          height += (int) extents.height + PADDING * 2;
+          height += (int) extents->height + PADDING * 2;
         }
     }
 
@@ -83,13 +104,12 @@ get_width (
       cairo_t* cr =
         (cairo_t*) puglGetContext (
           widget->app->view);
-      cairo_text_extents_t extents;
-      cairo_set_font_size (cr, self->font_size);
-      cairo_text_extents (cr, el->label, &extents);
+      const cairo_text_extents_t * extents =
+        get_label_extents (self, el, cr);
 
       width =
         /* *2 for the element, *2 for the frame */
-        MAX (width, extents.width + PADDING * 4);
+        MAX (width, extents->width + PADDING * 4);
     }
 
   return width;
@@ -148,19 +168,22 @@ draw_cb (
   void *      data)
 {
   ZtkComboBox * self = (ZtkComboBox *) w;
+  const ZtkStyle * style =
+    self->style ?
+      self->style : w->app->theme.combo_box_style;
 
   ZtkRect rect;
   get_dimensions (self, &rect);
 
   /* draw bg and frame */
-  ztk_color_set_for_cairo (
-    &self->frame_color, cr);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_FRAME, cr);
   cairo_rectangle (
     cr, rect.x, rect.y, rect.width,
     rect.height);
   cairo_fill (cr);
-  ztk_color_set_for_cairo (
-    &self->bg_color, cr);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_BG, cr);
   cairo_rectangle (
     cr, rect.x + PADDING, rect.y + PADDING,
     rect.width - PADDING * 2,
@@ -185,13 +208,15 @@ draw_cb (
             {
               if (w->state & ZTK_WIDGET_STATE_PRESSED)
                 {
-                  ztk_color_set_for_cairo (
-                    &self->click_color, cr);
+                  ztk_style_set_source (
+                    style,
+                    ZTK_STYLE_COLOR_BG_CLICK, cr);
                 }
               else
                 {
-                  ztk_color_set_for_cairo (
-                    &self->hover_color, cr);
+                  ztk_style_set_source (
+                    style,
+                    ZTK_STYLE_COLOR_BG_HOVER, cr);
                 }
               cairo_rectangle (
                 cr, rect.x + PADDING, height,
@@ -201,8 +226,8 @@ draw_cb (
             }
 
           /* draw the separator */
-          ztk_color_set_for_cairo (
-            &self->separator_color, cr);
+          ztk_style_set_source (
+            style, ZTK_STYLE_COLOR_SEPARATOR, cr);
           cairo_rectangle (
             cr, rect.x + PADDING * 2,
             height + PADDING,
@@ -214,12 +239,10 @@ draw_cb (
         }
       else
         {
-          cairo_text_extents_t extents;
-          cairo_set_font_size (cr, self->font_size);
-          cairo_text_extents (
-            cr, el->label, &extents);
+          const cairo_text_extents_t * extents =
+            get_label_extents (self, el, cr);
           next_height =
-            height + extents.height +
+            height + extents->height +
             PADDING * 2;
 
           /* draw the element bg */
@@ -227,13 +250,15 @@ draw_cb (
             {
               if (w->state & ZTK_WIDGET_STATE_PRESSED)
                 {
-                  ztk_color_set_for_cairo (
-                    &self->click_color, cr);
+                  ztk_style_set_source (
+                    style,
+                    ZTK_STYLE_COLOR_BG_CLICK, cr);
                 }
               else
                 {
-                  ztk_color_set_for_cairo (
-                    &self->hover_color, cr);
+                  ztk_style_set_source (
+                    style,
+                    ZTK_STYLE_COLOR_BG_HOVER, cr);
                 }
               cairo_rectangle (
                 cr, rect.x + PADDING, height,
@@ -247,24 +272,27 @@ draw_cb (
             {
               if (w->state & ZTK_WIDGET_STATE_PRESSED)
                 {
-                  ztk_color_set_for_cairo (
-                    &self->text_click_color, cr);
+                  ztk_style_set_source (
+                    style,
+                    ZTK_STYLE_COLOR_FG_CLICK, cr);
                 }
               else
                 {
-                  ztk_color_set_for_cairo (
-                    &self->text_hover_color, cr);
+                  ztk_style_set_source (
+                    style,
+                    ZTK_STYLE_COLOR_FG_HOVER, cr);
                 }
             }
           else
             {
-              ztk_color_set_for_cairo (
-                &self->text_normal_color, cr);
+              ztk_style_set_source (
+                style, ZTK_STYLE_COLOR_FG, cr);
             }
 
           cairo_move_to (
             cr, rect.x + PADDING * 2,
-            height + PADDING + extents.height);
+            height + PADDING + extents->height);
+          cairo_set_font_size (cr, self->font_size);
           cairo_show_text (
             cr, el->label);
 
@@ -314,13 +342,10 @@ motion_cb (
           cairo_t* cr =
             (cairo_t*) puglGetContext (
               ((ZtkWidget *) self)->app->view);
-          cairo_text_extents_t extents;
-          cairo_set_font_size (
-            cr, self->font_size);
-          cairo_text_extents (
-            cr, el->label, &extents);
+          const cairo_text_extents_t * extents =
+            get_label_extents (self, el, cr);
           next_height =
-            height + extents.height +
+            height + extents->height +
             PADDING * 2;
           if (y >= height && y < next_height)
             {
@@ -342,7 +367,12 @@ free_cb (
 {
   ZtkComboBox * self = (ZtkComboBox *) w;
 
-  free (self);
+  for (int i = 0; i < self->num_elements; i++)
+    {
+      ztk_string_unref (self->elements[i].label);
+    }
+  ztk_style_replace (&self->style, NULL);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 static int
@@ -400,24 +430,8 @@ static void
 ztk_combo_box_init (
   ZtkComboBox * self)
 {
-  strcpy (self->font_name, "Cantarrel");
+  self->font_name = "Cantarrel";
   self->font_size = 12.0;
-  ztk_color_parse_hex (
-    &self->text_normal_color, "#DDDDDD");
-  ztk_color_parse_hex (
-    &self->text_hover_color, "#EEEEEE");
-  ztk_color_parse_hex (
-    &self->text_click_color, "#FFFFFF");
-  ztk_color_parse_hex (
-    &self->bg_color, "#323232");
-  ztk_color_parse_hex (
-    &self->frame_color, "#646464");
-  ztk_color_parse_hex (
-    &self->separator_color, "#AAAAAA");
-  ztk_color_parse_hex (
-    &self->hover_color, "#646464");
-  ztk_color_parse_hex (
-    &self->click_color, "#868686");
 }
 
 /**
@@ -434,7 +448,7 @@ ztk_combo_box_new (
   int          spawn_backwards)
 {
   ZtkComboBox * self =
-    calloc (1, sizeof (ZtkComboBox));
+    ztk_widget_alloc (sizeof (ZtkComboBox));
   ZtkRect rect = { 0, 0, 0, 0 };
   ztk_widget_init (
     (ZtkWidget *) self, ZTK_WIDGET_TYPE_COMBO_BOX,
@@ -460,6 +474,26 @@ ztk_combo_box_new (
   return self;
 }
 
+/**
+ * Returns the next free element, or NULL if the
+ * combo box is full.
+ */
+static ZtkComboBoxElement *
+add_element (
+  ZtkComboBox * self)
+{
+  if (self->num_elements ==
+        ZTK_COMBO_BOX_MAX_ELEMENTS)
+    {
+      ztk_warning (
+        "Combo box is full (%d elements)",
+        ZTK_COMBO_BOX_MAX_ELEMENTS);
+      return NULL;
+    }
+
+  return &self->elements[self->num_elements++];
+}
+
 /**
  * @param data Data related to the current element
  *   to pass to the activate callback.
@@ -471,35 +505,66 @@ ztk_combo_box_add_text_element (
   ZtkWidgetActivateCallback activate_cb,
   void *        data)
 {
-  ZtkComboBoxElement * el =
-    &self->elements[self->num_elements++];
-
-  strcpy (el->label, label);
+  ZtkComboBoxElement * el = add_element (self);
+  if (!el)
+    return;
+
+  /* the parent's app if not added yet */
+  ZtkWidget * w = (ZtkWidget *) self;
+  ZtkApp * app =
+    w->app ? w->app : self->parent->app;
+  el->label =
+    ztk_string_table_intern (
+      app ? app->strings : NULL, label);
   el->is_separator = 0;
   el->activate_cb = activate_cb;
   el->activate_cb_data = data;
+  el->extents_font_size = 0;
 
   /* update dimensions */
-  ZtkWidget * widget = (ZtkWidget *) self;
-  get_dimensions (self, &widget->rect);
+  ZtkRect rect;
+  get_dimensions (self, &rect);
+  ztk_widget_set_rect ((ZtkWidget *) self, &rect);
 }
 
 void
 ztk_combo_box_add_separator (
   ZtkComboBox * self)
 {
-  ZtkComboBoxElement * el =
-    &self->elements[self->num_elements++];
+  ZtkComboBoxElement * el = add_element (self);
+  if (!el)
+    return;
+
+  el->label = NULL;
   el->is_separator = 1;
 
   /* update dimensions */
-  ZtkWidget * widget = (ZtkWidget *) self;
-  get_dimensions (self, &widget->rect);
+  ZtkRect rect;
+  get_dimensions (self, &rect);
+  ztk_widget_set_rect ((ZtkWidget *) self, &rect);
 }
 
 void
 ztk_combo_box_clear (
   ZtkComboBox * self)
 {
+  for (int i = 0; i < self->num_elements; i++)
+    {
+      ZtkComboBoxElement * el = &self->elements[i];
+      ztk_string_unref (el->label);
+      el->label = NULL;
+    }
   self->num_elements = 0;
 }
+
+/**
+ * Sets a style to use instead of the theme's, or
+ * NULL to use the theme's again.
+ */
+void
+ztk_combo_box_set_style (
+  ZtkComboBox * self,
+  ZtkStyle *    style)
+{
+  ztk_style_replace (&self->style, style);
+}
@@ -45,7 +45,19 @@
  * Macro to get real value.
  */
 #define GET_REAL_VAL \
-  ((*self->getter) (self, self->object))
+  (self->param_store ? \
+     ztk_param_store_get ( \
+       self->param_store, self->param_id) : \
+     (*self->getter) (self, self->object))
+
+/**
+ * Macro to get the real value to show, which is
+ * ahead of the stored value during drags if writes
+ * are rate-limited.
+ */
+#define GET_SHOWN_VAL \
+  (self->gesture.active ? \
+     self->gesture.value : GET_REAL_VAL)
 
 /**
  * MAcro to get real value from knob value.
@@ -65,8 +77,75 @@
  * Sets real val
  */
 #define SET_REAL_VAL(real) \
-   ((*self->setter) ( \
-      self, self->object, (float) real))
+  (self->param_store ? \
+     (void) ztk_param_store_set ( \
+       self->param_store, self->param_id, \
+       (float) real) : \
+     (*self->setter) ( \
+       self, self->object, (float) real))
+
+/**
+ * Returns the filmstrip frame for the current
+ * value.
+ */
+static int
+get_filmstrip_frame (
+  ZtkControl * self)
+{
+  float value =
+    CLAMP (
+      CONTROL_VAL_FROM_REAL (GET_SHOWN_VAL),
+      0.0f, 1.0f);
+
+  return
+    (int)
+    lround (
+      (double) value *
+        (self->filmstrip_num_frames - 1));
+}
+
+/**
+ * Built-in fingerprint, assuming the draw callback
+ * only depends on the value.
+ */
+static uint64_t
+fingerprint_cb (
+  ZtkWidget * widget)
+{
+  ZtkControl * self = (ZtkControl *) widget;
+
+  if (self->filmstrip)
+    {
+      uint64_t fp =
+        ztk_fingerprint_add (
+          0, (uint64_t) (uintptr_t) self->filmstrip);
+      return
+        ztk_fingerprint_add (
+          fp, (uint64_t) get_filmstrip_frame (self));
+    }
+
+  /* a value change below 1 pixel along the drag
+   * axis is assumed invisible */
+  double steps;
+  switch (self->drag_mode)
+    {
+    case ZTK_CTRL_DRAG_HORIZONTAL:
+      steps = widget->rect.width;
+      break;
+    case ZTK_CTRL_DRAG_VERTICAL:
+      steps = widget->rect.height;
+      break;
+    default:
+      steps =
+        MAX (widget->rect.width, widget->rect.height);
+      break;
+    }
+  float value = CONTROL_VAL_FROM_REAL (GET_SHOWN_VAL);
+
+  return
+    ztk_fingerprint_add (
+      0, (uint64_t) lround ((double) value * steps));
+}
 
 static void
 update_cb (
@@ -77,6 +156,13 @@ update_cb (
   ZtkApp * app = w->app;
   if (w->state & ZTK_WIDGET_STATE_PRESSED)
     {
+      if (!self->gesture.active)
+        {
+          ztk_gesture_begin (
+            &self->gesture, w, GET_REAL_VAL);
+        }
+
+      float val;
       if (self->relative_mode)
         {
           double dx =
@@ -114,13 +200,13 @@ update_cb (
             {
               sensitivity = self->sensitivity;
             }
-          SET_REAL_VAL (
+          val =
             REAL_VAL_FROM_CONTROL (
               CLAMP (
                 CONTROL_VAL_FROM_REAL (
-                  GET_REAL_VAL) +
+                  self->gesture.value) +
                     sensitivity * (float) delta,
-                 0.0f, 1.0f)));
+                 0.0f, 1.0f));
         }
       else /* absolute mode */
         {
@@ -145,12 +231,254 @@ update_cb (
                 "invalid with absolute mode");
               return;
             }
-          SET_REAL_VAL (
+          val =
             REAL_VAL_FROM_CONTROL (
               CLAMP (
-                (float) ctrl_val, 0.0f, 1.0f)));
+                (float) ctrl_val, 0.0f, 1.0f));
+        }
+
+      if (ztk_gesture_update (
+            &self->gesture, w, val,
+            ztk_app_get_time (app)))
+        {
+          SET_REAL_VAL (val);
         }
     }
+  else if (self->gesture.active)
+    {
+      /* released: write the exact final value */
+      if (ztk_gesture_flush (&self->gesture, w))
+        {
+          SET_REAL_VAL (self->gesture.value);
+        }
+      ztk_gesture_end (&self->gesture, w);
+    }
+}
+
+static void
+filmstrip_draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   draw_rect,
+  void *      data)
+{
+  ZtkControl * self = (ZtkControl *) widget;
+  cairo_surface_t * strip = self->filmstrip;
+  int frame = get_filmstrip_frame (self);
+
+  int frame_width =
+    cairo_image_surface_get_width (strip);
+  int frame_height =
+    cairo_image_surface_get_height (strip);
+  double frame_x = 0.0;
+  double frame_y = 0.0;
+  if (self->filmstrip_orientation ==
+        ZTK_CTRL_FILMSTRIP_VERTICAL)
+    {
+      frame_height /= self->filmstrip_num_frames;
+      frame_y = frame * frame_height;
+    }
+  else
+    {
+      frame_width /= self->filmstrip_num_frames;
+      frame_x = frame * frame_width;
+    }
+  if (frame_width <= 0 || frame_height <= 0)
+    return;
+
+  ZtkRect * rect = &widget->rect;
+  cairo_matrix_t matrix;
+  cairo_get_matrix (cr, &matrix);
+  if (math_doubles_equal (
+        rect->width, (double) frame_width) &&
+      math_doubles_equal (
+        rect->height, (double) frame_height) &&
+      math_doubles_equal (matrix.xx, 1.0) &&
+      math_doubles_equal (matrix.yy, 1.0) &&
+      math_doubles_equal (matrix.xy, 0.0) &&
+      math_doubles_equal (matrix.yx, 0.0) &&
+      math_doubles_equal (
+        rect->x + matrix.x0,
+        round (rect->x + matrix.x0)) &&
+      math_doubles_equal (
+        rect->y + matrix.y0,
+        round (rect->y + matrix.y0)))
+    {
+      /* same size on whole pixels: the frame is
+       * copied as it is */
+      cairo_set_source_surface (
+        cr, strip, rect->x - frame_x,
+        rect->y - frame_y);
+      cairo_pattern_set_filter (
+        cairo_get_source (cr), CAIRO_FILTER_NEAREST);
+      cairo_rectangle (
+        cr, rect->x, rect->y, rect->width,
+        rect->height);
+      cairo_fill (cr);
+      return;
+    }
+
+  /* scaled from the frame alone, so that the
+   * filter does not sample the next frames */
+  cairo_surface_t ** frame_surface =
+    &self->filmstrip_frames[frame];
+  if (!*frame_surface)
+    {
+      *frame_surface =
+        cairo_surface_create_for_rectangle (
+          strip, frame_x, frame_y, frame_width,
+          frame_height);
+    }
+  cairo_save (cr);
+  cairo_translate (cr, rect->x, rect->y);
+  cairo_scale (
+    cr, rect->width / frame_width,
+    rect->height / frame_height);
+  cairo_set_source_surface (
+    cr, *frame_surface, 0, 0);
+  cairo_pattern_set_extend (
+    cairo_get_source (cr), CAIRO_EXTEND_PAD);
+  cairo_rectangle (
+    cr, 0, 0, frame_width, frame_height);
+  cairo_fill (cr);
+  cairo_restore (cr);
+}
+
+/**
+ * Releases the filmstrip, if any.
+ */
+static void
+unset_filmstrip (
+  ZtkControl * self)
+{
+  if (!self->filmstrip)
+    return;
+
+  for (int i = 0; i < self->filmstrip_num_frames;
+       i++)
+    {
+      if (self->filmstrip_frames[i])
+        cairo_surface_destroy (
+          self->filmstrip_frames[i]);
+    }
+  free (self->filmstrip_frames);
+  self->filmstrip_frames = NULL;
+
+  if (self->filmstrip_cached)
+    ztk_resource_cache_release (self->filmstrip);
+  else
+    cairo_surface_destroy (self->filmstrip);
+  self->filmstrip = NULL;
+}
+
+/**
+ * Sets the filmstrip, taking over the reference
+ * to \p strip.
+ */
+static void
+set_filmstrip (
+  ZtkControl *                   self,
+  cairo_surface_t *              strip,
+  int                            cached,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation)
+{
+  unset_filmstrip (self);
+  self->filmstrip = strip;
+  self->filmstrip_cached = cached;
+  self->filmstrip_num_frames = MAX (num_frames, 1);
+  self->filmstrip_frames =
+    calloc (
+      (size_t) self->filmstrip_num_frames,
+      sizeof (cairo_surface_t *));
+  self->filmstrip_orientation = orientation;
+  ((ZtkWidget *) self)->draw_cb = filmstrip_draw_cb;
+  ((ZtkWidget *) self)->fingerprint_cb =
+    fingerprint_cb;
+  ztk_widget_queue_draw ((ZtkWidget *) self);
+}
+
+/**
+ * Draws the control as a filmstrip: an image with
+ * \p num_frames frames of the same size, of which
+ * the one for the current value is drawn.
+ *
+ * Frames the size of the control are copied as
+ * they are, otherwise they are scaled to fit. The
+ * control is only redrawn when the frame changes,
+ * or its state changes.
+ *
+ * @param strip The image, referenced by the
+ *   control, eg, a sprite from an asset pack.
+ */
+void
+ztk_control_make_filmstrip (
+  ZtkControl *                   self,
+  cairo_surface_t *              strip,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation)
+{
+  cairo_surface_reference (strip);
+  set_filmstrip (
+    self, strip, 0, num_frames, orientation);
+}
+
+/**
+ * Draws the control as a filmstrip loaded from the
+ * PNG at \p abs_path.
+ *
+ * The image is decoded once and shared by all the
+ * controls using it, in all the apps of the
+ * process.
+ *
+ * @return Non-zero if the PNG could not be loaded.
+ */
+int
+ztk_control_make_filmstrip_from_png (
+  ZtkControl *                   self,
+  const char *                   abs_path,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation)
+{
+  cairo_surface_t * strip =
+    ztk_resource_cache_get_png (abs_path);
+  if (!strip)
+    return -1;
+
+  set_filmstrip (
+    self, strip, 1, num_frames, orientation);
+
+  return 0;
+}
+
+/**
+ * Draws the control as a filmstrip decoded from
+ * PNG data in memory, eg, embedded in the plugin.
+ *
+ * @param key Unique name of the PNG, to share it
+ *   between the controls using it.
+ * @return Non-zero if the PNG could not be
+ *   decoded.
+ */
+int
+ztk_control_make_filmstrip_from_png_data (
+  ZtkControl *                   self,
+  const char *                   key,
+  const void *                   data,
+  size_t                         size,
+  int                            num_frames,
+  ZtkControlFilmstripOrientation orientation)
+{
+  cairo_surface_t * strip =
+    ztk_resource_cache_get_png_from_data (
+      key, data, size);
+  if (!strip)
+    return -1;
+
+  set_filmstrip (
+    self, strip, 1, num_frames, orientation);
+
+  return 0;
 }
 
 static void
@@ -160,7 +488,48 @@ control_free (
 {
   ZtkControl * self = (ZtkControl *) widget;
 
-  free (self);
+  unset_filmstrip (self);
+
+  if (self->param_store)
+    {
+      ztk_param_store_unbind_widget (
+        self->param_store, widget);
+    }
+
+  ztk_widget_dealloc ((ZtkWidget *) self);
+}
+
+/**
+ * Only redraws the control when its shown value
+ * changes by at least a pixel along the drag axis,
+ * or its state changes.
+ *
+ * Filmstrip controls do this already. Custom draw
+ * callbacks that only depend on
+ * ztk_control_get_shown_value() can opt in with
+ * this.
+ */
+void
+ztk_control_use_value_fingerprint (
+  ZtkControl * self)
+{
+  ((ZtkWidget *) self)->fingerprint_cb =
+    fingerprint_cb;
+}
+
+/**
+ * Returns the real value to draw.
+ *
+ * During drags, this is the dragged value, which
+ * is ahead of the getter's if writes are
+ * rate-limited, so custom draw callbacks should
+ * use this instead of the getter.
+ */
+float
+ztk_control_get_shown_value (
+  ZtkControl * self)
+{
+  return GET_SHOWN_VAL;
 }
 
 void
@@ -171,12 +540,37 @@ ztk_control_set_relative_mode (
   self->relative_mode = on;
 }
 
+/**
+ * Binds the control to a parameter.
+ *
+ * The control will then read and write its value
+ * through the store instead of its getter and
+ * setter, and will be redrawn when the DSP thread
+ * changes the parameter.
+ */
+void
+ztk_control_bind_param (
+  ZtkControl *    self,
+  ZtkParamStore * store,
+  uint32_t        id)
+{
+  self->param_store = store;
+  self->param_id = id;
+  ztk_param_store_bind_widget (
+    store, id, (ZtkWidget *) self);
+}
+
 /**
  * Creates a new control.
  *
  * @param get_val Getter function.
  * @param set_val Setter function.
- * @param draw_cb Custom draw callback.
+ * @param draw_cb Custom draw callback, which
+ *   should draw ztk_control_get_shown_value(), or
+ *   NULL for filmstrip controls. Custom controls
+ *   are redrawn whenever their area is, unless
+ *   ztk_control_use_value_fingerprint() is
+ *   called.
  * @param object Object to call get/set with.
  */
 ZtkControl *
@@ -191,11 +585,17 @@ ztk_control_new (
   float  max,
   float  zero)
 {
-  ZtkControl * self = calloc (1, sizeof (ZtkControl));
+  ZtkControl * self =
+    ztk_widget_alloc (sizeof (ZtkControl));
   ztk_widget_init (
     (ZtkWidget *) self, ZTK_WIDGET_TYPE_CONTROL, rect,
     update_cb, draw_cb,
     control_free);
+  if (!draw_cb)
+    {
+      ((ZtkWidget *) self)->fingerprint_cb =
+        fingerprint_cb;
+    }
 
   self->drag_mode = drag_mode;
   self->getter = get_val;
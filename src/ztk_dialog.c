@@ -24,6 +24,59 @@
 
 #define TITLE_BAR_HEIGHT 32
 
+static const char * license1 =
+  "This program comes with absolutely no "
+  "warranty.";
+static const char * license2 =
+  "See the GNU Affero General Public License, "
+  "version 3 or later for details.";
+
+/**
+ * Indices of the texts in
+ * ZtkDialog.text_extents.
+ */
+enum
+{
+  TEXT_TITLE,
+  TEXT_VERSION,
+  TEXT_COPYRIGHT,
+  TEXT_TEXT,
+  TEXT_LICENSE1,
+  TEXT_LICENSE2,
+};
+
+/**
+ * Measures the texts once, since measuring
+ * allocates inside cairo.
+ */
+static void
+measure_texts (
+  ZtkDialog * self,
+  cairo_t *   cr)
+{
+  if (self->texts_measured)
+    return;
+
+  cairo_text_extents_t * extents =
+    self->text_extents;
+  cairo_set_font_size (cr, 14);
+  cairo_text_extents (
+    cr, self->title, &extents[TEXT_TITLE]);
+  cairo_set_font_size (cr, 12);
+  cairo_text_extents (
+    cr, self->version, &extents[TEXT_VERSION]);
+  cairo_text_extents (
+    cr, self->copyright, &extents[TEXT_COPYRIGHT]);
+  cairo_text_extents (
+    cr, self->text, &extents[TEXT_TEXT]);
+  cairo_set_font_size (cr, 10);
+  cairo_text_extents (
+    cr, license1, &extents[TEXT_LICENSE1]);
+  cairo_text_extents (
+    cr, license2, &extents[TEXT_LICENSE2]);
+  self->texts_measured = 1;
+}
+
 static void
 draw_cb (
   ZtkWidget * widget,
@@ -37,26 +90,28 @@ draw_cb (
   double y = self->internal_rect.y;
   double width = self->internal_rect.width;
   double height = self->internal_rect.height;
+  const ZtkStyle * style =
+    widget->app->theme.dialog_style;
 
   /* draw modal bg */
-  cairo_set_source_rgba (
-    cr, 0, 0, 0, 0.4);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_BG_ALT, cr);
   cairo_rectangle (
     cr, widget->rect.x, widget->rect.y,
     widget->rect.width, widget->rect.height);
   cairo_fill (cr);
 
   /* draw bg */
-  cairo_set_source_rgba (
-    cr, 0.2, 0.2, 0.2, 1);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_BG, cr);
   cairo_rectangle (
     cr, x, y,
     width, height);
   cairo_fill (cr);
 
   /* draw frame */
-  cairo_set_source_rgba (
-    cr, 1, 1, 1, 0.5);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_FRAME, cr);
   cairo_set_line_width (
     cr, 2);
   cairo_rectangle (
@@ -65,8 +120,8 @@ draw_cb (
   cairo_stroke (cr);
 
   /* draw title line */
-  cairo_set_source_rgba (
-    cr, 1, 1, 1, 1);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_SEPARATOR, cr);
   cairo_set_line_width (
     cr, 3);
   cairo_move_to (
@@ -77,11 +132,14 @@ draw_cb (
     y + TITLE_BAR_HEIGHT);
   cairo_stroke (cr);
 
+  measure_texts (self, cr);
+
   /* draw title */
-  cairo_text_extents_t extents;
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_FG, cr);
+  cairo_text_extents_t extents =
+    self->text_extents[TEXT_TITLE];
   cairo_set_font_size (cr, 14);
-  cairo_text_extents (
-    cr, self->title, &extents);
   cairo_move_to (
     cr,
     (x + width / 2) -
@@ -98,8 +156,7 @@ draw_cb (
   cairo_set_font_size (cr, 12);
 
   /* draw ver */
-  cairo_text_extents (
-    cr, self->version, &extents);
+  extents = self->text_extents[TEXT_VERSION];
   cairo_move_to (
     cr,
     (x + width / 2) -
@@ -109,8 +166,7 @@ draw_cb (
   cairo_show_text (cr, self->version);
 
   /* draw copyright */
-  cairo_text_extents (
-    cr, self->copyright, &extents);
+  extents = self->text_extents[TEXT_COPYRIGHT];
   cairo_move_to (
     cr,
     (x + width / 2) -
@@ -120,8 +176,7 @@ draw_cb (
   cairo_show_text (cr, self->copyright);
 
   /* draw text */
-  cairo_text_extents (
-    cr, self->text, &extents);
+  extents = self->text_extents[TEXT_TEXT];
   cairo_move_to (
     cr,
     (x + width / 2) -
@@ -132,14 +187,7 @@ draw_cb (
 
   /* draw license */
   cairo_set_font_size (cr, 10);
-  const char * license1 =
-    "This program comes with absolutely no "
-    "warranty.";
-  const char * license2 =
-    "See the GNU Affero General Public License, "
-    "version 3 or later for details.";
-  cairo_text_extents (
-    cr, license1, &extents);
+  extents = self->text_extents[TEXT_LICENSE1];
   cairo_move_to (
     cr,
     (x + width / 2) -
@@ -149,8 +197,7 @@ draw_cb (
       avail_height_per_str / 2 +
       avail_height_per_str / 2 + extents.height / 2);
   cairo_show_text (cr, license1);
-  cairo_text_extents (
-    cr, license2, &extents);
+  extents = self->text_extents[TEXT_LICENSE2];
   cairo_move_to (
     cr,
     (x + width / 2) -
@@ -181,8 +228,9 @@ close_btn_draw_cb (
   void *      data)
 {
   const double padding = 4;
-  cairo_set_source_rgba (
-    cr, 0.2, 0.2, 0.2, 1);
+  ztk_style_set_source (
+    widget->app->theme.dialog_style,
+    ZTK_STYLE_COLOR_BG, cr);
   cairo_move_to (
     cr,
     widget->rect.x + padding,
@@ -208,6 +256,23 @@ update_cb (
 {
 }
 
+/**
+ * Releases the interned texts.
+ */
+static void
+release_texts (
+  ZtkDialog * self)
+{
+  ztk_string_unref (self->title);
+  ztk_string_unref (self->text);
+  ztk_string_unref (self->version);
+  ztk_string_unref (self->copyright);
+  self->title = NULL;
+  self->text = NULL;
+  self->version = NULL;
+  self->copyright = NULL;
+}
+
 static void
 free_cb (
   ZtkWidget * widget,
@@ -215,7 +280,8 @@ free_cb (
 {
   ZtkDialog * self = (ZtkDialog *) widget;
 
-  free (self);
+  release_texts (self);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 /**
@@ -231,12 +297,18 @@ ztk_dialog_new (
   ZtkRect *       rect,
   void *          data)
 {
-  ZtkDialog * self = calloc (1, sizeof (ZtkDialog));
+  ZtkDialog * self =
+    ztk_widget_alloc (sizeof (ZtkDialog));
   ZtkWidget * widget = (ZtkWidget *) self;
   ztk_widget_init (
     (ZtkWidget *) self, ZTK_WIDGET_TYPE_DIALOG,
     modal_rect, update_cb, draw_cb, free_cb);
 
+  /* the dialog belongs to the app from the start,
+   * so that its texts can be interned before it is
+   * added */
+  widget->app = app;
+
   self->internal_rect = *rect;
 
   const double padding = 1;
@@ -251,17 +323,9 @@ ztk_dialog_new (
       &close_btn_rect,
       (ZtkWidgetActivateCallback)
       on_close_btn_clicked, self);
-  ZtkColor normal;
-  ztk_color_parse_hex (
-    &normal, "#908888");
-  ZtkColor hover;
-  ztk_color_parse_hex (
-    &hover, "#CC575D");
-  ZtkColor click;
-  ztk_color_parse_hex (
-    &click, "#FF4D4D");
-  ztk_button_set_background_colors (
-    self->close_btn, &normal, &hover, &click);
+  ztk_button_set_background_style (
+    self->close_btn,
+    app->theme.dialog_close_button_style);
   ztk_button_make_custom (
     self->close_btn, close_btn_draw_cb);
   ztk_app_add_widget (
@@ -282,9 +346,17 @@ ztk_dialog_make_about (
   const char *    text)
 {
   self->type = ZTK_DIALOG_ABOUT;
-  strcpy (self->title, title);
-  strcpy (self->text, text);
-  strcpy (self->version, version);
-  strcpy (self->copyright, copyright);
+  release_texts (self);
+  ZtkStringTable * strings =
+    ((ZtkWidget *) self)->app->strings;
+  self->title =
+    ztk_string_table_intern (strings, title);
+  self->text =
+    ztk_string_table_intern (strings, text);
+  self->version =
+    ztk_string_table_intern (strings, version);
+  self->copyright =
+    ztk_string_table_intern (strings, copyright);
   self->license = license;
+  self->texts_measured = 0;
 }
@@ -41,7 +41,7 @@ ztk_drawing_area_free (
         widget, widget->user_data);
     }
 
-  free (self);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 /**
@@ -67,7 +67,7 @@ ztk_drawing_area_new (
   void *             data)
 {
   ZtkDrawingArea * self =
-    calloc (1, sizeof (ZtkDrawingArea));
+    ztk_widget_alloc (sizeof (ZtkDrawingArea));
   ztk_widget_init (
     (ZtkWidget *) self,
     ZTK_WIDGET_TYPE_DRAWING_AREA, rect,
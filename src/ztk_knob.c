@@ -47,7 +47,19 @@
  * Macro to get real value.
  */
 #define GET_REAL_VAL \
-  ((*self->getter) (self->object))
+  (self->param_store ? \
+     ztk_param_store_get ( \
+       self->param_store, self->param_id) : \
+     (*self->getter) (self->object))
+
+/**
+ * Macro to get the real value to show, which is
+ * ahead of the stored value during drags if writes
+ * are rate-limited.
+ */
+#define GET_SHOWN_VAL \
+  (self->gesture.active ? \
+     self->gesture.value : GET_REAL_VAL)
 
 /**
  * MAcro to get real value from knob value.
@@ -67,7 +79,24 @@
  * Sets real val
  */
 #define SET_REAL_VAL(real) \
-   ((*self->setter)(self->object, (float) real))
+  (self->param_store ? \
+     (void) ztk_param_store_set ( \
+       self->param_store, self->param_id, \
+       (float) real) : \
+     (*self->setter)(self->object, (float) real))
+
+/**
+ * Returns the style to draw with.
+ */
+static const ZtkStyle *
+get_style (
+  ZtkKnob * self)
+{
+  return
+    self->style ?
+      self->style :
+      ((ZtkWidget *) self)->app->theme.knob_style;
+}
 
 static void
 draw_cb (
@@ -93,7 +122,7 @@ draw_cb (
     ((360.f + ARC_CUT_ANGLE) * (float) M_PI) / 180.f;
 
   const float value =
-    KNOB_VAL_FROM_REAL (GET_REAL_VAL);
+    KNOB_VAL_FROM_REAL (GET_SHOWN_VAL);
   const float value_angle = start_angle
     + value * (end_angle - start_angle);
   const float zero_angle =
@@ -147,15 +176,20 @@ draw_cb (
       (double) (1.f - self->zero));
   const double intensity_inv =
     1.0 - intensity;
+  const ZtkStyle * style = get_style (self);
+  const float * start_color =
+    style->colors[ZTK_STYLE_COLOR_FG];
+  const float * end_color =
+    style->colors[ZTK_STYLE_COLOR_FG_ALT];
   double r =
-    intensity_inv * self->end_color.red   +
-    intensity * self->start_color.red;
+    intensity_inv * (double) end_color[0] +
+    intensity * (double) start_color[0];
   double g =
-    intensity_inv * self->end_color.green +
-    intensity * self->start_color.green;
+    intensity_inv * (double) end_color[1] +
+    intensity * (double) start_color[1];
   double b =
-    intensity_inv * self->end_color.blue  +
-    intensity * self->start_color.blue;
+    intensity_inv * (double) end_color[2] +
+    intensity * (double) start_color[2];
 
   //draw the arc
   cairo_set_source_rgb (
@@ -223,6 +257,31 @@ draw_cb (
 	cairo_restore(cr);
 }
 
+static uint64_t
+fingerprint_cb (
+  ZtkWidget * widget)
+{
+  ZtkKnob * self = (ZtkKnob *) widget;
+
+  /* the arc spans 300 degrees at 0.48 of the
+   * width, so about 2.5 pixels per pixel of width
+   * at its outer edge */
+  float steps = 2.5f * (float) widget->rect.width;
+  float value = KNOB_VAL_FROM_REAL (GET_SHOWN_VAL);
+
+  uint64_t fp =
+    ztk_fingerprint_add (
+      0, (uint64_t) lroundf (value * steps));
+  fp =
+    ztk_fingerprint_add (
+      fp, (uint64_t) lroundf (self->zero * steps));
+  fp =
+    ztk_fingerprint_add (
+      fp, get_style (self)->hash);
+
+  return fp;
+}
+
 static void
 update_cb (
   ZtkWidget * w,
@@ -232,16 +291,38 @@ update_cb (
   ZtkApp * app = w->app;
   if (w->state & ZTK_WIDGET_STATE_PRESSED)
     {
+      if (!self->gesture.active)
+        {
+          ztk_gesture_begin (
+            &self->gesture, w, GET_REAL_VAL);
+        }
+
       double delta =
         app->prev_press_y -
         app->offset_press_y;
 
-      SET_REAL_VAL (
+      float val =
         REAL_VAL_FROM_KNOB (
           CLAMP (
-            KNOB_VAL_FROM_REAL (GET_REAL_VAL) +
+            KNOB_VAL_FROM_REAL (
+              self->gesture.value) +
               0.007f * (float) delta,
-             0.0f, 1.0f)));
+             0.0f, 1.0f));
+      if (ztk_gesture_update (
+            &self->gesture, w, val,
+            ztk_app_get_time (app)))
+        {
+          SET_REAL_VAL (val);
+        }
+    }
+  else if (self->gesture.active)
+    {
+      /* released: write the exact final value */
+      if (ztk_gesture_flush (&self->gesture, w))
+        {
+          SET_REAL_VAL (self->gesture.value);
+        }
+      ztk_gesture_end (&self->gesture, w);
     }
 }
 
@@ -252,7 +333,14 @@ knob_free (
 {
   ZtkKnob * self = (ZtkKnob *) widget;
 
-  free (self);
+  if (self->param_store)
+    {
+      ztk_param_store_unbind_widget (
+        self->param_store, widget);
+    }
+
+  ztk_style_replace (&self->style, NULL);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 /**
@@ -274,22 +362,51 @@ ztk_knob_new (
   float  max,
   float  zero)
 {
-  ZtkKnob * self = calloc (1, sizeof (ZtkKnob));
+  ZtkKnob * self =
+    ztk_widget_alloc (sizeof (ZtkKnob));
   ztk_widget_init (
     (ZtkWidget *) self, ZTK_WIDGET_TYPE_KNOB, rect,
     update_cb, draw_cb, knob_free);
+  ((ZtkWidget *) self)->fingerprint_cb =
+    fingerprint_cb;
 
   self->getter = get_val;
   self->setter = set_val;
   self->object = object;
   self->min = min;
   self->max = max;
-  self->start_color.red = 78.0 / 100.0;
-  self->start_color.green = 78.0 / 100.0;
-  self->start_color.blue = 78.0 / 100.0;
-  self->end_color.red = 66.0 / 100.0;
-  self->end_color.green = 66.0 / 100.0;
-  self->end_color.blue = 66.0 / 100.0;
 
   return self;
 }
+
+/**
+ * Binds the knob to a parameter.
+ *
+ * The knob will then read and write its value
+ * through the store instead of its getter and
+ * setter, and will be redrawn when the DSP thread
+ * changes the parameter.
+ */
+void
+ztk_knob_bind_param (
+  ZtkKnob *       self,
+  ZtkParamStore * store,
+  uint32_t        id)
+{
+  self->param_store = store;
+  self->param_id = id;
+  ztk_param_store_bind_widget (
+    store, id, (ZtkWidget *) self);
+}
+
+/**
+ * Sets a style to use instead of the theme's, or
+ * NULL to use the theme's again.
+ */
+void
+ztk_knob_set_style (
+  ZtkKnob *  self,
+  ZtkStyle * style)
+{
+  ztk_style_replace (&self->style, style);
+}
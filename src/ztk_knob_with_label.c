@@ -62,7 +62,7 @@ ztk_knob_with_label_free (
   ZtkKnobWithLabel * self =
     (ZtkKnobWithLabel *) widget;
 
-  free (self);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 /**
@@ -79,7 +79,7 @@ ztk_knob_with_label_new (
   ZtkLabel * label)
 {
   ZtkKnobWithLabel * self =
-    calloc (1, sizeof (ZtkKnobWithLabel));
+    ztk_widget_alloc (sizeof (ZtkKnobWithLabel));
 
   ztk_widget_init (
     (ZtkWidget *) self,
@@ -103,19 +103,22 @@ ztk_knob_with_label_new (
 	cairo_set_font_size (cr, label->font_size);
 	cairo_text_extents (cr, label->label, &extents);
   ZtkWidget * w = (ZtkWidget *) label;
-  w->rect.x =
+  ZtkRect child_rect = w->rect;
+  child_rect.x =
     rect->x +
     (rect->width / 2.0 - extents.width / 2.0);
-  w->rect.y = rect->y;
+  child_rect.y = rect->y;
+  ztk_widget_set_rect (w, &child_rect);
 
   /* knob */
 #define PADDING 2.0
   w = (ZtkWidget *) knob;
-  w->rect.x = rect->x;
-  w->rect.y = rect->y + extents.height + PADDING;
-  w->rect.width = rect->width;
-  w->rect.height =
+  child_rect.x = rect->x;
+  child_rect.y = rect->y + extents.height + PADDING;
+  child_rect.width = rect->width;
+  child_rect.height =
     rect->height - (extents.height + PADDING);
+  ztk_widget_set_rect (w, &child_rect);
 
   return self;
 }
@@ -17,6 +17,7 @@
  * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -32,9 +33,7 @@ ztk_label_draw_cb (
   ZtkLabel * self = (ZtkLabel *) widget;
 
   // Draw label
-  cairo_text_extents_t extents;
   cairo_set_font_size (cr, self->font_size);
-  cairo_text_extents (cr, self->label, &extents);
   cairo_move_to (
     cr, widget->rect.x, widget->rect.y);
   ztk_color_set_for_cairo (
@@ -42,6 +41,24 @@ ztk_label_draw_cb (
   cairo_show_text (cr, self->label);
 }
 
+static uint64_t
+ztk_label_fingerprint_cb (
+  ZtkWidget * widget)
+{
+  ZtkLabel * self = (ZtkLabel *) widget;
+
+  uint64_t fp =
+    ztk_fingerprint_add_str (0, self->label);
+  fp =
+    ztk_fingerprint_add (
+      fp, (uint64_t) lround (self->font_size * 64.0));
+  fp =
+    ztk_fingerprint_add (
+      fp, ztk_color_to_rgba32 (&self->color));
+
+  return fp;
+}
+
 static void
 ztk_label_update_cb (
   ZtkWidget * widget,
@@ -57,7 +74,7 @@ ztk_label_free (
   ZtkLabel * self = (ZtkLabel *) widget;
   if (self->label)
     free (self->label);
-  free (self);
+  ztk_widget_dealloc ((ZtkWidget *) self);
 }
 
 /**
@@ -71,7 +88,8 @@ ztk_label_new (
   ZtkColor *   color,
   const char * lbl)
 {
-  ZtkLabel * self = calloc (1, sizeof (ZtkLabel));
+  ZtkLabel * self =
+    ztk_widget_alloc (sizeof (ZtkLabel));
   ZtkRect rect = {
     x, y, 0, 0,
   };
@@ -79,6 +97,8 @@ ztk_label_new (
     (ZtkWidget *) self, ZTK_WIDGET_TYPE_LABEL, &rect,
     ztk_label_update_cb, ztk_label_draw_cb,
     ztk_label_free);
+  ((ZtkWidget *) self)->fingerprint_cb =
+    ztk_label_fingerprint_cb;
 
   self->label = strdup (lbl);
   self->font_size = font_size;
@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ztoolkit/ztk.h"
+
+/** Padding to leave left of the text. */
+#define PADDING 4
+
+/** Rows to scroll per scroll step. */
+#define SCROLL_ROWS 3
+
+static int
+get_num_results (
+  ZtkPresetBrowser * self)
+{
+  return self->results->num_indices;
+}
+
+/**
+ * Clamps the scroll offset so that the last page
+ * is full when possible.
+ */
+static void
+clamp_scroll_offset (
+  ZtkPresetBrowser * self)
+{
+  int max_offset =
+    get_num_results (self) -
+    ztk_preset_browser_get_num_visible_rows (self);
+  self->scroll_offset =
+    CLAMP (self->scroll_offset, 0, MAX (max_offset, 0));
+}
+
+/**
+ * Returns the row in the results at the given y
+ * coordinate, or -1 if there is none.
+ */
+static int
+get_row_at_y (
+  ZtkPresetBrowser * self,
+  double             y)
+{
+  ZtkWidget * w = (ZtkWidget *) self;
+  double rel_y =
+    y - (w->rect.y + self->row_height);
+  if (rel_y < 0)
+    return -1;
+
+  int row =
+    self->scroll_offset +
+    (int) (rel_y / self->row_height);
+  if (row >= get_num_results (self) ||
+      row - self->scroll_offset >=
+        ztk_preset_browser_get_num_visible_rows (
+          self))
+    return -1;
+
+  return row;
+}
+
+static void
+apply_query (
+  ZtkPresetBrowser * self)
+{
+  ztk_search_index_query (
+    self->index, self->query, self->results);
+  self->scroll_offset = 0;
+  self->hovered_row = -1;
+}
+
+static void
+draw_text (
+  ZtkPresetBrowser * self,
+  cairo_t *          cr,
+  double             row_y,
+  const char *       text)
+{
+  ZtkWidget * w = (ZtkWidget *) self;
+
+  /* approximate vertical centering, to avoid
+   * measuring every row */
+  cairo_move_to (
+    cr, w->rect.x + PADDING,
+    row_y +
+      (self->row_height + self->font_size * 0.7) /
+        2.0);
+  cairo_show_text (cr, text);
+}
+
+static void
+draw_cb (
+  ZtkWidget * w,
+  cairo_t *   cr,
+  ZtkRect *   draw_rect,
+  void *      data)
+{
+  ZtkPresetBrowser * self = (ZtkPresetBrowser *) w;
+  ZtkRect * rect = &w->rect;
+  const ZtkStyle * style =
+    self->style ?
+      self->style : w->app->theme.preset_browser_style;
+
+  cairo_save (cr);
+  cairo_rectangle (
+    cr, rect->x, rect->y, rect->width,
+    rect->height);
+  cairo_clip (cr);
+
+  /* draw bg */
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_BG, cr);
+  cairo_rectangle (
+    cr, rect->x, rect->y, rect->width,
+    rect->height);
+  cairo_fill (cr);
+
+  /* draw search row */
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_BG_ALT, cr);
+  cairo_rectangle (
+    cr, rect->x, rect->y, rect->width,
+    self->row_height);
+  cairo_fill (cr);
+  cairo_set_font_size (cr, self->font_size);
+  ztk_style_set_source (
+    style, ZTK_STYLE_COLOR_FG, cr);
+  draw_text (
+    self, cr, rect->y,
+    self->query_len > 0 ? self->query : "Search...");
+
+  /* only lay out the visible rows */
+  int end =
+    MIN (
+      self->scroll_offset +
+        ztk_preset_browser_get_num_visible_rows (
+          self),
+      get_num_results (self));
+  for (int i = self->scroll_offset; i < end; i++)
+    {
+      double row_y =
+        rect->y +
+        self->row_height *
+          (double) (i - self->scroll_offset + 1);
+
+      /* skip rows outside the exposed area */
+      if (row_y + self->row_height < draw_rect->y ||
+          row_y > draw_rect->y + draw_rect->height)
+        continue;
+
+      int idx = self->results->indices[i];
+      if (idx == self->selected_idx ||
+          i == self->hovered_row)
+        {
+          ztk_style_set_source (
+            style,
+            idx == self->selected_idx ?
+              ZTK_STYLE_COLOR_BG_CLICK :
+              ZTK_STYLE_COLOR_BG_HOVER, cr);
+          cairo_rectangle (
+            cr, rect->x, row_y, rect->width,
+            self->row_height);
+          cairo_fill (cr);
+        }
+
+      ztk_style_set_source (
+        style, ZTK_STYLE_COLOR_FG, cr);
+      draw_text (
+        self, cr, row_y,
+        self->index->display_names[idx]);
+    }
+
+  cairo_restore (cr);
+}
+
+static void
+update_cb (
+  ZtkWidget * w,
+  void *      data)
+{
+}
+
+static void
+activate (
+  ZtkPresetBrowser * self)
+{
+  ZtkWidget * w = (ZtkWidget *) self;
+  if (self->selected_idx >= 0 && self->activate_cb)
+    {
+      self->activate_cb (
+        self, self->selected_idx, w->user_data);
+    }
+}
+
+/**
+ * Moves the selection by the given number of rows
+ * and scrolls it into view.
+ */
+static void
+move_selection (
+  ZtkPresetBrowser * self,
+  int                delta)
+{
+  int num_results = get_num_results (self);
+  if (num_results == 0)
+    return;
+
+  int row = -1;
+  for (int i = 0; i < num_results; i++)
+    {
+      if (self->results->indices[i] ==
+            self->selected_idx)
+        {
+          row = i;
+          break;
+        }
+    }
+  row = CLAMP (row + delta, 0, num_results - 1);
+  self->selected_idx = self->results->indices[row];
+
+  int num_visible =
+    ztk_preset_browser_get_num_visible_rows (self);
+  if (row < self->scroll_offset)
+    self->scroll_offset = row;
+  else if (row >= self->scroll_offset + num_visible)
+    self->scroll_offset = row - num_visible + 1;
+  clamp_scroll_offset (self);
+}
+
+static int
+key_event_cb (
+  ZtkWidget *          w,
+  const PuglEventKey * ev)
+{
+  ZtkPresetBrowser * self = (ZtkPresetBrowser *) w;
+
+  /* only take keys while selected */
+  if (ev->type != PUGL_KEY_PRESS ||
+      !(w->state & ZTK_WIDGET_STATE_SELECTED))
+    return 0;
+
+  switch (ev->key)
+    {
+    case PUGL_KEY_BACKSPACE:
+      if (self->query_len > 0)
+        {
+          self->query[--self->query_len] = '\0';
+          apply_query (self);
+        }
+      break;
+    case PUGL_KEY_ESCAPE:
+      ztk_preset_browser_set_query (self, "");
+      break;
+    case PUGL_KEY_UP:
+      move_selection (self, -1);
+      break;
+    case PUGL_KEY_DOWN:
+      move_selection (self, 1);
+      break;
+    case '\r':
+      activate (self);
+      break;
+    default:
+      if (ev->key >= 0x20 && ev->key < 0x7F &&
+          self->query_len <
+            ZTK_SEARCH_QUERY_MAX - 1)
+        {
+          self->query[self->query_len++] =
+            (char) ev->key;
+          self->query[self->query_len] = '\0';
+          apply_query (self);
+        }
+      break;
+    }
+
+  return 0;
+}
+
+static int
+button_event_cb (
+  ZtkWidget *             w,
+  const PuglEventButton * btn,
+  void *                  data)
+{
+  ZtkPresetBrowser * self = (ZtkPresetBrowser *) w;
+
+  if (btn->type != PUGL_BUTTON_RELEASE ||
+      !ztk_widget_is_hit (w, btn->x, btn->y))
+    return 0;
+
+  int row = get_row_at_y (self, btn->y);
+  if (row >= 0)
+    {
+      self->selected_idx =
+        self->results->indices[row];
+      activate (self);
+    }
+
+  return 0;
+}
+
+static int
+motion_cb (
+  ZtkWidget *             w,
+  const PuglEventMotion * ev,
+  void *                  data)
+{
+  ZtkPresetBrowser * self = (ZtkPresetBrowser *) w;
+
+  self->hovered_row =
+    ev->type == PUGL_MOTION_NOTIFY ?
+      get_row_at_y (self, ev->y) : -1;
+
+  return 0;
+}
+
+static int
+scroll_cb (
+  ZtkWidget *             w,
+  const PuglEventScroll * ev)
+{
+  ZtkPresetBrowser * self = (ZtkPresetBrowser *) w;
+
+  /* positive dy scrolls up */
+  if (ev->dy > 0)
+    self->scroll_offset -= SCROLL_ROWS;
+  else if (ev->dy < 0)
+    self->scroll_offset += SCROLL_ROWS;
+  clamp_scroll_offset (self);
+  self->hovered_row = get_row_at_y (self, ev->y);
+
+  return 0;
+}
+
+static void
+free_cb (
+  ZtkWidget * w,
+  void *      data)
+{
+  ZtkPresetBrowser * self = (ZtkPresetBrowser *) w;
+
+  ztk_search_results_free (self->results);
+  ztk_search_index_free (self->index);
+  ztk_style_replace (&self->style, NULL);
+
+  ztk_widget_dealloc ((ZtkWidget *) self);
+}
+
+/**
+ * Returns the number of rows that fit in the
+ * widget, excluding the search row.
+ */
+int
+ztk_preset_browser_get_num_visible_rows (
+  ZtkPresetBrowser * self)
+{
+  ZtkWidget * w = (ZtkWidget *) self;
+  int num_rows =
+    (int) (w->rect.height / self->row_height) - 1;
+
+  return MAX (num_rows, 0);
+}
+
+/**
+ * Sets the search query and scrolls to the top.
+ */
+void
+ztk_preset_browser_set_query (
+  ZtkPresetBrowser * self,
+  const char *       query)
+{
+  strncpy (
+    self->query, query, ZTK_SEARCH_QUERY_MAX - 1);
+  self->query[ZTK_SEARCH_QUERY_MAX - 1] = '\0';
+  self->query_len = (int) strlen (self->query);
+  apply_query (self);
+}
+
+/**
+ * Creates a new preset browser.
+ *
+ * @param names Preset names. These are copied.
+ * @param data User data to pass to the activate
+ *   callback.
+ */
+ZtkPresetBrowser *
+ztk_preset_browser_new (
+  ZtkRect *     rect,
+  const char ** names,
+  int           num_names,
+  ZtkPresetBrowserActivateCallback activate_cb,
+  void *        data)
+{
+  ZtkPresetBrowser * self =
+    ztk_widget_alloc (sizeof (ZtkPresetBrowser));
+  ZtkWidget * w = (ZtkWidget *) self;
+  ztk_widget_init (
+    w, ZTK_WIDGET_TYPE_PRESET_BROWSER, rect,
+    update_cb, draw_cb, free_cb);
+
+  w->button_event_cb = button_event_cb;
+  w->key_event_cb = key_event_cb;
+  w->motion_event_cb = motion_cb;
+  w->scroll_event_cb = scroll_cb;
+  w->user_data = data;
+
+  self->index =
+    ztk_search_index_new (names, num_names);
+  self->results =
+    ztk_search_results_new (self->index);
+  self->activate_cb = activate_cb;
+  self->selected_idx = -1;
+  self->font_size = 12.0;
+  self->row_height = 20.0;
+
+  ztk_preset_browser_set_query (self, "");
+
+  return self;
+}
+
+/**
+ * Sets a style to use instead of the theme's, or
+ * NULL to use the theme's again.
+ */
+void
+ztk_preset_browser_set_style (
+  ZtkPresetBrowser * self,
+  ZtkStyle *         style)
+{
+  ztk_style_replace (&self->style, style);
+}
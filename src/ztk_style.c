@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include <ztoolkit/ztk_style.h>
+#include <ztoolkit/ztk_widget.h>
+
+/**
+ * Creates a new style with a reference count of
+ * 1.
+ *
+ * @param colors ZTK_STYLE_NUM_COLORS colors
+ *   indexed by ZtkStyleColor.
+ */
+ZtkStyle *
+ztk_style_new (
+  const ZtkColor * colors)
+{
+  ZtkStyle * self = calloc (1, sizeof (ZtkStyle));
+
+  atomic_init (&self->refcount, 1);
+  uint64_t hash = 0;
+  for (int i = 0; i < ZTK_STYLE_NUM_COLORS; i++)
+    {
+      const ZtkColor * color = &colors[i];
+      self->colors[i][0] = (float) color->red;
+      self->colors[i][1] = (float) color->green;
+      self->colors[i][2] = (float) color->blue;
+      self->colors[i][3] = (float) color->alpha;
+      self->rgba32[i] =
+        ztk_color_to_rgba32 (color);
+      self->patterns[i] =
+        cairo_pattern_create_rgba (
+          color->red, color->green, color->blue,
+          color->alpha);
+      hash =
+        ztk_fingerprint_add (hash, self->rgba32[i]);
+    }
+  self->hash = hash;
+
+  return self;
+}
+
+/**
+ * Adds a reference to the style and returns it.
+ */
+ZtkStyle *
+ztk_style_ref (
+  ZtkStyle * self)
+{
+  atomic_fetch_add_explicit (
+    &self->refcount, 1, memory_order_relaxed);
+
+  return self;
+}
+
+/**
+ * Removes a reference from the style, freeing it
+ * when none are left.
+ */
+void
+ztk_style_unref (
+  ZtkStyle * self)
+{
+  if (atomic_fetch_sub_explicit (
+        &self->refcount, 1,
+        memory_order_acq_rel) != 1)
+    return;
+
+  for (int i = 0; i < ZTK_STYLE_NUM_COLORS; i++)
+    {
+      cairo_pattern_destroy (self->patterns[i]);
+    }
+  free (self);
+}
+
+/**
+ * Returns the given color in double precision.
+ */
+void
+ztk_style_get_color (
+  const ZtkStyle * self,
+  ZtkStyleColor    color,
+  ZtkColor *       out)
+{
+  out->red = (double) self->colors[color][0];
+  out->green = (double) self->colors[color][1];
+  out->blue = (double) self->colors[color][2];
+  out->alpha = (double) self->colors[color][3];
+}
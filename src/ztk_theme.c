@@ -17,8 +17,30 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stddef.h>
+
 #include "ztoolkit/ztk_theme.h"
 
+/**
+ * Creates a style from hex colors indexed by
+ * ZtkStyleColor, leaving the NULL ones
+ * transparent.
+ */
+static ZtkStyle *
+new_style (
+  const char * hex[ZTK_STYLE_NUM_COLORS])
+{
+  ZtkColor colors[ZTK_STYLE_NUM_COLORS] = {
+    { 0, 0, 0, 0 } };
+  for (int i = 0; i < ZTK_STYLE_NUM_COLORS; i++)
+    {
+      if (hex[i])
+        ztk_color_parse_hex (&colors[i], hex[i]);
+    }
+
+  return ztk_style_new (colors);
+}
+
 /**
  * Inits the theme to the default colors.
  */
@@ -62,4 +84,59 @@ ztk_theme_init (
     46.0 / 255.0, 179.0 / 255.0, 152.0 / 255.0,
     1.0 };
   self->matcha_green = matcha_green;
+
+  const char * combo_box[ZTK_STYLE_NUM_COLORS] = {
+    [ZTK_STYLE_COLOR_BG] = "#323232",
+    [ZTK_STYLE_COLOR_BG_HOVER] = "#646464",
+    [ZTK_STYLE_COLOR_BG_CLICK] = "#868686",
+    [ZTK_STYLE_COLOR_FRAME] = "#646464",
+    [ZTK_STYLE_COLOR_SEPARATOR] = "#AAAAAA",
+    [ZTK_STYLE_COLOR_FG] = "#DDDDDD",
+    [ZTK_STYLE_COLOR_FG_HOVER] = "#EEEEEE",
+    [ZTK_STYLE_COLOR_FG_CLICK] = "#FFFFFF", };
+  self->combo_box_style = new_style (combo_box);
+  const char * knob[ZTK_STYLE_NUM_COLORS] = {
+    [ZTK_STYLE_COLOR_FG] = "#C7C7C7",
+    [ZTK_STYLE_COLOR_FG_ALT] = "#A8A8A8", };
+  self->knob_style = new_style (knob);
+  const char * preset_browser[
+    ZTK_STYLE_NUM_COLORS] = {
+    [ZTK_STYLE_COLOR_BG] = "#323232",
+    [ZTK_STYLE_COLOR_BG_ALT] = "#1F1F1F",
+    [ZTK_STYLE_COLOR_BG_HOVER] = "#646464",
+    [ZTK_STYLE_COLOR_BG_CLICK] = "#868686",
+    [ZTK_STYLE_COLOR_FG] = "#DDDDDD", };
+  self->preset_browser_style =
+    new_style (preset_browser);
+  const char * dialog[ZTK_STYLE_NUM_COLORS] = {
+    [ZTK_STYLE_COLOR_BG] = "#333333",
+    [ZTK_STYLE_COLOR_BG_ALT] = "#00000066",
+    [ZTK_STYLE_COLOR_FRAME] = "#FFFFFF80",
+    [ZTK_STYLE_COLOR_SEPARATOR] = "#FFFFFF",
+    [ZTK_STYLE_COLOR_FG] = "#FFFFFF", };
+  self->dialog_style = new_style (dialog);
+  const char * dialog_close_button[
+    ZTK_STYLE_NUM_COLORS] = {
+    [ZTK_STYLE_COLOR_BG] = "#908888",
+    [ZTK_STYLE_COLOR_BG_HOVER] = "#CC575D",
+    [ZTK_STYLE_COLOR_BG_CLICK] = "#FF4D4D", };
+  self->dialog_close_button_style =
+    new_style (dialog_close_button);
+}
+
+/**
+ * Releases the styles of the theme.
+ *
+ * Widgets still holding a style keep it alive.
+ */
+void
+ztk_theme_free (
+  ZtkTheme * self)
+{
+  ztk_style_unref (self->combo_box_style);
+  ztk_style_unref (self->knob_style);
+  ztk_style_unref (self->preset_browser_style);
+  ztk_style_unref (self->dialog_style);
+  ztk_style_unref (
+    self->dialog_close_button_style);
 }
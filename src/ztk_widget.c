@@ -17,8 +17,50 @@
  * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
+
+#include "ztoolkit/arena.h"
+#include "ztoolkit/ztk_app.h"
 #include "ztoolkit/ztk_widget.h"
 
+/**
+ * Allocates a zeroed widget of \p size bytes, from
+ * the current arena of the calling thread if any,
+ * otherwise on the heap.
+ *
+ * To be called from the constructors of
+ * inheriting structs, which must then free it with
+ * ztk_widget_dealloc().
+ */
+void *
+ztk_widget_alloc (
+  size_t size)
+{
+  ZtkArena * arena = ztk_arena_get_current ();
+  if (!arena)
+    return calloc (1, size);
+
+  ZtkWidget * self = ztk_arena_alloc (arena, size);
+  if (self)
+    self->arena = arena;
+
+  return self;
+}
+
+/**
+ * Frees a widget allocated with ztk_widget_alloc().
+ *
+ * Widgets in an arena are left for the arena to
+ * free.
+ */
+void
+ztk_widget_dealloc (
+  ZtkWidget * self)
+{
+  if (!self->arena)
+    free (self);
+}
+
 /**
  * Inits a new ZWidget.
  *
@@ -113,5 +155,148 @@ ztk_widget_set_visible (
   ZtkWidget * self,
   int         visible)
 {
+  /* the area it covered must be repainted */
+  if (self->app && self->visible != visible)
+    self->app->redraw_all = 1;
+
   self->visible = visible;
+  if (self->app)
+    ztk_app_update_widget (self->app, self);
+}
+
+/**
+ * Moves or resizes the widget.
+ *
+ * The rectangle must only be changed through this
+ * once the widget is added to an app, so that the
+ * app can keep hit testing it.
+ */
+void
+ztk_widget_set_rect (
+  ZtkWidget *     self,
+  const ZtkRect * rect)
+{
+  /* the area it covered must be repainted */
+  if (self->app)
+    self->app->redraw_all = 1;
+
+  self->rect = *rect;
+  if (self->app)
+    ztk_app_update_widget (self->app, self);
+}
+
+/**
+ * Queues a redraw of the widget's rectangle.
+ *
+ * This is a no-op if the widget is not added to
+ * an app, or if its fingerprint did not change
+ * since it was last drawn.
+ */
+void
+ztk_widget_queue_draw (
+  ZtkWidget * self)
+{
+  if (!self->app || !self->app->view ||
+      ztk_widget_is_unchanged (self))
+    return;
+
+  PuglRect rect = {
+    self->rect.x, self->rect.y, self->rect.width,
+    self->rect.height };
+  puglPostRedisplayRect (self->app->view, rect);
+}
+
+/**
+ * Returns whether the widget would look the same
+ * as when it was last drawn, according to its
+ * fingerprint.
+ *
+ * Widgets without a fingerprint callback are never
+ * considered unchanged.
+ */
+int
+ztk_widget_is_unchanged (
+  ZtkWidget * self)
+{
+  if (!self->fingerprint_cb)
+    return 0;
+
+  uint64_t fp = self->fingerprint_cb (self);
+  fp = ztk_fingerprint_add (fp, self->state);
+  fp =
+    ztk_fingerprint_add (
+      fp, (uint64_t) (int64_t) self->rect.x);
+  fp =
+    ztk_fingerprint_add (
+      fp, (uint64_t) (int64_t) self->rect.y);
+  fp =
+    ztk_fingerprint_add (
+      fp, (uint64_t) (int64_t) self->rect.width);
+  fp =
+    ztk_fingerprint_add (
+      fp, (uint64_t) (int64_t) self->rect.height);
+  self->fingerprint = fp;
+
+  return
+    self->has_drawn_fingerprint &&
+    self->drawn_fingerprint == fp;
+}
+
+/**
+ * Records the fingerprint calculated in the last
+ * ztk_widget_is_unchanged() call as drawn.
+ */
+void
+ztk_widget_mark_drawn (
+  ZtkWidget * self)
+{
+  if (!self->fingerprint_cb)
+    return;
+
+  self->drawn_fingerprint = self->fingerprint;
+  self->has_drawn_fingerprint = 1;
+}
+
+/**
+ * Adds a value to a fingerprint.
+ */
+uint64_t
+ztk_fingerprint_add (
+  uint64_t fingerprint,
+  uint64_t val)
+{
+  /* FNV-1a over the 8 bytes */
+  if (!fingerprint)
+    fingerprint = 14695981039346656037ull;
+  for (int i = 0; i < 8; i++)
+    {
+      fingerprint ^= (val >> (i * 8)) & 0xff;
+      fingerprint *= 1099511628211ull;
+    }
+
+  return fingerprint;
+}
+
+/**
+ * Adds a string (which may be NULL) to a
+ * fingerprint.
+ */
+uint64_t
+ztk_fingerprint_add_str (
+  uint64_t     fingerprint,
+  const char * str)
+{
+  if (!fingerprint)
+    fingerprint = 14695981039346656037ull;
+  if (!str)
+    return ztk_fingerprint_add (fingerprint, 0);
+
+  for (; *str; str++)
+    {
+      fingerprint ^= (unsigned char) *str;
+      fingerprint *= 1099511628211ull;
+    }
+
+  /* so that "ab" + "c" differs from "a" + "bc" */
+  return ztk_fingerprint_add (fingerprint, 1);
 }
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Checks that dispatching events and drawing the
+ * built-in widgets on a warmed up app does not
+ * allocate, by interposing malloc() and friends.
+ *
+ * Only supported on glibc, skipped elsewhere.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#ifdef __GLIBC__
+
+extern void * __libc_malloc (size_t size);
+extern void * __libc_calloc (size_t num, size_t size);
+extern void * __libc_realloc (void * ptr, size_t size);
+
+/** Set while counting allocations on this
+ * thread. */
+static __thread int armed = 0;
+
+static int num_allocs = 0;
+
+void *
+malloc (
+  size_t size)
+{
+  if (armed)
+    num_allocs++;
+  return __libc_malloc (size);
+}
+
+void *
+calloc (
+  size_t num,
+  size_t size)
+{
+  if (armed)
+    num_allocs++;
+  return __libc_calloc (num, size);
+}
+
+void *
+realloc (
+  void * ptr,
+  size_t size)
+{
+  if (armed)
+    num_allocs++;
+  return __libc_realloc (ptr, size);
+}
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+static void
+draw_area_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   draw_rect,
+  void *      data)
+{
+  cairo_set_source_rgba (cr, 1, 0, 0, 1);
+  cairo_rectangle (
+    cr, widget->rect.x, widget->rect.y,
+    widget->rect.width, widget->rect.height);
+  cairo_fill (cr);
+}
+
+/**
+ * Hovers over the whole app and, if \p press is
+ * set, drags the widget at 30,30 and clicks the one
+ * at 130,20.
+ */
+static void
+run_frames (
+  ZtkApp * app,
+  int      num_frames,
+  int      press)
+{
+  for (int i = 0; i < num_frames; i++)
+    {
+      send_motion_event (
+        app, (i * 37) % 200, (i * 53) % 200);
+      if (press && i % 4 == 0)
+        {
+          send_button_event (
+            app, PUGL_BUTTON_PRESS, 30, 30);
+          send_motion_event (app, 30, 30 - i % 20);
+          send_button_event (
+            app, PUGL_BUTTON_RELEASE, 30, 10);
+          send_button_event (
+            app, PUGL_BUTTON_PRESS, 130, 20);
+          send_button_event (
+            app, PUGL_BUTTON_RELEASE, 130, 20);
+        }
+      test_knob_val = (float) (i % 10) / 10.f;
+      ztk_app_idle (app);
+    }
+}
+
+/**
+ * Runs the frames once to warm up, then again while
+ * counting allocations.
+ */
+static void
+check_steady_state (
+  ZtkApp * app,
+  int      press)
+{
+  run_frames (app, 20, press);
+
+  num_allocs = 0;
+  armed = 1;
+  run_frames (app, 20, press);
+  armed = 0;
+  if (num_allocs)
+    {
+      ztk_error (
+        "%d allocations in steady state",
+        num_allocs);
+    }
+  ztk_assert (num_allocs == 0);
+}
+
+#endif
+
+int main (
+  int argc, const char* argv[])
+{
+#ifndef __GLIBC__
+  /* skipped */
+  return 77;
+#else
+  ZtkColor color;
+  ztk_color_parse_hex (&color, "#CCCCCC");
+
+  /* controls that take presses */
+  ZtkApp * app =
+    ztk_app_new ("alloc free", NULL, 200, 200);
+  ZtkRect rect = { 10, 10, 40, 40 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+  ZtkLabel * label =
+    ztk_label_new (60, 20, 10, &color, "Label");
+  ztk_app_add_widget (app, (ZtkWidget *) label, 1);
+  rect = (ZtkRect) { 110, 10, 40, 20 };
+  ZtkButton * btn =
+    ztk_button_new (&rect, noop_cb, NULL);
+  ztk_button_set_background_colors (
+    btn, &color, &color, &color);
+  ztk_app_add_widget (app, (ZtkWidget *) btn, 1);
+  rect = (ZtkRect) { 10, 100, 180, 20 };
+  ZtkControl * control =
+    ztk_control_new (
+      &rect, get_control_val, set_control_val,
+      draw_area_cb,
+      ZTK_CTRL_DRAG_HORIZONTAL, NULL, 0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) control, 1);
+  rect = (ZtkRect) { 10, 150, 180, 40 };
+  ZtkDrawingArea * area =
+    ztk_drawing_area_new (
+      &rect, NULL, draw_area_cb, NULL, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) area, 1);
+
+  check_steady_state (app, 1);
+  ztk_app_free (app);
+
+  /* popups, which are closed by presses elsewhere,
+   * so only hovered */
+  app =
+    ztk_app_new ("alloc free", NULL, 200, 200);
+  rect = (ZtkRect) { 10, 10, 40, 20 };
+  btn = ztk_button_new (&rect, noop_cb, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) btn, 1);
+  ZtkComboBox * combo =
+    ztk_combo_box_new ((ZtkWidget *) btn, 0, 0);
+  ztk_app_add_widget (app, (ZtkWidget *) combo, 10);
+  ztk_combo_box_add_text_element (
+    combo, "First", noop_cb, NULL);
+  ztk_combo_box_add_separator (combo);
+  ztk_combo_box_add_text_element (
+    combo, "Second", noop_cb, NULL);
+  rect = (ZtkRect) { 0, 0, 200, 200 };
+  ZtkRect dialog_rect = { 60, 60, 120, 120 };
+  ZtkDialog * dialog =
+    ztk_dialog_new (app, &rect, &dialog_rect, NULL);
+  ztk_dialog_make_about (
+    dialog, "Title", "1.0", "Copyright",
+    ZTK_DIALOG_ABOUT_LICENSE_AGPL_3_PLUS, "Text");
+  ztk_app_add_widget (app, (ZtkWidget *) dialog, 5);
+
+  check_steady_state (app, 0);
+  ztk_app_free (app);
+
+  return 0;
+#endif
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Allocates widgets from the app's arena and frees
+ * them together with the app.
+ */
+
+#include "helper.h"
+
+#include <stdalign.h>
+#include <stdint.h>
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#define NUM_KNOBS 100
+
+int main (
+  int argc, const char* argv[])
+{
+  /* allocations are zeroed and aligned, and large
+   * ones get their own block */
+  ZtkArena * arena = ztk_arena_new (256);
+  for (size_t i = 1; i < 1000; i += 37)
+    {
+      unsigned char * ptr =
+        ztk_arena_alloc (arena, i);
+      ztk_assert (
+        (uintptr_t) ptr % alignof (max_align_t) == 0);
+      for (size_t j = 0; j < i; j++)
+        ztk_assert (ptr[j] == 0);
+      memset (ptr, 0xff, i);
+      ztk_assert (ztk_arena_contains (arena, ptr));
+    }
+  int on_stack;
+  ztk_assert (!ztk_arena_contains (arena, &on_stack));
+  ztk_arena_free (arena);
+
+  ZtkApp * app =
+    ztk_app_new ("arena", NULL, 200, 200);
+  ztk_app_use_arena (app, 1);
+  ztk_assert (ztk_arena_get_current () == app->arena);
+  for (int i = 0; i < NUM_KNOBS; i++)
+    {
+      ZtkRect rect = {
+        (i % 10) * 20, (i / 10) * 20, 20, 20 };
+      ZtkKnob * knob =
+        ztk_knob_new (
+          &rect, get_knob_val, set_knob_val, NULL,
+          0.f, 1.f, 0.f);
+      ztk_assert (
+        ztk_arena_contains (app->arena, knob));
+      ztk_assert (
+        ((ZtkWidget *) knob)->arena == app->arena);
+      ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+    }
+  ZtkColor color = { 1, 1, 1, 1 };
+  ZtkLabel * label =
+    ztk_label_new (0, 0, 10, &color, "Label");
+  ztk_app_add_widget (app, (ZtkWidget *) label, 2);
+  ztk_app_use_arena (app, 0);
+  ztk_assert (!ztk_arena_get_current ());
+
+  /* widgets created afterwards are on the heap */
+  ZtkRect rect = { 0, 0, 10, 10 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_assert (!((ZtkWidget *) knob)->arena);
+  ztk_assert (!ztk_arena_contains (app->arena, knob));
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 3);
+
+  ztk_app_idle (app);
+
+  /* frees both kinds of widgets */
+  ztk_app_free (app);
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <stdatomic.h>
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/** Loads block until this is set, to check that
+ * the UI thread does not wait for them. */
+static atomic_int can_load = 0;
+
+static pthread_t main_thread;
+
+static cairo_surface_t * loaded[4];
+static int num_loaded = 0;
+
+static void
+render_cb (
+  cairo_t * cr,
+  int       width,
+  int       height,
+  void *    data)
+{
+}
+
+static void *
+load_func (
+  const void * data)
+{
+  while (!atomic_load (&can_load))
+    usleep (1000);
+
+  const int * size = (const int *) data;
+  return
+    ztk_resource_cache_get_surface (
+      "asset", *size, *size, render_cb, NULL);
+}
+
+static void
+loaded_cb (
+  ZtkWidget *  widget,
+  void *       asset,
+  const void * data)
+{
+  ztk_assert (
+    pthread_equal (pthread_self (), main_thread));
+  const int * size = (const int *) data;
+  ztk_assert (
+    cairo_image_surface_get_width (asset) == *size);
+  loaded[num_loaded++] = asset;
+}
+
+static void
+draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   draw_rect,
+  void *      data)
+{
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  main_thread = pthread_self ();
+
+  ZtkApp * app =
+    ztk_app_new ("asset loader", NULL, 100, 100);
+  ZtkRect rect = { 10, 10, 40, 40 };
+  ZtkDrawingArea * area =
+    ztk_drawing_area_new (
+      &rect, NULL, draw_cb, NULL, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) area, 1);
+  ztk_assert (!app->asset_loader);
+  ZtkAssetLoader * loader =
+    ztk_app_get_asset_loader (app);
+  ztk_assert (loader);
+  ztk_assert (
+    ztk_app_get_asset_loader (app) == loader);
+
+  /* requests return before the assets are
+   * loaded and frames are not held up by them */
+  int sizes[] = { 16, 32 };
+  for (int i = 0; i < 2; i++)
+    {
+      ztk_asset_loader_load (
+        loader, (ZtkWidget *) area, load_func,
+        loaded_cb, &sizes[i], sizeof (int));
+    }
+  ztk_app_idle (app);
+  ztk_assert (num_loaded == 0);
+  ztk_assert (
+    ztk_asset_loader_get_num_pending (loader) == 2);
+
+  /* loaded assets are passed on in the next
+   * frame */
+  atomic_store (&can_load, 1);
+  ztk_asset_loader_wait (loader);
+  ztk_assert (num_loaded == 0);
+  ztk_app_idle (app);
+  ztk_assert (num_loaded == 2);
+  ztk_assert (
+    ztk_asset_loader_get_num_pending (loader) == 0);
+
+  /* other apps share the threads but dispatch
+   * their own loads */
+  int num_threads =
+    ztk_asset_loader_get_num_threads ();
+  ztk_assert (num_threads > 0);
+  ZtkApp * other_app =
+    ztk_app_new ("other", NULL, 100, 100);
+  ZtkDrawingArea * other_area =
+    ztk_drawing_area_new (
+      &rect, NULL, draw_cb, NULL, NULL);
+  ztk_app_add_widget (
+    other_app, (ZtkWidget *) other_area, 1);
+  ZtkAssetLoader * other_loader =
+    ztk_app_get_asset_loader (other_app);
+  ztk_assert (other_loader != loader);
+  ztk_assert (
+    ztk_asset_loader_get_num_threads () ==
+      num_threads);
+  ztk_asset_loader_load (
+    other_loader, (ZtkWidget *) other_area,
+    load_func, loaded_cb, &sizes[0], sizeof (int));
+  ztk_asset_loader_wait (other_loader);
+  ztk_app_idle (app);
+  ztk_assert (num_loaded == 2);
+  ztk_app_idle (other_app);
+  ztk_assert (num_loaded == 3);
+  ztk_app_free (other_app);
+  ztk_assert (
+    ztk_asset_loader_get_num_threads () ==
+      num_threads);
+
+  /* loads of removed widgets are dropped */
+  atomic_store (&can_load, 0);
+  rect = (ZtkRect) { 60, 10, 30, 30 };
+  ZtkDrawingArea * removed =
+    ztk_drawing_area_new (
+      &rect, NULL, draw_cb, NULL, NULL);
+  ztk_app_add_widget (
+    app, (ZtkWidget *) removed, 1);
+  int size = 64;
+  for (int i = 0; i < 3; i++)
+    {
+      ztk_asset_loader_load (
+        loader, (ZtkWidget *) removed, load_func,
+        loaded_cb, &size, sizeof (int));
+    }
+  ztk_app_remove_widget (
+    app, (ZtkWidget *) removed);
+  ((ZtkWidget *) removed)->free_cb (
+    (ZtkWidget *) removed, NULL);
+  ztk_assert (
+    ztk_asset_loader_get_num_pending (loader) == 0);
+  atomic_store (&can_load, 1);
+  ztk_asset_loader_wait (loader);
+  ztk_assert (ztk_asset_loader_dispatch (loader) == 0);
+  ztk_assert (num_loaded == 3);
+
+  /* loads still pending when the app is freed
+   * are released */
+  ztk_asset_loader_load (
+    loader, (ZtkWidget *) area, load_func,
+    loaded_cb, &size, sizeof (int));
+  ztk_app_free (app);
+  ztk_assert (num_loaded == 3);
+
+  /* the threads stop with the last loader */
+  ztk_assert (
+    ztk_asset_loader_get_num_threads () == 0);
+
+  for (int i = 0; i < num_loaded; i++)
+    {
+      ztk_resource_cache_release (loaded[i]);
+    }
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 0);
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <stdint.h>
+
+#include <ztoolkit/ztk.h>
+
+#define BROKEN_PACK_PATH "asset_pack_test.ztkpack"
+
+/* layout of the index, see scripts/ztkpack.py */
+#define PACK_HEADER_SIZE 32
+#define PACK_ENTRY_SIZE 80
+
+static uint32_t
+get_pixel (
+  cairo_surface_t * surface,
+  int               x,
+  int               y)
+{
+  unsigned char * data =
+    cairo_image_surface_get_data (surface);
+  int stride =
+    cairo_image_surface_get_stride (surface);
+  uint32_t pixel;
+  memcpy (
+    &pixel, data + y * stride + x * 4,
+    sizeof (pixel));
+  return pixel;
+}
+
+static char *
+read_file (
+  const char * path,
+  size_t *     size)
+{
+  FILE * file = fopen (path, "rb");
+  ztk_assert (file);
+  fseek (file, 0, SEEK_END);
+  *size = (size_t) ftell (file);
+  fseek (file, 0, SEEK_SET);
+  char * contents = malloc (*size);
+  ztk_assert (
+    fread (contents, 1, *size, file) == *size);
+  fclose (file);
+  return contents;
+}
+
+static void
+write_file (
+  const char * path,
+  const char * contents,
+  size_t       size)
+{
+  FILE * file = fopen (path, "wb");
+  ztk_assert (file);
+  ztk_assert (
+    fwrite (contents, 1, size, file) == size);
+  fclose (file);
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ztk_assert (argc == 3);
+  const char * pack_path = argv[1];
+
+  ZtkAssetPack * pack =
+    ztk_asset_pack_new (pack_path);
+  ztk_assert (pack);
+
+  /* sprites are premultiplied */
+  cairo_surface_t * sprite =
+    ztk_asset_pack_get_sprite (pack, "sprite", 1.0);
+  ztk_assert (sprite);
+  ztk_assert (
+    cairo_image_surface_get_width (sprite) == 4);
+  ztk_assert (
+    cairo_image_surface_get_height (sprite) == 4);
+  ztk_assert (
+    get_pixel (sprite, 0, 0) == 0xFFFF0000);
+  ztk_assert (
+    get_pixel (sprite, 1, 0) == 0x80801E00);
+  ztk_assert (
+    ztk_asset_pack_get_sprite (
+      pack, "sprite", 1.0) == sprite);
+  ztk_assert (
+    ztk_asset_pack_get_sprite (
+      pack, "sprite", 0.5) == sprite);
+
+  /* the next larger scale is picked, or the
+   * largest */
+  cairo_surface_t * sprite_2x =
+    ztk_asset_pack_get_sprite (pack, "sprite", 1.5);
+  ztk_assert (sprite_2x && sprite_2x != sprite);
+  ztk_assert (
+    cairo_image_surface_get_width (sprite_2x) == 8);
+  ztk_assert (
+    ztk_asset_pack_get_sprite (
+      pack, "sprite", 2.0) == sprite_2x);
+  ztk_assert (
+    ztk_asset_pack_get_sprite (
+      pack, "sprite", 3.0) == sprite_2x);
+  ztk_assert (get_pixel (sprite_2x, 0, 0) == 0);
+  ztk_assert (
+    get_pixel (sprite_2x, 1, 0) == 0xFF0000FF);
+  ztk_assert (
+    get_pixel (sprite_2x, 2, 0) == 0x80008000);
+
+  ztk_assert (
+    !ztk_asset_pack_get_sprite (
+      pack, "missing", 1.0));
+  ztk_assert (
+    !ztk_asset_pack_get_sprite (
+      pack, "compiled.svg", 1.0));
+
+  /* other files are stored as they are */
+  size_t svg_size = 0;
+  char * svg = read_file (argv[2], &svg_size);
+  size_t size = 0;
+  const void * data =
+    ztk_asset_pack_get_data (
+      pack, "compiled.svg", &size);
+  ztk_assert (data);
+  ztk_assert (size == svg_size);
+  ztk_assert (!memcmp (data, svg, size));
+  free (svg);
+  ztk_assert (
+    !ztk_asset_pack_get_data (
+      pack, "sprite", &size));
+  ztk_asset_pack_free (pack);
+
+  /* broken packs are rejected */
+  size_t pack_size = 0;
+  char * contents = read_file (pack_path, &pack_size);
+  write_file (BROKEN_PACK_PATH, contents, 100);
+  ztk_assert (!ztk_asset_pack_new (BROKEN_PACK_PATH));
+  contents[0] = 'X';
+  write_file (
+    BROKEN_PACK_PATH, contents, pack_size);
+  ztk_assert (!ztk_asset_pack_new (BROKEN_PACK_PATH));
+  contents[0] = 'Z';
+  write_file (
+    BROKEN_PACK_PATH, contents, pack_size);
+  pack = ztk_asset_pack_new (BROKEN_PACK_PATH);
+  ztk_assert (pack);
+  ztk_asset_pack_free (pack);
+
+  /* so are packs whose entries are not sorted,
+   * here the two scales of "sprite" */
+  char entry[PACK_ENTRY_SIZE];
+  char * entry_1x =
+    contents + PACK_HEADER_SIZE + PACK_ENTRY_SIZE;
+  char * entry_2x = entry_1x + PACK_ENTRY_SIZE;
+  memcpy (entry, entry_1x, PACK_ENTRY_SIZE);
+  memcpy (entry_1x, entry_2x, PACK_ENTRY_SIZE);
+  memcpy (entry_2x, entry, PACK_ENTRY_SIZE);
+  write_file (
+    BROKEN_PACK_PATH, contents, pack_size);
+  ztk_assert (!ztk_asset_pack_new (BROKEN_PACK_PATH));
+  free (contents);
+  remove (BROKEN_PACK_PATH);
+  ztk_assert (!ztk_asset_pack_new (BROKEN_PACK_PATH));
+
+  /* packs are shared by the apps */
+  ZtkApp * app =
+    ztk_app_new ("asset pack", NULL, 100, 100);
+  ZtkApp * app2 =
+    ztk_app_new ("asset pack 2", NULL, 100, 100);
+  ztk_assert (
+    !ztk_app_load_asset_pack (app, pack_path));
+  ztk_assert (
+    !ztk_app_load_asset_pack (app2, pack_path));
+  ztk_assert (app->asset_pack == app2->asset_pack);
+  sprite = ztk_app_get_sprite (app, "sprite", 2.0);
+  ztk_assert (sprite);
+  ztk_assert (
+    ztk_app_get_sprite (app2, "sprite", 2.0) ==
+      sprite);
+
+  /* a failed load keeps the current pack */
+  ztk_assert (
+    ztk_app_load_asset_pack (
+      app, BROKEN_PACK_PATH));
+  ztk_assert (
+    ztk_app_get_sprite (app, "sprite", 2.0) ==
+      sprite);
+
+  ztk_app_free (app);
+  ztk_app_free (app2);
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 0);
+
+  return 0;
+}
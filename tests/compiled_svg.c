@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#include "compiled_svgs.h"
+
+static int num_draws = 0;
+
+static void
+counting_draw (
+  cairo_t * cr)
+{
+  num_draws++;
+  test_svgs_compiled.draw (cr);
+}
+
+static const ZtkCompiledSvg counting_svg = {
+  "counting", 32.0, 32.0, counting_draw };
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ztk_assert (
+    !strcmp (test_svgs_compiled.name, "compiled"));
+  ztk_assert (
+    math_doubles_equal (
+      test_svgs_compiled.width, 32.0));
+  ztk_assert (
+    math_doubles_equal (
+      test_svgs_compiled.height, 32.0));
+
+  /* the generated calls leave the context in a
+   * valid state */
+  cairo_surface_t * surface =
+    cairo_image_surface_create (
+      CAIRO_FORMAT_ARGB32, 64, 48);
+  cairo_t * cr = cairo_create (surface);
+  ZtkRect rect = { 0, 0, 64, 48 };
+  ztk_compiled_svg_draw (
+    &test_svgs_compiled, cr, &rect);
+  ztk_assert (
+    cairo_status (cr) == CAIRO_STATUS_SUCCESS);
+
+  /* nothing is drawn in an empty rectangle */
+  rect.width = 0;
+  ztk_compiled_svg_draw (&counting_svg, cr, &rect);
+  ztk_assert (num_draws == 0);
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+
+  /* buttons draw the SVG of their state */
+  ZtkApp * app =
+    ztk_app_new ("compiled svg", NULL, 100, 100);
+  rect = (ZtkRect) { 10, 10, 40, 40 };
+  ZtkButton * btn =
+    ztk_button_new (&rect, noop_cb, NULL);
+  ztk_button_make_compiled_svged (
+    btn, 2, 2, &counting_svg, &test_svgs_compiled,
+    &test_svgs_compiled);
+  ztk_app_add_widget (app, (ZtkWidget *) btn, 1);
+  ztk_app_draw (
+    app, (cairo_t *)
+      puglGetContext (app->view), &rect);
+  ztk_assert (num_draws == 1);
+
+  PuglEventMotion ev = {
+    .type = PUGL_MOTION_NOTIFY, .x = 20, .y = 20 };
+  puglHeadlessSendEvent (
+    app->view, (const PuglEvent *) &ev);
+  ztk_app_idle (app);
+  ztk_assert (num_draws == 1);
+  ztk_assert (app->num_damage_rects > 0);
+
+  ztk_app_free (app);
+
+  return 0;
+}
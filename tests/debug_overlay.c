@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Checks the repaint flashes of the debug overlay
+ * on the headless platform.
+ */
+
+#include "helper.h"
+
+#include <time.h>
+
+#include <ztoolkit/ztk.h>
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkApp * app =
+    ztk_app_new ("debug_overlay", NULL, 200, 200);
+  ZtkRect rect = { 100, 100, 50, 50 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+
+  ztk_app_set_debug_overlay_enabled (app, 1);
+  ZtkDebugOverlay * overlay = app->debug_overlay;
+  ztk_assert (overlay);
+
+  /* the first frame is a full repaint */
+  ztk_app_idle (app);
+  ztk_assert (overlay->num_frames == 1);
+  ztk_assert (overlay->num_flashes == 1);
+  ztk_assert (!overlay->flashes[0].widget);
+
+  /* a changed widget flashes its own area */
+  test_knob_val = 0.9f;
+  ztk_app_idle (app);
+  ztk_assert (overlay->num_frames == 2);
+  ztk_assert (overlay->num_flashes == 2);
+  ztk_assert (
+    overlay->flashes[1].widget ==
+      (ZtkWidget *) knob);
+  ztk_assert (
+    ztk_rect_is_equal (
+      &overlay->flashes[1].rect, &rect));
+
+  /* repainting the same widget again restarts its
+   * flash */
+  test_knob_val = 0.1f;
+  ztk_app_idle (app);
+  ztk_assert (overlay->num_flashes == 2);
+
+  /* frames keep coming while the flashes fade
+   * out, without repainting the knob */
+  struct timespec ts = { 0, 350000000 };
+  nanosleep (&ts, NULL);
+  ztk_app_set_stats_enabled (app, 1);
+  ztk_app_idle (app);
+  ztk_assert (overlay->num_frames == 4);
+  ztk_assert (overlay->num_flashes == 0);
+  ztk_assert (app->stats.last_widgets_drawn == 1);
+  ztk_app_idle (app);
+  ztk_assert (app->stats.last_widgets_drawn == 0);
+
+  ztk_app_set_debug_overlay_enabled (app, 0);
+  ztk_assert (!app->debug_overlay);
+  ztk_assert (app->redraw_all);
+
+  ztk_app_free (app);
+
+  return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+static ZtkControl *
+filmstrip_control_new (
+  ZtkApp * app,
+  double   x,
+  double   size)
+{
+  ZtkRect rect = { x, 0, size, size };
+  ZtkControl * control =
+    ztk_control_new (
+      &rect, get_control_val, set_control_val,
+      NULL, ZTK_CTRL_DRAG_VERTICAL, NULL, 0.f, 1.f,
+      0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) control, 1);
+
+  return control;
+}
+
+static void
+draw (
+  ZtkApp * app)
+{
+  ZtkRect rect = { 0, 0, 100, 100 };
+  ztk_app_draw (
+    app, (cairo_t *) puglGetContext (app->view),
+    &rect);
+}
+
+static char *
+read_file (
+  const char * path,
+  size_t *     size)
+{
+  FILE * file = fopen (path, "rb");
+  ztk_assert (file);
+  fseek (file, 0, SEEK_END);
+  *size = (size_t) ftell (file);
+  fseek (file, 0, SEEK_SET);
+  char * contents = malloc (*size);
+  ztk_assert (
+    fread (contents, 1, *size, file) == *size);
+  fclose (file);
+  return contents;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ztk_assert (argc == 2);
+  const char * path = argv[1];
+  test_knob_val = 0.f;
+
+  ZtkApp * app =
+    ztk_app_new ("filmstrip", NULL, 100, 100);
+
+  /* 4 frames of 8x8, drawn as they are and
+   * scaled */
+  ZtkControl * control =
+    filmstrip_control_new (app, 0, 8);
+  ztk_assert (
+    !ztk_control_make_filmstrip_from_png (
+      control, path, 4,
+      ZTK_CTRL_FILMSTRIP_VERTICAL));
+  ZtkControl * scaled =
+    filmstrip_control_new (app, 10, 20);
+  ztk_assert (
+    !ztk_control_make_filmstrip_from_png (
+      scaled, path, 4,
+      ZTK_CTRL_FILMSTRIP_VERTICAL));
+  draw (app);
+
+  /* the strip is shared */
+  ztk_assert (control->filmstrip);
+  ztk_assert (
+    control->filmstrip == scaled->filmstrip);
+  ztk_assert (
+    cairo_image_surface_get_height (
+      control->filmstrip) == 32);
+
+  /* only scaled frames are drawn from their own
+   * subsurface */
+  ztk_assert (!control->filmstrip_frames[0]);
+  ztk_assert (scaled->filmstrip_frames[0]);
+  ztk_assert (!scaled->filmstrip_frames[1]);
+
+  /* only redrawn when the frame changes */
+  test_knob_val = 0.1f;
+  ztk_assert (
+    ztk_widget_is_unchanged ((ZtkWidget *) control));
+  test_knob_val = 0.5f;
+  ztk_assert (
+    !ztk_widget_is_unchanged ((ZtkWidget *) control));
+  draw (app);
+  test_knob_val = 0.6f;
+  ztk_assert (
+    ztk_widget_is_unchanged ((ZtkWidget *) control));
+  test_knob_val = 1.f;
+  ztk_assert (
+    !ztk_widget_is_unchanged ((ZtkWidget *) control));
+  draw (app);
+
+  /* from memory */
+  size_t size = 0;
+  char * contents = read_file (path, &size);
+  ZtkControl * from_data =
+    filmstrip_control_new (app, 40, 8);
+  ztk_assert (
+    !ztk_control_make_filmstrip_from_png_data (
+      from_data, "filmstrip", contents, size, 4,
+      ZTK_CTRL_FILMSTRIP_VERTICAL));
+  ztk_assert (
+    ztk_control_make_filmstrip_from_png_data (
+      from_data, "invalid", contents, 10, 4,
+      ZTK_CTRL_FILMSTRIP_VERTICAL));
+  free (contents);
+  ztk_assert (from_data->filmstrip);
+
+  /* from any surface, eg, an asset pack sprite */
+  cairo_surface_t * strip =
+    cairo_image_surface_create (
+      CAIRO_FORMAT_ARGB32, 32, 8);
+  ZtkControl * from_surface =
+    filmstrip_control_new (app, 60, 8);
+  ztk_control_make_filmstrip (
+    from_surface, strip, 4,
+    ZTK_CTRL_FILMSTRIP_HORIZONTAL);
+  cairo_surface_destroy (strip);
+  draw (app);
+
+  ztk_assert (
+    ztk_control_make_filmstrip_from_png (
+      control, "missing.png", 4,
+      ZTK_CTRL_FILMSTRIP_VERTICAL));
+
+  ztk_app_free (app);
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 0);
+
+  return 0;
+}
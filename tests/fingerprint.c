@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+static void
+count_draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   rect,
+  void *      data)
+{
+  (*(int *) data)++;
+}
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+static uint64_t
+const_fingerprint_cb (
+  ZtkWidget * widget)
+{
+  return 1;
+}
+
+static uint64_t zero_size_fp = 1;
+
+static uint64_t
+zero_size_fingerprint_cb (
+  ZtkWidget * widget)
+{
+  return zero_size_fp;
+}
+
+static ZtkWidget *
+counting_widget_new (
+  ZtkRect * rect,
+  int *     num_draws)
+{
+  ZtkWidget * widget =
+    calloc (1, sizeof (ZtkWidget));
+  ztk_widget_init (
+    widget, ZTK_WIDGET_TYPE_DRAWING_AREA, rect,
+    noop_cb, count_draw_cb, noop_cb);
+  widget->fingerprint_cb = const_fingerprint_cb;
+  widget->user_data = num_draws;
+
+  return widget;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkApp * app = calloc (1, sizeof (ZtkApp));
+  ztk_theme_init (&app->theme);
+  cairo_surface_t * surface =
+    cairo_image_surface_create (
+      CAIRO_FORMAT_ARGB32, 100, 100);
+  cairo_t * cr = cairo_create (surface);
+  ZtkRect full = { 0, 0, 100, 100 };
+
+  int bg_draws = 0;
+  int other_draws = 0;
+  ZtkRect rect = { 0, 0, 100, 50 };
+  ztk_app_add_widget (
+    app, counting_widget_new (&rect, &bg_draws), 0);
+  rect = (ZtkRect) { 60, 60, 20, 20 };
+  ztk_app_add_widget (
+    app, counting_widget_new (&rect, &other_draws),
+    1);
+  rect = (ZtkRect) { 10, 10, 30, 30 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+
+  /* everything is drawn the first time */
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 1 && other_draws == 1);
+
+  /* nothing changed */
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 1 && other_draws == 1);
+
+  /* a change smaller than a pixel */
+  test_knob_val += 0.0001f;
+  ztk_assert (
+    ztk_widget_is_unchanged ((ZtkWidget *) knob));
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 1 && other_draws == 1);
+
+  /* a visible change redraws the background under
+   * the knob, but not unrelated widgets */
+  test_knob_val = 0.8f;
+  ztk_assert (
+    !ztk_widget_is_unchanged ((ZtkWidget *) knob));
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 2 && other_draws == 1);
+
+  /* state changes are visible */
+  ((ZtkWidget *) knob)->state |=
+    ZTK_WIDGET_STATE_HOVERED;
+  ztk_assert (
+    !ztk_widget_is_unchanged ((ZtkWidget *) knob));
+
+  /* forced full redraw */
+  app->redraw_all = 1;
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 3 && other_draws == 2);
+
+  /* nothing is skipped if the backend does not
+   * keep the last frame */
+  app->backend_discards_frame = 1;
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 4 && other_draws == 3);
+  app->backend_discards_frame = 0;
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (bg_draws == 4 && other_draws == 3);
+
+  /* widgets after a changed zero-size one are
+   * marked drawn with their current fingerprint */
+  int zero_size_draws = 0;
+  rect = (ZtkRect) { 5, 5, 0, 0 };
+  ZtkWidget * zero_size =
+    counting_widget_new (&rect, &zero_size_draws);
+  zero_size->fingerprint_cb = zero_size_fingerprint_cb;
+  ztk_app_add_widget (app, zero_size, 0);
+  ztk_app_draw (app, cr, &full);
+  test_knob_val = 0.2f;
+  zero_size_fp++;
+  ztk_app_draw (app, cr, &full);
+  ztk_assert (
+    ztk_widget_is_unchanged ((ZtkWidget *) knob));
+  test_knob_val = 0.8f;
+  ztk_assert (
+    !ztk_widget_is_unchanged ((ZtkWidget *) knob));
+
+  /* labels with the same text look the same */
+  ZtkColor color = { 1, 1, 1, 1 };
+  ZtkLabel * label =
+    ztk_label_new (0, 0, 10, &color, "Cutoff");
+  ZtkWidget * label_w = (ZtkWidget *) label;
+  ztk_assert (!ztk_widget_is_unchanged (label_w));
+  ztk_widget_mark_drawn (label_w);
+  free (label->label);
+  label->label = strdup ("Cutoff");
+  ztk_assert (ztk_widget_is_unchanged (label_w));
+  free (label->label);
+  label->label = strdup ("Resonance");
+  ztk_assert (!ztk_widget_is_unchanged (label_w));
+
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+
+  return 0;
+}
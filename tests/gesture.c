@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+typedef struct Counts
+{
+  int   begins;
+  int   changes;
+  int   ends;
+  float last_value;
+} Counts;
+
+static void
+on_begin (
+  ZtkWidget * widget,
+  float       value,
+  void *      data)
+{
+  Counts * counts = (Counts *) data;
+  counts->begins++;
+  counts->last_value = value;
+}
+
+static void
+on_change (
+  ZtkWidget * widget,
+  float       value,
+  void *      data)
+{
+  Counts * counts = (Counts *) data;
+  counts->changes++;
+  counts->last_value = value;
+}
+
+static void
+on_end (
+  ZtkWidget * widget,
+  float       value,
+  void *      data)
+{
+  Counts * counts = (Counts *) data;
+
+  /* the final value must be written first */
+  ztk_assert (
+    math_floats_equal (value, counts->last_value));
+  counts->ends++;
+}
+
+static float stored_value = 0.f;
+
+static float
+get_val (
+  ZtkControl * control,
+  void *       object)
+{
+  return stored_value;
+}
+
+static void
+draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   draw_rect,
+  void *      data)
+{
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkGesture gesture = { 0 };
+  Counts counts = { 0 };
+  ztk_gesture_set_callbacks (
+    &gesture, on_begin, on_change, on_end, &counts);
+
+  /* once per frame: every change is written, but
+   * not unchanged values */
+  ztk_gesture_begin (&gesture, NULL, 0.f);
+  ztk_assert (counts.begins == 1);
+  ztk_assert (
+    ztk_gesture_update (&gesture, NULL, 0.1f, 0.0));
+  ztk_assert (
+    !ztk_gesture_update (&gesture, NULL, 0.1f, 0.1));
+  ztk_assert (
+    ztk_gesture_update (&gesture, NULL, 0.2f, 0.2));
+  ztk_assert (!ztk_gesture_flush (&gesture, NULL));
+  ztk_gesture_end (&gesture, NULL);
+  ztk_assert (counts.changes == 2);
+  ztk_assert (counts.ends == 1);
+  ztk_gesture_end (&gesture, NULL);
+  ztk_assert (counts.ends == 1);
+
+  /* 60 fps drag for 1 second at 10 writes per
+   * second */
+  memset (&counts, 0, sizeof (Counts));
+  ztk_gesture_set_rate (&gesture, 10.0);
+  ztk_gesture_begin (&gesture, NULL, 0.f);
+  int writes = 0;
+  for (int i = 1; i <= 60; i++)
+    {
+      if (ztk_gesture_update (
+            &gesture, NULL, (float) i / 60.f,
+            (double) i / 60.0))
+        writes++;
+    }
+  ztk_assert (writes >= 9 && writes <= 11);
+
+  /* the exact final value is written on release */
+  int flushed = ztk_gesture_flush (&gesture, NULL);
+  ztk_assert (
+    math_floats_equal (counts.last_value, 1.f));
+  ztk_assert (counts.changes == writes + flushed);
+  ztk_gesture_end (&gesture, NULL);
+  ztk_assert (counts.ends == 1);
+
+  /* custom controls are always redrawn unless they
+   * opt in, and then show and fingerprint the
+   * dragged value while its write is held back */
+  ZtkRect rect = { 0, 0, 40, 40 };
+  ZtkControl * control =
+    ztk_control_new (
+      &rect, get_val, NULL, draw_cb,
+      ZTK_CTRL_DRAG_VERTICAL, NULL, 0.f, 1.f, 0.f);
+  ZtkWidget * widget = (ZtkWidget *) control;
+  ztk_assert (!widget->fingerprint_cb);
+  ztk_control_use_value_fingerprint (control);
+  uint64_t fp = widget->fingerprint_cb (widget);
+  ztk_gesture_set_rate (&control->gesture, 1.0);
+  ztk_gesture_begin (&control->gesture, widget, 0.f);
+  ztk_assert (
+    ztk_gesture_update (
+      &control->gesture, widget, 0.5f, 0.0));
+  ztk_assert (
+    !ztk_gesture_update (
+      &control->gesture, widget, 0.7f, 0.1));
+  ztk_assert (
+    math_floats_equal (
+      ztk_control_get_shown_value (control), 0.7f));
+  ztk_assert (widget->fingerprint_cb (widget) != fp);
+  ztk_gesture_end (&control->gesture, widget);
+  ztk_assert (
+    math_floats_equal (
+      ztk_control_get_shown_value (control),
+      stored_value));
+  ztk_assert (widget->fingerprint_cb (widget) == fp);
+  widget->free_cb (widget, NULL);
+
+  return 0;
+}
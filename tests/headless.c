@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Drives a ZtkApp on the headless platform with
+ * synthetic events and checks the rendered
+ * pixels.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#define WIDTH 100
+#define HEIGHT 100
+
+static int gesture_begins = 0;
+static int gesture_ends = 0;
+
+static void
+on_gesture_begin (
+  ZtkWidget * widget,
+  float       value,
+  void *      data)
+{
+  gesture_begins++;
+}
+
+static void
+on_gesture_end (
+  ZtkWidget * widget,
+  float       value,
+  void *      data)
+{
+  gesture_ends++;
+}
+
+static void
+bg_draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   rect,
+  void *      data)
+{
+  cairo_set_source_rgb (cr, 0.2, 0.4, 0.6);
+  cairo_paint (cr);
+}
+
+static uint64_t
+bg_fingerprint_cb (
+  ZtkWidget * widget)
+{
+  return 1;
+}
+
+static uint32_t
+get_pixel (
+  ZtkApp * app,
+  int      x,
+  int      y)
+{
+  cairo_surface_t * surface =
+    (cairo_surface_t *)
+    puglHeadlessGetSurface (app->view);
+  cairo_surface_flush (surface);
+  unsigned char * data =
+    cairo_image_surface_get_data (surface);
+  int stride =
+    cairo_image_surface_get_stride (surface);
+
+  return
+    *(uint32_t *) (data + y * stride + x * 4) &
+    0xffffff;
+}
+
+/**
+ * Returns a copy of the rendered pixels.
+ */
+static uint32_t *
+copy_pixels (
+  ZtkApp * app)
+{
+  uint32_t * pixels =
+    malloc (WIDTH * HEIGHT * sizeof (uint32_t));
+  for (int y = 0; y < HEIGHT; y++)
+    {
+      for (int x = 0; x < WIDTH; x++)
+        {
+          pixels[y * WIDTH + x] =
+            get_pixel (app, x, y);
+        }
+    }
+
+  return pixels;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  test_knob_val = 0.f;
+  ZtkApp * app =
+    ztk_app_new ("headless", NULL, WIDTH, HEIGHT);
+  puglHeadlessSetTime (app->world, 0.0);
+
+  ZtkRect rect = { 0, 0, WIDTH, HEIGHT };
+  ZtkDrawingArea * bg =
+    ztk_drawing_area_new (
+      &rect, NULL, bg_draw_cb, NULL, NULL);
+  ((ZtkWidget *) bg)->fingerprint_cb =
+    bg_fingerprint_cb;
+  ztk_app_add_widget (app, (ZtkWidget *) bg, 0);
+
+  rect = (ZtkRect) { 10, 10, 40, 40 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_gesture_set_callbacks (
+    &knob->gesture, on_gesture_begin, NULL,
+    on_gesture_end, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+
+  /* the initial configure and expose are drawn */
+  ztk_app_idle (app);
+  ztk_assert (
+    puglHeadlessGetNumQueuedEvents (app->view) == 0);
+  uint32_t bg_pixel = get_pixel (app, 90, 90);
+  ztk_assert (bg_pixel == 0x336699);
+  ztk_assert (get_pixel (app, 30, 30) != bg_pixel);
+
+  /* drag the knob up */
+  send_button_event (app, PUGL_BUTTON_PRESS, 30, 30);
+  ztk_app_idle (app);
+  for (int i = 1; i <= 10; i++)
+    {
+      puglHeadlessSetTime (app->world, i / 60.0);
+      send_motion_event (app, 30, 30 - i * 2);
+      ztk_app_idle (app);
+    }
+  send_button_event (app, PUGL_BUTTON_RELEASE, 30, 10);
+  ztk_app_idle (app);
+  ztk_assert (test_knob_val > 0.1f);
+  ztk_assert (gesture_begins == 1);
+  ztk_assert (gesture_ends == 1);
+
+  /* the partially redrawn frame matches a full
+   * redraw */
+  uint32_t * partial = copy_pixels (app);
+  app->redraw_all = 1;
+  puglPostRedisplay (app->view);
+  ztk_app_idle (app);
+  uint32_t * full = copy_pixels (app);
+  ztk_assert (
+    !memcmp (
+      partial, full,
+      WIDTH * HEIGHT * sizeof (uint32_t)));
+  free (partial);
+  free (full);
+
+  ztk_app_free (app);
+
+  return 0;
+}
@@ -26,6 +26,9 @@
 #include <string.h>
 
 #include <ztoolkit/log.h>
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
 
 #define ztk_assert(x) \
   if (!(x)) \
@@ -48,4 +51,73 @@ str_endswith (
   return 0; // t was longer than s
 }
 
+/** Value behind the knobs and controls of the
+ * tests. */
+float test_knob_val = 0.5f;
+
+static inline float
+get_knob_val (
+  void * object)
+{
+  return test_knob_val;
+}
+
+static inline void
+set_knob_val (
+  void * object,
+  float  val)
+{
+  test_knob_val = val;
+}
+
+static inline float
+get_control_val (
+  ZtkControl * control,
+  void *       object)
+{
+  return test_knob_val;
+}
+
+static inline void
+set_control_val (
+  ZtkControl * control,
+  void *       object,
+  float        val)
+{
+  test_knob_val = val;
+}
+
+/**
+ * Sends a button event with the first button to
+ * the headless view of the app.
+ */
+static inline void
+send_button_event (
+  ZtkApp *      app,
+  PuglEventType type,
+  double        x,
+  double        y)
+{
+  PuglEventButton ev = {
+    .type = type, .x = x, .y = y, .button = 1 };
+  puglHeadlessSendEvent (
+    app->view, (const PuglEvent *) &ev);
+}
+
+/**
+ * Sends a motion event to the headless view of the
+ * app.
+ */
+static inline void
+send_motion_event (
+  ZtkApp * app,
+  double   x,
+  double   y)
+{
+  PuglEventMotion ev = {
+    .type = PUGL_MOTION_NOTIFY, .x = x, .y = y };
+  puglHeadlessSendEvent (
+    app->view, (const PuglEvent *) &ev);
+}
+
 #endif
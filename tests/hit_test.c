@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Checks that each supported hit testing kernel
+ * agrees with ztk_widget_is_hit_by_rect().
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#define NUM_WIDGETS 203
+#define NUM_QUERIES 500
+
+static uint32_t seed = 1;
+
+static double
+get_rand (
+  int max)
+{
+  seed = seed * 1664525u + 1013904223u;
+  return (double) ((seed >> 8) % (uint32_t) max);
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkWidget widgets[NUM_WIDGETS];
+  ZtkWidget * widget_ptrs[NUM_WIDGETS];
+  memset (widgets, 0, sizeof (widgets));
+  for (int i = 0; i < NUM_WIDGETS; i++)
+    {
+      ZtkWidget * w = &widgets[i];
+      w->rect.x = get_rand (1000);
+      w->rect.y = get_rand (1000);
+      w->rect.width = get_rand (100);
+      w->rect.height = get_rand (100);
+      w->visible = i % 7 != 0;
+      widget_ptrs[i] = w;
+    }
+  ZtkWidgetTable table;
+  memset (&table, 0, sizeof (table));
+  ztk_widget_table_rebuild (
+    &table, widget_ptrs, NUM_WIDGETS);
+
+  ztk_assert (
+    ztk_hit_test_is_impl_supported (
+      ZTK_HIT_TEST_SCALAR));
+  ztk_assert (
+    ztk_hit_test_is_impl_supported (
+      ztk_hit_test_get_impl ()));
+
+  uint8_t mask[(NUM_WIDGETS + 7) / 8];
+  ztk_assert (
+    ztk_hit_test_get_mask_size (&table) ==
+      sizeof (mask));
+  const ZtkHitTestImpl impls[] = {
+    ZTK_HIT_TEST_SCALAR, ZTK_HIT_TEST_SSE2,
+    ZTK_HIT_TEST_AVX2, ZTK_HIT_TEST_NEON, };
+  for (size_t i = 0;
+       i < sizeof (impls) / sizeof (impls[0]); i++)
+    {
+      if (ztk_hit_test_set_impl (impls[i]))
+        {
+          ztk_assert (
+            !ztk_hit_test_is_impl_supported (
+              impls[i]));
+          continue;
+        }
+      ztk_assert (ztk_hit_test_get_impl () == impls[i]);
+
+      seed = 2;
+      for (int j = 0; j < NUM_QUERIES; j++)
+        {
+          /* points every few queries */
+          ZtkRect rect = {
+            get_rand (1100), get_rand (1100),
+            j % 4 ? get_rand (200) : 0.0,
+            j % 4 ? get_rand (200) : 0.0, };
+          int num_hits =
+            ztk_hit_test_batch (&table, &rect, mask);
+          int num_expected = 0;
+          for (int k = 0; k < NUM_WIDGETS; k++)
+            {
+              int expected =
+                widgets[k].visible &&
+                ztk_widget_is_hit_by_rect (
+                  &widgets[k], &rect);
+              num_expected += expected;
+              ztk_assert (
+                ((mask[k / 8] >> (k % 8)) & 1) ==
+                  expected);
+            }
+          ztk_assert (num_hits == num_expected);
+        }
+    }
+
+  ztk_widget_table_free (&table);
+
+  return 0;
+}
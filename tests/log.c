@@ -17,8 +17,81 @@
  * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+/* debug messages are compiled out in this file */
+#define ZTK_LOG_MIN_LEVEL 1
+
 #include "helper.h"
 
+#include <pthread.h>
+
+#define LOG_PATH "log_test.txt"
+#define NUM_THREADS 4
+#define NUM_MESSAGES_PER_THREAD 1000
+
+static int num_evaluated = 0;
+
+static int
+evaluate (void)
+{
+  return ++num_evaluated;
+}
+
+static void *
+log_thread (
+  void * data)
+{
+  for (int i = 0; i < NUM_MESSAGES_PER_THREAD; i++)
+    {
+      ztk_message ("thread message %d", i);
+    }
+
+  return NULL;
+}
+
+static void *
+start_stop_thread (
+  void * data)
+{
+  for (int i = 0; i < 100; i++)
+    {
+      ztk_assert (!ztk_log_start_async (64));
+      ztk_message ("start stop message %d", i);
+      ztk_log_stop_async ();
+    }
+
+  return NULL;
+}
+
+/**
+ * Returns the number of lines containing \p str
+ * and adds the numbers of dropped messages to
+ * \p num_dropped.
+ */
+static int
+count_lines (
+  const char * str,
+  int *        num_dropped)
+{
+  FILE * file = fopen (LOG_PATH, "r");
+  ztk_assert (file);
+  char line[1024];
+  int num_lines = 0;
+  while (fgets (line, sizeof (line), file))
+    {
+      if (strstr (line, str))
+        num_lines++;
+      if (strstr (line, "log messages were dropped"))
+        {
+          /* the count follows the timestamp */
+          *num_dropped +=
+            atoi (strrchr (line, ':') + 2);
+        }
+    }
+  fclose (file);
+
+  return num_lines;
+}
+
 int main (
   int argc, const char* argv[])
 {
@@ -27,5 +100,80 @@ int main (
   ztk_warning ("%s %s", "warning test", "warning");
   ztk_error ("%s", "error test");
 
+  /* filtered out calls are not evaluated */
+  ztk_debug ("%d", evaluate ());
+  ztk_assert (num_evaluated == 0);
+
+  ztk_assert (freopen (LOG_PATH, "w", stderr));
+  ztk_log_set_level (ZTK_LOG_LEVEL_MESSAGE);
+
+  /* messages from several threads at once are
+   * either written or counted as dropped */
+  ztk_assert (!ztk_log_start_async (64));
+  pthread_t threads[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_create (
+        &threads[i], NULL, log_thread, NULL);
+    }
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_join (threads[i], NULL);
+    }
+
+  /* the backend keeps running until each start
+   * is matched by a stop */
+  ztk_assert (!ztk_log_start_async (64));
+  ztk_log_stop_async ();
+  ztk_message ("%s", "last async message");
+  ztk_log_stop_async ();
+
+  /* written synchronously */
+  ztk_message ("%s", "sync message");
+  fflush (stderr);
+
+  /* the last async message may have been dropped
+   * too if the ring was still full */
+  int num_dropped = 0;
+  int num_written =
+    count_lines ("thread message", &num_dropped);
+  int num_dropped_unused = 0;
+  num_written +=
+    count_lines (
+      "last async message", &num_dropped_unused);
+  ztk_assert (
+    num_written + num_dropped ==
+      NUM_THREADS * NUM_MESSAGES_PER_THREAD + 1);
+  ztk_assert (num_written > 0);
+  /* not to be confused with the last async
+   * message */
+  ztk_assert (
+    count_lines (
+      ": sync message", &num_dropped_unused) == 1);
+
+  /* apps on several threads may start and stop
+   * the backend at once */
+  ztk_assert (freopen (LOG_PATH, "w", stderr));
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_create (
+        &threads[i], NULL, start_stop_thread, NULL);
+    }
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_join (threads[i], NULL);
+    }
+  ztk_message ("%s", "sync message");
+  fflush (stderr);
+  num_dropped = 0;
+  ztk_assert (
+    count_lines ("start stop message", &num_dropped) +
+      num_dropped == NUM_THREADS * 100);
+  ztk_assert (
+    count_lines (
+      ": sync message", &num_dropped_unused) == 1);
+
+  remove (LOG_PATH);
+
   return 0;
 }
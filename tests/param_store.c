@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#define NUM_WRITES 20000
+
+static void *
+dsp_thread (
+  void * data)
+{
+  ZtkParamStore * store = (ZtkParamStore *) data;
+
+  for (int i = 1; i <= NUM_WRITES; i++)
+    {
+      /* retry while the UI catches up */
+      while (ztk_param_store_write_from_dsp (
+               store, (uint32_t) (i % 2),
+               (float) i))
+        sched_yield ();
+    }
+
+  return NULL;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkParamStore * store =
+    ztk_param_store_new (2, 64);
+
+  /* UI -> DSP */
+  ztk_assert (!ztk_param_store_set (store, 1, 0.5f));
+  ztk_assert (
+    ztk_param_store_get (store, 1) > 0.49f);
+  ztk_assert (ztk_param_store_set (store, 2, 0.5f));
+  uint32_t id;
+  float value;
+  ztk_assert (
+    ztk_param_store_read_from_ui (
+      store, &id, &value));
+  ztk_assert (id == 1 && value > 0.49f);
+  ztk_assert (
+    !ztk_param_store_read_from_ui (
+      store, &id, &value));
+
+  /* setting the same value sends nothing */
+  ztk_param_store_set (store, 1, 0.5f);
+  ztk_assert (
+    !ztk_param_store_read_from_ui (
+      store, &id, &value));
+
+  /* DSP -> UI, values arrive in order */
+  pthread_t thread;
+  pthread_create (&thread, NULL, dsp_thread, store);
+  float last[2] = { 0.f, 0.5f };
+  while (last[0] < (float) NUM_WRITES &&
+         last[1] < (float) NUM_WRITES)
+    {
+      ztk_param_store_drain (store);
+      for (int i = 0; i < 2; i++)
+        {
+          float val =
+            ztk_param_store_get (store, (uint32_t) i);
+          ztk_assert (val >= last[i]);
+          last[i] = val;
+        }
+      sched_yield ();
+    }
+  pthread_join (thread, NULL);
+  ztk_param_store_drain (store);
+  ztk_assert (
+    ztk_param_store_get (store, 0) >
+      (float) NUM_WRITES - 0.5f);
+  ztk_assert (
+    ztk_param_store_get (store, 1) >
+      (float) NUM_WRITES - 1.5f);
+
+  ztk_param_store_free (store);
+
+  /* port events only invalidate changed values */
+  store = ztk_param_store_new (202, 64);
+  ztk_assert (ztk_param_store_drain (store) == 0);
+  uint32_t ids[] = { 3, 100, 201, 500 };
+  float values[] = { 1.f, 2.f, 3.f, 4.f };
+  ztk_param_store_port_events (
+    store, ids, values, 4);
+  ztk_assert (ztk_param_store_drain (store) == 3);
+  ztk_assert (ztk_param_store_drain (store) == 0);
+  ztk_assert (
+    ztk_param_store_get (store, 201) > 2.99f);
+
+  /* contiguous array, one value differs */
+  float all[202] = { 0 };
+  all[3] = 1.f;
+  all[100] = 2.f;
+  all[201] = 3.f;
+  all[150] = 7.f;
+  ztk_param_store_port_events (
+    store, NULL, all, 202);
+  ztk_assert (ztk_param_store_drain (store) == 1);
+
+  /* NaNs are only redrawn once */
+  ztk_param_store_port_event (store, 7, NAN);
+  ztk_assert (ztk_param_store_drain (store) == 1);
+  ztk_assert (ztk_param_store_drain (store) == 0);
+
+  /* bound widgets read and write through the
+   * store */
+  ZtkRect rect = { 0, 0, 30, 30 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, NULL, NULL, NULL, 0.f, 10.f, 0.f);
+  ztk_knob_bind_param (knob, store, 0);
+  ztk_assert (store->params[0].num_widgets == 1);
+  ((ZtkWidget *) knob)->free_cb (
+    (ZtkWidget *) knob, NULL);
+  ztk_assert (store->params[0].num_widgets == 0);
+
+  ztk_param_store_free (store);
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Records a knob drag on the headless platform and
+ * replays it into a second app.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#define WIDTH 100
+#define HEIGHT 100
+#define RECORDING_PATH "recording_test.ztkrec"
+
+typedef struct TestUi
+{
+  ZtkApp * app;
+  float    knob_val;
+  int      num_writes;
+} TestUi;
+
+static float
+get_val (
+  void * object)
+{
+  return ((TestUi *) object)->knob_val;
+}
+
+static void
+set_val (
+  void * object,
+  float  val)
+{
+  TestUi * ui = (TestUi *) object;
+  ui->knob_val = val;
+  ui->num_writes++;
+}
+
+static void
+send_event (
+  TestUi *      ui,
+  PuglEventType type,
+  double        x,
+  double        y)
+{
+  PuglEvent ev;
+  memset (&ev, 0, sizeof (ev));
+  ev.type = type;
+  if (type == PUGL_MOTION_NOTIFY)
+    {
+      ev.motion.x = x;
+      ev.motion.y = y;
+    }
+  else
+    {
+      ev.button.x = x;
+      ev.button.y = y;
+      ev.button.button = 1;
+    }
+  puglHeadlessSendEvent (ui->app->view, &ev);
+}
+
+static void
+create_ui (
+  TestUi * ui)
+{
+  memset (ui, 0, sizeof (TestUi));
+  ui->app =
+    ztk_app_new ("recording", NULL, WIDTH, HEIGHT);
+  ZtkRect rect = { 10, 10, 40, 40 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_val, set_val, ui, 0.f, 1.f, 0.f);
+  ztk_app_add_widget (
+    ui->app, (ZtkWidget *) knob, 1);
+  ztk_app_idle (ui->app);
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  /* record a drag with frames in between */
+  TestUi rec;
+  create_ui (&rec);
+  puglHeadlessSetTime (rec.app->world, 0.0);
+  ztk_assert (
+    !ztk_app_start_recording (
+      rec.app, RECORDING_PATH));
+  send_event (&rec, PUGL_BUTTON_PRESS, 30, 30);
+  ztk_app_idle (rec.app);
+  for (int i = 1; i <= 20; i++)
+    {
+      puglHeadlessSetTime (rec.app->world, i / 200.0);
+      send_event (
+        &rec, PUGL_MOTION_NOTIFY, 30, 30 - i);
+      if (i % 2 == 0)
+        ztk_app_idle (rec.app);
+    }
+  send_event (&rec, PUGL_BUTTON_RELEASE, 30, 10);
+  ztk_app_idle (rec.app);
+  ztk_app_stop_recording (rec.app);
+  ztk_assert (rec.knob_val > 0.05f);
+
+  /* replay into a fresh UI */
+  TestUi replay;
+  create_ui (&replay);
+  ZtkReplayReport report;
+  ztk_assert (
+    !ztk_app_replay (
+      replay.app, RECORDING_PATH, 1, &report));
+
+  /* the same values were written, including the
+   * ones coalesced by the gesture */
+  ztk_assert (
+    math_floats_equal (
+      replay.knob_val, rec.knob_val));
+  ztk_assert (replay.num_writes == rec.num_writes);
+
+  /* 22 input events, one frame per idle call */
+  ztk_assert (report.num_events == 22);
+  ztk_assert (report.num_frames == 12);
+  ztk_assert (report.num_redraws > 0);
+  ztk_assert (
+    report.num_redraws <= report.num_frames);
+  ztk_replay_report_print (&report, stdout);
+  ztk_replay_report_clear (&report);
+
+  /* the replayed frame looks the same */
+  cairo_surface_t * rec_surface =
+    (cairo_surface_t *)
+    puglHeadlessGetSurface (rec.app->view);
+  cairo_surface_t * replay_surface =
+    (cairo_surface_t *)
+    puglHeadlessGetSurface (replay.app->view);
+  ztk_assert (
+    !memcmp (
+      cairo_image_surface_get_data (rec_surface),
+      cairo_image_surface_get_data (
+        replay_surface),
+      (size_t)
+        (cairo_image_surface_get_stride (
+           rec_surface) * HEIGHT)));
+
+  /* replaying at the recorded speed takes as long
+   * as the recording */
+  double start = puglGetTime (replay.app->world);
+  ztk_assert (
+    !ztk_app_replay (
+      replay.app, RECORDING_PATH, 0, &report));
+  ztk_assert (
+    puglGetTime (replay.app->world) - start >=
+      0.09);
+  ztk_assert (report.num_events == 22);
+  ztk_replay_report_clear (&report);
+
+  /* invalid recordings are rejected */
+  ztk_assert (
+    ztk_app_replay (
+      replay.app, "nonexistent.ztkrec", 1,
+      &report));
+
+  ztk_app_free (rec.app);
+  ztk_app_free (replay.app);
+  remove (RECORDING_PATH);
+
+  return 0;
+}
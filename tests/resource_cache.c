@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define NUM_THREADS 4
+
+static atomic_int num_renders = 0;
+
+static void
+render_cb (
+  cairo_t * cr,
+  int       width,
+  int       height,
+  void *    data)
+{
+  num_renders++;
+}
+
+/** Renders by drawing another cached surface. */
+static void
+render_nested_cb (
+  cairo_t * cr,
+  int       width,
+  int       height,
+  void *    data)
+{
+  cairo_surface_t * inner =
+    ztk_resource_cache_get_surface (
+      "inner", width, height, render_cb, NULL);
+  cairo_set_source_surface (cr, inner, 0, 0);
+  cairo_paint (cr);
+  ztk_resource_cache_release (inner);
+}
+
+static void *
+get_thread (
+  void * data)
+{
+  return
+    ztk_resource_cache_get_surface (
+      "shared", 32, 32, render_cb, NULL);
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  /* rendered once per key and size */
+  cairo_surface_t * surface =
+    ztk_resource_cache_get_surface (
+      "knob", 40, 40, render_cb, NULL);
+  ztk_assert (
+    ztk_resource_cache_get_surface (
+      "knob", 40, 40, render_cb, NULL) == surface);
+  ztk_assert (num_renders == 1);
+  cairo_surface_t * bigger =
+    ztk_resource_cache_get_surface (
+      "knob", 80, 80, render_cb, NULL);
+  ztk_assert (bigger != surface);
+  ztk_assert (num_renders == 2);
+  ztk_assert (
+    cairo_image_surface_get_width (bigger) == 80);
+
+  /* released resources stay cached until
+   * trimmed */
+  ztk_resource_cache_release (bigger);
+  ztk_assert (
+    ztk_resource_cache_get_surface (
+      "knob", 80, 80, render_cb, NULL) == bigger);
+  ztk_assert (num_renders == 2);
+  ztk_resource_cache_release (bigger);
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 1);
+
+  /* unused resources over the budget are evicted,
+   * oldest first */
+  char key[32];
+  for (int i = 0; i < 64; i++)
+    {
+      snprintf (key, sizeof (key), "sprite %d", i);
+      ztk_resource_cache_release (
+        ztk_resource_cache_get_surface (
+          key, 512, 512, render_cb, NULL));
+    }
+  int num_resources =
+    ztk_resource_cache_get_num_resources ();
+  ztk_assert (num_resources > 1);
+  ztk_assert (
+    (size_t) (num_resources - 1) * 512 * 512 * 4 <=
+      ZTK_RESOURCE_CACHE_MAX_UNUSED_BYTES);
+  num_renders = 0;
+  ztk_resource_cache_release (
+    ztk_resource_cache_get_surface (
+      "sprite 63", 512, 512, render_cb, NULL));
+  ztk_assert (num_renders == 0);
+  ztk_resource_cache_release (
+    ztk_resource_cache_get_surface (
+      "sprite 0", 512, 512, render_cb, NULL));
+  ztk_assert (num_renders == 1);
+
+  /* in use by the other instances */
+  ztk_resource_cache_release (surface);
+  ztk_resource_cache_release (surface);
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 0);
+
+  /* font faces */
+  cairo_font_face_t * face =
+    ztk_resource_cache_get_font_face (
+      "sans-serif", CAIRO_FONT_SLANT_NORMAL,
+      CAIRO_FONT_WEIGHT_BOLD);
+  ztk_assert (
+    ztk_resource_cache_get_font_face (
+      "sans-serif", CAIRO_FONT_SLANT_NORMAL,
+      CAIRO_FONT_WEIGHT_BOLD) == face);
+  cairo_font_face_t * normal_face =
+    ztk_resource_cache_get_font_face (
+      "sans-serif", CAIRO_FONT_SLANT_NORMAL,
+      CAIRO_FONT_WEIGHT_NORMAL);
+  ztk_assert (normal_face != face);
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 2);
+
+  /* apps on several threads share one copy */
+  num_renders = 0;
+  pthread_t threads[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_create (
+        &threads[i], NULL, get_thread, NULL);
+    }
+  void * results[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_join (threads[i], &results[i]);
+      ztk_assert (results[i] == results[0]);
+    }
+  /* rendered without the lock, so a copy may be
+   * rendered on each thread, but only one is
+   * kept */
+  ztk_assert (
+    num_renders >= 1 && num_renders <= NUM_THREADS);
+
+  /* the render callback may use the cache */
+  cairo_surface_t * outer =
+    ztk_resource_cache_get_surface (
+      "outer", 16, 16, render_nested_cb, NULL);
+  ztk_assert (outer);
+  ztk_resource_cache_release (outer);
+
+  for (int i = 0; i < NUM_THREADS; i++)
+    {
+      ztk_resource_cache_release (results[i]);
+    }
+  ztk_resource_cache_release (face);
+  ztk_resource_cache_release (face);
+  ztk_resource_cache_release (normal_face);
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 0);
+
+  return 0;
+}
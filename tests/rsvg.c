@@ -44,5 +44,24 @@ int main (
     ztk_rsvg_get_height (handle);
   ztk_assert (height == 32);
 
+  /* shared through the resource cache */
+  ztk_assert (ztk_rsvg_load_svg (argv[1]) == handle);
+  cairo_surface_t * surface =
+    ztk_resource_cache_get_svg_surface (
+      handle, 16, 16);
+  ztk_assert (surface);
+  ztk_assert (
+    ztk_resource_cache_get_svg_surface (
+      handle, 16, 16) == surface);
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 2);
+  ztk_resource_cache_release (surface);
+  ztk_resource_cache_release (surface);
+  ztk_resource_cache_release (handle);
+  ztk_resource_cache_release (handle);
+  ztk_resource_cache_trim ();
+  ztk_assert (
+    ztk_resource_cache_get_num_resources () == 0);
+
   return 0;
 }
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/search_index.h>
+
+static const char * names[] = {
+  "Warm Pad",
+  "Bass Drop",
+  "Pad Warmth",
+  "Lead Saw",
+  "Sawtooth Bass",
+  "Bell",
+  "ba",
+};
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkSearchIndex * index =
+    ztk_search_index_new (names, 7);
+  ZtkSearchResults * results =
+    ztk_search_results_new (index);
+  int * indices = results->indices;
+
+  /* names are matched lowercased but kept as they
+   * are for display */
+  ztk_assert (!strcmp (index->names[0], "warm pad"));
+  ztk_assert (
+    !strcmp (index->display_names[0], "Warm Pad"));
+
+  /* empty query matches everything */
+  ztk_search_index_query (index, "", results);
+  ztk_assert (results->num_indices == 7);
+
+  /* short queries without trigrams */
+  ztk_search_index_query (index, "BA", results);
+  ztk_assert (results->num_indices == 3);
+  ztk_assert (results->indices[0] == 1);
+  ztk_assert (results->indices[1] == 6);
+  ztk_assert (results->indices[2] == 4);
+
+  /* typing filters the previous results */
+  ztk_search_index_query (index, "bas", results);
+  ztk_assert (results->num_indices == 2);
+  ztk_search_index_query (index, "bass d", results);
+  ztk_assert (results->num_indices == 1);
+  ztk_assert (results->indices[0] == 1);
+
+  /* unrelated query uses the trigram index */
+  ztk_search_index_query (index, "warm", results);
+  ztk_assert (results->num_indices == 2);
+  ztk_assert (results->indices[0] == 0);
+  ztk_assert (results->indices[1] == 2);
+
+  /* prefix matches are ordered first */
+  ztk_search_index_query (index, "saw", results);
+  ztk_assert (results->num_indices == 2);
+  ztk_assert (results->indices[0] == 4);
+  ztk_assert (results->indices[1] == 3);
+
+  /* deleting a character widens the results */
+  ztk_search_index_query (index, "pad w", results);
+  ztk_assert (results->num_indices == 1);
+  ztk_search_index_query (index, "pad", results);
+  ztk_assert (results->num_indices == 2);
+
+  ztk_search_index_query (index, "xyz", results);
+  ztk_assert (results->num_indices == 0);
+
+  /* the result buffer is never reallocated */
+  ztk_assert (results->indices == indices);
+
+  ztk_search_results_free (results);
+  ztk_search_index_free (index);
+
+  return 0;
+}
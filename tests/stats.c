@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Collects statistics of a few frames on the
+ * headless platform.
+ */
+
+#include "helper.h"
+
+#include <time.h>
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+static void
+free_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+  free (widget);
+}
+
+/**
+ * Takes at least a millisecond to draw.
+ */
+static void
+slow_draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   rect,
+  void *      data)
+{
+  clock_t start = clock ();
+  while ((double) (clock () - start) <
+           (double) CLOCKS_PER_SEC / 1000.0)
+    ;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkApp * app =
+    ztk_app_new ("stats", NULL, 100, 100);
+  ZtkRect rect = { 0, 0, 50, 50 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+  rect = (ZtkRect) { 50, 0, 50, 50 };
+  knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+
+  /* no fingerprint, so redrawn in every frame */
+  ZtkWidget * slow =
+    calloc (1, sizeof (ZtkWidget));
+  rect = (ZtkRect) { 0, 60, 100, 40 };
+  ztk_widget_init (
+    slow, ZTK_WIDGET_TYPE_DRAWING_AREA, &rect,
+    noop_cb, slow_draw_cb, free_cb);
+  ztk_app_add_widget (app, slow, 0);
+
+  ZtkAppStats stats;
+  ztk_app_set_stats_enabled (app, 1);
+
+  /* the first frame draws everything once, leaving
+   * a gap between the knobs and the slow widget */
+  ztk_app_idle (app);
+  ztk_app_get_stats (app, &stats);
+  ztk_assert (stats.num_frames == 1);
+  ztk_assert (stats.last_widgets_drawn == 3);
+  ztk_assert (stats.last_widgets_culled == 0);
+  ztk_assert (
+    math_doubles_equal (
+      stats.pixels_damaged, 10000.0));
+  ztk_assert (
+    math_doubles_equal (
+      stats.pixels_painted, 9000.0));
+  ztk_assert (
+    math_doubles_equal (stats.overdraw, 0.9));
+  ztk_assert (stats.draw.last >= 0.001);
+  ztk_assert (stats.backend.last >= 0.0);
+
+  /* hovering the slow widget only redraws it */
+  send_motion_event (app, 20, 70);
+  ztk_app_idle (app);
+  ztk_app_get_stats (app, &stats);
+  ztk_assert (stats.num_frames == 2);
+  ztk_assert (stats.dispatch.last > 0.0);
+  ztk_assert (stats.last_widgets_drawn == 1);
+  ztk_assert (stats.last_widgets_culled == 2);
+  ztk_assert (stats.widgets_drawn == 4);
+  ztk_assert (stats.widgets_culled == 2);
+  ztk_assert (
+    math_doubles_equal (
+      stats.pixels_damaged, 14000.0));
+  ztk_assert (
+    math_doubles_equal (
+      stats.pixels_painted, 13000.0));
+  ztk_assert (
+    stats.draw.max >= stats.draw.last &&
+    stats.draw.total >= 0.002);
+
+  /* the slow widget is the most expensive */
+  ztk_assert (stats.num_top_widgets == 3);
+  ztk_assert (stats.top_widgets[0].widget == slow);
+  ztk_assert (stats.top_widgets[0].num_draws == 2);
+  ztk_assert (
+    stats.top_widgets[1].draw_time >=
+      stats.top_widgets[2].draw_time);
+  ztk_app_stats_print (&stats, stdout);
+
+  /* nothing is collected while disabled */
+  ztk_app_set_stats_enabled (app, 0);
+  send_motion_event (app, 20, 20);
+  ztk_app_idle (app);
+  ztk_app_get_stats (app, &stats);
+  ztk_assert (stats.num_frames == 2);
+  ztk_assert (slow->num_draws == 2);
+
+  ztk_app_reset_stats (app);
+  ztk_app_get_stats (app, &stats);
+  ztk_assert (stats.num_frames == 0);
+  ztk_assert (stats.num_top_widgets == 0);
+  ztk_assert (slow->num_draws == 0);
+
+  ztk_app_free (app);
+
+  return 0;
+}
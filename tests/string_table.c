@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkStringTable * table = ztk_string_table_new ();
+
+  /* equal strings are stored once */
+  char buf[16];
+  strcpy (buf, "Off");
+  const char * off =
+    ztk_string_table_intern (table, buf);
+  strcpy (buf, "XXX");
+  ztk_assert (!strcmp (off, "Off"));
+  ztk_assert (
+    ztk_string_table_intern (table, "Off") == off);
+  ztk_assert (ztk_string_get_length (off) == 3);
+  const char * on =
+    ztk_string_table_intern (table, "On");
+  ztk_assert (on != off);
+  ztk_assert (table->num_strings == 2);
+  ztk_assert (!ztk_string_table_intern (table, NULL));
+
+  /* removed with the last reference */
+  ztk_string_unref (off);
+  ztk_assert (table->num_strings == 2);
+  ztk_string_unref (off);
+  ztk_assert (table->num_strings == 1);
+
+  /* many strings grow the table */
+  const char * notes[1000];
+  for (int i = 0; i < 1000; i++)
+    {
+      snprintf (buf, sizeof (buf), "C%d", i);
+      notes[i] = ztk_string_table_intern (table, buf);
+    }
+  ztk_assert (table->num_strings == 1001);
+  for (int i = 0; i < 1000; i++)
+    {
+      snprintf (buf, sizeof (buf), "C%d", i);
+      ztk_assert (
+        ztk_string_table_intern (table, buf) ==
+          notes[i]);
+      ztk_string_unref (notes[i]);
+      ztk_string_unref (notes[i]);
+    }
+  ztk_assert (table->num_strings == 1);
+
+  /* strings outlive the table */
+  ztk_string_ref (on);
+  ztk_string_table_free (table);
+  ztk_assert (!strcmp (on, "On"));
+  ztk_string_unref (on);
+  ztk_string_unref (on);
+
+  /* without a table strings are not shared */
+  const char * a = ztk_string_table_intern (NULL, "On");
+  const char * b = ztk_string_table_intern (NULL, "On");
+  ztk_assert (a != b && !strcmp (a, b));
+  ztk_string_unref (a);
+  ztk_string_unref (b);
+
+  /* widgets in the same app share their texts */
+  ZtkApp * app =
+    ztk_app_new ("strings", NULL, 200, 200);
+  ZtkRect rect = { 10, 10, 40, 20 };
+  ZtkButton * btn =
+    ztk_button_new (&rect, noop_cb, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) btn, 1);
+  ZtkComboBox * combos[2];
+  for (int i = 0; i < 2; i++)
+    {
+      combos[i] =
+        ztk_combo_box_new ((ZtkWidget *) btn, 0, 0);
+      ztk_combo_box_add_text_element (
+        combos[i], "Off", noop_cb, NULL);
+      ztk_combo_box_add_separator (combos[i]);
+      ztk_combo_box_add_text_element (
+        combos[i], "On", noop_cb, NULL);
+    }
+  ztk_app_add_widget (
+    app, (ZtkWidget *) combos[0], 10);
+  ztk_assert (
+    combos[0]->elements[0].label ==
+      combos[1]->elements[0].label);
+  ztk_assert (app->strings->num_strings == 2);
+
+  ZtkRect dialog_rect = { 20, 20, 160, 160 };
+  ZtkDialog * dialog =
+    ztk_dialog_new (app, &rect, &dialog_rect, NULL);
+  ztk_dialog_make_about (
+    dialog, "On", "1.0", "Copyright",
+    ZTK_DIALOG_ABOUT_LICENSE_AGPL_3_PLUS, "Text");
+  ztk_assert (
+    dialog->title == combos[0]->elements[2].label);
+  ztk_app_add_widget (app, (ZtkWidget *) dialog, 5);
+  ztk_app_idle (app);
+
+  /* not added, so freed separately */
+  ((ZtkWidget *) combos[1])->free_cb (
+    (ZtkWidget *) combos[1], NULL);
+  ztk_assert (app->strings->num_strings == 5);
+
+  /* clearing releases the texts, and separators
+   * in reused slots have none */
+  ztk_combo_box_clear (combos[0]);
+  ztk_assert (app->strings->num_strings == 4);
+  ztk_combo_box_add_separator (combos[0]);
+  ztk_assert (!combos[0]->elements[0].label);
+  ztk_combo_box_add_text_element (
+    combos[0], "Unique", noop_cb, NULL);
+  ztk_assert (app->strings->num_strings == 5);
+  ztk_combo_box_clear (combos[0]);
+  ztk_assert (app->strings->num_strings == 4);
+  ztk_app_free (app);
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Affero Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkColor colors[ZTK_STYLE_NUM_COLORS];
+  memset (colors, 0, sizeof (colors));
+  ztk_color_parse_hex (
+    &colors[ZTK_STYLE_COLOR_BG], "#FF000080");
+  ztk_assert (
+    ztk_color_to_rgba32 (
+      &colors[ZTK_STYLE_COLOR_BG]) == 0xff000080);
+
+  /* styles with the same colors hash the same */
+  ZtkStyle * style = ztk_style_new (colors);
+  ZtkStyle * same = ztk_style_new (colors);
+  ztk_assert (style->hash == same->hash);
+  ztk_assert (
+    style->rgba32[ZTK_STYLE_COLOR_BG] == 0xff000080);
+  colors[ZTK_STYLE_COLOR_FG].alpha = 1;
+  ZtkStyle * other = ztk_style_new (colors);
+  ztk_assert (style->hash != other->hash);
+  ztk_style_unref (same);
+  ztk_style_unref (other);
+
+  ZtkApp * app =
+    ztk_app_new ("style", NULL, 200, 200);
+  ZtkStyle * theme_style =
+    app->theme.dialog_close_button_style;
+
+  /* buttons share the style they are given */
+  ZtkRect rect = { 10, 10, 40, 20 };
+  ZtkButton * btns[2];
+  for (int i = 0; i < 2; i++)
+    {
+      btns[i] =
+        ztk_button_new (&rect, noop_cb, NULL);
+      ztk_button_set_background_style (
+        btns[i], theme_style);
+      ztk_app_add_widget (
+        app, (ZtkWidget *) btns[i], 1);
+    }
+  ztk_assert (
+    btns[0]->bg_style == btns[1]->bg_style);
+  ztk_assert (theme_style->refcount == 3);
+
+  /* widgets without a style of their own draw
+   * with the theme's */
+  ZtkComboBox * combo =
+    ztk_combo_box_new ((ZtkWidget *) btns[0], 0, 0);
+  ztk_combo_box_add_text_element (
+    combo, "First", noop_cb, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) combo, 10);
+  ztk_assert (!combo->style);
+  ztk_combo_box_set_style (combo, style);
+  ztk_assert (style->refcount == 2);
+  ztk_app_idle (app);
+  ztk_combo_box_set_style (combo, NULL);
+  ztk_assert (style->refcount == 1);
+  ztk_app_idle (app);
+
+  /* widgets keep their styles alive after the
+   * theme is gone */
+  ztk_combo_box_set_style (combo, style);
+  ztk_style_ref (theme_style);
+  ztk_app_free (app);
+  ztk_assert (style->refcount == 1);
+  ztk_assert (theme_style->refcount == 1);
+  ztk_style_unref (theme_style);
+  ztk_style_unref (style);
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Traces a few frames on the headless platform.
+ * Skipped unless built with enable_trace.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+#define TRACE_PATH "trace_test.json"
+
+#ifdef ENABLE_TRACE
+
+static char *
+read_file (
+  const char * path)
+{
+  FILE * file = fopen (path, "rb");
+  ztk_assert (file);
+  fseek (file, 0, SEEK_END);
+  long size = ftell (file);
+  fseek (file, 0, SEEK_SET);
+  char * contents = calloc ((size_t) size + 1, 1);
+  ztk_assert (
+    fread (contents, 1, (size_t) size, file) ==
+      (size_t) size);
+  fclose (file);
+
+  return contents;
+}
+
+static void
+run_frames (
+  ZtkApp * app,
+  int      num_frames)
+{
+  for (int i = 0; i < num_frames; i++)
+    {
+      PuglEvent ev;
+      memset (&ev, 0, sizeof (ev));
+      ev.type = PUGL_MOTION_NOTIFY;
+      ev.motion.x = 20 + i % 2;
+      ev.motion.y = 20;
+      puglHeadlessSendEvent (app->view, &ev);
+      test_knob_val = (float) (i % 10) / 10.f;
+      ztk_app_idle (app);
+    }
+}
+
+#endif
+
+int main (
+  int argc, const char* argv[])
+{
+#ifndef ENABLE_TRACE
+  ztk_assert (
+    ztk_trace_start (TRACE_PATH, 16) == -1);
+  ztk_assert (!ztk_trace_active);
+
+  /* skipped */
+  return 77;
+#else
+  ZtkApp * app =
+    ztk_app_new ("trace", NULL, 100, 100);
+  ZtkRect rect = { 10, 10, 40, 40 };
+  ZtkKnob * knob =
+    ztk_knob_new (
+      &rect, get_knob_val, set_knob_val, NULL,
+      0.f, 1.f, 0.f);
+  ztk_app_add_widget (app, (ZtkWidget *) knob, 1);
+
+  ztk_assert (!ztk_trace_start (TRACE_PATH, 1024));
+  ztk_assert (ztk_trace_active);
+  run_frames (app, 10);
+  ztk_trace_stop ();
+  ztk_assert (!ztk_trace_active);
+
+  char * contents = read_file (TRACE_PATH);
+  ztk_assert (contents[0] == '[');
+  ztk_assert (strstr (contents, "\n]\n"));
+  const char * names[] = {
+    "\"puglDispatchEvents\"", "\"on_event\"",
+    "\"post_event_to_widgets\"", "\"update_cb\"",
+    "\"draw_cb\"", "\"backend_leave\"",
+    "\"damage_area\"", };
+  for (size_t i = 0;
+       i < sizeof (names) / sizeof (names[0]); i++)
+    {
+      ztk_assert (strstr (contents, names[i]));
+    }
+  free (contents);
+
+  /* a ring too small for a frame drops the oldest
+   * events but still writes a valid trace */
+  ztk_assert (!ztk_trace_start (TRACE_PATH, 4));
+  run_frames (app, 3);
+  ztk_trace_stop ();
+  contents = read_file (TRACE_PATH);
+  ztk_assert (contents[0] == '[');
+  ztk_assert (strstr (contents, "\n]\n"));
+  free (contents);
+
+  ztk_app_free (app);
+
+  /* apps started from ZTK_TRACE share the trace,
+   * which lasts until the last one is freed */
+  setenv ("ZTK_TRACE", TRACE_PATH, 1);
+  app = ztk_app_new ("trace", NULL, 100, 100);
+  run_frames (app, 2);
+  ZtkApp * app2 =
+    ztk_app_new ("trace 2", NULL, 100, 100);
+  ztk_assert (ztk_trace_active);
+  ztk_app_free (app);
+  ztk_assert (ztk_trace_active);
+  ztk_app_idle (app2);
+  ztk_app_free (app2);
+  ztk_assert (!ztk_trace_active);
+  unsetenv ("ZTK_TRACE");
+  contents = read_file (TRACE_PATH);
+  ztk_assert (strstr (contents, "\"on_event\""));
+  ztk_assert (strstr (contents, "\n]\n"));
+  free (contents);
+
+  remove (TRACE_PATH);
+
+  return 0;
+#endif
+}
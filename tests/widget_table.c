@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 Alexandros Theodotou <alex at zrythm dot org>
+ *
+ * This file is part of ZToolkit
+ *
+ * ZToolkit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ZToolkit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with ZToolkit.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ *
+ * Checks that the hot data of the widgets follows
+ * the widget API.
+ */
+
+#include "helper.h"
+
+#include <ztoolkit/ztk.h>
+
+#include "pugl/pugl_headless.h"
+
+static void
+noop_cb (
+  ZtkWidget * widget,
+  void *      data)
+{
+}
+
+static void
+draw_cb (
+  ZtkWidget * widget,
+  cairo_t *   cr,
+  ZtkRect *   rect,
+  void *      data)
+{
+}
+
+static ZtkWidget *
+add_widget (
+  ZtkApp * app,
+  double   x,
+  double   y,
+  int      z)
+{
+  ZtkRect rect = { x, y, 20, 20 };
+  ZtkDrawingArea * area =
+    ztk_drawing_area_new (
+      &rect, noop_cb, draw_cb, NULL, NULL);
+  ztk_app_add_widget (app, (ZtkWidget *) area, z);
+
+  return (ZtkWidget *) area;
+}
+
+/**
+ * Returns the index of the widget in the app.
+ */
+static int
+get_idx (
+  ZtkApp *    app,
+  ZtkWidget * widget)
+{
+  for (int i = 0; i < app->num_widgets; i++)
+    {
+      if (app->widgets[i] == widget)
+        return i;
+    }
+
+  return -1;
+}
+
+int main (
+  int argc, const char* argv[])
+{
+  ZtkApp * app =
+    ztk_app_new ("widget table", NULL, 100, 100);
+  ZtkWidgetTable * table = &app->widget_table;
+
+  /* kept in z order */
+  ZtkWidget * top = add_widget (app, 10, 10, 2);
+  ZtkWidget * bot = add_widget (app, 0, 0, 1);
+  ZtkWidget * other = add_widget (app, 50, 50, 0);
+  ztk_assert (table->num_widgets == 3);
+  ztk_assert (table->size % 8 == 0);
+  ztk_assert (get_idx (app, top) == 2);
+  ztk_assert (table->z[2] == 2);
+  for (int i = 0; i < app->num_widgets; i++)
+    {
+      ztk_assert (app->widgets[i]->table_idx == i);
+    }
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 15, 15) ==
+      2);
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 5, 5) ==
+      get_idx (app, bot));
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 90, 5) ==
+      -1);
+
+  /* setters update it */
+  ztk_widget_set_visible (top, 0);
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 15, 15) ==
+      get_idx (app, bot));
+  ztk_widget_set_visible (top, 1);
+  ZtkRect rect = { 60, 0, 20, 20 };
+  ztk_widget_set_rect (top, &rect);
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 70, 10) ==
+      get_idx (app, top));
+
+  /* events only hover the top-most widget and
+   * mirror its state */
+  ztk_widget_set_rect (
+    top, &(ZtkRect) { 10, 10, 20, 20 });
+  PuglEventMotion ev = {
+    .type = PUGL_MOTION_NOTIFY, .x = 15, .y = 15 };
+  puglHeadlessSendEvent (
+    app->view, (const PuglEvent *) &ev);
+  ztk_app_idle (app);
+  ztk_assert (top->state & ZTK_WIDGET_STATE_HOVERED);
+  ztk_assert (
+    !(bot->state & ZTK_WIDGET_STATE_HOVERED));
+  ztk_assert (
+    table->flags[get_idx (app, top)] &
+      ZTK_WIDGET_STATE_HOVERED);
+
+  /* removing shifts the entries */
+  ztk_app_remove_widget (app, bot);
+  ztk_assert (table->num_widgets == 2);
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 5, 5) ==
+      -1);
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 55, 55) ==
+      get_idx (app, other));
+  ztk_assert (
+    top->table_idx == get_idx (app, top));
+  ztk_assert (
+    other->table_idx == get_idx (app, other));
+
+  /* the stale index of a removed widget is not
+   * used */
+  ztk_widget_set_rect (
+    bot, &(ZtkRect) { 50, 50, 20, 20 });
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 15, 15) ==
+      get_idx (app, top));
+  ztk_assert (
+    ztk_widget_table_find_top_hit (table, 55, 55) ==
+      get_idx (app, other));
+  bot->free_cb (bot, NULL);
+
+  ztk_app_free (app);
+
+  return 0;
+}